@@ -430,6 +430,28 @@ prefix_ senf::Packet const & senf::ppi::connector::InputConnector::operator()()
     }
 }
 
+prefix_ senf::ppi::connector::InputConnector::size_type
+senf::ppi::connector::InputConnector::read(PacketBurst & burst, size_type max)
+{
+    if (empty())
+        v_requestEvent();
+    size_type n (0);
+    if (fastPacket_ && max > 0) {
+        SENF_PPI_TRACE(*fastPacket_, "IN ");
+        burst.push_back(*fastPacket_);
+        fastPacket_ = nullptr;
+        ++ n;
+    }
+    for (; n < max && ! queue_.empty(); ++ n) {
+        SENF_PPI_TRACE(queue_.back(), "IN ");
+        burst.push_back(queue_.back());
+        queue_.pop_back();
+    }
+    if (n > 0)
+        v_dequeueEvent();
+    return n;
+}
+
 prefix_ void senf::ppi::connector::InputConnector::v_disconnected()
 {
     Connector::v_disconnected();
@@ -518,6 +540,19 @@ prefix_ void senf::ppi::connector::GenericPassiveInput::throttlingDisc(Throttlin
     throttlingDisc_.reset();
 }
 
+prefix_ void senf::ppi::connector::GenericPassiveInput::burstRequest()
+{
+    // Deliver the queue in bursts of at most maxBurst_ packets until it is empty or the input
+    // gets throttled. Remaining packets are delivered on unthrottle
+    do {
+        burst_.clear();
+        if (read(burst_, maxBurst_) == 0)
+            break;
+        burstCallback_(burst_);
+    } while (! empty() && ! throttled());
+    burst_.clear();
+}
+
 prefix_ void senf::ppi::connector::GenericPassiveInput::v_unthrottleEvent()
 {
     size_type n (queueSize());
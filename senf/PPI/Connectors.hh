@@ -19,6 +19,7 @@
 
 // Custom includes
 #include <deque>
+#include <vector>
 #include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <senf/Utils/safe_bool.hh>
@@ -34,6 +35,13 @@
 
 namespace senf {
 namespace ppi {
+
+    /** \brief Batch of packets passed with a single connector call
+
+        \see \ref ppi_connectors_burst
+     */
+    typedef std::vector<Packet> PacketBurst;
+
 namespace connector {
 
     /** \namespace senf::ppi::connector
@@ -65,6 +73,48 @@ namespace connector {
         must be the type of packet expected or sent on this connector. If it is not specified,
         packets will be passed using the generic Packet handle.
 
+        \section ppi_connectors_burst Bursts
+
+        Every packet normally takes a complete trip through the connectors: The output calls the
+        input, the input checks the throttling state and calls the \c onRequest handler of the
+        module, which again reads the packet from the input. To spread this cost over many packets,
+        an output may send a complete PacketBurst with a single call:
+
+        \code
+        senf::ppi::PacketBurst burst;
+        // ... fill burst
+        output(burst);
+        \endcode
+
+        A passive input opts in to receive bursts by registering an \c onRequestBurst handler
+        instead of an \c onRequest handler. The handler is called with up to maxBurst() packets:
+
+        \code
+        class BurstForwarder : public senf::ppi::module::Module
+        {
+            SENF_PPI_MODULE(BurstForwarder);
+        public:
+            senf::ppi::connector::PassiveInput<> input;
+            senf::ppi::connector::ActiveOutput<> output;
+
+            BurstForwarder() {
+                route(input, output);
+                input.onRequestBurst(&BurstForwarder::onRequest);
+            }
+
+        private:
+            void onRequest(senf::ppi::PacketBurst & burst) {
+                // process packets ...
+                output(burst);
+            }
+        };
+        \endcode
+
+        Bursts and single packets mix freely: A burst sent to an input without \c onRequestBurst
+        handler is passed on packet by packet, single packets sent to a burst input are delivered as
+        bursts of one packet. Throttling is checked per burst: A burst always is delivered
+        completely, throttling the input from within the handler only affects the next burst.
+
         \code
         class IpFilter : public senf::ppi::module::Module
         {
@@ -414,6 +464,13 @@ namespace connector {
 
         Packet const & read();          ///< Alias for operator()()
 
+        size_type read(PacketBurst & burst, size_type max);
+                                        ///< Get up to \a max packets
+                                        /**< Appends up to \a max queued packets to \a burst. If the
+                                             connector is active and the queue is empty, new
+                                             packets are requested first.
+                                             \returns number of packets added to \a burst */
+
         OutputConnector & peer() const;
 
         size_type queueSize() const;    ///< Return number of elements in the queue
@@ -425,8 +482,11 @@ namespace connector {
         virtual void v_disconnected();
         virtual void v_connected();
 
+        bool burstMode_;
+
     private:
         void enqueue(Packet const & p);
+        void enqueue(PacketBurst const & burst);
 
         virtual void v_requestEvent();
         virtual void v_enqueueEvent();
@@ -454,6 +514,10 @@ namespace connector {
 
         void write(Packet const & p);           ///< Alias for operator()(Packet p)
 
+        void operator()(PacketBurst const & burst); ///< Send out a burst of packets
+                                        /**< \see \ref ppi_connectors_burst */
+        void write(PacketBurst const & burst);  ///< Alias for operator()(PacketBurst burst)
+
         InputConnector & peer() const;
 
     protected:
@@ -493,6 +557,17 @@ namespace connector {
         void throttlingDisc(ThrottlingDiscipline::None_t);
                                         ///< Disable throttling discipline
 
+        template <class Handler>
+        void onRequestBurst(Handler handler); ///< Register burst request handler
+                                        /**< Replaces onRequest(): The handler is called with a
+                                             PacketBurst of up to maxBurst() packets instead of
+                                             having to read the packets one by one. The handler
+                                             may modify the burst, it is cleared after the
+                                             handler returns.
+                                             \see \ref ppi_connectors_burst */
+        size_type maxBurst() const;     ///< Maximum number of packets passed to the burst handler
+        void maxBurst(size_type n);     ///< Set maximum number of packets passed to burst handler
+
     protected:
         GenericPassiveInput();
 
@@ -504,8 +579,13 @@ namespace connector {
         void v_dequeueEvent();
         void v_unthrottleEvent();
 
+        void burstRequest();
+
         GenericActiveOutput * peer_;
         boost::scoped_ptr<ThrottlingDiscipline> throttlingDisc_;
+        ppi::detail::Callback<PacketBurst &>::type burstCallback_;
+        PacketBurst burst_;
+        size_type maxBurst_;
     };
 
     /** \brief Combination of PassiveConnector and OutputConnector
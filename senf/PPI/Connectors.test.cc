@@ -562,6 +562,116 @@ SENF_AUTO_TEST_CASE(disconnect)
     }
 }
 
+namespace {
+
+    class BurstSink
+        : public ppi::module::Module
+    {
+        SENF_PPI_MODULE(BurstSink);
+
+    public:
+        ppi::connector::PassiveInput<> input;
+
+        std::vector<unsigned> bursts;
+        std::vector<senf::Packet> packets;
+        bool throttle;
+
+        BurstSink() : throttle (false) {
+            noroute(input);
+            input.onRequestBurst(&BurstSink::request);
+        }
+
+    private:
+        void request(ppi::PacketBurst & burst) {
+            bursts.push_back(burst.size());
+            packets.insert(packets.end(), burst.begin(), burst.end());
+            if (throttle)
+                input.throttle();
+        }
+    };
+
+    ppi::PacketBurst makeBurst(unsigned n)
+    {
+        ppi::PacketBurst burst;
+        for (unsigned i (0); i < n; ++i)
+            burst.push_back(senf::DataPacket::create());
+        return burst;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(burstConnector)
+{
+    debug::ActiveSource source;
+    BurstSink sink;
+
+    ppi::connect(source, sink);
+    ppi::init();
+
+    BOOST_CHECK_EQUAL( sink.input.maxBurst(), 64u );
+    sink.input.maxBurst(4);
+
+    // A burst is passed with a single call, larger bursts are split
+    ppi::PacketBurst burst (makeBurst(6));
+    source.submit(burst);
+    BOOST_REQUIRE_EQUAL( sink.bursts.size(), 2u );
+    BOOST_CHECK_EQUAL( sink.bursts[0], 4u );
+    BOOST_CHECK_EQUAL( sink.bursts[1], 2u );
+    BOOST_CHECK( sink.packets == burst );
+    BOOST_CHECK( sink.input.empty() );
+
+    // Single packets are passed as bursts of one packet
+    senf::Packet p (senf::DataPacket::create());
+    source.submit(p);
+    BOOST_CHECK_EQUAL( sink.bursts.size(), 3u );
+    BOOST_CHECK_EQUAL( sink.bursts.back(), 1u );
+    BOOST_CHECK( sink.packets.back() == p );
+
+    // Throttling from within the handler keeps the rest of the burst queued
+    sink.bursts.clear();
+    sink.packets.clear();
+    sink.throttle = true;
+    source.submit(burst);
+    BOOST_CHECK_EQUAL( sink.bursts.size(), 1u );
+    BOOST_CHECK_EQUAL( sink.input.queueSize(), 2u );
+    BOOST_CHECK( ! source );
+    sink.throttle = false;
+    sink.input.unthrottle();
+    BOOST_CHECK_EQUAL( sink.bursts.size(), 2u );
+    BOOST_CHECK( sink.packets == burst );
+    BOOST_CHECK( sink.input.empty() );
+}
+
+SENF_AUTO_TEST_CASE(burstAdapter)
+{
+    // Bursts sent to a module without burst handler are delivered packet by packet
+    debug::ActiveSource source;
+    debug::PassiveSink sink;
+
+    ppi::connect(source, sink);
+    ppi::init();
+
+    ppi::PacketBurst burst (makeBurst(3));
+    source.submit(burst);
+    BOOST_REQUIRE_EQUAL( sink.size(), 3u );
+    BOOST_CHECK( sink.pop_front() == burst[0] );
+    BOOST_CHECK( sink.pop_front() == burst[1] );
+    BOOST_CHECK( sink.pop_front() == burst[2] );
+
+    // Reading bursts from an input
+    TypedActiveOutput<> output;
+    debug::PassiveSink target;
+    ppi::connect(output, target);
+    ppi::init();
+    target.throttle();
+    output.output(burst);
+    BOOST_CHECK_EQUAL( target.input.queueSize(), 3u );
+    ppi::PacketBurst received;
+    BOOST_CHECK_EQUAL( target.input.read(received, 2u), 2u );
+    BOOST_CHECK_EQUAL( target.input.read(received, 2u), 1u );
+    BOOST_CHECK( received == burst );
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
@@ -77,6 +77,8 @@ namespace debug {
 
         void submit(Packet const & packet);     ///< Submit packet
                                         /**< \pre boolean_test() is \c true */
+        void submit(PacketBurst const & burst); ///< Submit burst of packets
+                                        /**< \pre boolean_test() is \c true */
 
         bool boolean_test() const;      ///< \c true if \a output is not throttled
     };
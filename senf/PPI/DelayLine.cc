@@ -0,0 +1,411 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief DelayLine non-inline non-template implementation */
+
+#include "DelayLine.hh"
+#include "DelayLine.ih"
+
+// Custom includes
+#include <cmath>
+#include <senf/Utils/membind.hh>
+#include <senf/Utils/Console/ParsedCommand.hh>
+#include <senf/Utils/Console/Variables.hh>
+
+//#include "DelayLine.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+namespace module {
+
+    SENF_CONSOLE_REGISTER_ENUM_MEMBER( DelayLine, Distribution,
+                                       (UNIFORM)(NORMAL)(PARETO)(PARETONORMAL) );
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::detail::TimingWheel
+
+unsigned const senf::ppi::module::detail::TimingWheel::None;
+
+prefix_ senf::ppi::module::detail::TimingWheel::TimingWheel(ClockService::clock_type granularity,
+                                                            ClockService::clock_type horizon)
+    : granularity_ (std::max(ClockService::in_nanoseconds(granularity), std::int64_t(1))),
+      current_ (0), mask_ (0), free_ (None), size_ (0), wheelSize_ (0)
+{
+    this->horizon(horizon);
+}
+
+prefix_ void senf::ppi::module::detail::TimingWheel::horizon(ClockService::clock_type horizon)
+{
+    std::int64_t ticks (ClockService::in_nanoseconds(horizon) / granularity_ + 2);
+    unsigned slots (64);
+    while (slots < ticks && slots < (1u << 22))
+        slots <<= 1;
+    if (slots == head_.size())
+        return;
+
+    std::vector< std::pair<std::int64_t, Packet> > packets;
+    packets.reserve(wheelSize_);
+    for (unsigned offset (0); packets.size() < wheelSize_; ++offset) {
+        unsigned slot ((current_ + offset) & mask_);
+        for (unsigned n (head_[slot]); n != None; n = nodes_[n].next)
+            packets.push_back(std::make_pair(current_ + offset, nodes_[n].packet));
+    }
+
+    head_.assign(slots, None);
+    tail_.assign(slots, None);
+    bitmap_.assign(slots / 64, 0u);
+    mask_ = slots - 1;
+    std::vector<Node>().swap(nodes_);
+    free_ = None;
+    size_ -= wheelSize_;
+    wheelSize_ = 0;
+    for (std::vector< std::pair<std::int64_t, Packet> >::const_iterator i (packets.begin());
+         i != packets.end(); ++i)
+        link(i->first, i->second);
+    migrate(0);
+}
+
+prefix_ senf::ClockService::clock_type
+senf::ppi::module::detail::TimingWheel::insert(Packet const & packet,
+                                               ClockService::clock_type release,
+                                               ClockService::clock_type now)
+{
+    if (wheelSize_ == 0) {
+        // all earlier ticks are past, don't scan them on the next expire()
+        std::int64_t nowTick (ClockService::in_nanoseconds(now) / granularity_);
+        if (current_ < nowTick) {
+            current_ = nowTick;
+            migrate(0);
+        }
+    }
+    std::int64_t t (std::max(tick(release), current_));
+    link(t, packet);
+    return ClockService::nanoseconds(t * granularity_);
+}
+
+prefix_ senf::ClockService::clock_type senf::ppi::module::detail::TimingWheel::next()
+    const
+{
+    if (wheelSize_ > 0)
+        return ClockService::nanoseconds(nextTick() * granularity_);
+    if (! overflow_.empty())
+        return ClockService::nanoseconds(overflow_.begin()->first * granularity_);
+    return ClockService::clock_type(0);
+}
+
+prefix_ void senf::ppi::module::detail::TimingWheel::expire(ClockService::clock_type now,
+                                                            PacketBurst & burst)
+{
+    std::int64_t nowTick (ClockService::in_nanoseconds(now) / granularity_);
+    for (;;) {
+        std::int64_t t (nextTick());
+        if (t < 0 || t > nowTick)
+            break;
+        drain(t & mask_, burst);
+        current_ = t + 1;
+        migrate(&burst);
+    }
+    if (current_ <= nowTick)
+        current_ = nowTick + 1;
+    migrate(&burst);
+}
+
+prefix_ void senf::ppi::module::detail::TimingWheel::link(std::int64_t tick, Packet const & packet)
+{
+    ++ size_;
+    if (tick >= current_ + std::int64_t(head_.size())) {
+        overflow_.insert(std::make_pair(tick, packet));
+        return;
+    }
+    unsigned n;
+    if (free_ != None) {
+        n = free_;
+        free_ = nodes_[n].next;
+        nodes_[n].packet = packet;
+    } else {
+        n = nodes_.size();
+        nodes_.push_back(Node { packet, None });
+    }
+    nodes_[n].next = None;
+    unsigned slot (tick & mask_);
+    if (head_[slot] == None) {
+        head_[slot] = n;
+        bitmap_[slot / 64] |= std::uint64_t(1) << (slot % 64);
+    } else
+        nodes_[tail_[slot]].next = n;
+    tail_[slot] = n;
+    ++ wheelSize_;
+}
+
+prefix_ void senf::ppi::module::detail::TimingWheel::migrate(PacketBurst * burst)
+{
+    while (! overflow_.empty()
+           && overflow_.begin()->first < current_ + std::int64_t(head_.size())) {
+        Overflow::iterator i (overflow_.begin());
+        -- size_;
+        if (burst && i->first < current_)
+            burst->push_back(i->second);
+        else
+            link(std::max(i->first, current_), i->second);
+        overflow_.erase(i);
+    }
+}
+
+prefix_ void senf::ppi::module::detail::TimingWheel::drain(unsigned slot, PacketBurst & burst)
+{
+    unsigned n (head_[slot]);
+    while (n != None) {
+        Node & node (nodes_[n]);
+        burst.push_back(node.packet);
+        node.packet = Packet();
+        unsigned next (node.next);
+        node.next = free_;
+        free_ = n;
+        n = next;
+        -- size_;
+        -- wheelSize_;
+    }
+    head_[slot] = tail_[slot] = None;
+    bitmap_[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+}
+
+prefix_ std::int64_t senf::ppi::module::detail::TimingWheel::nextTick()
+    const
+{
+    if (wheelSize_ == 0)
+        return -1;
+    unsigned pos (current_ & mask_);
+    unsigned word (pos / 64);
+    std::uint64_t bits (bitmap_[word] & (~std::uint64_t(0) << (pos % 64)));
+    // The last iteration re-visits the first word to find the slots before pos
+    for (unsigned n (0); n <= bitmap_.size(); ++n) {
+        if (bits) {
+            unsigned slot (word * 64 + __builtin_ctzll(bits));
+            return current_ + ((slot - pos) & mask_);
+        }
+        word = (word + 1) & (bitmap_.size() - 1);
+        bits = bitmap_[word];
+    }
+    return -1;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::DelayLine
+
+prefix_ senf::ppi::module::DelayLine::DelayLine(ClockService::clock_type delay,
+                                                ClockService::clock_type jitter,
+                                                ClockService::clock_type granularity)
+    : wheel_ (granularity, delay + 4 * jitter),
+      timer_ ("senf::ppi::module::DelayLine", membind(&DelayLine::timeout, this)),
+      delay_ (delay), jitter_ (jitter), lastRelease_ (0), distribution_ (UNIFORM),
+      correlation_ (0.0), reordering_ (false), limit_ (16u << 20), dropped_ (0u),
+      droppedRead_ (0u), random_ (std::random_device()()), uniformDist_ (0.0, 1.0),
+      normalDist_ (0.0, 1.0), lastUniform_ (0.0), lastNormal_ (0.0)
+{
+    route(input, output).autoThrottling(false);
+    input.onRequest(&DelayLine::onRequest);
+    input.throttlingDisc(ThrottlingDiscipline::NONE);
+
+    namespace fty = console::factory;
+    namespace kw = console::kw;
+    dir.add("delay", fty::Command(
+                SENF_MEMBINDFNP(ClockService::clock_type, DelayLine, delay, () const))
+            .formatter(senf::formatClockServiceInterval)
+            .doc("Get mean packet delay.") );
+    dir.add("delay", fty::Command(
+                SENF_MEMBINDFNP(void, DelayLine, delay, (ClockService::clock_type)))
+            .arg("delay", "mean packet delay", kw::parser = senf::parseClockServiceInterval)
+            .doc("Set mean packet delay.") );
+    dir.add("jitter", fty::Command(
+                SENF_MEMBINDFNP(ClockService::clock_type, DelayLine, jitter, () const))
+            .formatter(senf::formatClockServiceInterval)
+            .doc("Get delay variation.") );
+    dir.add("jitter", fty::Command(
+                SENF_MEMBINDFNP(void, DelayLine, jitter, (ClockService::clock_type)))
+            .arg("jitter", "delay variation", kw::parser = senf::parseClockServiceInterval)
+            .doc("Set delay variation.") );
+    dir.add("distribution", fty::Command(
+                SENF_MEMBINDFNP(Distribution, DelayLine, distribution, () const))
+            .doc("Get delay distribution.") );
+    dir.add("distribution", fty::Command(
+                SENF_MEMBINDFNP(void, DelayLine, distribution, (Distribution)))
+            .arg("distribution", "UNIFORM, NORMAL, PARETO or PARETONORMAL")
+            .doc("Set delay distribution.") );
+    dir.add("correlation", fty::Command(
+                SENF_MEMBINDFNP(double, DelayLine, correlation, () const))
+            .doc("Get correlation of successive delays.") );
+    dir.add("correlation", fty::Command(
+                SENF_MEMBINDFNP(void, DelayLine, correlation, (double)))
+            .arg("correlation", "0 (independent) to 1 (identical)")
+            .doc("Set correlation of successive delays.") );
+    dir.add("reordering", fty::Variable(reordering_)
+            .doc("Release packets strictly by release time, allowing jitter to reorder packets.") );
+    dir.add("limit", fty::Variable(limit_)
+            .doc("Maximum number of packets held.") );
+    dir.add("size", fty::Command(&DelayLine::size, this)
+            .doc("Number of packets held.") );
+    dir.add("dropped", fty::Command(&DelayLine::dropped, this)
+            .doc("Get and reset number of packets dropped due to the limit.") );
+    dir.add("granularity", fty::Command(&DelayLine::granularity, this)
+            .formatter(senf::formatClockServiceInterval)
+            .doc("Timing wheel slot interval.") );
+    dir.add("seed", fty::Command(&DelayLine::seed, this)
+            .arg("seed", "random seed")
+            .doc("Re-seed random number generator.") );
+}
+
+prefix_ void senf::ppi::module::DelayLine::delay(ClockService::clock_type delay)
+{
+    delay_ = delay;
+    resize();
+}
+
+prefix_ void senf::ppi::module::DelayLine::jitter(ClockService::clock_type jitter)
+{
+    jitter_ = jitter;
+    resize();
+}
+
+prefix_ void senf::ppi::module::DelayLine::correlation(double c)
+{
+    correlation_ = std::min(std::max(c, 0.0), 1.0);
+}
+
+prefix_ void senf::ppi::module::DelayLine::seed(std::uint32_t seed)
+{
+    random_.seed(seed);
+    normalDist_.reset();
+}
+
+prefix_ void senf::ppi::module::DelayLine::exportMetrics(std::string const & name,
+                                                        metrics::Labels const & labels)
+{
+    metrics_.clear();
+    metrics_.push_back(metrics::Registry::instance().gauge(
+                           name + "_packets", "Number of packets held in the delay line",
+                           [this]() { return double(wheel_.size()); }, labels));
+    metrics_.push_back(metrics::Registry::instance().counter(
+                           name + "_dropped", "Number of packets dropped due to the limit",
+                           [this]() { return double(dropped_); }, labels));
+}
+
+prefix_ void senf::ppi::module::DelayLine::resize()
+{
+    wheel_.horizon(delay_ + 4 * jitter_);
+}
+
+prefix_ void senf::ppi::module::DelayLine::onRequest()
+{
+    Packet const & packet (input());
+    if (wheel_.size() >= limit_) {
+        ++ dropped_;
+        return;
+    }
+    ClockService::clock_type now (ClockService::now());
+    ClockService::clock_type release (now + sample());
+    if (! reordering_) {
+        release = std::max(release, lastRelease_);
+        lastRelease_ = release;
+    }
+    arm(wheel_.insert(packet, release, now));
+}
+
+prefix_ void senf::ppi::module::DelayLine::arm(ClockService::clock_type release)
+{
+    if (! timer_.enabled() || release < timer_.timeout())
+        timer_.timeout(release);
+}
+
+prefix_ void senf::ppi::module::DelayLine::timeout()
+{
+    wheel_.expire(ClockService::now(), burst_);
+    if (! burst_.empty()) {
+        output.write(burst_);
+        burst_.clear();
+    }
+    if (! wheel_.empty())
+        arm(wheel_.next());
+}
+
+prefix_ senf::ClockService::clock_type senf::ppi::module::DelayLine::sample()
+{
+    if (jitter_ == ClockService::clock_type(0))
+        return delay_;
+    double x (0.0);
+    switch (distribution_) {
+    case UNIFORM:
+        x = 2.0 * uniform() - 1.0;
+        break;
+    case NORMAL:
+        x = normal();
+        break;
+    case PARETO:
+        x = pareto();
+        break;
+    case PARETONORMAL:
+        // same mixture as netem's paretonormal table
+        x = 0.25 * normal() + 0.75 * pareto();
+        break;
+    }
+    std::int64_t d (ClockService::in_nanoseconds(delay_)
+                    + std::int64_t(x * ClockService::in_nanoseconds(jitter_)));
+    return ClockService::nanoseconds(std::max(d, std::int64_t(0)));
+}
+
+prefix_ double senf::ppi::module::DelayLine::uniform()
+{
+    // correlated like netem's get_crandom()
+    double u (uniformDist_(random_));
+    if (correlation_ > 0.0)
+        u = (1.0 - correlation_) * u + correlation_ * lastUniform_;
+    lastUniform_ = u;
+    return u;
+}
+
+prefix_ double senf::ppi::module::DelayLine::normal()
+{
+    // first order autoregressive process, keeps the marginal distribution standard normal
+    double z (normalDist_(random_));
+    if (correlation_ > 0.0)
+        z = correlation_ * lastNormal_ + std::sqrt(1.0 - correlation_ * correlation_) * z;
+    lastNormal_ = z;
+    return z;
+}
+
+prefix_ double senf::ppi::module::DelayLine::pareto()
+{
+    // inverse transform of a pareto distribution with shape 3 and scale 1 (mean 1.5,
+    // variance 0.75), normalized to mean 0 and standard deviation 1
+    return (std::pow(1.0 - uniform(), -1.0 / 3.0) - 1.5) / std::sqrt(0.75);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "DelayLine.mpp"
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
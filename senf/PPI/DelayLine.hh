@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief DelayLine public header */
+
+#ifndef HH_SENF_PPI_DelayLine_
+#define HH_SENF_PPI_DelayLine_ 1
+
+// Custom includes
+#include <random>
+#include <senf/Scheduler/TimerEvent.hh>
+#include <senf/Utils/Console/ScopedDirectory.hh>
+#include <senf/Utils/Metrics.hh>
+#include "Module.hh"
+#include "Connectors.hh"
+
+#include "DelayLine.ih"
+//#include "DelayLine.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+namespace module {
+
+    /** \brief Delay packets by a random per-packet delay
+
+        The DelayLine holds every packet until its individual release time. The release time is
+        computed as <tt>delay() + jitter() * X</tt> where \c X is drawn from the selected
+        distribution():
+
+        \li \c UNIFORM: uniformly distributed in [-1, 1)
+        \li \c NORMAL: standard normal distribution
+        \li \c PARETO: pareto distribution (shape 3), normalized to mean 0 and standard deviation 1
+        \li \c PARETONORMAL: sum of 25% of a normal and 75% of a pareto value (as netem)
+
+        Successive values of \c X are correlated according to correlation() as in the Linux netem
+        queueing discipline. Negative delays are clamped to 0.
+
+        By default packets leave the DelayLine in the order they arrived, a packet is never released
+        before its predecessor. If reordering() is enabled, packets are released strictly by release
+        time and jitter will reorder packets.
+
+        Packets are stored in a timing wheel with a slot for every granularity() interval, so
+        inserting and releasing a packet takes constant time independent of the number of packets
+        in flight. The wheel is sized to hold <tt>delay() + 4 * jitter()</tt>, packets with larger
+        delays (e.g. from the tail of the pareto distribution) are kept in an overflow tree. All
+        packets due within one slot are released as a single \ref ppi_connectors_burst "burst" from
+        a single timer.
+
+        At most limit() packets are held, further packets are dropped and counted in dropped().
+
+        exportMetrics() registers the number of packets held and the number of packets dropped with
+        the senf::metrics::Registry.
+
+        \ingroup routing_modules
+     */
+    class DelayLine
+        : public Module
+    {
+        SENF_PPI_MODULE(DelayLine);
+
+    public:
+        enum Distribution { UNIFORM, NORMAL, PARETO, PARETONORMAL };
+
+        console::ScopedDirectory<> dir;
+        connector::PassiveInput<> input;
+        connector::ActiveOutput<> output;
+
+        explicit DelayLine(ClockService::clock_type delay = ClockService::clock_type(0),
+                           ClockService::clock_type jitter = ClockService::clock_type(0),
+                           ClockService::clock_type granularity = ClockService::microseconds(100));
+
+        ClockService::clock_type delay() const; ///< Mean packet delay
+        void delay(ClockService::clock_type delay); ///< Set mean packet delay
+        ClockService::clock_type jitter() const; ///< Delay variation
+        void jitter(ClockService::clock_type jitter); ///< Set delay variation
+        Distribution distribution() const; ///< Delay distribution
+        void distribution(Distribution distribution); ///< Set delay distribution
+        double correlation() const;     ///< Correlation of successive delays
+        void correlation(double c);     ///< Set correlation of successive delays
+                                        /**< \param[in] c correlation between 0 (independent)
+                                                 and 1 (all delays identical) */
+        bool reordering() const;        ///< \c true, if packets may be reordered
+        void reordering(bool r);        ///< Enable/disable reordering
+        unsigned limit() const;         ///< Maximum number of packets held
+        void limit(unsigned packets);   ///< Set maximum number of packets held
+        void seed(std::uint32_t seed);  ///< Re-seed random number generator
+
+        ClockService::clock_type granularity() const; ///< Timing wheel slot interval
+        unsigned size() const;          ///< Number of packets held
+        unsigned dropped();             ///< Number of packets dropped since the last call
+
+        void exportMetrics(std::string const & name,
+                           metrics::Labels const & labels = metrics::Labels());
+                                        ///< Register metrics
+                                        /**< Registers the gauge <em>name</em>\c _packets
+                                             (size()) and the counter <em>name</em>\c _dropped
+                                             with the senf::metrics::Registry. The metrics are
+                                             removed when the module is destroyed. */
+
+    private:
+        void onRequest();
+        void timeout();
+        void arm(ClockService::clock_type release);
+        void resize();
+        ClockService::clock_type sample();
+        double uniform();
+        double normal();
+        double pareto();
+
+        detail::TimingWheel wheel_;
+        scheduler::TimerEvent timer_;
+        PacketBurst burst_;
+        ClockService::clock_type delay_;
+        ClockService::clock_type jitter_;
+        ClockService::clock_type lastRelease_;
+        Distribution distribution_;
+        double correlation_;
+        bool reordering_;
+        unsigned limit_;
+        std::uint64_t dropped_;
+        std::uint64_t droppedRead_;
+
+        std::mt19937 random_;
+        std::uniform_real_distribution<double> uniformDist_;
+        std::normal_distribution<double> normalDist_;
+        double lastUniform_;
+        double lastNormal_;
+        std::vector<metrics::Registration> metrics_;
+    };
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "DelayLine.cci"
+//#include "DelayLine.ct"
+//#include "DelayLine.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,191 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief DelayLine unit tests */
+
+#include "DelayLine.hh"
+
+// Custom includes
+#include <sstream>
+#include <senf/Scheduler/Scheduler.hh>
+#include "DebugModules.hh"
+#include "Setup.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ppi = senf::ppi;
+namespace module = ppi::module;
+namespace debug = module::debug;
+
+namespace {
+
+    void runPPI(senf::ClockService::clock_type t)
+    {
+        senf::scheduler::TimerEvent timeout(
+                "delayLine test timer", &senf::scheduler::terminate, senf::scheduler::now() + t);
+        senf::ppi::run();
+    }
+
+    senf::ClockService::clock_type ms(unsigned v)
+    {
+        return senf::ClockService::milliseconds(v);
+    }
+
+    senf::Packet packet(unsigned seq)
+    {
+        senf::DataPacket p (senf::DataPacket::create(2u));
+        p.data()[0] = seq >> 8;
+        p.data()[1] = seq & 0xff;
+        return p;
+    }
+
+    unsigned seq(senf::Packet const & p)
+    {
+        return (p.data()[0] << 8) | p.data()[1];
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(timingWheel)
+{
+    module::detail::TimingWheel wheel (ms(1), ms(10));
+    ppi::PacketBurst burst;
+    senf::ClockService::clock_type t0 (senf::ClockService::seconds(1000));
+
+    BOOST_CHECK( wheel.empty() );
+    BOOST_CHECK_EQUAL( wheel.next(), senf::ClockService::clock_type(0) );
+
+    // 64 slots of 1ms, so the third packet goes to the overflow map
+    BOOST_CHECK_EQUAL( wheel.insert(packet(1), t0 + ms(5), t0), t0 + ms(5) );
+    BOOST_CHECK_EQUAL( wheel.insert(packet(2), t0 + ms(2), t0), t0 + ms(2) );
+    BOOST_CHECK_EQUAL( wheel.insert(packet(3), t0 + ms(200), t0), t0 + ms(200) );
+    BOOST_CHECK_EQUAL( wheel.insert(packet(4), t0 + senf::ClockService::microseconds(1500), t0),
+                       t0 + ms(2) );
+    BOOST_CHECK_EQUAL( wheel.size(), 4u );
+    BOOST_CHECK_EQUAL( wheel.next(), t0 + ms(2) );
+
+    wheel.expire(t0 + ms(1), burst);
+    BOOST_CHECK( burst.empty() );
+    wheel.expire(t0 + ms(3), burst);
+    BOOST_REQUIRE_EQUAL( burst.size(), 2u );
+    BOOST_CHECK_EQUAL( seq(burst[0]), 2u );
+    BOOST_CHECK_EQUAL( seq(burst[1]), 4u );
+    burst.clear();
+    BOOST_CHECK_EQUAL( wheel.next(), t0 + ms(5) );
+
+    wheel.expire(t0 + ms(150), burst);
+    BOOST_REQUIRE_EQUAL( burst.size(), 1u );
+    BOOST_CHECK_EQUAL( seq(burst[0]), 1u );
+    burst.clear();
+    BOOST_CHECK_EQUAL( wheel.size(), 1u );
+    BOOST_CHECK_EQUAL( wheel.next(), t0 + ms(200) );
+
+    // packets already late are released with the next slot
+    BOOST_CHECK_EQUAL( wheel.insert(packet(5), t0 + ms(100), t0 + ms(150)), t0 + ms(151) );
+    wheel.horizon(senf::ClockService::seconds(1));
+    BOOST_CHECK_EQUAL( wheel.size(), 2u );
+    wheel.expire(t0 + ms(300), burst);
+    BOOST_REQUIRE_EQUAL( burst.size(), 2u );
+    BOOST_CHECK_EQUAL( seq(burst[0]), 5u );
+    BOOST_CHECK_EQUAL( seq(burst[1]), 3u );
+    BOOST_CHECK( wheel.empty() );
+}
+
+SENF_AUTO_TEST_CASE(delayLine)
+{
+    module::DelayLine delayLine (ms(20));
+    debug::ActiveSource source;
+    debug::PassiveSink sink;
+
+    ppi::connect(source, delayLine);
+    ppi::connect(delayLine, sink);
+    ppi::init();
+
+    for (unsigned i (0); i < 10; ++i)
+        source.submit(packet(i));
+    BOOST_CHECK_EQUAL( delayLine.size(), 10u );
+    BOOST_CHECK_EQUAL( sink.size(), 0u );
+
+    runPPI(ms(50));
+    BOOST_REQUIRE_EQUAL( sink.size(), 10u );
+    for (unsigned i (0); i < 10; ++i)
+        BOOST_CHECK_EQUAL( seq(sink.pop_front()), i );
+
+    delayLine.limit(5);
+    for (unsigned i (0); i < 10; ++i)
+        source.submit(packet(i));
+    BOOST_CHECK_EQUAL( delayLine.size(), 5u );
+    BOOST_CHECK_EQUAL( delayLine.dropped(), 5u );
+    BOOST_CHECK_EQUAL( delayLine.dropped(), 0u );
+
+    // The metrics counter is not reset by dropped()
+    delayLine.exportMetrics("test_delayline");
+    std::stringstream ss;
+    senf::metrics::Registry::instance().write(ss);
+    BOOST_CHECK( ss.str().find("test_delayline_packets 5\n") != std::string::npos );
+    BOOST_CHECK( ss.str().find("test_delayline_dropped_total 5\n") != std::string::npos );
+}
+
+SENF_AUTO_TEST_CASE(delayLine_jitter)
+{
+    module::DelayLine delayLine (ms(10), ms(5));
+    debug::ActiveSource source;
+    debug::PassiveSink sink;
+
+    ppi::connect(source, delayLine);
+    ppi::connect(delayLine, sink);
+    ppi::init();
+
+    delayLine.seed(1);
+    delayLine.distribution(module::DelayLine::NORMAL);
+    delayLine.correlation(0.25);
+    for (unsigned i (0); i < 100; ++i)
+        source.submit(packet(i));
+    runPPI(ms(60));
+    BOOST_REQUIRE_EQUAL( sink.size(), 100u );
+    unsigned reordered (0);
+    for (unsigned i (0); i < 100; ++i)
+        if (seq(sink.pop_front()) != i)
+            ++ reordered;
+    BOOST_CHECK_EQUAL( reordered, 0u );
+
+    delayLine.reordering(true);
+    delayLine.distribution(module::DelayLine::UNIFORM);
+    for (unsigned i (0); i < 100; ++i)
+        source.submit(packet(i));
+    runPPI(ms(30));
+    BOOST_REQUIRE_EQUAL( sink.size(), 100u );
+    for (unsigned i (0); i < 100; ++i)
+        if (seq(sink.pop_front()) != i)
+            ++ reordered;
+    BOOST_CHECK( reordered > 0u );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -26,13 +26,11 @@
 prefix_ senf::ppi::module::DiscardSink::DiscardSink()
 {
     noroute(input);
-    input.onRequest(&DiscardSink::request);
+    input.onRequestBurst(&DiscardSink::request);
 }
 
-prefix_ void senf::ppi::module::DiscardSink::request()
-{
-    senf::IGNORE( input() );
-}
+prefix_ void senf::ppi::module::DiscardSink::request(PacketBurst & burst)
+{}
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
@@ -44,7 +44,7 @@ namespace module {
         DiscardSink();
 
     private:
-        void request();
+        void request(PacketBurst & burst);
     };
 
 
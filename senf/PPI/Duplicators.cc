@@ -18,12 +18,14 @@
 //#include "Duplicators.ih"
 
 // Custom includes
+#include <boost/next_prior.hpp>
 
 //#include "Duplicators.mpp"
 #define prefix_
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 
 prefix_ senf::ppi::module::ActiveDuplicator::ActiveDuplicator()
+    : copyOnWrite_ (false)
 {
     noroute(input);
     input.onRequest(&ActiveDuplicator::request);
@@ -39,8 +41,28 @@ prefix_ void senf::ppi::module::ActiveDuplicator::request()
     Packet p (input());
     ContainerType::iterator i (connectors().begin());
     ContainerType::iterator const i_end (connectors().end());
-    for (; i != i_end; ++i)
+    if (copyOnWrite_) {
+        if (i == i_end)
+            return;
+        // The last output gets the original packet
+        for (ContainerType::iterator i_last (boost::prior(i_end)); i != i_last; ++i)
+            (*i)(p.cowClone());
         (*i)(p);
+    }
+    else
+        for (; i != i_end; ++i)
+            (*i)(p);
+}
+
+prefix_ void senf::ppi::module::ActiveDuplicator::copyOnWrite(bool flag)
+{
+    copyOnWrite_ = flag;
+}
+
+prefix_ bool senf::ppi::module::ActiveDuplicator::copyOnWrite()
+    const
+{
+    return copyOnWrite_;
 }
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -33,6 +33,11 @@ namespace module {
 
         ActiveDuplicator will take every received packet and push it out to each connected output.
 
+        By default, every output receives the very same packet, so a module modifying the packet
+        changes the packet seen by all following outputs. With copyOnWrite() enabled, every output
+        but the last receives a Packet::cowClone() instead: the packet data is only copied for
+        outputs which actually modify (or parse) the packet.
+
         \ingroup routing_modules
      */
     class ActiveDuplicator
@@ -45,10 +50,15 @@ namespace module {
 
         ActiveDuplicator();
 
+        void copyOnWrite(bool flag);    ///< Pass copy-on-write clones to the outputs
+        bool copyOnWrite() const;       ///< \c true, if outputs receive copy-on-write clones
+
     private:
         void connectorSetup(ActiveDuplicator::ConnectorType & conn);
         void request();
 
+        bool copyOnWrite_;
+
         friend class MultiConnectorMixin<ActiveDuplicator, connector::ActiveOutput<> >;
     };
 
@@ -51,6 +51,16 @@ SENF_AUTO_TEST_CASE(activeDuplicator)
     BOOST_CHECK_EQUAL( sink2.size(), 1u );
     BOOST_CHECK( sink1.pop_front() == p );
     BOOST_CHECK( sink2.pop_front() == p );
+
+    duplicator.copyOnWrite(true);
+    BOOST_CHECK( duplicator.copyOnWrite() );
+    source.submit(p);
+    BOOST_CHECK_EQUAL( sink1.size(), 1u );
+    BOOST_CHECK_EQUAL( sink2.size(), 1u );
+    senf::Packet p1 (sink1.pop_front());
+    BOOST_CHECK( p1 != p );
+    BOOST_CHECK( sink2.pop_front() == p );
+    BOOST_CHECK_EQUAL( p1.size(), p.size() );
 }
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
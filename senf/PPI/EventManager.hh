@@ -21,6 +21,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <senf/Scheduler/ClockService.hh>
+#include <senf/Utils/thread_singleton.hh>
 #include "predecl.hh"
 #include "detail/Callback.hh"
 #include "detail/EventBinding.hh"
@@ -36,9 +37,11 @@ namespace ppi {
         The EventManager control event registration and manages global event parameters. The
         EventManager controls event dispatch but does \e not control event generation. This is the
         responsibility of an external component (the Scheduler)
+
+        Like the ModuleManager, every thread has it's own EventManager.
       */
     class EventManager
-        : boost::noncopyable
+        : public thread_singleton<EventManager>
     {
     public:
         //-////////////////////////////////////////////////////////////////////////
@@ -56,8 +59,8 @@ namespace ppi {
         ///\name Structors and default members
         //\{
 
-        static EventManager & instance();
-        static bool alive();
+        using thread_singleton<EventManager>::instance;
+        using thread_singleton<EventManager>::alive;
 
         // default default constructor
         // default copy constructor
@@ -93,8 +96,7 @@ namespace ppi {
 
         ClockService::clock_type eventTime_;
 
-        static bool alive_;
-
+        friend class thread_singleton<EventManager>;
         friend class detail::EventBindingBase;
         friend class module::Module;
         friend class EventDescriptor;
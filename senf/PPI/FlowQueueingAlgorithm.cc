@@ -0,0 +1,476 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief FlowQueueingAlgorithm non-inline non-template implementation */
+
+#include "FlowQueueingAlgorithm.hh"
+#include "FlowQueueingAlgorithm.ih"
+
+// Custom includes
+#include <cmath>
+#include <senf/Packets/DefaultBundle/IPv4Packet.hh>
+#include <senf/Packets/DefaultBundle/IPv6Packet.hh>
+#include <senf/Utils/Exception.hh>
+#include <senf/Utils/Console/ParsedCommand.hh>
+#include <senf/Utils/Console/Variables.hh>
+
+//#include "FlowQueueingAlgorithm.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    unsigned const NoFlow (unsigned(-1));
+
+    // MurmurHash3 mixing steps
+    inline std::uint32_t mix(std::uint32_t h, std::uint32_t k)
+    {
+        k *= 0xcc9e2d51u;
+        k = (k << 15) | (k >> 17);
+        k *= 0x1b873593u;
+        h ^= k;
+        h = (h << 13) | (h >> 19);
+        return h * 5 + 0xe6546b64u;
+    }
+
+    inline std::uint32_t finalize(std::uint32_t h)
+    {
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    inline std::uint32_t get16(unsigned char const * p)
+    {
+        return (std::uint32_t(p[0]) << 8) | p[1];
+    }
+
+    inline std::uint32_t get32(unsigned char const * p)
+    {
+        return (get16(p) << 16) | get16(p + 2);
+    }
+
+    inline bool hasPorts(unsigned protocol)
+    {
+        // TCP, UDP, DCCP, SCTP and UDP-Lite all start with source and destination port
+        return protocol == 6 || protocol == 17 || protocol == 33 || protocol == 132
+            || protocol == 136;
+    }
+
+    std::uint32_t hashIPv4(unsigned char const * p, unsigned size, std::uint32_t h)
+    {
+        if (size < 20 || (p[0] >> 4) != 4)
+            return h;
+        unsigned headerLength ((p[0] & 0x0f) * 4);
+        h = mix(h, get32(p + 12));
+        h = mix(h, get32(p + 16));
+        h = mix(h, p[9]);
+        // Only the first fragment contains the ports, so don't use them for any fragment
+        if ((get16(p + 6) & 0x3fff) == 0 && hasPorts(p[9]) && size >= headerLength + 4)
+            h = mix(h, get32(p + headerLength));
+        return h;
+    }
+
+    std::uint32_t hashIPv6(unsigned char const * p, unsigned size, std::uint32_t h)
+    {
+        if (size < 40 || (p[0] >> 4) != 6)
+            return h;
+        for (unsigned i (8); i < 40; i += 4)
+            h = mix(h, get32(p + i));
+        h = mix(h, p[6]);
+        if (hasPorts(p[6]) && size >= 44)
+            h = mix(h, get32(p + 40));
+        return h;
+    }
+
+    std::uint32_t hashEthernet(unsigned char const * p, unsigned size, std::uint32_t h)
+    {
+        if (size < 14)
+            return h;
+        unsigned offset (12);
+        unsigned type (get16(p + offset));
+        while ((type == 0x8100 || type == 0x88a8) && size >= offset + 6) {
+            h = mix(h, get16(p + offset + 2) & 0x0fff);
+            offset += 4;
+            type = get16(p + offset);
+        }
+        offset += 2;
+        if (type == 0x0800)
+            return hashIPv4(p + offset, size - offset, h);
+        if (type == 0x86dd)
+            return hashIPv6(p + offset, size - offset, h);
+        h = mix(h, get32(p));
+        h = mix(h, get32(p + 4));
+        h = mix(h, get32(p + 8));
+        return mix(h, type);
+    }
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::detail::FlowRing
+
+prefix_ void senf::ppi::detail::FlowRing::grow()
+{
+    std::vector<Entry> entries (entries_.empty() ? 8 : 2 * entries_.size());
+    for (unsigned i (0); i < size_; ++i)
+        std::swap(entries[i], entries_[(head_ + i) & (entries_.size() - 1)]);
+    entries_.swap(entries);
+    head_ = 0;
+}
+
+prefix_ void senf::ppi::detail::FlowRing::clear()
+{
+    std::vector<Entry>().swap(entries_);
+    head_ = size_ = 0;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::FlowQueueingAlgorithm
+
+prefix_ std::uint32_t senf::ppi::FlowQueueingAlgorithm::flowHash(Packet const & packet,
+                                                                  std::uint32_t perturbation)
+{
+    PacketData & data (packet.data());
+    if (data.size() == 0)
+        return finalize(perturbation);
+    unsigned char const * p (&*data.begin());
+    if (packet.is<IPv4Packet>())
+        return finalize(hashIPv4(p, data.size(), perturbation));
+    if (packet.is<IPv6Packet>())
+        return finalize(hashIPv6(p, data.size(), perturbation));
+    return finalize(hashEthernet(p, data.size(), perturbation));
+}
+
+prefix_ senf::ppi::FlowQueueingAlgorithm::FlowQueueingAlgorithm(unsigned flows, unsigned quantum,
+                                                                unsigned limit, unsigned flowLimit)
+    : current_ (NoFlow), size_ (0), quantum_ (0), limit_ (limit), flowLimit_ (flowLimit),
+      dropped_ (0),
+      perturbation_ (finalize(
+                         std::uint32_t(ClockService::in_nanoseconds(ClockService::now()))
+                         ^ std::uint32_t(reinterpret_cast<std::uintptr_t>(this))))
+{
+    newFlows_.head = newFlows_.tail = oldFlows_.head = oldFlows_.tail = NoFlow;
+    this->flows(flows);
+    this->quantum(quantum);
+
+    namespace fty = console::factory;
+    consoleDir()
+        .add("flows", fty::Command(
+                 SENF_MEMBINDFNP(unsigned, FlowQueueingAlgorithm, flows, () const))
+             .doc("Get number of flow queues.") );
+    consoleDir()
+        .add("flows", fty::Command(
+                 SENF_MEMBINDFNP(void, FlowQueueingAlgorithm, flows, (unsigned)))
+             .arg("n", "number of flow queues, rounded up to a power of 2")
+             .doc("Set number of flow queues. All queued packets are dropped.") );
+    consoleDir()
+        .add("quantum", fty::Command(
+                 SENF_MEMBINDFNP(unsigned, FlowQueueingAlgorithm, quantum, () const))
+             .doc("Get number of bytes each flow may send per round.") );
+    consoleDir()
+        .add("quantum", fty::Command(
+                 SENF_MEMBINDFNP(void, FlowQueueingAlgorithm, quantum, (unsigned)))
+             .arg("bytes", "number of bytes, must not be 0")
+             .doc("Set number of bytes each flow may send per round.") );
+    consoleDir()
+        .add("limit", fty::Variable(limit_)
+             .doc("Maximum number of queued packets.") );
+    consoleDir()
+        .add("flow-limit", fty::Variable(flowLimit_)
+             .doc("Maximum number of queued packets per flow.") );
+    consoleDir()
+        .add("dropped", fty::Command(&FlowQueueingAlgorithm::dropped, this)
+             .doc("Get and reset number of rejected packets.") );
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::quantum(unsigned bytes)
+{
+    // With a quantum of 0, no flow would ever gain any deficit and select() would loop forever
+    if (bytes == 0)
+        throw InvalidArgumentException("flow queueing quantum must not be 0");
+    quantum_ = bytes;
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::flows(unsigned n)
+{
+    unsigned flows (1);
+    while (flows < n)
+        flows <<= 1;
+    v_clear();
+    std::vector<Flow>(flows).swap(flows_);
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::perturbation(std::uint32_t p)
+{
+    v_clear();
+    perturbation_ = p;
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::dropHead(Flow & flow)
+{
+    flow.bytes -= flow.ring.front().packet.size();
+    flow.ring.pop();
+    -- size_;
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::append(FlowList & list, unsigned index)
+{
+    flows_[index].next = NoFlow;
+    if (list.head == NoFlow)
+        list.head = index;
+    else
+        flows_[list.tail].next = index;
+    list.tail = index;
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::removeHead(FlowList & list)
+{
+    list.head = flows_[list.head].next;
+    if (list.head == NoFlow)
+        list.tail = NoFlow;
+}
+
+// The QueueingAlgorithm interface separates looking at the next packet (peek(), front()) from
+// removing it (pop()). Therefore the flow to be served next is selected lazily and kept in
+// current_ until the packet is popped.
+prefix_ senf::ppi::FlowQueueingAlgorithm::Flow * senf::ppi::FlowQueueingAlgorithm::select()
+{
+    if (current_ != NoFlow)
+        return &flows_[current_];
+    if (size_ == 0)
+        return 0;
+    ClockService::clock_type now (ClockService::now());
+    for (;;) {
+        bool isNew (newFlows_.head != NoFlow);
+        FlowList & list (isNew ? newFlows_ : oldFlows_);
+        if (list.head == NoFlow)
+            return 0;
+        unsigned index (list.head);
+        Flow & flow (flows_[index]);
+        if (flow.deficit <= 0) {
+            flow.deficit += quantum_;
+            removeHead(list);
+            append(oldFlows_, index);
+            flow.list = Flow::Old;
+            continue;
+        }
+        if (! flow.ring.empty())
+            v_select(flow, now);
+        if (flow.ring.empty()) {
+            removeHead(list);
+            // A new flow which becomes empty is moved to the end of the old list instead of
+            // being removed. Otherwise a flow sending a packet just before each round would be
+            // served before all other flows all the time.
+            if (isNew && oldFlows_.head != NoFlow) {
+                append(oldFlows_, index);
+                flow.list = Flow::Old;
+            } else
+                flow.list = Flow::None;
+            continue;
+        }
+        current_ = index;
+        return &flow;
+    }
+}
+
+prefix_ senf::Packet const & senf::ppi::FlowQueueingAlgorithm::v_front()
+    const
+{
+    Flow * flow (const_cast<FlowQueueingAlgorithm*>(this)->select());
+    if (! flow) {
+        static Packet none;
+        return none;
+    }
+    return flow->ring.front().packet;
+}
+
+prefix_ unsigned senf::ppi::FlowQueueingAlgorithm::v_peek(unsigned maxSize)
+    const
+{
+    Flow * flow (const_cast<FlowQueueingAlgorithm*>(this)->select());
+    if (! flow)
+        return 0;
+    unsigned size (flow->ring.front().packet.size());
+    return size <= maxSize ? size : 0;
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::v_pop()
+{
+    Flow * flow (select());
+    if (! flow)
+        return;
+    flow->deficit -= flow->ring.front().packet.size();
+    dropHead(*flow);
+    current_ = NoFlow;
+}
+
+prefix_ bool senf::ppi::FlowQueueingAlgorithm::v_enqueue(Packet const & packet, bool force)
+{
+    if (!force and size_ >= limit_) {
+        ++ dropped_;
+        return false;
+    }
+    unsigned index (flowHash(packet, perturbation_) & (flows_.size() - 1));
+    Flow & flow (flows_[index]);
+    if (!force and flow.ring.size() >= flowLimit_) {
+        ++ dropped_;
+        return false;
+    }
+    flow.ring.push(packet, ClockService::now());
+    flow.bytes += packet.size();
+    ++ size_;
+    if (flow.list == Flow::None) {
+        append(newFlows_, index);
+        flow.list = Flow::New;
+        flow.deficit = quantum_;
+    }
+    return true;
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::v_clear()
+{
+    for (std::vector<Flow>::iterator i (flows_.begin()); i != flows_.end(); ++i) {
+        i->ring.clear();
+        i->bytes = 0;
+        i->deficit = 0;
+        i->list = Flow::None;
+        i->reset();
+    }
+    newFlows_.head = newFlows_.tail = oldFlows_.head = oldFlows_.tail = NoFlow;
+    current_ = NoFlow;
+    size_ = 0;
+}
+
+prefix_ void senf::ppi::FlowQueueingAlgorithm::v_select(Flow & flow, ClockService::clock_type now)
+{}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::DRRQueueingAlgorithm
+
+prefix_ senf::ppi::DRRQueueingAlgorithm::DRRQueueingAlgorithm(unsigned flows, unsigned quantum,
+                                                              unsigned limit, unsigned flowLimit)
+    : FlowQueueingAlgorithm(flows, quantum, limit, flowLimit)
+{}
+
+prefix_ senf::ppi::QueueingAlgorithm::ptr senf::ppi::DRRQueueingAlgorithm::create()
+{
+    return QueueingAlgorithm::ptr(new DRRQueueingAlgorithm());
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::FQCoDelQueueingAlgorithm
+
+prefix_ senf::ppi::FQCoDelQueueingAlgorithm::
+FQCoDelQueueingAlgorithm(ClockService::clock_type target, ClockService::clock_type interval,
+                         unsigned flows, unsigned quantum, unsigned limit, unsigned flowLimit)
+    : FlowQueueingAlgorithm(flows, quantum, limit, flowLimit),
+      target_ (target), interval_ (interval), mtu_ (quantum), codelDropped_ (0)
+{
+    namespace fty = console::factory;
+    consoleDir()
+        .add("target", fty::Variable(target_)
+             .parser(senf::parseClockServiceInterval)
+             .formatter(senf::formatClockServiceInterval)
+             .doc("Acceptable standing queue delay.") );
+    consoleDir()
+        .add("interval", fty::Variable(interval_)
+             .parser(senf::parseClockServiceInterval)
+             .formatter(senf::formatClockServiceInterval)
+             .doc("Sliding minimum window, should be the worst case round trip time.") );
+    consoleDir()
+        .add("codel-dropped", fty::Command(&FQCoDelQueueingAlgorithm::codelDropped, this)
+             .doc("Get and reset number of packets dropped by CoDel.") );
+}
+
+prefix_ senf::ppi::QueueingAlgorithm::ptr senf::ppi::FQCoDelQueueingAlgorithm::create()
+{
+    return QueueingAlgorithm::ptr(new FQCoDelQueueingAlgorithm());
+}
+
+prefix_ senf::ClockService::clock_type
+senf::ppi::FQCoDelQueueingAlgorithm::controlLaw(ClockService::clock_type t, unsigned count)
+    const
+{
+    return t + ClockService::nanoseconds(
+        ClockService::int64_type(ClockService::in_nanoseconds(interval_) / std::sqrt(double(count))));
+}
+
+prefix_ bool senf::ppi::FQCoDelQueueingAlgorithm::shouldDrop(Flow & flow,
+                                                             ClockService::clock_type now)
+{
+    if (flow.ring.empty()) {
+        flow.firstAboveTime = ClockService::clock_type(0);
+        return false;
+    }
+    unsigned size (flow.ring.front().packet.size());
+    if (now - flow.ring.front().timestamp < target_ || flow.bytes - size <= mtu_) {
+        flow.firstAboveTime = ClockService::clock_type(0);
+        return false;
+    }
+    if (flow.firstAboveTime == ClockService::clock_type(0)) {
+        flow.firstAboveTime = now + interval_;
+        return false;
+    }
+    return now >= flow.firstAboveTime;
+}
+
+// CoDel dequeue logic as given in RFC 8289, section 5.5
+prefix_ void senf::ppi::FQCoDelQueueingAlgorithm::v_select(Flow & flow,
+                                                           ClockService::clock_type now)
+{
+    bool okToDrop (shouldDrop(flow, now));
+    if (flow.dropping) {
+        if (! okToDrop)
+            flow.dropping = false;
+        else while (now >= flow.dropNext && flow.dropping) {
+            dropHead(flow);
+            ++ codelDropped_;
+            ++ flow.count;
+            if (! shouldDrop(flow, now))
+                flow.dropping = false;
+            else
+                flow.dropNext = controlLaw(flow.dropNext, flow.count);
+        }
+    }
+    else if (okToDrop) {
+        dropHead(flow);
+        ++ codelDropped_;
+        flow.dropping = true;
+        // Re-use the drop rate of the last dropping state if it ended only recently
+        unsigned delta (flow.count - flow.lastCount);
+        flow.count = (delta > 1 && now - flow.dropNext < 16 * interval_) ? delta : 1;
+        flow.dropNext = controlLaw(now, flow.count);
+        flow.lastCount = flow.count;
+    }
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "FlowQueueingAlgorithm.mpp"
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
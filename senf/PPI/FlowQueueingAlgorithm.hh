@@ -0,0 +1,204 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief FlowQueueingAlgorithm public header */
+
+#ifndef HH_SENF_PPI_FlowQueueingAlgorithm_
+#define HH_SENF_PPI_FlowQueueingAlgorithm_ 1
+
+// Custom includes
+#include <vector>
+#include <cstdint>
+#include <senf/Scheduler/ClockService.hh>
+#include "QueueingAlgorithm.hh"
+
+#include "FlowQueueingAlgorithm.ih"
+//#include "FlowQueueingAlgorithm.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+
+    /** \brief Flow isolating queueing algorithm base-class
+
+        Packets are sorted into \ref flows() queues by a hash over the flow identifying header
+        fields (see flowHash()). The queues are served by deficit round robin: Every flow may send
+        \ref quantum() bytes per round. Flows which have just become active are served before
+        the flows which have been active for a longer time, so sparse flows (e.g. DNS or VoIP) see
+        almost no queueing delay even if some bulk flows keep their queues full.
+
+        Every flow queue is a ring buffer bounded to \ref flowLimit() packets, the total number of
+        queued packets is bounded by \ref limit(). Packets exceeding these limits are rejected by
+        enqueue() (unless forced) and counted in dropped(). Enqueueing and dequeueing a packet
+        takes constant time.
+
+        \see DRRQueueingAlgorithm \n
+            FQCoDelQueueingAlgorithm
+     */
+    class FlowQueueingAlgorithm
+        : public QueueingAlgorithm
+    {
+    public:
+        static std::uint32_t flowHash(Packet const & packet, std::uint32_t perturbation = 0);
+                                        ///< Hash flow identifying header fields of \a packet
+                                        /**< IPv4 and IPv6 packets are identified by addresses,
+                                             protocol and, for TCP, UDP, UDP-Lite, DCCP and
+                                             SCTP, ports. Ethernet frames by VLAN tags and, if
+                                             they don't contain an IP packet, addresses and
+                                             ethertype. All packets other than IPv4Packet or
+                                             IPv6Packet are parsed as Ethernet frames. */
+
+        unsigned flows() const;         ///< Number of flow queues
+        void flows(unsigned n);         ///< Set number of flow queues
+                                        /**< \a n is rounded up to the next power of 2. All queued
+                                             packets are dropped. */
+        unsigned quantum() const;       ///< Bytes per flow and round
+        void quantum(unsigned bytes);   ///< Set bytes per flow and round
+                                        /**< \throws InvalidArgumentException if \a bytes is 0 */
+        unsigned limit() const;         ///< Maximum number of queued packets
+        void limit(unsigned packets);   ///< Set maximum number of queued packets
+        unsigned flowLimit() const;     ///< Maximum number of queued packets per flow
+        void flowLimit(unsigned packets); ///< Set maximum number of queued packets per flow
+
+        std::uint32_t perturbation() const; ///< Flow hash perturbation
+        void perturbation(std::uint32_t p); ///< Set flow hash perturbation
+                                        /**< The perturbation is initialized randomly to make
+                                             flow collisions unpredictable. All queued packets are
+                                             dropped. */
+
+        unsigned dropped();             ///< Number of packets rejected since the last call
+
+    protected:
+        FlowQueueingAlgorithm(unsigned flows, unsigned quantum, unsigned limit, unsigned flowLimit);
+
+        typedef detail::FlowQueue Flow;
+
+        void dropHead(Flow & flow);     ///< Drop packet at the head of \a flow
+
+    private:
+        virtual Packet const & v_front() const;
+        virtual unsigned v_peek(unsigned maxSize) const;
+        virtual void v_pop();
+        virtual bool v_enqueue(Packet const & packet, bool force);
+        virtual unsigned v_size() const;
+        virtual void v_clear();
+        virtual bool v_empty() const;
+
+        virtual void v_select(Flow & flow, ClockService::clock_type now);
+                                        ///< Called whenever a new packet reaches the head of a flow
+                                        /**< May drop packets with dropHead() (active queue
+                                             management). The default implementation does
+                                             nothing */
+        struct FlowList
+        {
+            unsigned head;
+            unsigned tail;
+        };
+
+        Flow * select();
+        void append(FlowList & list, unsigned index);
+        void removeHead(FlowList & list);
+
+        std::vector<Flow> flows_;
+        FlowList newFlows_;
+        FlowList oldFlows_;
+        unsigned current_;
+        unsigned size_;
+        unsigned quantum_;
+        unsigned limit_;
+        unsigned flowLimit_;
+        unsigned dropped_;
+        std::uint32_t perturbation_;
+    };
+
+    /** \brief Deficit round robin queueing algorithm
+
+        Fair queueing between flows without any active queue management: Packets are only dropped
+        if a flow queue or the complete queue is full.
+
+        \see FlowQueueingAlgorithm
+     */
+    class DRRQueueingAlgorithm
+        : public FlowQueueingAlgorithm
+    {
+    public:
+        static QueueingAlgorithm::ptr create();
+
+        explicit DRRQueueingAlgorithm(unsigned flows = 1024, unsigned quantum = 1514,
+                                      unsigned limit = 10240, unsigned flowLimit = 1024);
+    };
+
+    /** \brief FQ-CoDel queueing algorithm
+
+        Flow queueing as in FlowQueueingAlgorithm with CoDel (controlled delay, RFC 8289) active
+        queue management applied to every flow queue: If the time packets of a flow have spent in
+        the queue (the sojourn time) stays above target() for at least interval(), packets are
+        dropped at the head of the flow with increasing frequency until the sojourn time falls
+        below target() again. This keeps the standing queue of bulk flows short. See RFC 8290 for
+        the algorithm.
+
+        \see FlowQueueingAlgorithm
+     */
+    class FQCoDelQueueingAlgorithm
+        : public FlowQueueingAlgorithm
+    {
+    public:
+        static QueueingAlgorithm::ptr create();
+
+        explicit FQCoDelQueueingAlgorithm(
+            ClockService::clock_type target = ClockService::milliseconds(5),
+            ClockService::clock_type interval = ClockService::milliseconds(100),
+            unsigned flows = 1024, unsigned quantum = 1514,
+            unsigned limit = 10240, unsigned flowLimit = 1024);
+
+        ClockService::clock_type target() const; ///< Acceptable standing queue delay
+        void target(ClockService::clock_type t); ///< Set acceptable standing queue delay
+        ClockService::clock_type interval() const; ///< Sliding minimum window
+        void interval(ClockService::clock_type t); ///< Set sliding minimum window
+                                        /**< Should be set to the worst case round trip time of
+                                             the flows */
+
+        unsigned codelDropped();        ///< Number of packets dropped by CoDel since the last call
+
+    private:
+        virtual void v_select(Flow & flow, ClockService::clock_type now);
+
+        bool shouldDrop(Flow & flow, ClockService::clock_type now);
+        ClockService::clock_type controlLaw(ClockService::clock_type t, unsigned count) const;
+
+        ClockService::clock_type target_;
+        ClockService::clock_type interval_;
+        unsigned mtu_;
+        unsigned codelDropped_;
+    };
+
+}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "FlowQueueingAlgorithm.cci"
+//#include "FlowQueueingAlgorithm.ct"
+//#include "FlowQueueingAlgorithm.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief FlowQueueingAlgorithm unit tests */
+
+#include "FlowQueueingAlgorithm.hh"
+
+// Custom includes
+#include <unistd.h>
+#include <senf/Packets/DefaultBundle/EthernetPacket.hh>
+#include <senf/Packets/DefaultBundle/IPv4Packet.hh>
+#include <senf/Packets/DefaultBundle/UDPPacket.hh>
+#include <senf/Utils/Exception.hh>
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ppi = senf::ppi;
+
+namespace {
+
+    senf::IPv4Packet udpPacket(unsigned port, unsigned size = 100)
+    {
+        senf::IPv4Packet ip (senf::IPv4Packet::create());
+        ip->source() = senf::INet4Address::from_string("192.168.0.1");
+        ip->destination() = senf::INet4Address::from_string("192.168.0.2");
+        senf::UDPPacket udp (senf::UDPPacket::createAfter(ip));
+        udp->source() = 1024;
+        udp->destination() = port;
+        senf::DataPacket::createAfter(udp, size - senf::IPv4PacketParser::fixed_bytes
+                                      - senf::UDPPacketParser::fixed_bytes);
+        ip.finalizeAll();
+        return ip;
+    }
+
+    unsigned port(senf::Packet const & packet)
+    {
+        return packet.find<senf::UDPPacket>()->destination();
+    }
+
+    // make sure the test flows don't share a flow queue
+    void separate(ppi::FlowQueueingAlgorithm & qalgo, unsigned portA, unsigned portB)
+    {
+        std::uint32_t p (0);
+        while ((ppi::FlowQueueingAlgorithm::flowHash(udpPacket(portA), p) & (qalgo.flows() - 1))
+               == (ppi::FlowQueueingAlgorithm::flowHash(udpPacket(portB), p) & (qalgo.flows() - 1)))
+            ++ p;
+        qalgo.perturbation(p);
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(flowHash)
+{
+    typedef ppi::FlowQueueingAlgorithm FQA;
+
+    BOOST_CHECK_EQUAL( FQA::flowHash(udpPacket(53)), FQA::flowHash(udpPacket(53, 1000)) );
+    BOOST_CHECK( FQA::flowHash(udpPacket(53)) != FQA::flowHash(udpPacket(54)) );
+    BOOST_CHECK( FQA::flowHash(udpPacket(53), 1) != FQA::flowHash(udpPacket(53), 2) );
+
+    senf::IPv4Packet ip (udpPacket(53));
+    senf::EthernetPacket frame (senf::EthernetPacket::create());
+    frame->type_length() = 0x0800;
+    frame.data().insert(frame.data().end(), ip.data().begin(), ip.data().end());
+    BOOST_CHECK_EQUAL( FQA::flowHash(frame), FQA::flowHash(ip) );
+    BOOST_CHECK_EQUAL( FQA::flowHash(frame.next()), FQA::flowHash(ip) );
+}
+
+SENF_AUTO_TEST_CASE(drrQueueingAlgorithm)
+{
+    ppi::DRRQueueingAlgorithm qalgo (1024, 100, 16, 4);
+    separate(qalgo, 1, 2);
+
+    for (unsigned i (0); i < 4; ++i)
+        BOOST_CHECK( qalgo.enqueue(udpPacket(1)) );
+    BOOST_CHECK( ! qalgo.enqueue(udpPacket(1)) );
+    BOOST_CHECK_EQUAL( qalgo.dropped(), 1u );
+    BOOST_CHECK_EQUAL( qalgo.dropped(), 0u );
+    BOOST_CHECK( qalgo.enqueue(udpPacket(2)) );
+    BOOST_CHECK( qalgo.enqueue(udpPacket(2)) );
+    BOOST_CHECK_EQUAL( qalgo.size(), 6u );
+
+    BOOST_CHECK_EQUAL( qalgo.peek(99), 0u );
+    BOOST_CHECK_EQUAL( qalgo.peek(100), 100u );
+
+    unsigned order[] = { 1, 2, 1, 2, 1, 1 };
+    for (unsigned i (0); i < sizeof(order)/sizeof(order[0]); ++i) {
+        BOOST_REQUIRE( qalgo.peek(1500) > 0 );
+        BOOST_CHECK_EQUAL( port(qalgo.front()), order[i] );
+        qalgo.pop();
+    }
+    BOOST_CHECK( qalgo.empty() );
+    BOOST_CHECK_EQUAL( qalgo.peek(1500), 0u );
+
+    qalgo.limit(2);
+    BOOST_CHECK( qalgo.enqueue(udpPacket(1)) );
+    BOOST_CHECK( qalgo.enqueue(udpPacket(2)) );
+    BOOST_CHECK( ! qalgo.enqueue(udpPacket(2)) );
+    BOOST_CHECK( qalgo.enqueue(udpPacket(2), true) );
+    BOOST_CHECK_EQUAL( qalgo.size(), 3u );
+    qalgo.clear();
+    BOOST_CHECK( qalgo.empty() );
+    BOOST_CHECK_EQUAL( qalgo.peek(1500), 0u );
+
+    qalgo.flows(1000);
+    BOOST_CHECK_EQUAL( qalgo.flows(), 1024u );
+
+    BOOST_CHECK_THROW( qalgo.quantum(0), senf::InvalidArgumentException );
+    BOOST_CHECK_EQUAL( qalgo.quantum(), 100u );
+    BOOST_CHECK_THROW( ppi::DRRQueueingAlgorithm(16, 0), senf::InvalidArgumentException );
+}
+
+SENF_AUTO_TEST_CASE(fqCoDelQueueingAlgorithm)
+{
+    ppi::FQCoDelQueueingAlgorithm qalgo (
+        senf::ClockService::milliseconds(1), senf::ClockService::milliseconds(10));
+
+    for (unsigned i (0); i < 20; ++i)
+        BOOST_CHECK( qalgo.enqueue(udpPacket(1, 1000)) );
+
+    // The first packet above target only starts the interval
+    ::usleep(5000);
+    BOOST_CHECK_EQUAL( qalgo.peek(1500), 1000u );
+    qalgo.pop();
+    BOOST_CHECK_EQUAL( qalgo.codelDropped(), 0u );
+    BOOST_CHECK_EQUAL( qalgo.size(), 19u );
+
+    // still above target after a full interval: enter dropping state
+    ::usleep(15000);
+    BOOST_CHECK_EQUAL( qalgo.peek(1500), 1000u );
+    qalgo.pop();
+    BOOST_CHECK_EQUAL( qalgo.codelDropped(), 1u );
+    BOOST_CHECK_EQUAL( qalgo.size(), 17u );
+
+    ppi::QueueingAlgorithm::ptr q (
+        ppi::QueueingAlgorithmRegistry::instance().createQAlgorithm("FQCoDelQueueingAlgorithm"));
+    BOOST_CHECK( dynamic_cast<ppi::FQCoDelQueueingAlgorithm*>(q.get()) );
+    q = ppi::QueueingAlgorithmRegistry::instance().createQAlgorithm("DRRQueueingAlgorithm");
+    BOOST_CHECK( dynamic_cast<ppi::DRRQueueingAlgorithm*>(q.get()) );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,517 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief HTBShaper non-inline non-template implementation */
+
+#include "HTBShaper.hh"
+#include "HTBShaper.ih"
+
+// Custom includes
+#include <boost/format.hpp>
+#include <boost/ref.hpp>
+#include <senf/Packets/DefaultBundle/EthernetPacket.hh>
+#include <senf/Packets/DefaultBundle/IPv4Packet.hh>
+#include <senf/Packets/DefaultBundle/IPv6Packet.hh>
+#include <senf/Utils/membind.hh>
+#include <senf/Utils/Console/ParsedCommand.hh>
+#include <senf/Utils/Console/Variables.hh>
+
+//#include "HTBShaper.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    // Maximum debt of a class in nanoseconds. Without a limit, a class whose children borrow for
+    // a long time would not get its own rate for just as long after the borrowing stops.
+    std::int64_t const MaxDebt (1000000000ll);
+
+    unsigned defaultBurst(unsigned rate)
+    {
+        // 10ms at rate plus one full sized ethernet frame
+        return rate / 800u + 1514u;
+    }
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::detail::HTBClass
+
+prefix_ senf::ppi::module::detail::HTBClass::HTBClass(unsigned _id, HTBClass * _parent,
+                                                      unsigned _rate, unsigned _ceil,
+                                                      unsigned _burst, unsigned _prio,
+                                                      QueueingAlgorithm::ptr qAlgorithm)
+    : id (_id), parent (_parent), children (0), rate (0), ceil (0), burst (_burst), prio (_prio),
+      quantum (0), tokens (0), ctokens (0), buffer (0), cbuffer (0),
+      lastUpdate (ClockService::now()), queue (qAlgorithm.release()), deficit (0), active (false),
+      bytes (0), packets (0), dropped (0), borrowed (0)
+{
+    configure(_rate, _ceil);
+    tokens = buffer;
+    ctokens = cbuffer;
+
+    namespace fty = console::factory;
+    dir.add("rate", fty::Variable(boost::cref(rate))
+            .doc("Guaranteed rate in bits per second.") );
+    dir.add("ceil", fty::Variable(boost::cref(ceil))
+            .doc("Maximum rate in bits per second.") );
+    dir.add("prio", fty::Variable(boost::cref(prio))
+            .doc("Leaf priority, 0 is served first.") );
+    dir.add("quantum", fty::Variable(quantum)
+            .doc("Bytes per deficit round robin round.") );
+    dir.add("backlog", fty::Command(&HTBClass::backlog, this)
+            .doc("Number of queued packets.") );
+    dir.add("bytes", fty::Variable(boost::cref(bytes))
+            .doc("Number of bytes sent by this class and its children.") );
+    dir.add("packets", fty::Variable(boost::cref(packets))
+            .doc("Number of packets sent by this class and its children.") );
+    dir.add("dropped", fty::Variable(boost::cref(dropped))
+            .doc("Number of packets dropped by the queue.") );
+    dir.add("borrowed", fty::Variable(boost::cref(borrowed))
+            .doc("Number of packets sent above the guaranteed rate.") );
+    dir.add("queue", queue->consoleDir());
+}
+
+prefix_ void senf::ppi::module::detail::HTBClass::configure(unsigned _rate, unsigned _ceil)
+{
+    rate = _rate;
+    ceil = std::max(_rate, _ceil);
+    quantum = std::min(std::max(rate / 80u, 1514u), 200000u);
+    buffer = cost(burst ? burst : defaultBurst(rate), rate);
+    cbuffer = cost(burst ? burst : defaultBurst(ceil), ceil);
+    tokens = std::min(tokens, buffer);
+    ctokens = std::min(ctokens, cbuffer);
+}
+
+prefix_ unsigned senf::ppi::module::detail::HTBClass::backlog()
+    const
+{
+    return queue->size();
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::HTBShaper::DSCPClassifier
+
+prefix_ senf::ppi::module::HTBShaper::DSCPClassifier::DSCPClassifier(ClassId defaultClass)
+{
+    std::fill(classes_, classes_ + 64, defaultClass);
+}
+
+prefix_ void senf::ppi::module::HTBShaper::DSCPClassifier::map(unsigned dscp, ClassId id)
+{
+    classes_[dscp & 0x3f] = id;
+}
+
+prefix_ senf::ppi::module::HTBShaper::ClassId
+senf::ppi::module::HTBShaper::DSCPClassifier::operator()(Packet const & packet)
+    const
+{
+    Packet p (packet.is<EthernetPacket>() ? packet.next(nothrow) : packet);
+    if (p.is<IPv4Packet>())
+        return classes_[p.as<IPv4Packet>()->dscp()];
+    if (p.is<IPv6Packet>())
+        return classes_[p.as<IPv6Packet>()->trafficClass() >> 2];
+    return classes_[0];
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::HTBShaper
+
+prefix_ senf::ppi::module::HTBShaper::HTBShaper(unsigned rate, unsigned burst)
+    : defaultClass_ (0),
+      timer_ ("senf::ppi::module::HTBShaper", membind(&HTBShaper::schedule, this))
+{
+    route(input, output).autoThrottling(false);
+    input.onRequest(&HTBShaper::onRequest);
+    input.throttlingDisc(ThrottlingDiscipline::NONE);
+    output.onUnthrottle(&HTBShaper::schedule);
+
+    if (rate == 0)
+        throw InvalidClassException(0);
+    ClassId key (0);
+    Class & root (*classes_.insert(
+                      key, new Class(0, 0, rate, rate, burst, 0,
+                                     FIFOQueueingAlgorithm::create())).first->second);
+    classesDir_.add("0", root.dir);
+
+    namespace fty = console::factory;
+    namespace kw = console::kw;
+    dir.add("classes", classesDir_);
+    dir.add("add-class", fty::Command(&HTBShaper::consoleAddClass, this)
+            .arg("id", "class id")
+            .arg("parent", "parent class id")
+            .arg("rate", "guaranteed rate in bits per second")
+            .arg("ceil", "maximum rate in bits per second, 0 to disable borrowing",
+                 kw::default_value = 0u)
+            .arg("prio", "leaf priority, 0 is served first", kw::default_value = 0u)
+            .arg("qalgorithm", "name of the leaf queueing algorithm",
+                 kw::default_value = std::string("FIFOQueueingAlgorithm"))
+            .doc("Add a new class. If the parent class was a leaf, its queue is dropped.") );
+    dir.add("remove-class", fty::Command(&HTBShaper::removeClass, this)
+            .arg("id", "class id")
+            .doc("Remove leaf class and drop its queued packets.") );
+    dir.add("rate", fty::Command(
+                SENF_MEMBINDFNP(void, HTBShaper, rate, (ClassId, unsigned, unsigned)))
+            .arg("id", "class id")
+            .arg("rate", "guaranteed rate in bits per second")
+            .arg("ceil", "maximum rate in bits per second, 0 to disable borrowing",
+                 kw::default_value = 0u)
+            .doc("Change rates of a class.") );
+    dir.add("default-class", fty::Command(
+                SENF_MEMBINDFNP(ClassId, HTBShaper, defaultClass, () const))
+            .doc("Get class of unclassified packets.") );
+    dir.add("default-class", fty::Command(
+                SENF_MEMBINDFNP(void, HTBShaper, defaultClass, (ClassId)))
+            .arg("id", "class id")
+            .doc("Set class of unclassified packets.") );
+    dir.add("list", fty::Command(&HTBShaper::consoleList, this)
+            .doc("List all classes with rates and counters.") );
+}
+
+prefix_ void senf::ppi::module::HTBShaper::addClass(ClassId id, ClassId parent, unsigned rate,
+                                                    unsigned ceil, unsigned prio,
+                                                    QueueingAlgorithm::ptr qAlgorithm)
+{
+    if (classes_.find(id) != classes_.end() || rate == 0 || prio >= Priorities)
+        throw InvalidClassException(id);
+    Class & p (getClass(parent));
+    if (p.leaf()) {
+        if (p.active)
+            deactivate(p);
+        p.queue->clear();
+    }
+    if (! qAlgorithm)
+        qAlgorithm = FIFOQueueingAlgorithm::create();
+    Class & c (*classes_.insert(
+                   id, new Class(id, &p, rate, ceil, 0, prio, std::move(qAlgorithm))).first->second);
+    ++ p.children;
+    classesDir_.add(senf::str(id), c.dir);
+}
+
+prefix_ void senf::ppi::module::HTBShaper::removeClass(ClassId id)
+{
+    Class & c (getClass(id));
+    if (! c.parent || ! c.leaf())
+        throw InvalidClassException(id);
+    if (c.active)
+        deactivate(c);
+    -- c.parent->children;
+    classes_.erase(id);
+}
+
+prefix_ void senf::ppi::module::HTBShaper::rate(ClassId id, unsigned rate, unsigned ceil)
+{
+    if (rate == 0)
+        throw InvalidClassException(id);
+    getClass(id).configure(rate, ceil);
+    schedule();
+}
+
+prefix_ unsigned senf::ppi::module::HTBShaper::rate(ClassId id)
+    const
+{
+    return getClass(id).rate;
+}
+
+prefix_ unsigned senf::ppi::module::HTBShaper::ceil(ClassId id)
+    const
+{
+    return getClass(id).ceil;
+}
+
+prefix_ senf::ppi::module::HTBShaper::ClassStatistics
+senf::ppi::module::HTBShaper::statistics(ClassId id)
+    const
+{
+    Class const & c (getClass(id));
+    ClassStatistics stats;
+    stats.bytes = c.bytes;
+    stats.packets = c.packets;
+    stats.dropped = c.dropped;
+    stats.borrowed = c.borrowed;
+    stats.backlog = c.leaf() ? c.queue->size() : 0u;
+    return stats;
+}
+
+prefix_ senf::ppi::QueueingAlgorithm & senf::ppi::module::HTBShaper::qAlgorithm(ClassId id)
+    const
+{
+    return *getClass(id).queue;
+}
+
+prefix_ void senf::ppi::module::HTBShaper::defaultClass(ClassId id)
+{
+    getClass(id);
+    defaultClass_ = id;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// private members
+
+prefix_ senf::ppi::module::HTBShaper::Class &
+senf::ppi::module::HTBShaper::getClass(ClassId id)
+    const
+{
+    Classes::const_iterator i (classes_.find(id));
+    if (i == classes_.end())
+        throw InvalidClassException(id);
+    return const_cast<Class &>(*i->second);
+}
+
+prefix_ senf::ppi::module::HTBShaper::Class *
+senf::ppi::module::HTBShaper::classify(Packet const & packet)
+{
+    Classes::iterator i (classes_.find(classifier_ ? classifier_(packet) : defaultClass_));
+    if (i == classes_.end() || ! i->second->leaf()) {
+        i = classes_.find(defaultClass_);
+        if (i == classes_.end() || ! i->second->leaf())
+            return 0;
+    }
+    return i->second;
+}
+
+prefix_ void senf::ppi::module::HTBShaper::activate(Class & leaf)
+{
+    active_[leaf.prio].push_back(&leaf);
+    leaf.active = true;
+    leaf.deficit = leaf.quantum;
+}
+
+prefix_ void senf::ppi::module::HTBShaper::deactivate(Class & leaf)
+{
+    active_[leaf.prio].remove(&leaf);
+    leaf.active = false;
+}
+
+prefix_ void senf::ppi::module::HTBShaper::onRequest()
+{
+    Packet const & packet (input());
+    Class * leaf (classify(packet));
+    if (! leaf)
+        return;
+    if (! leaf->queue->enqueue(packet)) {
+        ++ leaf->dropped;
+        return;
+    }
+    if (leaf->active) {
+        // More backlog on an already waiting leaf does not allow any class to send earlier
+        if (timer_.enabled())
+            return;
+    }
+    else
+        activate(*leaf);
+    schedule();
+}
+
+prefix_ void senf::ppi::module::HTBShaper::schedule()
+{
+    ClockService::clock_type now (ClockService::now());
+    Class * leaf;
+    while (output && (leaf = select(now))) {
+        unsigned size (leaf->queue->peek());
+        Packet packet (leaf->queue->front());
+        leaf->queue->pop();
+        if (leaf->tokens < 0)
+            ++ leaf->borrowed;
+        charge(*leaf, size, now);
+        ActiveList & list (active_[leaf->prio]);
+        if (leaf->queue->empty()) {
+            list.pop_front();
+            leaf->active = false;
+        }
+        else if ((leaf->deficit -= size) <= 0) {
+            leaf->deficit += leaf->quantum;
+            list.splice(list.end(), list, list.begin());
+        }
+        output(packet);
+    }
+    setTimeout(now);
+}
+
+prefix_ senf::ppi::module::HTBShaper::Class *
+senf::ppi::module::HTBShaper::select(ClockService::clock_type now)
+{
+    // First serve all leaves within their own rate, then those which may borrow
+    for (unsigned pass (0); pass < 2; ++pass) {
+        for (unsigned prio (0); prio < Priorities; ++prio) {
+            ActiveList & list (active_[prio]);
+            for (std::size_t n (list.size()); n > 0; --n) {
+                Class * leaf (list.front());
+                if (leaf->queue->peek() > 0) {
+                    if (mayDequeue(*leaf, pass > 0, now))
+                        return leaf;
+                }
+                else if (leaf->queue->empty()) {
+                    // The queueing algorithm may drop packets on dequeue (e.g. CoDel)
+                    list.pop_front();
+                    leaf->active = false;
+                    continue;
+                }
+                list.splice(list.end(), list, list.begin());
+            }
+        }
+    }
+    return 0;
+}
+
+prefix_ bool senf::ppi::module::HTBShaper::mayDequeue(Class & leaf, bool borrow,
+                                                      ClockService::clock_type now)
+{
+    leaf.update(now);
+    if (! borrow)
+        return leaf.tokens >= 0 && leaf.ctokens >= 0;
+    for (Class * c (&leaf); c; c = c->parent) {
+        c->update(now);
+        if (c->ctokens < 0)
+            return false;
+        if (c->tokens >= 0)
+            return true;
+    }
+    return false;
+}
+
+prefix_ void senf::ppi::module::HTBShaper::charge(Class & leaf, unsigned size,
+                                                  ClockService::clock_type now)
+{
+    for (Class * c (&leaf); c; c = c->parent) {
+        c->update(now);
+        c->tokens = std::max(c->tokens - c->cost(size, c->rate), -MaxDebt);
+        c->ctokens = std::max(c->ctokens - c->cost(size, c->ceil), -MaxDebt);
+        c->bytes += size;
+        ++ c->packets;
+    }
+}
+
+prefix_ void senf::ppi::module::HTBShaper::setTimeout(ClockService::clock_type now)
+{
+    // A leaf may send as soon as some class on its path to the root has tokens and no class
+    // between the leaf and that class is above its ceil rate
+    std::int64_t wait (-1);
+    for (unsigned prio (0); prio < Priorities; ++prio) {
+        for (ActiveList::const_iterator i (active_[prio].begin()); i != active_[prio].end(); ++i) {
+            std::int64_t ceilWait (0);
+            for (Class * c (*i); c; c = c->parent) {
+                c->update(now);
+                ceilWait = std::max(ceilWait, -c->ctokens);
+                std::int64_t w (std::max(ceilWait, -c->tokens));
+                if (wait < 0 || w < wait)
+                    wait = w;
+            }
+        }
+    }
+    if (wait < 0 || ! output) {
+        timer_.disable();
+        return;
+    }
+    timer_.timeout(now + ClockService::nanoseconds(std::max(wait, std::int64_t(1000))));
+}
+
+prefix_ void senf::ppi::module::HTBShaper::consoleAddClass(ClassId id, ClassId parent,
+                                                           unsigned rate, unsigned ceil,
+                                                           unsigned prio,
+                                                           std::string const & qAlgorithm)
+{
+    addClass(id, parent, rate, ceil, prio,
+             QueueingAlgorithmRegistry::instance().createQAlgorithm(qAlgorithm));
+}
+
+namespace {
+
+    std::uint64_t statBytes(senf::ppi::module::HTBShaper::ClassStatistics const & s)
+    { return s.bytes; }
+
+    std::uint64_t statPackets(senf::ppi::module::HTBShaper::ClassStatistics const & s)
+    { return s.packets; }
+
+    std::uint64_t statDropped(senf::ppi::module::HTBShaper::ClassStatistics const & s)
+    { return s.dropped; }
+
+    std::uint64_t statBorrowed(senf::ppi::module::HTBShaper::ClassStatistics const & s)
+    { return s.borrowed; }
+
+    std::uint64_t statBacklog(senf::ppi::module::HTBShaper::ClassStatistics const & s)
+    { return s.backlog; }
+
+}
+
+prefix_ void senf::ppi::module::HTBShaper::exportMetrics(std::string const & name,
+                                                        metrics::Labels const & labels)
+{
+    static struct {
+        char const * suffix;
+        metrics::Type type;
+        char const * sample;            // counter samples need the _total suffix
+        std::uint64_t (*field)(ClassStatistics const &);
+        char const * help;
+    } const metrics[] = {
+        { "_bytes",    metrics::Counter, "_total", &statBytes, "Number of bytes sent by the class" },
+        { "_packets",  metrics::Counter, "_total", &statPackets,
+          "Number of packets sent by the class" },
+        { "_dropped",  metrics::Counter, "_total", &statDropped,
+          "Number of packets dropped by the queue" },
+        { "_borrowed", metrics::Counter, "_total", &statBorrowed,
+          "Number of packets sent above rate" },
+        { "_backlog",  metrics::Gauge,   "",       &statBacklog, "Number of queued packets" } };
+
+    metrics_.clear();
+    for (unsigned i (0); i < sizeof(metrics)/sizeof(metrics[0]); ++i)
+        metrics_.push_back(metrics::Registry::instance().add(
+                               name + metrics[i].suffix, metrics[i].type, metrics[i].help,
+                               boost::bind(&HTBShaper::writeMetrics, this, metrics[i].field,
+                                           std::string(metrics[i].sample), _1, _2, _3),
+                               labels));
+}
+
+prefix_ void
+senf::ppi::module::HTBShaper::writeMetrics(std::uint64_t (*field)(ClassStatistics const &),
+                                           std::string const & suffix, metrics::Writer & w,
+                                           std::string const & name,
+                                           metrics::Labels const & labels)
+    const
+{
+    std::string sample (name + suffix);
+    for (Classes::const_iterator i (classes_.begin()); i != classes_.end(); ++i)
+        w.sample(sample, labels, "class", senf::str(i->first),
+                 double(field(statistics(i->first))));
+}
+
+prefix_ void senf::ppi::module::HTBShaper::consoleList(std::ostream & os)
+    const
+{
+    boost::format fmt ("%8s %8s %12s %12s %4s %8s %14s %10s %8s %8s\n");
+    os << fmt % "ID" % "PARENT" % "RATE" % "CEIL" % "PRIO" % "BACKLOG" % "BYTES" % "PACKETS"
+        % "DROPPED" % "BORROWED";
+    for (Classes::const_iterator i (classes_.begin()); i != classes_.end(); ++i) {
+        Class const & c (*i->second);
+        os << fmt % c.id % (c.parent ? senf::str(c.parent->id) : std::string("-")) % c.rate
+            % c.ceil % c.prio % (c.leaf() ? senf::str(c.queue->size()) : std::string("-"))
+            % c.bytes % c.packets % c.dropped % c.borrowed;
+    }
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "HTBShaper.mpp"
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief HTBShaper public header */
+
+#ifndef HH_SENF_PPI_HTBShaper_
+#define HH_SENF_PPI_HTBShaper_ 1
+
+// Custom includes
+#include <vector>
+#include <list>
+#include <boost/function.hpp>
+#include <boost/ptr_container/ptr_map.hpp>
+#include <senf/Scheduler/TimerEvent.hh>
+#include <senf/Utils/String.hh>
+#include <senf/Utils/Metrics.hh>
+#include "Module.hh"
+#include "Connectors.hh"
+#include "QueueingAlgorithm.hh"
+
+#include "HTBShaper.ih"
+//#include "HTBShaper.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+namespace module {
+
+    /** \brief Hierarchical token bucket shaper
+
+        The HTBShaper shapes any number of traffic classes with a single module and a single
+        timer. The classes form a tree: Every class is guaranteed its \e rate and may borrow unused
+        bandwidth from its ancestors up to its \e ceil rate. Packets are only queued in the leaf
+        classes, every leaf has its own QueueingAlgorithm (a FIFOQueueingAlgorithm by default).
+
+        The tree is rooted in class \c 0 which is created by the constructor with the link rate.
+        As long as the root class has no children, the HTBShaper works like a single token bucket
+        filter.
+        \code
+        senf::ppi::module::HTBShaper shaper (10000000u);         // 10 MBit/s link
+        shaper.addClass(1, 0,  8000000u, 10000000u);            // station 1: 8 MBit/s, may borrow
+        shaper.addClass(2, 0,  2000000u,  2000000u);            // station 2: hard limit 2 MBit/s
+        shaper.addClass(10, 1, 1000000u, 10000000u, 0);         // station 1 voice, priority 0
+        shaper.addClass(11, 1, 7000000u, 10000000u, 1);         // station 1 best effort
+        shaper.classifier(MyClassifier());
+        \endcode
+
+        Incoming packets are mapped to a class by the classifier(). Packets classified to an
+        unknown or inner class are placed into the defaultClass(). Two classifiers are provided:
+        AnnotationClassifier reads the class from a packet annotation, DSCPClassifier maps the
+        DiffServ code point of IPv4/IPv6 packets.
+
+        Leaf classes are served in order of their priority (lower value first). Leaves with the same
+        priority share the bandwidth by deficit round robin with a quantum of a tenth of the leaf's
+        rate per second (at least 1514 bytes). In a first pass only leaves within their own rate
+        are served, in a second pass leaves may borrow from an ancestor which is within its rate,
+        provided no class on the way is above its ceil rate.
+
+        All classes have a console directory below \c classes/ of the module's \ref dir which
+        allows to inspect and change their parameters and counters. exportMetrics() makes the
+        counters of all classes available to the senf::metrics::Registry.
+
+        \ingroup routing_modules
+     */
+    class HTBShaper
+        : public Module
+    {
+        SENF_PPI_MODULE(HTBShaper);
+
+    public:
+        typedef unsigned ClassId;
+        typedef boost::function<ClassId (Packet const &)> Classifier;
+
+        static unsigned const Priorities = detail::HTBClass::Priorities;
+                                        ///< Number of leaf class priorities
+
+        struct ClassStatistics
+        {
+            std::uint64_t bytes;        ///< Number of bytes sent
+            std::uint64_t packets;      ///< Number of packets sent
+            unsigned dropped;           ///< Number of packets dropped by the queue (leaf only)
+            unsigned borrowed;          ///< Number of packets sent above rate (leaf only)
+            unsigned backlog;           ///< Number of queued packets (leaf only)
+        };
+
+        /** \brief Classify packets by annotation
+
+            Uses the \c value member of the \a Annotation as class id.
+         */
+        template <class Annotation>
+        struct AnnotationClassifier
+        {
+            typedef ClassId result_type;
+            ClassId operator()(Packet const & packet) const;
+        };
+
+        /** \brief Classify IPv4 and IPv6 packets by DiffServ code point
+
+            IPv4 and IPv6 packets are classified either directly or when contained in an Ethernet
+            frame. All other packets and all code points not mapped are assigned the default
+            class.
+         */
+        class DSCPClassifier
+        {
+        public:
+            typedef ClassId result_type;
+
+            explicit DSCPClassifier(ClassId defaultClass = 0);
+
+            void map(unsigned dscp, ClassId id); ///< Assign class \a id to code point \a dscp
+
+            ClassId operator()(Packet const & packet) const;
+
+        private:
+            ClassId classes_[64];
+        };
+
+        struct InvalidClassException : public senf::Exception
+        { InvalidClassException(ClassId id)
+              : senf::Exception("invalid senf::ppi::module::HTBShaper class ")
+                { append( senf::str(id)); } };
+
+        console::ScopedDirectory<> dir;
+        connector::PassiveInput<> input;
+        connector::ActiveOutput<> output;
+
+        explicit HTBShaper(unsigned rate, unsigned burst = 0);
+                                        ///< Create shaper with root class \c 0
+                                        /**< \param[in] rate link rate in bits per second
+                                             \param[in] burst bucket size in bytes. Defaults to
+                                                 10ms at \a rate plus 1514 bytes */
+
+        void addClass(ClassId id, ClassId parent, unsigned rate, unsigned ceil = 0,
+                      unsigned prio = 0, QueueingAlgorithm::ptr qAlgorithm = QueueingAlgorithm::ptr());
+                                        ///< Add class \a id below \a parent
+                                        /**< If \a parent was a leaf class up to now, its queued
+                                             packets are dropped.
+                                             \param[in] id new class id
+                                             \param[in] parent parent class id
+                                             \param[in] rate guaranteed rate in bits per second
+                                             \param[in] ceil maximum rate in bits per second when
+                                                 borrowing. Defaults to \a rate (no borrowing)
+                                             \param[in] prio leaf priority, must be less than
+                                                 Priorities
+                                             \param[in] qAlgorithm leaf queue. Defaults to a
+                                                 FIFOQueueingAlgorithm
+                                             \throws InvalidClassException if \a id exists, \a
+                                                 parent does not exist or any parameter is
+                                                 invalid */
+        void removeClass(ClassId id);   ///< Remove leaf class \a id and drop its queued packets
+                                        /**< \throws InvalidClassException if \a id does not exist,
+                                             is the root class or has children */
+
+        void rate(ClassId id, unsigned rate, unsigned ceil = 0);
+                                        ///< Change rates of class \a id
+        unsigned rate(ClassId id) const; ///< Guaranteed rate of class \a id
+        unsigned ceil(ClassId id) const; ///< Maximum rate of class \a id
+
+        ClassStatistics statistics(ClassId id) const; ///< Get counters of class \a id
+        QueueingAlgorithm & qAlgorithm(ClassId id) const; ///< Queue of leaf class \a id
+
+        void classifier(Classifier const & classifier); ///< Set packet classifier
+        ClassId defaultClass() const;   ///< Class of unclassified packets
+        void defaultClass(ClassId id);  ///< Set class of unclassified packets
+
+        void exportMetrics(std::string const & name,
+                           metrics::Labels const & labels = metrics::Labels());
+                                        ///< Register class counters as metrics
+                                        /**< Registers the counters <em>name</em>\c _bytes,
+                                             <em>name</em>\c _packets, <em>name</em>\c _dropped
+                                             and <em>name</em>\c _borrowed and the gauge
+                                             <em>name</em>\c _backlog with the
+                                             senf::metrics::Registry. Every metric has a sample
+                                             for each class labeled with \c class (the ClassId)
+                                             in addition to \a labels. Classes added later are
+                                             included automatically. */
+
+    private:
+        typedef detail::HTBClass Class;
+        typedef boost::ptr_map<ClassId, Class> Classes;
+        typedef std::list<Class *> ActiveList;
+
+        Class & getClass(ClassId id) const;
+        Class * classify(Packet const & packet);
+        void activate(Class & leaf);
+        void deactivate(Class & leaf);
+
+        void onRequest();
+        void schedule();
+        Class * select(ClockService::clock_type now);
+        bool mayDequeue(Class & leaf, bool borrow, ClockService::clock_type now);
+        void charge(Class & leaf, unsigned size, ClockService::clock_type now);
+        void setTimeout(ClockService::clock_type now);
+
+        void consoleAddClass(ClassId id, ClassId parent, unsigned rate, unsigned ceil,
+                             unsigned prio, std::string const & qAlgorithm);
+        void consoleList(std::ostream & os) const;
+        void writeMetrics(std::uint64_t (*field)(ClassStatistics const &),
+                          std::string const & suffix, metrics::Writer & w,
+                          std::string const & name, metrics::Labels const & labels) const;
+
+        Classes classes_;
+        ActiveList active_[Priorities];
+        Classifier classifier_;
+        ClassId defaultClass_;
+        scheduler::TimerEvent timer_;
+        console::ScopedDirectory<> classesDir_;
+        std::vector<metrics::Registration> metrics_;
+    };
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "HTBShaper.cci"
+//#include "HTBShaper.ct"
+#include "HTBShaper.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
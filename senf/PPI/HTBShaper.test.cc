@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief HTBShaper unit tests */
+
+#include "HTBShaper.hh"
+
+// Custom includes
+#include <sstream>
+#include <senf/Scheduler/Scheduler.hh>
+#include <senf/Packets/DefaultBundle/EthernetPacket.hh>
+#include <senf/Packets/DefaultBundle/IPv4Packet.hh>
+#include "DebugModules.hh"
+#include "Setup.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ppi = senf::ppi;
+namespace module = ppi::module;
+namespace debug = module::debug;
+
+namespace {
+
+    void runPPI(senf::ClockService::clock_type t)
+    {
+        senf::scheduler::TimerEvent timeout(
+                "htbShaper test timer", &senf::scheduler::terminate, senf::scheduler::now() + t);
+        senf::ppi::run();
+    }
+
+    struct ClassAnnotation
+    {
+        unsigned value;
+    };
+
+    std::ostream & operator<<(std::ostream & os, ClassAnnotation const & v)
+    { os << v.value; return os; }
+
+    senf::Packet packet(unsigned classId, unsigned size = 1000)
+    {
+        senf::Packet p (senf::DataPacket::create(size));
+        p.annotation<ClassAnnotation>().value = classId;
+        return p;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(htbShaper)
+{
+    // 8 MBit/s, 10000 bytes burst
+    module::HTBShaper shaper (8000000u, 10000u);
+    debug::ActiveSource source;
+    debug::PassiveSink sink;
+
+    ppi::connect(source, shaper);
+    ppi::connect(shaper, sink);
+    ppi::init();
+
+    senf::Packet p (packet(0));
+    for (unsigned i (0); i < 20; ++i)
+        source.submit(p);
+
+    // A class may send as long as its bucket is not below zero, so 11 packets pass right away,
+    // the remaining packets are queued
+    BOOST_CHECK_EQUAL( sink.size(), 11u );
+    BOOST_CHECK_EQUAL( shaper.statistics(0).backlog, 9u );
+
+    // 9 packets at 1 MByte/s take 10ms
+    runPPI( senf::ClockService::milliseconds(30));
+    BOOST_CHECK_EQUAL( sink.size(), 20u );
+    BOOST_CHECK_EQUAL( shaper.statistics(0).backlog, 0u );
+    BOOST_CHECK_EQUAL( shaper.statistics(0).packets, 20u );
+    BOOST_CHECK_EQUAL( shaper.statistics(0).bytes, 20000u );
+}
+
+SENF_AUTO_TEST_CASE(htbShaper_borrowing)
+{
+    module::HTBShaper shaper (8000000u, 12000u);
+    debug::ActiveSource source;
+    debug::PassiveSink sink;
+
+    ppi::connect(source, shaper);
+    ppi::connect(shaper, sink);
+    ppi::init();
+
+    shaper.classifier(module::HTBShaper::AnnotationClassifier<ClassAnnotation>());
+    shaper.addClass(1, 0, 1000000u, 8000000u);
+    shaper.addClass(2, 0, 1000000u);
+    shaper.defaultClass(2);
+    BOOST_CHECK_THROW( shaper.addClass(1, 0, 1000000u), module::HTBShaper::InvalidClassException );
+    BOOST_CHECK_THROW( shaper.addClass(3, 4, 1000000u), module::HTBShaper::InvalidClassException );
+    BOOST_CHECK_THROW( shaper.removeClass(0), module::HTBShaper::InvalidClassException );
+    BOOST_CHECK_EQUAL( shaper.ceil(2), 1000000u );
+
+    senf::Packet p1 (packet(1));
+    senf::Packet p2 (packet(2));
+    senf::Packet p0 (packet(0));    // inner class -> default class
+    for (unsigned i (0); i < 20; ++i) {
+        source.submit(p1);
+        source.submit(p2);
+    }
+    source.submit(p0);
+
+    // Both leaves may send about 3 packets at their own rate (2764 bytes default burst), class 1
+    // may borrow up to the root class's 12000 bytes bucket
+    module::HTBShaper::ClassStatistics s1 (shaper.statistics(1));
+    module::HTBShaper::ClassStatistics s2 (shaper.statistics(2));
+    BOOST_CHECK_EQUAL( s2.packets, 3u );
+    BOOST_CHECK_EQUAL( s2.borrowed, 0u );
+    BOOST_CHECK_EQUAL( s1.packets, 10u );
+    BOOST_CHECK_EQUAL( s1.borrowed, 7u );
+    BOOST_CHECK_EQUAL( s1.backlog + s2.backlog, 41u - 13u );
+    BOOST_CHECK_EQUAL( shaper.statistics(0).packets, 13u );
+    BOOST_CHECK_EQUAL( sink.size(), 13u );
+
+    shaper.exportMetrics("test_htb");
+    std::stringstream ss;
+    senf::metrics::Registry::instance().write(ss);
+    BOOST_CHECK( ss.str().find("# TYPE test_htb_packets counter\n") != std::string::npos );
+    BOOST_CHECK( ss.str().find("test_htb_packets_total{class=\"0\"} 13\n"
+                               "test_htb_packets_total{class=\"1\"} 10\n"
+                               "test_htb_packets_total{class=\"2\"} 3\n") != std::string::npos );
+    BOOST_CHECK( ss.str().find("test_htb_borrowed_total{class=\"1\"} 7\n") != std::string::npos );
+
+    BOOST_CHECK_THROW( shaper.removeClass(0), module::HTBShaper::InvalidClassException );
+    shaper.removeClass(1);
+    BOOST_CHECK_THROW( shaper.statistics(1), module::HTBShaper::InvalidClassException );
+    shaper.removeClass(2);
+    BOOST_CHECK_EQUAL( shaper.statistics(0).backlog, 0u );
+}
+
+SENF_AUTO_TEST_CASE(htbShaper_dscpClassifier)
+{
+    module::HTBShaper::DSCPClassifier classifier (7);
+    classifier.map(46, 1);
+
+    senf::EthernetPacket eth (senf::EthernetPacket::create());
+    senf::IPv4Packet ip (senf::IPv4Packet::createAfter(eth));
+    eth.finalizeAll();
+
+    BOOST_CHECK_EQUAL( classifier(eth), 7u );
+    ip->dscp() = 46;
+    BOOST_CHECK_EQUAL( classifier(eth), 1u );
+    BOOST_CHECK_EQUAL( classifier(ip), 1u );
+    BOOST_CHECK_EQUAL( classifier(senf::DataPacket::create(10u)), 7u );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -17,6 +17,7 @@
 #include "IntervalTimer.hh"
 
 // Custom includes
+#include <senf/Scheduler/Scheduler.hh>
 #include "Module.hh"
 #include "Setup.hh"
 
@@ -77,6 +78,20 @@ SENF_AUTO_TEST_CASE(intervalTimer)
         BOOST_CHECK( true );
 }
 
+SENF_AUTO_TEST_CASE(intervalTimer_virtualTime)
+{
+    senf::scheduler::virtualTime(true);
+    {
+        TimerTest timer (senf::ClockService::in_milliseconds(senf::ClockService::hours(1)), 3);
+        senf::ClockService::clock_type start (senf::ClockService::now());
+        senf::ClockService::clock_type real (senf::ClockService::monotonic());
+        senf::ppi::run();
+        BOOST_CHECK_EQUAL( senf::ClockService::now(), start + senf::ClockService::hours(3) );
+        BOOST_CHECK( senf::ClockService::monotonic() - real < senf::ClockService::seconds(1) );
+    }
+    senf::scheduler::virtualTime(false);
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
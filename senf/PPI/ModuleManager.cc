@@ -105,7 +105,9 @@ prefix_ senf::ppi::ModuleManager::ModuleManager()
       alive_(true),
       initRunner_("senf::ppi::init", membind(&ModuleManager::init, this), scheduler::EventHook::PRE, false)
 {
-    console::sysdir().add("ppi", consoleDir_);
+    // The console is not thread safe: only the main threads network is accessible
+    if (mainThread())
+        console::sysdir().add("ppi", consoleDir_);
 
     consoleDir_
         .add("dump", console::factory::Command(
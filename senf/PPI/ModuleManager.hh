@@ -22,6 +22,7 @@
 #include <deque>
 #include "predecl.hh"
 #include <senf/Scheduler/EventHook.hh>
+#include <senf/Utils/thread_singleton.hh>
 #include <senf/Utils/Console/ScopedDirectory.hh>
 
 //#include "ModuleManager.mpp"
@@ -34,8 +35,13 @@ namespace ppi {
 
         Every module is registered with the ModuleManager. The ModuleManager controls module
         initialization and execution of the network.
+
+        Every thread has its own ModuleManager running its own network on the threads %scheduler
+        (see senf::scheduler::Mailbox for passing work between threads). Only the main threads
+        network is accessible via the console.
       */
     class ModuleManager
+        : public thread_singleton<ModuleManager>
     {
     public:
         //-////////////////////////////////////////////////////////////////////////
@@ -57,7 +63,7 @@ namespace ppi {
         ///\name Structors and default members
         //\{
 
-        static ModuleManager & instance();
+        using thread_singleton<ModuleManager>::instance;
 
         // default default constructor
         // default copy constructor
@@ -107,6 +113,7 @@ namespace ppi {
 
         console::ScopedDirectory<> consoleDir_;
 
+        friend class thread_singleton<ModuleManager>;
         friend class module::Module;
         friend struct Initializable;
     };
@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PacketChannel non-inline non-template implementation */
+
+#include "PacketChannel.hh"
+//#include "PacketChannel.ih"
+
+// Custom includes
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <senf/Utils/Exception.hh>
+#include <senf/Utils/membind.hh>
+
+//#include "PacketChannel.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::PacketChannel
+
+namespace {
+
+    int createEventFd()
+    {
+        int fd (::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+        if (fd < 0)
+            SENF_THROW_SYSTEM_EXCEPTION("eventfd()");
+        return fd;
+    }
+
+    unsigned roundCapacity(unsigned capacity)
+    {
+        unsigned n (1u);
+        while (n < capacity)
+            n <<= 1;
+        return n;
+    }
+
+}
+
+prefix_ senf::ppi::PacketChannel::PacketChannel(unsigned capacity)
+    : mask_ (roundCapacity(capacity) - 1), slots_ (new Packet[mask_ + 1]),
+      dataFd_ (createEventFd()), spaceFd_ (-1),
+      head_ (0u), producerWaiting_ (false), staged_ (0u), tailCache_ (0u),
+      tail_ (0u), consumerWaiting_ (true), headCache_ (0u)
+{
+    try {
+        spaceFd_ = createEventFd();
+    }
+    catch (...) {
+        ::close(dataFd_);
+        throw;
+    }
+}
+
+prefix_ senf::ppi::PacketChannel::~PacketChannel()
+{
+    ::close(dataFd_);
+    ::close(spaceFd_);
+}
+
+// Wakeup protocol: A side about to sleep first announces this in it's 'waiting' flag and then
+// re-checks the ring, the other side first updates the ring and then checks the flag. The
+// sequentially consistent fences between those two steps guarantee, that at least one of the two
+// sides sees the update of the other, so a wakeup is never lost. The flag is cleared with
+// exchange() so only one eventfd write is issued per wait.
+
+prefix_ void senf::ppi::PacketChannel::publish()
+{
+    head_.store(head_.load(std::memory_order_relaxed) + staged_, std::memory_order_release);
+    staged_ = 0;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumerWaiting_.load(std::memory_order_relaxed) && consumerWaiting_.exchange(false))
+        signal(dataFd_);
+}
+
+prefix_ bool senf::ppi::PacketChannel::waitSpace()
+{
+    producerWaiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (full())
+        return true;
+    // The consumer freed some slots in the meantime. If it already took notice of the waiting
+    // flag, this will lead to a single spurious space event.
+    producerWaiting_.exchange(false);
+    return false;
+}
+
+prefix_ void senf::ppi::PacketChannel::popped()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // Wake up the producer only after half of the channel has been drained
+    if (producerWaiting_.load(std::memory_order_relaxed)
+        && head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed) <= mask_ / 2
+        && producerWaiting_.exchange(false))
+        signal(spaceFd_);
+}
+
+prefix_ void senf::ppi::PacketChannel::waitData()
+{
+    clear(dataFd_);
+    consumerWaiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // If the producer published new packets before taking notice of the waiting flag, the
+    // consumer must wake itself up
+    if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_relaxed)
+        && consumerWaiting_.exchange(false))
+        signal(dataFd_);
+}
+
+prefix_ void senf::ppi::PacketChannel::signal(int fd)
+{
+    uint64_t one (1);
+    while (::write(fd, &one, sizeof(one)) < 0)
+        if (errno != EINTR && errno != EAGAIN)
+            SENF_THROW_SYSTEM_EXCEPTION("write(eventfd)");
+}
+
+prefix_ void senf::ppi::PacketChannel::clear(int fd)
+{
+    uint64_t count;
+    if (::read(fd, &count, sizeof(count)) < 0 && errno != EAGAIN && errno != EINTR)
+        SENF_THROW_SYSTEM_EXCEPTION("read(eventfd)");
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::ChannelSink
+
+prefix_ senf::ppi::module::ChannelSink::ChannelSink(PacketChannel & channel)
+    : channel_ (channel), spaceEvent_ (channel.spaceFd_, IOEvent::Read),
+      flushHook_ ("senf::ppi::module::ChannelSink", membind(&ChannelSink::flush, this),
+                  scheduler::EventHook::POST, false),
+      copied_ (0u)
+{
+    noroute(input);
+    input.onRequest(&ChannelSink::request);
+    registerEvent(spaceEvent_, &ChannelSink::space);
+    spaceEvent_.enabled(false);
+}
+
+prefix_ void senf::ppi::module::ChannelSink::request()
+{
+    while (input) {
+        if (SENF_UNLIKELY(channel_.full()) && channel_.waitSpace()) {
+            input.throttle();
+            spaceEvent_.enabled(true);
+            return;
+        }
+        channel_.stage(input());
+        flushHook_.enable();
+    }
+}
+
+prefix_ void senf::ppi::module::ChannelSink::flush()
+{
+    // Packets are only handed over at the end of the scheduler cycle: by then all handles held
+    // by the modules upstream have been released. A packet still referenced elsewhere in this
+    // thread is replaced by a copy, since packet handles must not be shared between threads.
+    // Packet data in external memory (e.g. a held rx ring frame) is moved into the packet here,
+    // since the owner of that memory must only be notified in this thread.
+    unsigned head (channel_.head_.load(std::memory_order_relaxed));
+    for (unsigned i (0); i < channel_.staged_; ++i) {
+        Packet & packet (channel_.slots_[(head + i) & channel_.mask_]);
+        if (SENF_UNLIKELY(packet.is_shared())) {
+            packet = packet.clone();
+            ++ copied_;
+        }
+        else if (SENF_UNLIKELY(packet.data().usingExternalMemory())) {
+            packet.data().releaseExternalMemory();
+            ++ copied_;
+        }
+    }
+    channel_.publish();
+    flushHook_.disable();
+}
+
+prefix_ void senf::ppi::module::ChannelSink::space()
+{
+    PacketChannel::clear(channel_.spaceFd_);
+    spaceEvent_.enabled(false);
+    input.unthrottle();
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::ChannelSource
+
+prefix_ senf::ppi::module::ChannelSource::ChannelSource(PacketChannel & channel, unsigned burst)
+    : channel_ (channel), dataEvent_ (channel.dataFd_, IOEvent::Read), maxBurst_ (burst)
+{
+    registerEvent(dataEvent_, &ChannelSource::read);
+    route(dataEvent_, output);
+}
+
+prefix_ void senf::ppi::module::ChannelSource::read()
+{
+    // The eventfd is only cleared once the channel is empty: if the burst limit is reached or
+    // the output is throttled, the event will fire again as soon as it is (re-)enabled
+    for (unsigned n (0); n < maxBurst_ && output; ++n) {
+        Packet packet (channel_.pop());
+        if (! packet) {
+            channel_.waitData();
+            break;
+        }
+        output(packet);
+    }
+    channel_.popped();
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "PacketChannel.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+
+/** \file
+    \brief PacketChannel public header */
+
+#ifndef HH_SENF_PPI_PacketChannel_
+#define HH_SENF_PPI_PacketChannel_ 1
+
+// Custom includes
+#include <atomic>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <senf/Scheduler/EventHook.hh>
+#include "Connectors.hh"
+#include "Module.hh"
+#include "IOEvent.hh"
+
+//#include "PacketChannel.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+
+    namespace module {
+        class ChannelSink;
+        class ChannelSource;
+    }
+
+    /** \brief Bounded single producer / single consumer packet channel between threads
+
+        A PacketChannel connects two PPI networks running in different threads (each thread runs
+        it's own %scheduler and module network, see \ref sched_threads). The channel is a lock-free
+        ring of \a capacity packet handles. It is not used directly but through a pair of
+        modules: module::ChannelSink is the producer end, module::ChannelSource the consumer
+        end. Each of the modules must be created in the thread it is used in, the channel itself
+        must outlive both modules.
+
+        \code
+        senf::ppi::PacketChannel channel (1024u);
+
+        // RX thread
+        senf::ppi::module::ChannelSink toClassifier (channel);
+        senf::ppi::connect(rxParser, toClassifier);
+        senf::ppi::run();
+
+        // classifier thread
+        senf::ppi::module::ChannelSource fromRx (channel);
+        senf::ppi::connect(fromRx, classifier);
+        senf::ppi::run();
+        \endcode
+
+        Both ends are signaled via an \c eventfd polled by their %scheduler, the channel will only
+        issue a system call, if the peer thread is actually waiting (consumer: the channel ran
+        empty, producer: the channel ran full).
+
+        Throttling is propagated across the thread boundary: If the output of the ChannelSource is
+        throttled, the channel fills up and the input of the ChannelSink is throttled when the
+        channel is full. The ChannelSink is unthrottled again as soon as at least half of the
+        channel is free.
+
+        Packet handles are not thread safe. When handing a packet to the consumer thread, the
+        ChannelSink makes sure no other handle to that packet is left in the producer thread: A
+        packet which is still referenced when it is handed over is copied (see
+        module::ChannelSink::copied()). The same holds for packets referencing external memory
+        (like a zero-copy rx ring frame, see module::ActiveQueueSocketSource::maxHeldFrames()): The
+        memory is released in the producer thread.
+      */
+    class PacketChannel
+        : boost::noncopyable
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        explicit PacketChannel(unsigned capacity = 1024u);
+                                        ///< Create channel
+                                        /**< \param[in] capacity maximum number of packets
+                                                 in transit. Rounded up to the next power of
+                                                 2. */
+        ~PacketChannel();
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+
+        unsigned capacity() const;      ///< Maximum number of packets in the channel
+        unsigned size() const;          ///< Number of packets handed to the consumer
+                                        /**< Packets accepted by the ChannelSink during the
+                                             current %scheduler cycle are not included. May be
+                                             called from any thread. */
+
+    private:
+        // producer
+        bool full();
+        void stage(Packet const & packet);
+        void publish();
+        bool waitSpace();
+
+        // consumer
+        Packet pop();
+        void popped();
+        void waitData();
+
+        static void signal(int fd);
+        static void clear(int fd);
+
+        static unsigned const CacheLine = 64u;
+
+        unsigned mask_;
+        boost::scoped_array<Packet> slots_;
+        int dataFd_;
+        int spaceFd_;
+
+        // the producer and consumer state is kept in separate cache lines
+        char pad0_[CacheLine];
+        std::atomic<unsigned> head_;    // written by the producer: next slot to publish
+        std::atomic<bool> producerWaiting_;
+        unsigned staged_;
+        unsigned tailCache_;
+        char pad1_[CacheLine];
+        std::atomic<unsigned> tail_;    // written by the consumer: next slot to pop
+        std::atomic<bool> consumerWaiting_;
+        unsigned headCache_;
+        char pad2_[CacheLine];
+
+        friend class module::ChannelSink;
+        friend class module::ChannelSource;
+    };
+
+namespace module {
+
+    /** \brief Producer end of a PacketChannel
+
+        All packets received on \a input are handed to the ChannelSource on the other end of the
+        channel. Packets are collected during a %scheduler cycle and are passed to the consumer
+        in a single batch at the end of the cycle.
+
+        \a input is throttled, whenever the channel is full.
+
+        \see PacketChannel
+        \ingroup io_modules
+     */
+    class ChannelSink
+        : public Module
+    {
+        SENF_PPI_MODULE(ChannelSink);
+    public:
+        connector::PassiveInput<> input;
+
+        explicit ChannelSink(PacketChannel & channel);
+
+        PacketChannel & channel() const; ///< Channel fed by this sink
+        unsigned copied() const;        ///< Number of packets copied
+                                        /**< A packet must be copied, if it is still referenced
+                                             in the producer thread when it is handed over to
+                                             the consumer or if it references external
+                                             memory. */
+
+    private:
+        void request();
+        void flush();
+        void space();
+
+        PacketChannel & channel_;
+        IOEvent spaceEvent_;
+        scheduler::EventHook flushHook_;
+        unsigned copied_;
+    };
+
+    /** \brief Consumer end of a PacketChannel
+
+        All packets received from the ChannelSink on the other end of the channel are sent out on
+        \a output. Per wakeup at most \a burst packets are processed.
+
+        \see PacketChannel
+        \ingroup io_modules
+     */
+    class ChannelSource
+        : public Module
+    {
+        SENF_PPI_MODULE(ChannelSource);
+    public:
+        connector::ActiveOutput<> output;
+
+        explicit ChannelSource(PacketChannel & channel, unsigned burst = 64u);
+
+        PacketChannel & channel() const; ///< Channel read by this source
+        unsigned maxBurst() const;      ///< Maximum number of packets sent per wakeup
+        void maxBurst(unsigned burst);  ///< Set maximum number of packets sent per wakeup
+
+    private:
+        void read();
+
+        PacketChannel & channel_;
+        IOEvent dataEvent_;
+        unsigned maxBurst_;
+    };
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "PacketChannel.cci"
+//#include "PacketChannel.ct"
+//#include "PacketChannel.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
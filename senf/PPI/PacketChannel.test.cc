@@ -0,0 +1,245 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PacketChannel unit tests */
+
+#include "PacketChannel.hh"
+
+// Custom includes
+#include <thread>
+#include <senf/Packets/PacketInfo.hh>
+#include <senf/Scheduler/Scheduler.hh>
+#include "DebugModules.hh"
+#include "Setup.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace debug = senf::ppi::module::debug;
+namespace ppi = senf::ppi;
+namespace connector = senf::ppi::connector;
+namespace module = senf::ppi::module;
+namespace scheduler = senf::scheduler;
+
+namespace {
+
+    void run(senf::ClockService::clock_type t)
+    {
+        scheduler::TimerEvent timeout (
+                "test-timeout", &scheduler::terminate, scheduler::now() + t);
+        ppi::run();
+    }
+
+    // Packets submitted from outside the scheduler are handed over at the end of the first
+    // scheduler cycle, which only ends with the timeout of the first run
+    void run()
+    {
+        run(senf::ClockService::milliseconds(50));
+        run(senf::ClockService::milliseconds(50));
+    }
+
+    senf::Packet makePacket(unsigned i)
+    {
+        senf::PacketData::byte data[] = { senf::PacketData::byte(i) };
+        return senf::DataPacket::create(data);
+    }
+
+    class CountingSink
+        : public module::Module
+    {
+        SENF_PPI_MODULE(CountingSink);
+    public:
+        connector::PassiveInput<> input;
+
+        unsigned expected;
+        unsigned received;
+        unsigned misordered;
+
+        explicit CountingSink(unsigned n)
+            : expected (n), received (0u), misordered (0u)
+        {
+            noroute(input);
+            input.onRequest(&CountingSink::request);
+        }
+
+    private:
+        void request()
+        {
+            senf::Packet packet (input());
+            if (packet.data()[0] != (received & 0xff))
+                ++ misordered;
+            if (++ received == expected)
+                scheduler::terminate();
+        }
+    };
+
+}
+
+SENF_AUTO_TEST_CASE(packetChannel)
+{
+    ppi::PacketChannel channel (3u);
+    BOOST_CHECK_EQUAL( channel.capacity(), 4u );
+
+    debug::ActiveSource source;
+    module::ChannelSink channelSink (channel);
+    module::ChannelSource channelSource (channel);
+    debug::PassiveSink sink;
+
+    ppi::connect( source, channelSink );
+    ppi::connect( channelSource, sink );
+    ppi::init();
+
+    // packets are handed over at the end of the scheduler cycle
+    for (unsigned i (0); i < 3u; ++i)
+        source.submit(makePacket(i));
+    BOOST_CHECK_EQUAL( channel.size(), 0u );
+    run();
+    BOOST_CHECK_EQUAL( channel.size(), 0u );
+    BOOST_REQUIRE_EQUAL( sink.size(), 3u );
+    for (unsigned i (0); i < 3u; ++i)
+        BOOST_CHECK_EQUAL( sink.pop_front().data()[0], i );
+
+    // a throttled consumer throttles the producer once the channel is full
+    sink.input.throttle();
+    for (unsigned i (0); i < 5u; ++i) {
+        BOOST_CHECK( source );
+        source.submit(makePacket(i));
+    }
+    BOOST_CHECK( ! source );
+    run();
+    BOOST_CHECK_EQUAL( channel.size(), 4u );
+    BOOST_CHECK_EQUAL( sink.size(), 0u );
+    BOOST_CHECK( ! source );
+
+    sink.input.unthrottle();
+    run();
+    BOOST_CHECK( source );
+    BOOST_CHECK_EQUAL( channel.size(), 0u );
+    BOOST_REQUIRE_EQUAL( sink.size(), 5u );
+    for (unsigned i (0); i < 5u; ++i)
+        BOOST_CHECK_EQUAL( sink.pop_front().data()[0], i );
+
+    // packets still referenced are copied (this includes the last packet dequeued from the
+    // input queue above)
+    unsigned copied (channelSink.copied());
+    senf::Packet p (makePacket(42u));
+    source.submit(p);
+    run();
+    BOOST_CHECK_EQUAL( channelSink.copied(), copied + 1 );
+    BOOST_REQUIRE_EQUAL( sink.size(), 1u );
+    BOOST_CHECK( ! (sink.front() == p) );
+    BOOST_CHECK_EQUAL( sink.pop_front().data()[0], 42u );
+}
+
+#ifndef SENF_PACKET_STD_CONTAINER
+
+namespace {
+
+    struct FrameOwner : public senf::PacketVector::ExternalMemoryOwner
+    {
+        FrameOwner() : released (0u) {}
+        virtual void externalMemoryReleased(senf::PacketVector::value_type *)
+            { ++ released; }
+        unsigned released;
+    };
+
+}
+
+SENF_AUTO_TEST_CASE(packetChannel_externalMemory)
+{
+    ppi::PacketChannel channel (4u);
+    debug::ActiveSource source;
+    module::ChannelSink channelSink (channel);
+    module::ChannelSource channelSource (channel);
+    debug::PassiveSink sink;
+    ppi::connect( source, channelSink );
+    ppi::connect( channelSource, sink );
+    ppi::init();
+
+    // like a held rx ring frame, the packet data is owned by the producer side. It must be
+    // released by the producer before the packet is handed over
+    senf::PacketData::byte frame[] = { 1u, 2u, 3u, 4u };
+    FrameOwner owner;
+    {
+        senf::Packet p (senf::DataPacket::create(frame, sizeof(frame), sizeof(frame), 0u));
+        BOOST_REQUIRE( senf::PacketInfo(p).externalMemoryOwner(&owner) );
+        source.submit(p);
+    }
+    unsigned copied (channelSink.copied());
+    run();
+    BOOST_CHECK_EQUAL( channelSink.copied(), copied + 1 );
+    BOOST_REQUIRE_EQUAL( sink.size(), 1u );
+    BOOST_CHECK_EQUAL( owner.released, 1u );
+    BOOST_CHECK( ! sink.front().data().usingExternalMemory() );
+    BOOST_CHECK_EQUAL( sink.front().size(), sizeof(frame) );
+    BOOST_CHECK_EQUAL( sink.pop_front().data()[3], 4u );
+    BOOST_CHECK_EQUAL( owner.released, 1u );
+}
+
+#endif
+
+SENF_AUTO_TEST_CASE(packetChannel_threads)
+{
+    unsigned const count (10000u);
+    ppi::PacketChannel channel (16u);
+    unsigned received (0u);
+    unsigned misordered (0u);
+    scheduler::Mailbox mailbox ("packetChannel_threads");
+
+    std::thread consumer ([&] () {
+            module::ChannelSource channelSource (channel, 4u);
+            CountingSink sink (count);
+            ppi::connect( channelSource, sink );
+            run(senf::ClockService::seconds(10));
+            received = sink.received;
+            misordered = sink.misordered;
+            mailbox.post(&scheduler::terminate);
+        });
+
+    {
+        debug::ActiveSource source;
+        module::ChannelSink channelSink (channel);
+        ppi::connect( source, channelSink );
+        unsigned sent (0u);
+        // submit packets as long as the channel sink is not throttled
+        scheduler::IdleEvent producer ("packetChannel_threads", [&] () {
+                while (source && sent < count)
+                    source.submit(makePacket(sent++));
+            });
+        run(senf::ClockService::seconds(10));
+        BOOST_CHECK_EQUAL( sent, count );
+        BOOST_CHECK( channelSink.copied() < count );
+    }
+
+    consumer.join();
+    BOOST_CHECK_EQUAL( received, count );
+    BOOST_CHECK_EQUAL( misordered, 0u );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
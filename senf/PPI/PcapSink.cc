@@ -0,0 +1,224 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PcapSink non-inline non-template implementation */
+
+#include "PcapSink.hh"
+//#include "PcapSink.ih"
+
+// Custom includes
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <boost/lexical_cast.hpp>
+#include <senf/Utils/Exception.hh>
+#include "SocketSource.hh"
+
+//#include "PcapSink.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    struct PcapFileHeader
+    {
+        boost::uint32_t magic;
+        boost::uint16_t versionMajor;
+        boost::uint16_t versionMinor;
+        boost::int32_t thisZone;
+        boost::uint32_t sigFigs;
+        boost::uint32_t snapLen;
+        boost::uint32_t linkType;
+    };
+
+    struct PcapRecordHeader
+    {
+        boost::uint32_t tsSec;
+        boost::uint32_t tsNsec;
+        boost::uint32_t inclLen;
+        boost::uint32_t origLen;
+    };
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::PcapSink
+
+prefix_ senf::ppi::module::PcapSink::PcapSink(std::string const & path, boost::uint32_t linkType,
+                                              boost::uint32_t snapLen, unsigned bufferSize)
+    : path_ (path), linkType_ (linkType), snapLen_ (snapLen), out_ (bufferSize),
+      maxFileSize_ (0u), fileSize_ (0u), maxFiles_ (0u), file_ (0u), packets_ (0u),
+      epoch_ (ClockService::from_time_t(0))
+{
+    noroute(input);
+    input.onRequest(&PcapSink::write);
+    open();
+}
+
+prefix_ void senf::ppi::module::PcapSink::rotate(boost::uint64_t maxFileSize, unsigned maxFiles)
+{
+    maxFileSize_ = maxFileSize;
+    maxFiles_ = maxFiles;
+}
+
+prefix_ void senf::ppi::module::PcapSink::flush()
+{
+    out_.flush();
+}
+
+prefix_ std::string senf::ppi::module::PcapSink::file()
+    const
+{
+    return file_ == 0u ? path_ : path_ + "." + boost::lexical_cast<std::string>(file_);
+}
+
+prefix_ unsigned long senf::ppi::module::PcapSink::packets()
+    const
+{
+    return packets_;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// private members
+
+prefix_ void senf::ppi::module::PcapSink::open()
+{
+    out_.open(file());
+
+    PcapFileHeader header;
+    header.magic = 0xa1b23c4du;         // nanosecond resolution
+    header.versionMajor = 2u;
+    header.versionMinor = 4u;
+    header.thisZone = 0;
+    header.sigFigs = 0u;
+    header.snapLen = snapLen_;
+    header.linkType = linkType_;
+    out_.write(&header, sizeof(header));
+    fileSize_ = sizeof(header);
+}
+
+prefix_ void senf::ppi::module::PcapSink::write()
+{
+    Packet const & packet (input());
+    boost::uint32_t size (std::min<boost::uint32_t>(packet.size(), snapLen_));
+    std::size_t length (sizeof(PcapRecordHeader) + size);
+
+    if (maxFileSize_ > 0u && fileSize_ + length > maxFileSize_
+        && fileSize_ > sizeof(PcapFileHeader)) {
+        out_.flush();
+        file_ = maxFiles_ > 0u ? (file_ + 1u) % maxFiles_ : file_ + 1u;
+        open();
+    }
+
+    ClockService::clock_type timestamp (packet.annotation<ReadTimestamp>().value);
+    if (timestamp == ClockService::clock_type(0))
+        timestamp = ClockService::now();
+    boost::uint64_t ns (ClockService::in_nanoseconds(timestamp - epoch_));
+
+    PcapRecordHeader header;
+    header.tsSec = ns / 1000000000u;
+    header.tsNsec = ns % 1000000000u;
+    header.inclLen = size;
+    header.origLen = packet.size();
+
+    if (out_.used + length > out_.buffer.size())
+        out_.flush();
+    if (length > out_.buffer.size()) {
+        // does not fit into the buffer at all
+        out_.writeAll(&header, sizeof(header));
+        out_.writeAll(&(*packet.data().begin()), size);
+    }
+    else {
+        out_.write(&header, sizeof(header));
+        if (size > 0u)
+            out_.write(&(*packet.data().begin()), size);
+    }
+    fileSize_ += length;
+    ++ packets_;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::PcapSink::File
+
+prefix_ senf::ppi::module::PcapSink::File::File(unsigned bufferSize)
+    : fd (-1), buffer (std::max(bufferSize, unsigned(sizeof(PcapFileHeader)))), used (0u)
+{}
+
+prefix_ senf::ppi::module::PcapSink::File::~File()
+{
+    try {
+        flush();
+    }
+    catch (std::exception &) {}
+    if (fd >= 0)
+        ::close(fd);
+}
+
+prefix_ void senf::ppi::module::PcapSink::File::open(std::string const & name_)
+{
+    int newFd (::open(name_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    if (newFd < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("::open(") << name_ << ")";
+    if (fd >= 0)
+        ::close(fd);
+    fd = newFd;
+    name = name_;
+    used = 0u;
+}
+
+prefix_ void senf::ppi::module::PcapSink::File::write(void const * data, std::size_t size)
+{
+    ::memcpy(&buffer[used], data, size);
+    used += size;
+}
+
+prefix_ void senf::ppi::module::PcapSink::File::flush()
+{
+    if (used > 0u) {
+        writeAll(&buffer[0], used);
+        used = 0u;
+    }
+}
+
+prefix_ void senf::ppi::module::PcapSink::File::writeAll(void const * data, std::size_t size)
+{
+    char const * p (static_cast<char const *>(data));
+    while (size > 0u) {
+        ssize_t rv (::write(fd, p, size));
+        if (rv < 0) {
+            if (errno == EINTR)
+                continue;
+            SENF_THROW_SYSTEM_EXCEPTION("::write(") << name << ")";
+        }
+        p += rv;
+        size -= rv;
+    }
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "PcapSink.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
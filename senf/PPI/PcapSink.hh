@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PcapSink public header */
+
+#ifndef HH_SENF_PPI_PcapSink_
+#define HH_SENF_PPI_PcapSink_ 1
+
+// Custom includes
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+#include <senf/Scheduler/ClockService.hh>
+#include "Module.hh"
+#include "Connectors.hh"
+
+//#include "PcapSink.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+namespace module {
+
+    /** \brief Write packets to a pcap capture file
+
+        PcapSink writes all packets received on it's \a input to the pcap file \a path. The file is
+        written in the classic pcap format with nanosecond timestamp resolution in host byte order
+        (magic number \c 0xa1b23c4d), which is supported by all current versions of tcpdump and
+        wireshark. The timestamp is taken from the senf::ppi::ReadTimestamp annotation (see
+        PcapSource or ActiveSocketSource). If the annotation is not set, the current time is used.
+
+        Packets are collected in a buffer of \a bufferSize bytes which is written out with a single
+        system call as soon as it is full, when calling flush() or when the module is destroyed.
+
+        The file may be rotated whenever it would exceed a maximum size (see rotate()). The first
+        file is named \a path, the following files <em>path</em>.1, <em>path</em>.2 and so on.
+
+        \code
+        senf::ppi::module::ActiveSocketSource<> source (handle);
+        senf::ppi::module::PcapSink sink ("capture.pcap");
+        sink.rotate(100u*1024u*1024u, 10u); // ring of 10 files of 100MB
+        senf::ppi::connect(source, sink);
+        \endcode
+
+        \throws senf::SystemException if the file cannot be created or written
+
+        \ingroup io_modules
+     */
+    class PcapSink
+        : public Module
+    {
+        SENF_PPI_MODULE(PcapSink);
+    public:
+        static boost::uint32_t const LINKTYPE_ETHERNET = 1u;
+
+        connector::PassiveInput<> input;
+
+        explicit PcapSink(std::string const & path, boost::uint32_t linkType = LINKTYPE_ETHERNET,
+                          boost::uint32_t snapLen = 65535u, unsigned bufferSize = 1024u*1024u);
+                                        ///< Create capture file \a path
+                                        /**< \param[in] path name of the capture file
+                                             \param[in] linkType pcap link type of the packets
+                                             \param[in] snapLen packets are truncated to this
+                                                 size
+                                             \param[in] bufferSize size of the write buffer */
+
+        void rotate(boost::uint64_t maxFileSize, unsigned maxFiles = 0u);
+                                        ///< Enable file rotation
+                                        /**< As soon as the current file would grow beyond \a
+                                             maxFileSize bytes, the next file is started. If \a
+                                             maxFiles is not 0, the files are used as a ring,
+                                             overwriting the oldest file. A \a maxFileSize of 0
+                                             disables rotation. */
+        void flush();                   ///< Write out buffered packets
+
+        std::string file() const;       ///< Name of the file currently written
+        unsigned long packets() const;  ///< Number of packets written
+
+    private:
+        // Buffered output file, flushed and closed on destruction
+        struct File : boost::noncopyable
+        {
+            explicit File(unsigned bufferSize);
+            ~File();
+
+            void open(std::string const & name);
+            void write(void const * data, std::size_t size);
+            void flush();
+            void writeAll(void const * data, std::size_t size);
+
+            std::string name;
+            int fd;
+            std::vector<boost::uint8_t> buffer;
+            std::size_t used;
+        };
+
+        void write();
+        void open();
+
+        std::string path_;
+        boost::uint32_t linkType_;
+        boost::uint32_t snapLen_;
+        File out_;
+        boost::uint64_t maxFileSize_;
+        boost::uint64_t fileSize_;
+        unsigned maxFiles_;
+        unsigned file_;
+        unsigned long packets_;
+        ClockService::clock_type epoch_;
+    };
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+//#include "PcapSink.cci"
+//#include "PcapSink.ct"
+//#include "PcapSink.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PcapSink unit tests */
+
+#include "PcapSink.hh"
+
+// Custom includes
+#include <fstream>
+#include <iterator>
+#include <boost/filesystem/operations.hpp>
+#include <senf/Packets/Packets.hh>
+#include "SocketSource.hh"
+#include "DebugModules.hh"
+#include "Setup.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    std::string readFile(std::string const & name)
+    {
+        std::ifstream f (name.c_str(), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+
+    boost::uint32_t get32(std::string const & data, std::string::size_type offset)
+    {
+        boost::uint32_t v;
+        data.copy(reinterpret_cast<char *>(&v), sizeof(v), offset);
+        return v;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(pcapSink)
+{
+    std::string filename ("/tmp/senf_pcapSink_test.pcap");
+    senf::ppi::module::debug::ActiveSource source;
+    {
+        senf::ppi::module::PcapSink sink (filename, 1u, 4u);
+        senf::ppi::connect(source, sink);
+        senf::ppi::init();
+
+        senf::Packet p1 (senf::DataPacket::create(std::string("abcdef")));
+        p1.annotation<senf::ppi::ReadTimestamp>().value =
+            senf::ClockService::from_time_t(1000) + senf::ClockService::nanoseconds(123);
+        source.submit(p1);
+        source.submit(senf::DataPacket::create(std::string("xy")));
+        BOOST_CHECK_EQUAL( sink.packets(), 2u );
+        BOOST_CHECK_EQUAL( sink.file(), filename );
+        // buffered
+        BOOST_CHECK_EQUAL( readFile(filename).size(), 0u );
+        sink.flush();
+    }
+
+    std::string data (readFile(filename));
+    BOOST_REQUIRE_EQUAL( data.size(), 24u + 16u + 4u + 16u + 2u );
+    BOOST_CHECK_EQUAL( get32(data, 0), 0xa1b23c4du );
+    BOOST_CHECK_EQUAL( get32(data, 16), 4u );
+    BOOST_CHECK_EQUAL( get32(data, 20), 1u );
+    BOOST_CHECK_EQUAL( get32(data, 24), 1000u );
+    BOOST_CHECK_EQUAL( get32(data, 28), 123u );
+    BOOST_CHECK_EQUAL( get32(data, 32), 4u );
+    BOOST_CHECK_EQUAL( get32(data, 36), 6u );
+    BOOST_CHECK_EQUAL( data.substr(40, 4), "abcd" );
+    BOOST_CHECK_EQUAL( get32(data, 52), 2u );
+    BOOST_CHECK_EQUAL( data.substr(60), "xy" );
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+}
+
+SENF_AUTO_TEST_CASE(pcapSink_rotate)
+{
+    std::string filename ("/tmp/senf_pcapSink_rotate.pcap");
+    senf::ppi::module::debug::ActiveSource source;
+    senf::ppi::module::PcapSink sink (filename, 1u, 65535u, 64u);
+    senf::ppi::connect(source, sink);
+    senf::ppi::init();
+
+    // every file has room for two 10 byte packets
+    sink.rotate(24u + 2u * (16u + 10u), 2u);
+    for (unsigned i (0); i < 5; ++i)
+        source.submit(senf::DataPacket::create(10u));
+    BOOST_CHECK_EQUAL( sink.packets(), 5u );
+    BOOST_CHECK_EQUAL( sink.file(), filename );
+    sink.flush();
+    BOOST_CHECK_EQUAL( readFile(filename).size(), 24u + 16u + 10u );
+    BOOST_CHECK_EQUAL( readFile(filename + ".1").size(), 24u + 2u * (16u + 10u) );
+    BOOST_CHECK( ! boost::filesystem::exists(filename + ".2") );
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename + ".1") );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
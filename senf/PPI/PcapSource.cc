@@ -0,0 +1,388 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PcapSource non-inline non-template implementation */
+
+#include "PcapSource.hh"
+#include "PcapSource.ih"
+
+// Custom includes
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <byteswap.h>
+
+//#include "PcapSource.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    boost::uint32_t const PCAP_MAGIC          = 0xa1b2c3d4u;
+    boost::uint32_t const PCAP_MAGIC_SWAPPED  = 0xd4c3b2a1u;
+    boost::uint32_t const PCAP_NSEC           = 0xa1b23c4du;
+    boost::uint32_t const PCAP_NSEC_SWAPPED   = 0x4d3cb2a1u;
+    boost::uint32_t const PCAPNG_BYTE_ORDER   = 0x1a2b3c4du;
+    boost::uint32_t const PCAPNG_BYTE_ORDER_SWAPPED = 0x4d3c2b1au;
+
+    // pcapng block types. The section header block type is a palindrome and may therefore be
+    // read before the byte order is known
+    boost::uint32_t const PCAPNG_SHB = 0x0a0d0d0au;
+    boost::uint32_t const PCAPNG_IDB = 0x00000001u;
+    boost::uint32_t const PCAPNG_SPB = 0x00000003u;
+    boost::uint32_t const PCAPNG_EPB = 0x00000006u;
+
+    boost::uint16_t const PCAPNG_OPT_ENDOFOPT = 0u;
+    boost::uint16_t const PCAPNG_IF_TSRESOL   = 9u;
+
+    boost::uint32_t native32(boost::uint8_t const * p)
+    {
+        boost::uint32_t v;
+        ::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::detail::PcapMapping
+
+prefix_ senf::ppi::detail::PcapMapping * senf::ppi::detail::PcapMapping::map(std::string const & path)
+{
+    int fd (::open(path.c_str(), O_RDONLY));
+    if (fd < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("::open(") << path << ")";
+    struct ::stat st;
+    if (::fstat(fd, &st) < 0) {
+        ::close(fd);
+        SENF_THROW_SYSTEM_EXCEPTION("::fstat(") << path << ")";
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        throw PcapFormatException("empty capture file: " + path);
+    }
+    // A private writable mapping allows packets to be changed in place without changing the file
+    void * data (::mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+    ::close(fd);
+    if (data == MAP_FAILED)
+        SENF_THROW_SYSTEM_EXCEPTION("::mmap(") << path << ")";
+    ::madvise(data, st.st_size, MADV_SEQUENTIAL);
+    return new PcapMapping(static_cast<boost::uint8_t *>(data), st.st_size);
+}
+
+prefix_ senf::ppi::detail::PcapMapping::PcapMapping(boost::uint8_t * data, std::size_t size)
+    : data_ (data), size_ (size), refcount_ (1u)
+{}
+
+prefix_ senf::ppi::detail::PcapMapping::~PcapMapping()
+{
+    ::munmap(data_, size_);
+}
+
+prefix_ void senf::ppi::detail::PcapMapping::ref()
+{
+    ++ refcount_;
+}
+
+prefix_ void senf::ppi::detail::PcapMapping::release()
+{
+    unref();
+}
+
+prefix_ void senf::ppi::detail::PcapMapping::unref()
+{
+    if (-- refcount_ == 0u)
+        delete this;
+}
+
+#ifndef SENF_PACKET_STD_CONTAINER
+
+prefix_ void senf::ppi::detail::PcapMapping::externalMemoryReleased(PacketVector::value_type *)
+{
+    unref();
+}
+
+#endif
+
+prefix_ boost::uint8_t * senf::ppi::detail::PcapMapping::begin()
+    const
+{
+    return data_;
+}
+
+prefix_ boost::uint8_t * senf::ppi::detail::PcapMapping::end()
+    const
+{
+    return data_ + size_;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::detail::PcapReader
+
+prefix_ senf::ppi::detail::PcapReader::PcapReader(std::string const & path)
+    : path_ (path), mapping_ (PcapMapping::map(path)), pos_ (0), pcapng_ (false),
+      swapped_ (false), linkType_ (0u)
+{
+    try {
+        rewind();
+    }
+    catch (...) {
+        mapping_->release();
+        throw;
+    }
+}
+
+prefix_ senf::ppi::detail::PcapReader::~PcapReader()
+{
+    mapping_->release();
+}
+
+prefix_ void senf::ppi::detail::PcapReader::rewind()
+{
+    if (pos_) {
+        // Packets of the previous pass may have been changed in place and may still be alive:
+        // Replay from a fresh mapping of the file. The old mapping is released together with
+        // its last packet
+        PcapMapping * mapping (PcapMapping::map(path_));
+        mapping_->release();
+        mapping_ = mapping;
+    }
+    pos_ = mapping_->begin();
+    interfaces_.clear();
+    if (mapping_->end() - pos_ < 24)
+        throw PcapFormatException("not a capture file: " + path_);
+
+    boost::uint32_t magic (native32(pos_));
+    if (magic == PCAPNG_SHB) {
+        pcapng_ = true;
+        // Find the link type of the first interface
+        boost::uint8_t * end (mapping_->end());
+        for (boost::uint8_t * p (pos_); end - p >= 12 && interfaces_.empty(); ) {
+            if (native32(p) == PCAPNG_SHB)
+                section(p);
+            boost::uint32_t length (get32(p + 4));
+            if (length < 12u || length % 4u || length > boost::uint32_t(end - p))
+                break;
+            if (get32(p) == PCAPNG_IDB)
+                interface(p, length);
+            p += length;
+        }
+        linkType_ = interfaces_.empty() ? 0u : interfaces_.front().linkType;
+        interfaces_.clear();
+        return;
+    }
+
+    pcapng_ = false;
+    bool nsec (false);
+    switch (magic) {
+    case PCAP_MAGIC:         swapped_ = false; break;
+    case PCAP_MAGIC_SWAPPED: swapped_ = true;  break;
+    case PCAP_NSEC:          swapped_ = false; nsec = true; break;
+    case PCAP_NSEC_SWAPPED:  swapped_ = true;  nsec = true; break;
+    default:
+        throw PcapFormatException("not a capture file: " + path_);
+    }
+    Interface ifc;
+    ifc.snapLen = get32(pos_ + 16);
+    ifc.linkType = get32(pos_ + 20);
+    ifc.binary = false;
+    ifc.resolution = nsec ? 9u : 6u;
+    interfaces_.push_back(ifc);
+    linkType_ = ifc.linkType;
+    pos_ += 24;
+}
+
+prefix_ bool senf::ppi::detail::PcapReader::next(Record & record)
+{
+    return pcapng_ ? nextPcapng(record) : nextPcap(record);
+}
+
+prefix_ boost::uint32_t senf::ppi::detail::PcapReader::linkType()
+    const
+{
+    return linkType_;
+}
+
+prefix_ senf::ppi::detail::PcapMapping & senf::ppi::detail::PcapReader::mapping()
+    const
+{
+    return *mapping_;
+}
+
+prefix_ boost::uint16_t senf::ppi::detail::PcapReader::get16(boost::uint8_t const * p)
+    const
+{
+    boost::uint16_t v;
+    ::memcpy(&v, p, sizeof(v));
+    return swapped_ ? bswap_16(v) : v;
+}
+
+prefix_ boost::uint32_t senf::ppi::detail::PcapReader::get32(boost::uint8_t const * p)
+    const
+{
+    boost::uint32_t v (native32(p));
+    return swapped_ ? bswap_32(v) : v;
+}
+
+prefix_ boost::uint64_t senf::ppi::detail::PcapReader::nanoseconds(boost::uint64_t ts,
+                                                                   Interface const & ifc)
+    const
+{
+    if (ifc.binary) {
+        if (ifc.resolution >= 64u)
+            return 0u;
+        boost::uint64_t frac (ts & ((boost::uint64_t(1u) << ifc.resolution) - 1u));
+        return (ts >> ifc.resolution) * 1000000000u
+            + boost::uint64_t((static_cast<unsigned __int128>(frac) * 1000000000u)
+                              >> ifc.resolution);
+    }
+    if (ifc.resolution > 9u + 19u)
+        return 0u;
+    boost::uint64_t scale (1u);
+    for (unsigned i (std::min(ifc.resolution, 9u)); i < std::max(ifc.resolution, 9u); ++i)
+        scale *= 10u;
+    return ifc.resolution <= 9u ? ts * scale : ts / scale;
+}
+
+prefix_ bool senf::ppi::detail::PcapReader::nextPcap(Record & record)
+{
+    boost::uint8_t * end (mapping_->end());
+    if (end - pos_ < 16)
+        return false;
+    boost::uint32_t size (get32(pos_ + 8));
+    if (size > boost::uint32_t(end - pos_ - 16))
+        // truncated file
+        return false;
+    Interface const & ifc (interfaces_.front());
+    record.data = pos_ + 16;
+    record.size = size;
+    record.origSize = get32(pos_ + 12);
+    record.timestamp = boost::uint64_t(get32(pos_)) * 1000000000u
+        + boost::uint64_t(get32(pos_ + 4)) * (ifc.resolution == 9u ? 1u : 1000u);
+    record.linkType = ifc.linkType;
+    pos_ += 16 + size;
+    return true;
+}
+
+prefix_ bool senf::ppi::detail::PcapReader::nextPcapng(Record & record)
+{
+    boost::uint8_t * end (mapping_->end());
+    while (end - pos_ >= 12) {
+        boost::uint8_t * block (pos_);
+        if (native32(block) == PCAPNG_SHB)
+            section(block);
+        boost::uint32_t length (get32(block + 4));
+        if (length < 12u || length % 4u || length > boost::uint32_t(end - block))
+            // corrupt or truncated file
+            return false;
+        pos_ += length;
+
+        switch (get32(block)) {
+        case PCAPNG_IDB:
+            interface(block, length);
+            break;
+
+        case PCAPNG_EPB: {
+            if (length < 32u)
+                break;
+            boost::uint32_t id (get32(block + 8));
+            boost::uint32_t size (get32(block + 20));
+            if (id >= interfaces_.size() || size > length - 32u)
+                break;
+            record.data = block + 28;
+            record.size = size;
+            record.origSize = get32(block + 24);
+            record.timestamp = nanoseconds(
+                (boost::uint64_t(get32(block + 12)) << 32) | get32(block + 16), interfaces_[id]);
+            record.linkType = interfaces_[id].linkType;
+            return true;
+        }
+
+        case PCAPNG_SPB: {
+            if (length < 16u || interfaces_.empty())
+                break;
+            boost::uint32_t size (get32(block + 8));
+            size = std::min(size, length - 16u);
+            if (interfaces_.front().snapLen > 0u)
+                size = std::min(size, interfaces_.front().snapLen);
+            record.data = block + 12;
+            record.size = size;
+            record.origSize = get32(block + 8);
+            // simple packet blocks don't carry a timestamp
+            record.timestamp = 0u;
+            record.linkType = interfaces_.front().linkType;
+            return true;
+        }
+
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
+prefix_ void senf::ppi::detail::PcapReader::section(boost::uint8_t const * block)
+{
+    switch (native32(block + 8)) {
+    case PCAPNG_BYTE_ORDER:         swapped_ = false; break;
+    case PCAPNG_BYTE_ORDER_SWAPPED: swapped_ = true;  break;
+    default:
+        throw PcapFormatException("invalid pcapng section header: " + path_);
+    }
+    // interface ids are local to a section
+    interfaces_.clear();
+}
+
+prefix_ void senf::ppi::detail::PcapReader::interface(boost::uint8_t const * block,
+                                                      boost::uint32_t length)
+{
+    if (length < 20u)
+        return;
+    Interface ifc;
+    ifc.linkType = get16(block + 8);
+    ifc.snapLen = get32(block + 12);
+    ifc.binary = false;
+    ifc.resolution = 6u;
+    boost::uint8_t const * end (block + length - 4);
+    for (boost::uint8_t const * p (block + 16); end - p >= 4; ) {
+        boost::uint16_t code (get16(p));
+        boost::uint16_t size (get16(p + 2));
+        if (code == PCAPNG_OPT_ENDOFOPT || size > end - p - 4)
+            break;
+        if (code == PCAPNG_IF_TSRESOL && size >= 1u) {
+            ifc.binary = p[4] & 0x80u;
+            ifc.resolution = p[4] & 0x7fu;
+        }
+        p += 4 + ((size + 3u) & ~3u);
+    }
+    interfaces_.push_back(ifc);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "PcapSource.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PcapSource public header */
+
+#ifndef HH_SENF_PPI_PcapSource_
+#define HH_SENF_PPI_PcapSource_ 1
+
+// Custom includes
+#include <senf/Utils/Exception.hh>
+#include "SocketSource.hh"
+#include "Module.hh"
+#include "Connectors.hh"
+#include "IdleEvent.hh"
+
+#include "PcapSource.ih"
+//#include "PcapSource.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+
+    /** \brief Invalid or unsupported capture file */
+    struct PcapFormatException : public senf::Exception
+    { PcapFormatException(std::string const & descr) : senf::Exception(descr) {} };
+
+namespace module {
+
+    /** \brief Read packets from a pcap or pcapng capture file
+
+        PcapSource maps the capture file \a path into memory and sends all packets found in the
+        file on it's \a output, as fast as the output is not throttled. Classic pcap files as well
+        as pcapng files are supported (see \ref ppi::detail::PcapReader).
+
+        The packets are created as \a Packet (which defaults to senf::DataPacket) directly
+        referencing the mapped file (zero-copy, see senf::PacketVector::ExternalMemoryOwner). The
+        file is mapped privately: Changing packet data in place will not change the file. Every
+        pass over the file (see loops() and rewind()) uses a new mapping, so a replay always sends
+        the file contents. A mapping is released when it is not used for reading any more and the
+        last packet referencing it is gone.
+
+        The capture time of every packet is stored in the senf::ppi::ReadTimestamp annotation,
+        converted to the senf::ClockService clock (see senf::ClockService::from_time_t()).
+
+        \code
+        senf::ppi::module::PcapSource<senf::EthernetPacket> source ("capture.pcapng");
+        senf::ppi::module::PassiveSocketSink<> sink (handle);
+        senf::ppi::connect(source, sink);
+        senf::ppi::run();
+        \endcode
+
+        The file is read in bursts of at most \a burst packets per idle event (see IdleEvent).
+        When the end of the file is reached, the module stops sending packets. It will restart at
+        the beginning of the file instead, as long as the file has not been sent loops() times.
+
+        \throws senf::SystemException if the file cannot be opened or mapped
+        \throws senf::ppi::PcapFormatException if the file is not a valid capture file
+
+        \ingroup io_modules
+     */
+    template <class Packet=DataPacket>
+    class PcapSource
+        : public Module
+    {
+        SENF_PPI_MODULE(PcapSource);
+    public:
+        typedef Packet PacketType;
+
+        connector::ActiveOutput<Packet> output;
+
+        explicit PcapSource(std::string const & path, unsigned burst = 16u);
+
+        boost::uint32_t linkType() const; ///< Link type of the capture file
+                                        /**< For pcapng files, this is the link type of the first
+                                             interface. */
+
+        unsigned loops() const;         ///< Number of times the file is sent
+        void loops(unsigned n);         ///< Set number of times the file is sent
+                                        /**< 0 will repeat the file forever. Defaults to 1 */
+
+        unsigned maxBurst() const;      ///< Maximum number of packets sent per event
+        void maxBurst(unsigned burst);  ///< Set maximum number of packets sent per event
+
+        bool eof() const;               ///< \c true, if all packets have been sent
+        unsigned long packets() const;  ///< Number of packets sent
+        void rewind();                  ///< Restart sending the file
+
+    private:
+        bool next(ppi::detail::PcapReader::Record & record);
+        void read();
+
+        ppi::detail::PcapReader reader_;
+        IdleEvent event_;
+        unsigned maxBurst_;
+        unsigned loops_;
+        unsigned pass_;
+        bool eof_;
+        unsigned long packets_;
+        ClockService::clock_type epoch_;
+    };
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+//#include "PcapSource.cci"
+#include "PcapSource.ct"
+#include "PcapSource.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,285 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PcapSource unit tests */
+
+#include "PcapSource.hh"
+
+// Custom includes
+#include <fstream>
+#include <byteswap.h>
+#include <boost/filesystem/operations.hpp>
+#include <senf/Packets/Packets.hh>
+#include <senf/Scheduler/Scheduler.hh>
+#include "PcapSink.hh"
+#include "DebugModules.hh"
+#include "Setup.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    namespace ppi = senf::ppi;
+    namespace module = senf::ppi::module;
+    namespace debug = module::debug;
+    namespace connector = senf::ppi::connector;
+
+    void timeout() {
+        senf::scheduler::terminate();
+    }
+
+    void run(senf::ClockService::clock_type t) {
+        senf::scheduler::TimerEvent timeoutTimer (
+            "pcapSource test timer", &timeout, senf::ClockService::now() + t);
+        ppi::run();
+    }
+
+    // Build capture files in native or swapped byte order
+    struct FileBuilder
+    {
+        explicit FileBuilder(bool swap_) : swap (swap_) {}
+
+        FileBuilder & u16(boost::uint16_t v) {
+            if (swap) v = bswap_16(v);
+            data.append(reinterpret_cast<char const *>(&v), sizeof(v));
+            return *this;
+        }
+
+        FileBuilder & u32(boost::uint32_t v) {
+            if (swap) v = bswap_32(v);
+            data.append(reinterpret_cast<char const *>(&v), sizeof(v));
+            return *this;
+        }
+
+        FileBuilder & bytes(std::string const & s) {
+            data.append(s);
+            data.append((4u - s.size() % 4u) % 4u, '\0');
+            return *this;
+        }
+
+        void write(std::string const & name) const {
+            std::ofstream f (name.c_str(), std::ios::binary);
+            f << data;
+        }
+
+        bool swap;
+        std::string data;
+    };
+
+    // Changes the first byte of the first n packets in place
+    class Scribbler : public module::Module
+    {
+        SENF_PPI_MODULE(Scribbler);
+    public:
+        connector::PassiveInput<> input;
+        connector::ActiveOutput<> output;
+
+        explicit Scribbler(unsigned n) : n_ (n) {
+            route(input, output);
+            input.onRequest(&Scribbler::request);
+        }
+
+    private:
+        void request() {
+            senf::Packet packet (input());
+            if (n_ > 0u) {
+                -- n_;
+                packet.data()[0] = 'X';
+            }
+            output(packet);
+        }
+
+        unsigned n_;
+    };
+
+    std::string str(senf::Packet const & p) {
+        return std::string(p.data().begin(), p.data().end());
+    }
+
+    senf::ClockService::int64_type timestamp(senf::Packet const & p) {
+        return senf::ClockService::in_nanoseconds(
+            p.annotation<ppi::ReadTimestamp>().value - senf::ClockService::from_time_t(0));
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(pcapSource_pcap)
+{
+    std::string filename ("/tmp/senf_pcapSource_test.pcap");
+    FileBuilder b (false);
+    b.u32(0xa1b2c3d4u).u16(2u).u16(4u).u32(0u).u32(0u).u32(65535u).u32(1u);
+    b.u32(1000u).u32(5u).u32(5u).u32(60u);
+    b.data.append("hello");
+    b.u32(1001u).u32(0u).u32(6u).u32(6u);
+    b.data.append("world!");
+    b.write(filename);
+
+    {
+        module::PcapSource<> source (filename);
+        debug::PassiveSink sink;
+        ppi::connect(source, sink);
+        BOOST_CHECK_EQUAL( source.linkType(), 1u );
+        source.loops(2u);
+
+        run(senf::ClockService::milliseconds(100));
+
+        BOOST_CHECK( source.eof() );
+        BOOST_CHECK_EQUAL( source.packets(), 4u );
+        BOOST_REQUIRE_EQUAL( sink.size(), 4u );
+        senf::Packet p (sink.pop_front());
+        BOOST_CHECK_EQUAL( str(p), "hello" );
+        BOOST_CHECK_EQUAL( timestamp(p), 1000000005000ll );
+#ifndef SENF_PACKET_STD_CONTAINER
+        BOOST_CHECK( senf::PacketInfo(p).usingExternalMemory() );
+#endif
+        p = sink.pop_front();
+        BOOST_CHECK_EQUAL( str(p), "world!" );
+        BOOST_CHECK_EQUAL( timestamp(p), 1001000000000ll );
+        BOOST_CHECK_EQUAL( str(sink.pop_front()), "hello" );
+
+        // the packets keep the mapping alive after the source is gone
+        p = sink.pop_front();
+    }
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+}
+
+SENF_AUTO_TEST_CASE(pcapSource_loopInPlace)
+{
+    std::string filename ("/tmp/senf_pcapSource_test.pcap");
+    FileBuilder b (false);
+    b.u32(0xa1b2c3d4u).u16(2u).u16(4u).u32(0u).u32(0u).u32(65535u).u32(1u);
+    b.u32(1000u).u32(5u).u32(5u).u32(60u);
+    b.data.append("hello");
+    b.u32(1001u).u32(0u).u32(6u).u32(6u);
+    b.data.append("world!");
+    b.write(filename);
+
+    {
+        module::PcapSource<> source (filename);
+        Scribbler scribbler (2u);
+        debug::PassiveSink sink;
+        ppi::connect(source, scribbler);
+        ppi::connect(scribbler, sink);
+        source.loops(2u);
+
+        run(senf::ClockService::milliseconds(100));
+
+        // the second pass replays the file, not the packets changed in the first pass, and the
+        // packets of both passes do not share their data
+        BOOST_REQUIRE_EQUAL( sink.size(), 4u );
+        BOOST_CHECK_EQUAL( str(sink.pop_front()), "Xello" );
+        BOOST_CHECK_EQUAL( str(sink.pop_front()), "Xorld!" );
+        BOOST_CHECK_EQUAL( str(sink.pop_front()), "hello" );
+        BOOST_CHECK_EQUAL( str(sink.pop_front()), "world!" );
+    }
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+}
+
+SENF_AUTO_TEST_CASE(pcapSource_pcapng)
+{
+    std::string filename ("/tmp/senf_pcapSource_test.pcapng");
+    FileBuilder b (true);
+    // section header block
+    b.u32(0x0a0d0d0au).u32(28u).u32(0x1a2b3c4du).u16(1u).u16(0u).u32(0xffffffffu).u32(0xffffffffu)
+        .u32(28u);
+    // interface description block with if_tsresol of 2^-10 s
+    b.u32(1u).u32(32u).u16(105u).u16(0u).u32(4u).u16(9u).u16(1u).bytes("\x8a").u16(0u).u16(0u)
+        .u32(32u);
+    // enhanced packet block
+    b.u32(6u).u32(36u).u32(0u).u32(0u).u32(3u * 1024u + 512u).u32(3u).u32(3u).bytes("abc")
+        .u32(36u);
+    // unknown block
+    b.u32(0x0bad0bad).u32(12u).u32(12u);
+    // simple packet block, truncated to the snap length
+    b.u32(3u).u32(24u).u32(6u).bytes("uvwxyz").u32(24u);
+    b.write(filename);
+
+    module::PcapSource<> source (filename, 1u);
+    debug::PassiveSink sink;
+    ppi::connect(source, sink);
+    BOOST_CHECK_EQUAL( source.linkType(), 105u );
+
+    run(senf::ClockService::milliseconds(100));
+
+    BOOST_CHECK( source.eof() );
+    BOOST_REQUIRE_EQUAL( sink.size(), 2u );
+    BOOST_CHECK_EQUAL( str(sink.front()), "abc" );
+    BOOST_CHECK_EQUAL( timestamp(sink.front()), 3500000000ll );
+    sink.pop_front();
+    BOOST_CHECK_EQUAL( str(sink.front()), "uvwx" );
+
+    sink.clear();
+    source.rewind();
+    BOOST_CHECK( ! source.eof() );
+    run(senf::ClockService::milliseconds(100));
+    BOOST_CHECK_EQUAL( sink.size(), 2u );
+    BOOST_CHECK_EQUAL( source.packets(), 4u );
+
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+}
+
+SENF_AUTO_TEST_CASE(pcapSource_roundtrip)
+{
+    std::string filename ("/tmp/senf_pcapSource_roundtrip.pcap");
+    {
+        debug::ActiveSource source;
+        module::PcapSink sink (filename, 105u);
+        ppi::connect(source, sink);
+        ppi::init();
+        for (unsigned i (0); i < 3; ++i) {
+            senf::Packet p (senf::DataPacket::create(std::string(10u + i, 'a' + i)));
+            p.annotation<ppi::ReadTimestamp>().value =
+                senf::ClockService::from_time_t(2000 + i) + senf::ClockService::nanoseconds(7);
+            source.submit(p);
+        }
+    }
+
+    module::PcapSource<> source (filename);
+    debug::PassiveSink sink;
+    ppi::connect(source, sink);
+    BOOST_CHECK_EQUAL( source.linkType(), 105u );
+    run(senf::ClockService::milliseconds(100));
+
+    BOOST_REQUIRE_EQUAL( sink.size(), 3u );
+    for (unsigned i (0); i < 3; ++i) {
+        BOOST_CHECK_EQUAL( str(sink.front()), std::string(10u + i, 'a' + i) );
+        BOOST_CHECK_EQUAL( timestamp(sink.front()), (2000ll + i) * 1000000000ll + 7 );
+        sink.pop_front();
+    }
+
+    BOOST_CHECK_THROW( module::PcapSource<> ("/tmp/senf_pcapSource_missing.pcap"),
+                       senf::SystemException );
+    { std::ofstream f (filename.c_str()); f << "garbage garbage garbage garbage"; }
+    BOOST_CHECK_THROW( module::PcapSource<> (filename.c_str()), ppi::PcapFormatException );
+
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
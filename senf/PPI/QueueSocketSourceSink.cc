@@ -18,10 +18,128 @@
 #include "QueueSocketSourceSink.ih"
 
 // Custom includes
+#include <senf/Utils/senflikely.hh>
 
 #define prefix_
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 
+#ifndef SENF_PACKET_STD_CONTAINER
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::detail::QueueFrameHolder
+
+prefix_ senf::ppi::detail::QueueFrameHolder::QueueFrameHolder()
+    : qi_ (nullptr), maxHeld_ (0)
+{}
+
+prefix_ senf::ppi::detail::QueueFrameHolder::~QueueFrameHolder()
+{
+    detachAll();
+}
+
+prefix_ void senf::ppi::detail::QueueFrameHolder::guard(senf::detail::QueueInfo & qi)
+{
+    if (SENF_LIKELY(maxHeld_ == 0 && ! qi_))
+        return;
+    if (SENF_UNLIKELY(qi.holder != this)) {
+        detachAll();
+        // zero-copy is only supported on TPACKET_V2 rings, TPACKET_V3 blocks are returned to the
+        // kernel as a whole
+        if (qi.version != TPACKET_V2 || qi.rx.qlen == 0 || qi.holder)
+            return;
+        qi_ = &qi;
+        qi_->holder = this;
+        frames_.assign(qi_->rx.qlen, nullptr);
+    }
+    // frames are held in ring order. Copy out the oldest held frames before the kernel reaches
+    // them: the kernel is ahead of rx.head and stops at the first frame not owned by it
+    unsigned const limit (qi_->rx.qlen / 4);
+    while (! order_.empty()) {
+        unsigned index (order_.front());
+        if (frames_[index]) {
+            if (distance(index) >= limit)
+                break;
+            frames_[index]->releaseExternal();
+        }
+        order_.pop_front();
+    }
+}
+
+prefix_ bool senf::ppi::detail::QueueFrameHolder::hold(PacketInfo const & ifo, unsigned char * data)
+{
+    if (! qi_ || qi_->held >= maxHeld_)
+        return false;
+    PacketVector * vec (ifo.externalMemoryOwner(this));
+    if (! vec)
+        return false;
+    unsigned char * frame (data - qi_->hdrlen);
+    unsigned index (qi_->frameIndex(frame));
+    frames_[index] = vec;
+    order_.push_back(index);
+    qi_->hold(frame);
+    return true;
+}
+
+prefix_ unsigned senf::ppi::detail::QueueFrameHolder::maxHeld()
+    const
+{
+    return maxHeld_;
+}
+
+prefix_ void senf::ppi::detail::QueueFrameHolder::maxHeld(unsigned n)
+{
+    maxHeld_ = n;
+}
+
+prefix_ unsigned senf::ppi::detail::QueueFrameHolder::held()
+    const
+{
+    return qi_ ? qi_->held : 0u;
+}
+
+prefix_ void senf::ppi::detail::QueueFrameHolder::detach(unsigned char * frame)
+{
+    unsigned index (qi_->frameIndex(frame));
+    if (frames_[index])
+        frames_[index]->releaseExternal();
+    else
+        qi_->unhold(frame);
+}
+
+prefix_ void senf::ppi::detail::QueueFrameHolder::detachAll()
+{
+    if (! qi_)
+        return;
+    // releaseExternal() copies the data and calls externalMemoryReleased() which hands the
+    // frame back to the kernel
+    for (PacketVector * vec : frames_)
+        if (vec)
+            vec->releaseExternal();
+    qi_->holder = nullptr;
+    qi_ = nullptr;
+    frames_.clear();
+    order_.clear();
+}
+
+prefix_ void senf::ppi::detail::QueueFrameHolder::externalMemoryReleased(PacketVector::value_type * data)
+{
+    unsigned char * frame (data - qi_->hdrlen);
+    frames_[qi_->frameIndex(frame)] = nullptr;
+    qi_->unhold(frame);
+}
+
+prefix_ unsigned senf::ppi::detail::QueueFrameHolder::distance(unsigned index)
+    const
+{
+    unsigned head (qi_->frameIndex(qi_->rx.head));
+    return index >= head ? index - head : index + qi_->rx.qlen - head;
+}
+
+#endif
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::ppi::module::QueueEthVLanFilter
+
 prefix_ senf::ppi::module::QueueEthVLanFilter::QueueEthVLanFilter()
 {
     route(input, output).autoThrottling(false);
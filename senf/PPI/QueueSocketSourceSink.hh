@@ -55,6 +55,23 @@ namespace module {
         will be instantiated utilizing the queue memory using the external packet memory manager
         support.
 
+        Per read event at most \a burst packets are read. If the handle uses a TPACKET_V3 (block
+        based) rx ring, all frames of the current block are read, even if this exceeds \a burst.
+        All packets read are sent as a single PacketBurst (see \ref ppi_connectors_burst), unless
+        the output is a fast connector.
+
+        flush() drops all frames still queued in the socket. If called from downstream while a
+        burst is processed, the frames are dropped as soon as the burst has been sent. Packets
+        sent to a fast connector one by one are not sent any more after flush() has been called,
+        a PacketBurst however is always delivered completely.
+
+        By default, a packet still referenced after it has been processed by the output is copied
+        out of the queue memory. If \ref maxHeldFrames() is set on a TPACKET_V2 rx ring, up to that
+        many such packets instead keep referencing their frame (zero-copy). The frame is returned
+        to the kernel as soon as the last packet handle is dropped or the packet data is
+        reallocated (e.g. by an insert exceeding the frame space). Held frames the kernel is about
+        to reach are copied out of the ring, so the ring never stalls on a held frame.
+
         \see \ref senf::QueueReadPolicy
      */
     template <class Packet=DataPacket,
@@ -82,6 +99,11 @@ namespace module {
 
         void flush();
 
+        unsigned maxHeldFrames() const;
+        void maxHeldFrames(unsigned n); ///< Set maximum number of frames held by zero-copy packets
+                                        /**< 0 (the default) disables zero-copy packets */
+        unsigned heldFrames() const;    ///< Number of frames currently held by zero-copy packets
+
 #ifdef SENF_DEBUG
         unsigned burstMax();
 #endif
@@ -98,7 +120,13 @@ namespace module {
         unsigned burst_;
         bool flushPending_;
         unsigned red_;
-        
+        PacketBurst packets_;
+        std::vector<PacketInfo> infos_;
+        std::vector<QueueReadPolicy::Buffer> buffers_;
+#ifndef SENF_PACKET_STD_CONTAINER
+        senf::ppi::detail::QueueFrameHolder holder_;
+#endif
+
 #ifdef SENF_DEBUG
         unsigned burstMax_;
 #endif
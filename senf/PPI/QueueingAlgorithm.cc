@@ -19,12 +19,15 @@
 
 // Custom includes
 #include <senf/Utils/Console/Variables.hh>
+#include "FlowQueueingAlgorithm.hh"
 
 #define prefix_
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 
 SENF_PPI_REGISTER_QALGORITHM( "FIFOQueueingAlgorithm", senf::ppi::FIFOQueueingAlgorithm);
 SENF_PPI_REGISTER_QALGORITHM( "NoneQueueingAlgorithm", senf::ppi::NoneQueueingAlgorithm);
+SENF_PPI_REGISTER_QALGORITHM( "DRRQueueingAlgorithm", senf::ppi::DRRQueueingAlgorithm);
+SENF_PPI_REGISTER_QALGORITHM( "FQCoDelQueueingAlgorithm", senf::ppi::FQCoDelQueueingAlgorithm);
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 // senf::ppi::QueueingAlgorithm
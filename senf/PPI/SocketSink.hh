@@ -18,7 +18,9 @@
 #define HH_SENF_PPI_SocketSink_ 1
 
 // Custom includes
+#include <vector>
 #include <senf/Packets/Packets.hh>
+#include <senf/Scheduler/EventHook.hh>
 #include <senf/Socket/ClientSocketHandle.hh>
 #include <senf/Socket/Protocols/Raw/PacketSocketHandle.hh>
 #include <senf/Socket/SocketPolicy.hh>
@@ -183,6 +185,59 @@ namespace ppi {
         LLSocketAddress target_;
     };
 
+    /** \brief Writer for module::PassiveBatchSocketSink
+
+        This writer will write a batch of packets as separate datagrams to the given socket with a
+        single system call. The socket must be connected and support the senf::BatchWritePolicy.
+     */
+    class ConnectedBatchDgramWriter
+    {
+    public:
+        typedef senf::ClientSocketHandle<
+            senf::MakeSocketPolicy< senf::BatchWritePolicy,
+                                    senf::DatagramFramingPolicy,
+                                    senf::ConnectedCommunicationPolicy>::policy > Handle;
+                                        ///< Handle type supported by this writer
+        typedef Packet PacketType;
+
+        unsigned operator()(Handle & handle, std::vector<Packet> const & packets);
+                                        ///< Write \a packets to \a handle
+                                        /**< \param[in] handle Handle to write data to
+                                             \param[in] packets Packets to write
+                                             \returns number of packets written */
+    };
+
+    /** \brief Batch writer sending data with ClientSocketHandle::writeBatchTo()
+
+        This is the batch variant of TargetDgramWriter. The target address can be specified in the
+        writer constructor and can be adjusted at any time.
+
+        If no target address is set, incoming data will be <em>silently dropped</em>.
+     */
+    template <class HandleType>
+    class TargetBatchDgramWriter
+    {
+    public:
+        typedef HandleType Handle;
+        typedef Packet PacketType;
+
+        TargetBatchDgramWriter();       ///< Create TargetBatchDgramWriter with unset target address
+        TargetBatchDgramWriter(typename Handle::Address const & target);
+                                        ///< Create TargetBatchDgramWriter sending to \a target
+
+        typename Handle::Address target() const; ///< Get current target address
+        void target(typename Handle::Address const & target); ///< Set target address
+
+        unsigned operator()(Handle & handle, std::vector<Packet> const & packets);
+                                        ///< Write \a packets to \a handle
+                                        /**< \param[in] handle Handle to write data to
+                                             \param[in] packets Packets to write
+                                             \returns number of packets written */
+
+    private:
+        typename Handle::Address target_;
+    };
+
 }}
 
 namespace senf {
@@ -364,6 +419,112 @@ namespace module {
         TxStats txStats_;
     };
 
+    /** \brief Output module writing batches of datagrams to a FileHandle
+
+        This output module is a variant of PassiveSocketSink for datagram sockets supporting the
+        senf::BatchWritePolicy. Packets received are collected and written out with a single
+        system call whenever \a batch_size packets are pending or the current scheduler wakeup
+        has been processed completely (the batch is flushed from a scheduler event hook). As with
+        PassiveSocketSink, <em>the output handle may not block</em>.
+
+        The default \a Writer is senf::ppi::ConnectedBatchDgramWriter. A \a Writer must fulfill
+        the following interface:
+        \code
+          class SomeWriter
+          {
+          public:
+              typedef unspecified Handle;                          // type of handle requested
+              typedef unspecified_type PacketType                  // type of packet read
+
+              SomeWriter();                                        // EITHER default constructible
+              SomeWriter(SomeWriter const & other);                // OR copy constructible
+
+              unsigned operator()(Handle handle, std::vector<PacketType> const & packets);
+                                                                   // batch insertion function
+          };
+        \endcode
+
+        \ingroup io_modules
+     */
+    template <class Writer=ConnectedBatchDgramWriter>
+    class PassiveBatchSocketSink : public Module
+    {
+        SENF_PPI_MODULE(PassiveBatchSocketSink);
+
+    public:
+        typedef typename Writer::Handle Handle; ///< Handle type requested by writer
+        typedef typename Writer::PacketType PacketType;
+
+        connector::PassiveInput<PacketType> input; ///< Input connector from which data is received
+
+        explicit PassiveBatchSocketSink(unsigned batch_size=16);
+                                        ///< Create non-connected writer
+                                        /**< The writer will be disabled until a socket is set
+                                             \pre Requires \a Writer to be default constructible */
+        explicit PassiveBatchSocketSink(Handle const & handle, unsigned batch_size=16);
+                                        ///< Create new writer for the given handle
+                                        /**< \pre Requires \a Writer to be default constructible
+                                             \param[in] handle Handle to write data to
+                                             \param[in] batch_size maximum number of packets
+                                                 written with a single system call */
+        PassiveBatchSocketSink(Handle const & handle, Writer const & writer,
+                               unsigned batch_size=16);
+                                        ///< Create new writer for the given handle
+                                        /**< \pre Requires \a Writer to be copy constructible
+                                             \param[in] handle Handle to write data to
+                                             \param[in] writer Writer helper writing packet date to
+                                                 the socket
+                                             \param[in] batch_size maximum number of packets
+                                                 written with a single system call */
+
+        Writer & writer();              ///< Access the Writer
+        Handle & handle();              ///< Access handle
+        void handle(Handle const & handle);
+                                        ///< Set handle
+                                        /**< Pending packets are written to the old handle before
+                                             the new handle is assigned. Assigning an empty or
+                                             in-valid() handle will disable the module until a new
+                                             valid handle is assigned. */
+
+        unsigned batchSize() const;     ///< Maximum number of packets written per system call
+        void batchSize(unsigned batch_size);
+
+        void flush();                   ///< Write out all pending packets
+
+        struct TxStats {
+            TxStats () {
+                clear();
+            }
+            void clear() {
+                memset(this, 0, sizeof(*this));
+            }
+            void dump(std::ostream & os) const {
+                os << "sent "    << sent << ", "
+                   << "batches " << batches << ", "
+                   << "error "   << error << ".";
+            }
+
+            unsigned sent;
+            unsigned batches;
+            unsigned error;
+        };
+
+        TxStats & txStats() {
+            return txStats_;
+        }
+
+    private:
+        void write();
+        void checkThrottle();
+
+        Handle handle_;
+        Writer writer_;
+        std::vector<PacketType> batch_;
+        unsigned batchSize_;
+        scheduler::EventHook flushHook_;
+        TxStats txStats_;
+    };
+
 }}}
 
 
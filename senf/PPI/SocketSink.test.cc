@@ -97,6 +97,54 @@ SENF_AUTO_TEST_CASE(activeSocketSink)
     BOOST_CHECK_EQUAL( data, input );
 }
 
+SENF_AUTO_TEST_CASE(passiveBatchSocketSink)
+{
+    senf::ConnectedUDPv4ClientSocketHandle outputSocket (
+        senf::INet4SocketAddress(localhost4str(1)));
+    module::PassiveBatchSocketSink<> udpSink(outputSocket, 3u);
+    debug::ActiveSource source;
+    ppi::connect(source, udpSink);
+
+    senf::UDPv4ClientSocketHandle inputSocket;
+    inputSocket.bind(senf::INet4SocketAddress(localhost4str(1)));
+    inputSocket.blocking(false);
+    senf::ppi::init();
+
+    // a full batch is written out immediately
+    for (unsigned i (0); i < 3; ++i)
+        source.submit(senf::DataPacket::create(std::string("BATCH")));
+    BOOST_CHECK_EQUAL( udpSink.txStats().batches, 1u );
+    BOOST_CHECK_EQUAL( udpSink.txStats().sent, 3u );
+    for (unsigned i (0); i < 3; ++i)
+        BOOST_CHECK_EQUAL( inputSocket.read(), "BATCH" );
+
+    // an incomplete batch is written at the end of the scheduler wakeup
+    source.submit(senf::DataPacket::create(std::string("LAST")));
+    BOOST_CHECK_EQUAL( udpSink.txStats().sent, 3u );
+    senf::scheduler::TimerEvent timer (
+        "passiveBatchSocketSink test timer", &timeout,
+        senf::ClockService::now() + senf::ClockService::milliseconds(100));
+    senf::ppi::run();
+    BOOST_CHECK_EQUAL( udpSink.txStats().batches, 2u );
+    BOOST_CHECK_EQUAL( udpSink.txStats().sent, 4u );
+    BOOST_CHECK_EQUAL( inputSocket.read(), "LAST" );
+}
+
+SENF_AUTO_TEST_CASE(targetBatchDgramWriter)
+{
+    senf::UDPv4ClientSocketHandle outputSocket;
+    senf::ppi::TargetBatchDgramWriter<senf::UDPv4ClientSocketHandle> writer;
+    std::vector<senf::Packet> packets;
+    packets.push_back(senf::DataPacket::create(std::string("TEST")));
+    BOOST_CHECK_EQUAL( writer(outputSocket, packets), 0u );
+
+    senf::UDPv4ClientSocketHandle inputSocket;
+    inputSocket.bind(senf::INet4SocketAddress(localhost4str(2)));
+    writer.target(senf::INet4SocketAddress(localhost4str(2)));
+    BOOST_CHECK_EQUAL( writer(outputSocket, packets), 1u );
+    BOOST_CHECK_EQUAL( inputSocket.read(), "TEST" );
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
@@ -18,6 +18,7 @@
 #define HH_SENF_PPI_SocketSource_ 1
 
 // Custom includes
+#include <vector>
 #include <senf/Packets/Packets.hh>
 #include <senf/Socket/ClientSocketHandle.hh>
 #include <senf/Socket/SocketPolicy.hh>
@@ -67,6 +68,38 @@ namespace ppi {
                                                  packet could be read */
     };
 
+    /** \brief Reader for module::ActiveBatchSocketSource
+
+        This read helper will read a batch of datagrams from a datagram socket supporting the
+        senf::BatchReadPolicy with a single system call. Each datagram is interpreted as a packet
+        of type \a Packet. Datagrams larger than \a MaxSize are truncated.
+     */
+    template <class Packet=DataPacket, unsigned MaxSize=2048u>
+    class BatchDgramReader
+    {
+    public:
+        typedef Packet PacketType;
+        typedef senf::ClientSocketHandle<
+            senf::MakeSocketPolicy< senf::BatchReadPolicy,
+                                    senf::DatagramFramingPolicy >::policy > Handle;
+                                        ///< Handle type supported by this reader
+
+        BatchDgramReader();
+
+        unsigned operator()(Handle & handle, std::vector<Packet> & packets);
+                                        ///< Read batch of packets from \a handle
+                                        /**< Read up to <tt>packets.size()</tt> datagrams into
+                                             \a packets. Only the slots filled by the previous
+                                             call (and any invalid slots) are replaced by new
+                                             packet instances, the remaining slots are reused.
+                                             \param[in] handle Handle to read data from
+                                             \param[in,out] packets batch of packets
+                                             \returns number of packets read */
+
+    private:
+        unsigned consumed_;
+    };
+
 }}
 
 namespace senf {
@@ -164,6 +197,99 @@ namespace module {
         void read();
     };
 
+    /** \brief Input module reading batches of datagrams from a FileHandle
+
+        This input module is a variant of ActiveSocketSource for datagram sockets supporting the
+        senf::BatchReadPolicy (e.g. senf::UDPv4ClientSocketHandle). Whenever the handle becomes
+        readable, up to \a batch_size datagrams are read with a single system call and then sent
+        out one by one. If the batch was filled completely, further batches are read up to a total
+        of \a max_burst batches per scheduler wakeup.
+
+        \code
+        senf::ppi::module::ActiveBatchSocketSource<> source (udpHandle, 32);
+        \endcode
+
+        A \a Reader must fulfill the following interface:
+        \code
+        class SomeReader
+        {
+        public:
+            typedef unspecified_type Handle;                       // type of handle requested
+            typedef unspecified_type PacketType                    // type of packet returned
+
+            SomeReader();                                          // EITHER default constructible
+            SomeReader(SomeReader const & other);                  // OR copy constructible
+
+            unsigned operator()(Handle handle, std::vector<PacketType> & packets);
+                                                                   // batch extraction function
+        };
+        \endcode
+
+        \see BatchDgramReader
+        \ingroup io_modules
+     */
+    template <class Reader=BatchDgramReader<> >
+    class ActiveBatchSocketSource
+        : public Module
+    {
+        SENF_PPI_MODULE(ActiveBatchSocketSource);
+
+    public:
+        typedef typename Reader::Handle Handle; ///< Handle type requested by the reader
+
+        connector::ActiveOutput<typename Reader::PacketType> output;
+                                        ///< Output connector to which the data received is written
+
+        explicit ActiveBatchSocketSource(unsigned batch_size=16, unsigned max_burst=1);
+        explicit ActiveBatchSocketSource(Handle const & handle, unsigned batch_size=16,
+                                         unsigned max_burst=1);
+        ActiveBatchSocketSource(Handle const & handle, Reader reader, unsigned batch_size=16,
+                                unsigned max_burst=1);
+
+        Reader & reader();              ///< Access Reader helper
+        Handle handle();                ///< Access handle
+        void handle(Handle const & handle);
+                                        ///< Set handle
+                                        /**< Assigning an empty or in-valid() handle will disable
+                                             the module until a new, valid handle is assigned. */
+
+        unsigned batchSize() const;     ///< Maximum number of datagrams read per system call
+        void batchSize(unsigned batch_size);
+        unsigned maxBurst() const;      ///< Maximum number of batches read per scheduler wakeup
+        void maxBurst(unsigned max_burst);
+
+        struct RxStats {
+            RxStats () {
+                clear();
+            }
+            void clear() {
+                memset(this, 0, sizeof(*this));
+            }
+            void dump(std::ostream & os) const {
+                os << "received "  << received << ", "
+                   << "batches "   << batches << ", "
+                   << "noop "      << noop << ".";
+            }
+
+            unsigned received;
+            unsigned batches;
+            unsigned noop;
+        };
+
+        RxStats & rxStats() {
+            return rxStats_;
+        }
+
+    private:
+        Handle handle_;
+        IOEvent event_;
+        Reader reader_;
+        std::vector<typename Reader::PacketType> batch_;
+        unsigned maxBurst_;
+        RxStats rxStats_;
+        void read();
+    };
+
 }}}
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -78,6 +78,60 @@ SENF_AUTO_TEST_CASE(socketSource)
                              data.begin()) );
 }
 
+SENF_AUTO_TEST_CASE(batchSocketSource)
+{
+    senf::UDPv4ClientSocketHandle inputSocket;
+    inputSocket.bind(senf::INet4SocketAddress(localhost4str(1)));
+    inputSocket.blocking(false);
+    module::ActiveBatchSocketSource<> udpSource(inputSocket, 2u, 4u);
+    debug::PassiveSink sink;
+    ppi::connect(udpSource, sink);
+
+    senf::UDPv4ClientSocketHandle outputSocket;
+    outputSocket.writeto(senf::INet4SocketAddress(localhost4str(1)), std::string("ONE"));
+    outputSocket.writeto(senf::INet4SocketAddress(localhost4str(1)), std::string("TWO"));
+    outputSocket.writeto(senf::INet4SocketAddress(localhost4str(1)), std::string("THREE"));
+    runPPI( senf::ClockService::milliseconds(100));
+
+    BOOST_REQUIRE_EQUAL( sink.size(), 3u );
+    BOOST_CHECK_EQUAL( udpSource.rxStats().received, 3u );
+    BOOST_CHECK_EQUAL( udpSource.rxStats().batches, 2u );
+    senf::Packet p (sink.pop_front());
+    BOOST_CHECK_EQUAL( std::string(p.data().begin(), p.data().end()), "ONE" );
+    sink.pop_front();
+    p = sink.pop_front();
+    BOOST_CHECK_EQUAL( std::string(p.data().begin(), p.data().end()), "THREE" );
+}
+
+SENF_AUTO_TEST_CASE(batchDgramReader)
+{
+    senf::UDPv4ClientSocketHandle inputSocket;
+    inputSocket.bind(senf::INet4SocketAddress(localhost4str(2)));
+    inputSocket.blocking(false);
+    ppi::BatchDgramReader<>::Handle handle (inputSocket);
+    ppi::BatchDgramReader<> reader;
+    std::vector<senf::DataPacket> batch (3u);
+
+    senf::UDPv4ClientSocketHandle outputSocket;
+    outputSocket.writeto(senf::INet4SocketAddress(localhost4str(2)), std::string("ONE"));
+    ::usleep(10000);
+    BOOST_REQUIRE_EQUAL( reader(handle, batch), 1u );
+    BOOST_CHECK_EQUAL( std::string(batch[0].data().begin(), batch[0].data().end()), "ONE" );
+    senf::DataPacket first (batch[0]);
+    senf::DataPacket unused (batch[1]);
+
+    outputSocket.writeto(senf::INet4SocketAddress(localhost4str(2)), std::string("TWO"));
+    outputSocket.writeto(senf::INet4SocketAddress(localhost4str(2)), std::string("THREE"));
+    ::usleep(10000);
+    BOOST_REQUIRE_EQUAL( reader(handle, batch), 2u );
+    // the consumed slot is replaced, the unused one is read into in place
+    BOOST_CHECK( ! (batch[0] == first) );
+    BOOST_CHECK( batch[1] == unused );
+    BOOST_CHECK_EQUAL( std::string(first.data().begin(), first.data().end()), "ONE" );
+    BOOST_CHECK_EQUAL( std::string(batch[0].data().begin(), batch[0].data().end()), "TWO" );
+    BOOST_CHECK_EQUAL( std::string(batch[1].data().begin(), batch[1].data().end()), "THREE" );
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
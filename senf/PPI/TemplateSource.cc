@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief TemplateSource non-inline non-template implementation */
+
+#include "TemplateSource.hh"
+
+// Custom includes
+#include <senf/Scheduler/ClockService.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+prefix_ senf::ppi::module::TemplateSource::TemplateSource(PacketTemplate & tmpl,
+                                                          PacketTemplate::size_type size)
+    : template_ (tmpl), size_ (size)
+{
+    noroute(output);
+    output.onRequest(&TemplateSource::request);
+}
+
+prefix_ senf::PacketTemplate::size_type senf::ppi::module::TemplateSource::size()
+    const
+{
+    return size_ ? size_ : template_.size();
+}
+
+prefix_ void senf::ppi::module::TemplateSource::size(PacketTemplate::size_type size)
+{
+    size_ = size;
+}
+
+prefix_ void senf::ppi::module::TemplateSource::request()
+{
+    template_.now(ClockService::now());
+    output(template_.stamp(size()));
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief TemplateSource public header */
+
+#ifndef HH_SENF_PPI_TemplateSource_
+#define HH_SENF_PPI_TemplateSource_ 1
+
+// Custom includes
+#include <senf/Packets/PacketTemplate.hh>
+#include "Module.hh"
+#include "Connectors.hh"
+
+//#include "TemplateSource.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace ppi {
+namespace module {
+
+    /** \brief Generate packets stamped from a packet template
+
+        TemplateSource will provide packets stamped from the senf::PacketTemplate \a tmpl on it's
+        \a output. Before stamping a packet, the template time is set to the current
+        senf::ClockService::now() value.
+
+        Compared to CloneSource, the prototype packet is neither cloned nor finalized for every
+        packet. Sequence numbers, timestamps, lengths and checksums are updated as defined by the
+        fields registered with the template.
+
+        \ingroup io_modules
+     */
+    class TemplateSource
+        : public Module
+    {
+        SENF_PPI_MODULE(TemplateSource);
+
+    public:
+        connector::PassiveOutput<> output;
+
+        explicit TemplateSource(PacketTemplate & tmpl, PacketTemplate::size_type size = 0u);
+                                        ///< Create source stamping packets from \a tmpl
+                                        /**< \a tmpl must stay valid as long as the module exists.
+                                             \param[in] tmpl packet template
+                                             \param[in] size size of the packets to create. A \a
+                                                 size of 0 creates packets of the templates size.
+                                                 See senf::PacketTemplate::stamp(). */
+
+        PacketTemplate::size_type size() const; ///< Size of the packets created
+        void size(PacketTemplate::size_type size); ///< Change size of the packets created
+
+    private:
+        void request();
+
+        PacketTemplate & template_;
+        PacketTemplate::size_type size_;
+    };
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+//#include "TemplateSource.cci"
+//#include "TemplateSource.ct"
+//#include "TemplateSource.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
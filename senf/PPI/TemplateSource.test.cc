@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief TemplateSource unit tests */
+
+#include "TemplateSource.hh"
+
+// Custom includes
+#include <senf/Packets/Packets.hh>
+#include "DebugModules.hh"
+#include "Setup.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+SENF_AUTO_TEST_CASE(templateSource)
+{
+    senf::PacketData::byte data[] = { 0xab, 0x00, 0x00 };
+    senf::Packet p (senf::DataPacket::create(data));
+    senf::PacketTemplate tmpl (p);
+    tmpl.counter(1u, 2u);
+
+    senf::ppi::module::TemplateSource source (tmpl);
+    senf::ppi::module::debug::ActiveSink sink;
+
+    senf::ppi::connect(source,sink);
+    senf::ppi::init();
+
+    BOOST_CHECK_EQUAL( source.size(), 3u );
+    senf::Packet p1 (sink.request());
+    BOOST_CHECK( p1 != p );
+    BOOST_CHECK( p1.is<senf::DataPacket>() );
+    BOOST_CHECK_EQUAL( p1.data()[0], 0xabu );
+    BOOST_CHECK_EQUAL( p1.data()[2], 0u );
+    BOOST_CHECK_EQUAL( sink.request().data()[2], 1u );
+
+    source.size(5u);
+    senf::Packet p3 (sink.request());
+    BOOST_CHECK_EQUAL( p3.size(), 5u );
+    BOOST_CHECK_EQUAL( p3.data()[2], 2u );
+}
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -44,6 +44,15 @@ prefix_ boost::uint16_t senf::IPv4PacketParser::calcChecksum()
     return summer.sum();
 }
 
+prefix_ void senf::IPv4PacketParser::decrementTTL()
+{
+    // ttl and protocol make up one 16bit word of the header
+    boost::uint8_t t (ttl());
+    boost::uint8_t p (protocol());
+    ttl() = boost::uint8_t(t - 1);
+    checksum() << IpChecksum::update(checksum(), (t << 8) | p, (boost::uint8_t(t - 1) << 8) | p);
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 // senf::IPv4PacketType
 
@@ -92,6 +92,12 @@ namespace senf {
                                         /**< return \c true if the \ref checksum() "checksum"
                                              field is equal to the \ref calcChecksum()
                                              "calculated checksum" */
+
+        void decrementTTL();            ///< decrement ttl and update checksum
+                                        /**< The \ref checksum() "checksum" is updated
+                                             incrementally (RFC 1624) and is therefore only
+                                             correct, if it was correct before.
+                                             \see senf::IpChecksum::update() */
     };
 
 
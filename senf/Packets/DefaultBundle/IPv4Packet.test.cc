@@ -78,6 +78,12 @@ SENF_AUTO_TEST_CASE(ipV4Packet_create)
     BOOST_CHECK_EQUAL( ip->checksum(), 0xbad2 );
 
     BOOST_CHECK( ip->validateChecksum() );
+
+    ip->ttl() = 64;
+    ip.finalizeThis();
+    ip->decrementTTL();
+    BOOST_CHECK_EQUAL( ip->ttl(), 63u );
+    BOOST_CHECK( ip->validateChecksum() );
 }
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
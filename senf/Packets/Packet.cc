@@ -37,6 +37,11 @@ prefix_ std::int32_t const & senf::Packet::pktCount()
 #endif
 }
 
+prefix_ void senf::Packet::preallocate(unsigned n)
+{
+    detail::PacketImpl::preallocate(n);
+}
+
 prefix_ senf::PacketInterpreterBase::ptr senf::Packet::getNext(PacketInterpreterBase::optional_range const & range)
     const
 {
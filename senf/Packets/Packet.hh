@@ -160,6 +160,28 @@ namespace senf {
                                              packet. The returned packet will have the same data,
                                              annotations and packet chain. It does however not
                                              share any data with the original packet. */
+        Packet cowClone() const;        ///< Create copy-on-write copy of packet
+                                        /**< Like clone(), cowClone() returns a packet with the
+                                             same data, annotations and packet chain. The packet
+                                             data is however not copied but shared with \c this
+                                             packet. A private copy is made, as soon as either
+                                             packet modifies the data via PacketData or a
+                                             parser. This makes handing the same packet to many
+                                             receivers, which mostly just forward the packet,
+                                             cheap (e.g. ActiveDuplicator). Accessing the packet
+                                             fields via parser() or operator->() also creates a
+                                             copy, since the parsers can't tell reading from
+                                             writing. Use ConcretePacket::constParser() to only
+                                             read fields without copying.
+
+                                             The interpreter chain and the annotations are
+                                             always copied.
+
+                                             \warning Writing to the data of a copy-on-write packet
+                                                 via raw data iterators (e.g. \c
+                                                 data().begin()) will change all sharing packets.
+                                                 Call \c data().releaseSharedMemory() first.
+                                             \see PacketData::usingSharedMemory() */
 
         // conversion constructors
 
@@ -179,6 +201,24 @@ namespace senf {
         
         static std::int32_t const & pktCount();
 
+        static void preallocate(unsigned n); ///< Pre-warm the calling threads packet pools
+                                        /**< Packet data and PacketImpl instances are allocated
+                                             from thread local pools. This call ensures, that
+                                             the pools of the calling thread can serve at least
+                                             \a n packets without accessing the heap or the
+                                             global depot. Call this once per thread at startup
+                                             to avoid allocation latency on the first packets. */
+
+        template <class ForwardIterator>
+        static void release(ForwardIterator b, ForwardIterator e);
+                                        ///< Drop all packets in [\a b, \a e) at once
+                                        /**< All packet handles in the range are reset to
+                                             uninitialized handles. The memory of packets which
+                                             are not referenced any more is returned to the
+                                             thread local pools in bulk. This is cheaper than
+                                             dropping the packets one by one, e.g. when
+                                             discarding a burst of packets. */
+
         //\}
         //-////////////////////////////////////////////////////////////////////////
 
@@ -537,6 +577,7 @@ namespace senf {
         template <class PacketType>
         friend class ConcretePacket;
         friend class PacketParserBase;
+        friend class PacketTemplate;
     };
 
     std::ostream & operator<<(std::ostream & os, Packet const & packet);
@@ -788,6 +829,7 @@ namespace senf {
         // Create a clone of the current packet
 
         ConcretePacket clone() const;
+        ConcretePacket cowClone() const;
 
         //\}
         //-////////////////////////////////////////////////////////////////////////
@@ -820,6 +862,13 @@ namespace senf {
                                              itself, only it's members.
                                              \see \ref packetparser for the %parser interface */
 
+        Parser constParser() const;     ///< Read-only access to the packet field parser
+                                        /**< Like parser() but does not create a private copy of
+                                             the data of a copy-on-write packet (see cowClone()).
+                                             The returned parser must only be used to read
+                                             fields: Writing through it will change all packets
+                                             sharing the data. */
+
 #ifndef DOXYGEN
         using Packet::next;
 
@@ -18,6 +18,7 @@
 
 // Custom includes
 #include <sstream>
+#include <vector>
 #include <boost/static_assert.hpp>
 #include <boost/cstdint.hpp>
 
@@ -471,6 +472,47 @@ SENF_AUTO_TEST_CASE(packetExternalMemory)
     BOOST_CHECK_EQUAL( foo->data()[9], 6u );
 }
 
+SENF_AUTO_TEST_CASE(packetCowClone)
+{
+    FooPacket foo (FooPacket::create());
+    BarPacket bar (BarPacket::createAfter(foo));
+    bar->length() = 4;
+    foo.annotation<IntAnnotation>().value = 42u;
+
+    FooPacket copy (foo.cowClone());
+    BOOST_CHECK( copy != foo );
+    BOOST_CHECK_EQUAL( copy.size(), foo.size() );
+    BOOST_CHECK( copy.next().is<BarPacket>() );
+    BOOST_CHECK_EQUAL( copy.annotation<IntAnnotation>().value, 42u );
+#ifndef SENF_PACKET_STD_CONTAINER
+    BOOST_CHECK( copy.data().usingSharedMemory() );
+    BOOST_CHECK( foo.data().usingSharedMemory() );
+    BOOST_CHECK( copy.data().begin() == foo.data().begin() );
+#endif
+
+    // Reading the fields via constParser() keeps the data shared
+    BOOST_CHECK_EQUAL( copy.next().as<BarPacket>().constParser().length(), 4 );
+#ifndef SENF_PACKET_STD_CONTAINER
+    BOOST_CHECK( copy.data().usingSharedMemory() );
+    BOOST_CHECK( foo.data().usingSharedMemory() );
+#endif
+
+    // Accessing the fields creates a private copy
+    copy.next().as<BarPacket>()->length() = 6;
+    BOOST_CHECK( ! copy.data().usingSharedMemory() );
+    BOOST_CHECK_EQUAL( bar->length(), 4 );
+    BOOST_CHECK( ! foo.data().usingSharedMemory() );
+
+    // Cloning from the middle of the chain only shares that part of the data
+    BarPacket barCopy (bar.cowClone());
+    BOOST_CHECK_EQUAL( barCopy.size(), bar.size() );
+    barCopy.data().insert(barCopy.data().end(), 2u, 0xffu);
+    BOOST_CHECK( ! barCopy.data().usingSharedMemory() );
+    BOOST_CHECK_EQUAL( barCopy.size(), 10u );
+    BOOST_CHECK_EQUAL( bar.size(), 8u );
+    BOOST_CHECK_EQUAL( foo.size(), 12u );
+}
+
 SENF_AUTO_TEST_CASE(packetAssign)
 {
     BarPacket bar1 (BarPacket::create());
@@ -482,6 +524,21 @@ SENF_AUTO_TEST_CASE(packetAssign)
     BOOST_CHECK_EQUAL( bar1->type(), 0x2A2Bu );
 }
 
+SENF_AUTO_TEST_CASE(packetRelease)
+{
+    std::vector<senf::Packet> packets;
+    for (unsigned i (0); i < 100; ++i)
+        packets.push_back(FooPacket::create());
+    senf::Packet kept (packets[0]);
+    senf::Packet::release(packets.begin(), packets.end());
+    BOOST_CHECK_EQUAL( packets.size(), 100u );
+    for (senf::Packet const & p : packets)
+        BOOST_CHECK( ! p );
+    BOOST_CHECK( kept );
+    BOOST_CHECK( ! kept.is_shared() );
+    BOOST_CHECK_EQUAL( kept.size(), FooPacket::create().size() );
+}
+
 #ifdef SENF_CXX11_ENABLED
 
 void movePacket(senf::Packet packet)
@@ -145,6 +145,21 @@ namespace senf {
 
                                              If \c usingExternalMemory() is \c false, this function
                                              is a no-op. */
+        bool usingSharedMemory() const; ///< Check for copy-on-write shared data
+                                        /**< Returns \c true, if the packet data is shared with
+                                             other packets created by Packet::cowClone(). Members
+                                             modifying the data (insert(), erase(), the non-const
+                                             operator[], zero() and the packet parsers) will
+                                             transparently create a private copy first. Writing
+                                             via raw iterators does \e not, call
+                                             releaseSharedMemory() before. */
+        void releaseSharedMemory();     ///< Create private copy of shared data
+                                        /**< If \c usingSharedMemory() returns \c true, this
+                                             member will copy the packet data to a private buffer
+                                             (unless all other users have gone away). This
+                                             operation will invalidate any iterators.
+                                             If \c usingSharedMemory() is \c false, this function
+                                             is a no-op. */
 
         //\}
 
@@ -79,6 +79,14 @@ namespace {
                    << "maxPreallocHeapcount = " << senf::detail::PacketImpl::maxPreallocHeapcount() << "\n"
 #endif
                    << "# of live Packets = " << senf::pool_alloc_mixin<senf::detail::PacketImpl>::allocCounter() << "\n"
+#endif
+                   << "PacketImpl pool: allocated = " << senf::detail::PacketImpl::pool<>::allocated()
+                   << ", cached = " << senf::detail::PacketImpl::pool<>::cached()
+                   << ", depot magazines = " << senf::detail::PacketImpl::pool<>::depotMagazines() << "\n"
+#ifndef SENF_PACKET_STD_CONTAINER
+                   << "PacketVector chunk pool: allocated = " << senf::PacketVector::ChunkPool::allocated()
+                   << ", cached = " << senf::PacketVector::ChunkPool::cached()
+                   << ", depot magazines = " << senf::PacketVector::ChunkPool::depotMagazines() << "\n"
 #endif
                     ;
             }
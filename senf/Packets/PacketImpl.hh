@@ -131,6 +131,9 @@ namespace detail {
         PacketImpl(InputIterator b, InputIterator e);
         PacketImpl(byte * data, size_type size, size_type chunkSize = 0u,
                    size_type offset = 0u);
+#ifndef SENF_PACKET_STD_CONTAINER
+        PacketImpl(PacketImpl & other, size_type b, size_type e);
+#endif
         ~PacketImpl();
 
         // reference/memory management
@@ -152,6 +155,11 @@ namespace detail {
 
         bool usingExternalMemory() const;
         void releaseExternalMemory();
+#ifndef SENF_PACKET_STD_CONTAINER
+        PacketVector * externalMemoryOwner(PacketVector::ExternalMemoryOwner * owner);
+#endif
+        bool usingSharedMemory() const;
+        void releaseSharedMemory();
 
         void memDebug(std::ostream & os);
 
@@ -209,6 +217,10 @@ namespace detail {
         static size_type maxPreallocHigh();
         static size_type maxPreallocHeapcount();
 
+        static void preallocate(unsigned n);
+
+        struct BulkRelease;
+
     private:
         void eraseInterpreters(interpreter_list::iterator b, interpreter_list::iterator e);
         void updateIterators(PacketData * self, difference_type pos, difference_type n);
@@ -255,6 +267,9 @@ namespace detail {
         };
 
         PreallocSlot prealloc_[SENF_PACKET_PREALLOC_INTERPRETERS];
+#ifndef SENF_PACKET_NO_HEAP_INTERPRETERS
+        typedef ThreadLocalPool<PreallocSlot, sizeof(PreallocSlot)> HeapInterpreterPool;
+#endif
 #ifdef SENF_PACKET_ALTERNATIVE_PREALLOC
         size_type preallocHigh_;
 #endif
@@ -271,6 +286,24 @@ namespace detail {
 #endif
     };
 
+    /** \brief Internal: Return the memory of all packets released within scope in bulk
+
+        \internal
+
+        \see ThreadLocalPool::BulkFree
+     */
+    struct PacketImpl::BulkRelease
+        : boost::noncopyable
+    {
+        PacketImpl::pool<>::BulkFree impls;
+#ifndef SENF_PACKET_NO_HEAP_INTERPRETERS
+        HeapInterpreterPool::BulkFree interpreters;
+#endif
+#ifndef SENF_PACKET_STD_CONTAINER
+        PacketVector::ChunkPool::BulkFree chunks;
+#endif
+    };
+
     void intrusive_ptr_add_ref(PacketImpl *);
     void intrusive_ptr_release(PacketImpl *);
 
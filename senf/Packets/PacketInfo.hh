@@ -43,6 +43,15 @@ namespace senf {
         bool is_shared() const;
         bool usingExternalMemory() const;
         void releaseExternalMemory() const;
+#ifndef SENF_PACKET_STD_CONTAINER
+        PacketVector * externalMemoryOwner(PacketVector::ExternalMemoryOwner * owner) const;
+                                        ///< Register owner of the packets external memory
+                                        /**< \a owner is notified as soon as the packet stops
+                                             using the external memory (see
+                                             PacketVector::ExternalMemoryOwner).
+                                             \returns the packets data container or \c nullptr,
+                                                 if the packet does not use external memory */
+#endif
 
         void memDebug(std::ostream & os) const;
 
@@ -38,6 +38,23 @@ prefix_ senf::PacketInterpreterBase::ptr senf::PacketInterpreterBase::clone()
     return pi;
 }
 
+prefix_ senf::PacketInterpreterBase::ptr senf::PacketInterpreterBase::cowClone()
+{
+#ifndef SENF_PACKET_STD_CONTAINER
+    size_type b (std::distance(impl().begin(), begin()));
+    detail::PacketImpl::Guard p (new detail::PacketImpl(impl(), b, b + size()));
+    // Sharing may have moved our data out of external memory, so begin() must be re-read here
+    iterator base (begin());
+    ptr pi (appendClone(p.p,base,p.p->begin()));
+    for (ptr i (next()); i; i = i->next())
+        i->appendClone(p.p,base,p.p->begin());
+    pi->impl().assignAnnotations( impl());
+    return pi;
+#else
+    return clone();
+#endif
+}
+
 // Interpreter chain access
 
 prefix_ senf::PacketInterpreterBase::ptr senf::PacketInterpreterBase::append(ptr packet)
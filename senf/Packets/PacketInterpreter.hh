@@ -131,6 +131,7 @@ namespace senf {
         static factory_t no_factory();
 
         ptr clone();
+        ptr cowClone();
 
         //\}
         //-////////////////////////////////////////////////////////////////////////
@@ -308,6 +309,7 @@ namespace senf {
         // Create a clone of the current packet
 
         ptr clone();
+        ptr cowClone();
 
         //\}
         //-////////////////////////////////////////////////////////////////////////
@@ -315,6 +317,7 @@ namespace senf {
         // Packet field access
 
         parser fields();
+        parser constFields();
 
         // PacketType access
 
@@ -72,6 +72,27 @@ namespace senf {
         register multiple Packets with the same \a key as long as the \a priority is unique. The
         registration with the highest \a priority value will take precedence on key lookup.
 
+        \section packet_registry_flat Flat lookup tables
+
+        Key lookup is on the parse path of every packet. For small integral key types (up to 32
+        bits, e.g. ethertype or IP protocol number) the registry therefore keeps an additional flat
+        dispatch table which is rebuilt on every registration change (lookup never modifies the
+        registry and is thus safe to call from several threads concurrently):
+
+        \li if the registered keys span a small range, the table is a dense array indexed by the
+            key
+        \li otherwise the table is a sorted array of keys which is searched by binary search
+
+        Other key types always use the ordered index. Defining SENF_PACKET_REGISTRY_NO_FLAT_LOOKUP
+        disables the flat tables globally (like SENF_PACKET_STD_CONTAINER, this must be defined
+        consistently for the library and all applications). The flat table may be disabled for a
+        single key type by specializing senf::detail::PacketRegistryFlatLookup:
+        \code
+        template <>
+        struct senf::detail::PacketRegistryFlatLookup<some_key_type>
+            : public boost::false_type {};
+        \endcode
+
         \ingroup packet_module
      */
     template <class Tag>
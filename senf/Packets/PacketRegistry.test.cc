@@ -19,6 +19,8 @@
 // Custom includes
 #include <string>
 #include <sstream>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 
 // Unit test includes
 #include <senf/Utils/auto_unit_test.hh>
@@ -153,6 +155,75 @@ SENF_AUTO_TEST_CASE(packetRegistry_test)
     }
 }
 
+SENF_AUTO_TEST_CASE(packetRegistry_flatLookup)
+{
+    typedef PacketRegistry<BaseTag> Registry;
+
+    Registry::registerPacket<FooPacket>(10u);
+    BOOST_CHECK( Registry::lookup(10u).type() == typeid(FooPacket) );
+    // registration changes must invalidate the table
+    Registry::registerPacket<BarPacket>(10u, 1);
+    BOOST_CHECK( Registry::lookup(10u).type() == typeid(BarPacket) );
+    BOOST_CHECK( ! Registry::lookup(11u, senf::nothrow) );
+    BOOST_CHECK( ! Registry::lookup(0u, senf::nothrow) );
+
+    Registry::registerPacket<OtherPacket>(0x10000u);
+    BOOST_CHECK( Registry::lookup(0x10000u).type() == typeid(OtherPacket) );
+    BOOST_CHECK( Registry::lookup(10u).type() == typeid(BarPacket) );
+    BOOST_CHECK( ! Registry::lookup(0x8000u, senf::nothrow) );
+
+    Registry::unregisterPacket<BarPacket>();
+    BOOST_CHECK( Registry::lookup(10u).type() == typeid(FooPacket) );
+    Registry::unregisterPacket<FooPacket>();
+    BOOST_CHECK_THROW( Registry::lookup(10u), PacketTypeNotRegisteredException );
+    Registry::unregisterPacket<OtherPacket>();
+    BOOST_CHECK( ! Registry::lookup(0x10000u, senf::nothrow) );
+}
+
+namespace {
+    struct TestEntry {
+        TestEntry(int k) : key (k) {}
+        int key;
+    };
+}
+
+SENF_AUTO_TEST_CASE(packetRegistry_flatTable)
+{
+    typedef std::vector< boost::shared_ptr<TestEntry> > Entries;
+    Entries entries;
+    entries.push_back(boost::shared_ptr<TestEntry>(new TestEntry(-5)));
+    entries.push_back(boost::shared_ptr<TestEntry>(new TestEntry(3)));
+    entries.push_back(boost::shared_ptr<TestEntry>(new TestEntry(3)));
+
+    senf::detail::PacketRegistryFlatTable<int, TestEntry> table;
+    BOOST_CHECK( ! table.valid() );
+    BOOST_CHECK( table.rebuild(entries.begin(), entries.end()) );
+    BOOST_CHECK( table.valid() );
+    BOOST_CHECK( table.dense() );
+    BOOST_CHECK_EQUAL( table.size(), 9u );
+    BOOST_CHECK_EQUAL( table.find(-5), entries[0].get() );
+    BOOST_CHECK_EQUAL( table.find(3), entries[1].get() );
+    BOOST_CHECK( ! table.find(0) );
+    BOOST_CHECK( ! table.find(-6) );
+    BOOST_CHECK( ! table.find(4) );
+
+    entries.push_back(boost::shared_ptr<TestEntry>(new TestEntry(100000)));
+    table.invalidate();
+    BOOST_CHECK( ! table.valid() );
+    table.rebuild(entries.begin(), entries.end());
+    BOOST_CHECK( ! table.dense() );
+    BOOST_CHECK_EQUAL( table.size(), 3u );
+    BOOST_CHECK_EQUAL( table.find(-5), entries[0].get() );
+    BOOST_CHECK_EQUAL( table.find(3), entries[1].get() );
+    BOOST_CHECK_EQUAL( table.find(100000), entries[3].get() );
+    BOOST_CHECK( ! table.find(4) );
+    BOOST_CHECK( ! table.find(200000) );
+
+    senf::detail::PacketRegistryFlatTable<std::string, TestEntry> disabled;
+    BOOST_CHECK( ! disabled.rebuild(entries.begin(), entries.end()) );
+    BOOST_CHECK( ! disabled.valid() );
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
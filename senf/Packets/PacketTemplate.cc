@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PacketTemplate non-inline non-template implementation */
+
+#include "PacketTemplate.hh"
+//#include "PacketTemplate.ih"
+
+// Custom includes
+#include <string.h>
+#include <senf/Utils/senfassert.hh>
+
+//#include "PacketTemplate.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::PacketTemplate
+
+prefix_ senf::PacketTemplate::PacketTemplate(Packet const & prototype)
+    : prototype_ (prototype), now_ (0u)
+{
+    prototype_.finalizeAll();
+    image_.assign(prototype_.data().begin(), prototype_.data().end());
+}
+
+prefix_ senf::PacketTemplate::FieldId
+senf::PacketTemplate::checksum(size_type offset, size_type begin, size_type end)
+{
+    SENF_ASSERT( begin <= offset && offset + 2u <= end,
+                 "checksum field outside of checksummed range" );
+    FieldId id (add(Checksum, offset, 2u, 0u));
+    fields_[id].begin = begin;
+    fields_[id].end = end;
+    for (FieldId i (0); i < id; ++i)
+        if (fields_[i].type != Checksum
+            && fields_[i].offset >= begin && fields_[i].offset + fields_[i].bytes <= end)
+            fields_[id].covered.push_back(std::make_pair(i, ((fields_[i].offset - begin) & 1) != 0));
+    return id;
+}
+
+prefix_ void senf::PacketTemplate::cover(FieldId checksum, FieldId field)
+{
+    SENF_ASSERT( checksum < fields_.size() && fields_[checksum].type == Checksum
+                 && field < fields_.size() && fields_[field].type != Checksum,
+                 "invalid field passed to PacketTemplate::cover()" );
+    fields_[checksum].covered.push_back(std::make_pair(field, false));
+}
+
+prefix_ void senf::PacketTemplate::reset()
+{
+    for (std::vector<Field>::iterator i (fields_.begin()); i != fields_.end(); ++i)
+        i->next = i->base;
+}
+
+prefix_ senf::Packet senf::PacketTemplate::stamp(size_type size)
+{
+    Packet p (prototype_.factory()->create(size, senf::noinit));
+    if (size > 0u)
+        stamp(&(*p.data().begin()), size);
+    return p;
+}
+
+prefix_ void senf::PacketTemplate::stamp(void * buffer, size_type size)
+{
+    SENF_ASSERT( size >= image_.size(), "stamped packet smaller than PacketTemplate" );
+    boost::uint8_t * p (static_cast<boost::uint8_t *>(buffer));
+    if (! image_.empty())
+        ::memcpy(p, &image_[0], image_.size());
+    ::memset(p + image_.size(), 0, size - image_.size());
+    patch(p, size);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// private members
+
+prefix_ senf::PacketTemplate::Field::Field(FieldType type_, size_type offset_, size_type bytes_,
+                                           boost::uint64_t base_, boost::uint64_t arg_)
+    : type (type_), offset (offset_), bytes (bytes_), base (base_), arg (arg_), next (base_),
+      value (base_), begin (0u), end (0u)
+{}
+
+prefix_ senf::PacketTemplate::FieldId
+senf::PacketTemplate::add(FieldType type, size_type offset, size_type bytes, boost::uint64_t arg)
+{
+    SENF_ASSERT( bytes >= 1u && bytes <= 8u && offset + bytes <= image_.size(),
+                 "invalid PacketTemplate field" );
+    SENF_ASSERT( type != Timestamp || arg > 0u, "invalid PacketTemplate timestamp unit" );
+    FieldId id (fields_.size());
+    fields_.push_back(Field(type, offset, bytes, read(offset, bytes), arg));
+    if (type != Checksum)
+        for (FieldId i (0); i < id; ++i)
+            if (fields_[i].type == Checksum
+                && offset >= fields_[i].begin && offset + bytes <= fields_[i].end)
+                fields_[i].covered.push_back(
+                    std::make_pair(id, ((offset - fields_[i].begin) & 1) != 0));
+    return id;
+}
+
+prefix_ boost::uint64_t senf::PacketTemplate::read(size_type offset, size_type bytes)
+    const
+{
+    boost::uint64_t v (0u);
+    for (size_type i (0); i < bytes; ++i)
+        v = (v << 8) | image_[offset + i];
+    return v;
+}
+
+prefix_ void senf::PacketTemplate::write(boost::uint8_t * p, size_type bytes,
+                                         boost::uint64_t value)
+{
+    for (; bytes > 0; --bytes, value >>= 8)
+        p[bytes - 1] = value & 0xffu;
+}
+
+prefix_ boost::uint32_t senf::PacketTemplate::sum(boost::uint64_t value, size_type bytes,
+                                                  bool odd)
+{
+    // Sum of the 16bit words the value contributes to the checksum. odd is set, if the value
+    // starts at an odd offset within the checksummed data
+    boost::uint32_t s (0u);
+    for (size_type i (bytes); i > 0; --i, value >>= 8) {
+        boost::uint32_t b (value & 0xffu);
+        // i is the position counted from the end, the parity of the first byte is given by odd
+        s += ((i - 1) & 1) == (odd ? 1u : 0u) ? b << 8 : b;
+    }
+    while (s >> 16)
+        s = (s & 0xffffu) + (s >> 16);
+    return s;
+}
+
+prefix_ void senf::PacketTemplate::patch(boost::uint8_t * buffer, size_type size)
+{
+    size_type extra (size - image_.size());
+    for (std::vector<Field>::iterator i (fields_.begin()); i != fields_.end(); ++i) {
+        switch (i->type) {
+        case Counter:
+            i->value = i->next;
+            i->next += i->arg;
+            break;
+        case Timestamp:
+            i->value = now_ / i->arg;
+            break;
+        case Length:
+            i->value = i->base + extra;
+            break;
+        case Checksum:
+            continue;
+        }
+        if (i->bytes < 8u)
+            i->value &= (boost::uint64_t(1u) << (8 * i->bytes)) - 1u;
+        write(buffer + i->offset, i->bytes, i->value);
+    }
+    // RFC 1624: HC' = ~(~HC + ~m + m')
+    for (std::vector<Field>::iterator i (fields_.begin()); i != fields_.end(); ++i) {
+        if (i->type != Checksum)
+            continue;
+        boost::uint32_t s (~i->base & 0xffffu);
+        for (std::vector< std::pair<FieldId, bool> >::const_iterator j (i->covered.begin());
+             j != i->covered.end(); ++j) {
+            Field const & f (fields_[j->first]);
+            if (f.value == f.base)
+                continue;
+            s += ~sum(f.base, f.bytes, j->second) & 0xffffu;
+            s += sum(f.value, f.bytes, j->second);
+        }
+        while (s >> 16)
+            s = (s & 0xffffu) + (s >> 16);
+        i->value = ~s & 0xffffu;
+        if (i->value == 0u)
+            // 0 and 0xffff are equivalent. 0 is reserved as 'no checksum' in UDP
+            i->value = 0xffffu;
+        write(buffer + i->offset, 2u, i->value);
+    }
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "PacketTemplate.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PacketTemplate public header */
+
+#ifndef HH_SENF_Packets_PacketTemplate_
+#define HH_SENF_Packets_PacketTemplate_ 1
+
+// Custom includes
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+#include "Packets.hh"
+
+//#include "PacketTemplate.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    /** \brief Stamp packets from a precompiled prototype
+
+        Traffic generators typically create every packet by cloning a prototype, updating some
+        fields (sequence numbers, timestamps) and calling finalizeAll(). This will re-create and
+        re-walk the complete interpreter chain for every packet sent.
+
+        A PacketTemplate compiles a fully parsed and finalized prototype packet into a flat byte
+        image and a list of patchable fields. Stamping a packet then just copies the image and
+        patches the registered fields in place:
+
+        \code
+        senf::EthernetPacket eth (senf::EthernetPacket::create());
+        senf::IPv4Packet ip (senf::IPv4Packet::createAfter(eth));
+        senf::UDPPacket udp (senf::UDPPacket::createAfter(ip));
+        senf::DataPacket payload (senf::DataPacket::createAfter(udp, 64u));
+        // ... initialize all header fields ...
+
+        senf::PacketTemplate tmpl (eth);  // calls eth.finalizeAll()
+        senf::PacketTemplate::FieldId seqno (tmpl.counter(ip->identifier()));
+        tmpl.length(ip->length());
+        tmpl.checksum(ip->checksum(), tmpl.offset(ip), tmpl.offset(udp));
+        tmpl.cover(tmpl.checksum(udp->checksum(), tmpl.offset(udp)), tmpl.length(udp->length()));
+
+        for (;;) {
+            senf::EthernetPacket p (tmpl.stamp().as<senf::EthernetPacket>());
+            ...
+        }
+        \endcode
+
+        The following field types are supported. All fields are unsigned big endian integers of 1
+        to 8 bytes:
+
+        \li A \e counter is incremented by \a step for every packet stamped, starting with the
+            value found in the prototype.
+        \li A \e timestamp field is set to the time last set via now() divided by \a unit
+            (e.g. <tt>now(senf::ClockService::now())</tt> and a unit of 1000 for a microsecond
+            timestamp). The time is set explicitly since updating it once per burst is enough.
+        \li A \e length field is increased by the number of bytes a stamped packet is larger than
+            the prototype (see stamp()).
+        \li A \e checksum is an Internet checksum (RFC 1071) over the byte range [\a begin, \a
+            end) of the image. Instead of recomputing it, the value found in the prototype is
+            updated incrementally for every field within this range (RFC 1624). Fields not
+            contained in the range but nevertheless part of the checksum (like the length in the
+            UDP pseudo header) are added via cover().
+
+        Field offsets are relative to the start of the prototype packet. They may be passed
+        explicitly or as parsers of the prototype packet (e.g. <tt>ip->identifier()</tt>). Fields
+        must not overlap and checksum ranges must not contain other checksum fields.
+
+        Stamped packets are created with the type of the prototype packet. Only this outermost
+        interpreter is created, the remaining chain is only parsed when accessed. Alternatively,
+        packets may be stamped into arbitrary memory (e.g. a TX ring frame of a
+        QueueWriteableSocketHandle). The template keeps a reference to the prototype packet.
+
+        \ingroup packet_module
+     */
+    class PacketTemplate
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // Types
+
+        typedef PacketData::size_type size_type;
+        typedef unsigned FieldId;       ///< Identifier of a registered field
+
+        static size_type const npos = size_type(-1);
+
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        explicit PacketTemplate(Packet const & prototype);
+                                        ///< Compile \a prototype
+                                        /**< Calls <tt>prototype.finalizeAll()</tt> and takes the
+                                             packet image. Later changes to the prototype are not
+                                             reflected in the template. */
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Fields
+        //\{
+
+        size_type offset(PacketData::iterator i) const;
+                                        ///< Offset of \a i relative to prototype packet
+        size_type offset(Packet const & packet) const;
+                                        ///< Offset of \a packet relative to prototype packet
+        template <class Parser>
+        typename boost::enable_if<boost::is_base_of<PacketParserBase, Parser>, size_type>::type
+            offset(Parser const & parser) const;
+                                        ///< Offset of \a parser relative to prototype packet
+
+        FieldId counter(size_type offset, size_type bytes, boost::uint64_t step = 1u);
+                                        ///< Register counter field
+        template <class Parser>
+        typename boost::enable_if<boost::is_base_of<PacketParserBase, Parser>, FieldId>::type
+            counter(Parser const & field, boost::uint64_t step = 1u);
+                                        ///< Register counter field given as parser
+
+        FieldId timestamp(size_type offset, size_type bytes, boost::uint64_t unit = 1u);
+                                        ///< Register timestamp field
+        template <class Parser>
+        typename boost::enable_if<boost::is_base_of<PacketParserBase, Parser>, FieldId>::type
+            timestamp(Parser const & field, boost::uint64_t unit = 1u);
+                                        ///< Register timestamp field given as parser
+
+        FieldId length(size_type offset, size_type bytes);
+                                        ///< Register length field
+        template <class Parser>
+        typename boost::enable_if<boost::is_base_of<PacketParserBase, Parser>, FieldId>::type
+            length(Parser const & field);
+                                        ///< Register length field given as parser
+
+        FieldId checksum(size_type offset, size_type begin, size_type end = npos);
+                                        ///< Register 16bit checksum field
+                                        /**< \param[in] offset offset of the checksum field
+                                             \param[in] begin start of checksummed range
+                                             \param[in] end end of checksummed range. \c npos
+                                                 includes all data up to the end of the
+                                                 stamped packet. */
+        template <class Parser>
+        typename boost::enable_if<boost::is_base_of<PacketParserBase, Parser>, FieldId>::type
+            checksum(Parser const & field, size_type begin, size_type end = npos);
+                                        ///< Register checksum field given as parser
+
+        void cover(FieldId checksum, FieldId field);
+                                        ///< Add \a field to \a checksum
+                                        /**< Adds \a field as additional 16bit aligned data to \a
+                                             checksum. This is used for data not contained in the
+                                             checksummed range like the UDP pseudo header
+                                             length. */
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Stamping
+        //\{
+
+        size_type size() const;         ///< Size of the prototype image
+        Packet prototype() const;       ///< Prototype packet
+
+        void now(boost::uint64_t time); ///< Set time used for timestamp fields
+        void reset();                   ///< Reset all counters to their initial value
+
+        Packet stamp();                 ///< Stamp next packet
+        Packet stamp(size_type size);   ///< Stamp next packet of \a size bytes
+                                        /**< \a size must not be smaller than size(). The data
+                                             following the prototype image is zero filled and all
+                                             length fields are adjusted accordingly. */
+        void stamp(void * buffer, size_type size);
+                                        ///< Stamp next packet into \a buffer
+                                        /**< \a buffer must provide \a size bytes, \a size must not
+                                             be smaller than size(). */
+        template <class OutputIterator>
+        void stamp(unsigned n, OutputIterator out, size_type size = 0u);
+                                        ///< Stamp burst of \a n packets
+                                        /**< Writes \a n stamped packets to \a out. A \a size of 0
+                                             stamps packets of size() bytes. */
+
+        //\}
+
+    private:
+        enum FieldType { Counter, Timestamp, Length, Checksum };
+
+        struct Field
+        {
+            Field(FieldType type_, size_type offset_, size_type bytes_, boost::uint64_t base_,
+                  boost::uint64_t arg_);
+
+            FieldType type;
+            size_type offset;
+            size_type bytes;
+            boost::uint64_t base;       // value in the prototype image
+            boost::uint64_t arg;        // counter step or timestamp unit
+            boost::uint64_t next;       // next counter value
+            boost::uint64_t value;      // last stamped value
+            size_type begin;            // checksum range
+            size_type end;
+            std::vector< std::pair<FieldId, bool> > covered; // fields added and their parity
+        };
+
+        FieldId add(FieldType type, size_type offset, size_type bytes, boost::uint64_t arg);
+        boost::uint64_t read(size_type offset, size_type bytes) const;
+        static void write(boost::uint8_t * p, size_type bytes, boost::uint64_t value);
+        static boost::uint32_t sum(boost::uint64_t value, size_type bytes, bool odd);
+        void patch(boost::uint8_t * buffer, size_type size);
+
+        Packet prototype_;
+        std::vector<boost::uint8_t> image_;
+        std::vector<Field> fields_;
+        boost::uint64_t now_;
+    };
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "PacketTemplate.cci"
+//#include "PacketTemplate.ct"
+#include "PacketTemplate.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief PacketTemplate unit tests */
+
+#include "PacketTemplate.hh"
+
+// Custom includes
+#include <vector>
+#include <senf/Packets/DefaultBundle/EthernetPacket.hh>
+#include <senf/Packets/DefaultBundle/IPv4Packet.hh>
+#include <senf/Packets/DefaultBundle/UDPPacket.hh>
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+SENF_AUTO_TEST_CASE(packetTemplate)
+{
+    senf::EthernetPacket eth (senf::EthernetPacket::create());
+    eth->source() = senf::MACAddress::from_string("00:11:22:33:44:55");
+    eth->destination() = senf::MACAddress::from_string("00:11:22:33:44:66");
+    senf::IPv4Packet ip (senf::IPv4Packet::createAfter(eth));
+    ip->source() = senf::INet4Address::from_string("192.168.0.1");
+    ip->destination() = senf::INet4Address::from_string("192.168.0.2");
+    ip->identifier() = 0xfffeu;
+    ip->ttl() = 64u;
+    senf::UDPPacket udp (senf::UDPPacket::createAfter(ip));
+    udp->source() = 5000u;
+    udp->destination() = 5001u;
+    senf::DataPacket payload (senf::DataPacket::createAfter(udp, 13u));
+    // an odd sized payload places the second payload field at an odd offset
+    payload.data()[0] = 0xa5u;
+
+    senf::PacketTemplate tmpl (eth);
+    BOOST_CHECK_EQUAL( tmpl.size(), 14u + 20u + 8u + 13u );
+    BOOST_CHECK( ip->validateChecksum() );
+    BOOST_CHECK_EQUAL( tmpl.offset(ip), 14u );
+    BOOST_CHECK_EQUAL( tmpl.offset(ip->identifier()), 18u );
+
+    tmpl.counter(ip->identifier());
+    tmpl.length(ip->length());
+    tmpl.checksum(ip->checksum(), tmpl.offset(ip), tmpl.offset(udp));
+    senf::PacketTemplate::FieldId udpLength (tmpl.length(udp->length()));
+    tmpl.cover(tmpl.checksum(udp->checksum(), tmpl.offset(udp)), udpLength);
+    // fields registered after the checksum are covered as well
+    tmpl.counter(tmpl.offset(payload) + 1u, 4u, 3u);
+    tmpl.timestamp(tmpl.offset(payload) + 5u, 8u, 1000u);
+
+    std::vector<senf::Packet> packets;
+    tmpl.now(123456789u);
+    tmpl.stamp(2u, std::back_inserter(packets));
+    packets.push_back(tmpl.stamp(tmpl.size() + 5u));
+    tmpl.now(987654321u);
+    packets.push_back(tmpl.stamp(tmpl.size() + 10u));
+    BOOST_REQUIRE_EQUAL( packets.size(), 4u );
+
+    for (unsigned i (0); i < packets.size(); ++i) {
+        BOOST_REQUIRE( packets[i].is<senf::EthernetPacket>() );
+        senf::IPv4Packet sip (packets[i].find<senf::IPv4Packet>());
+        senf::UDPPacket sudp (packets[i].find<senf::UDPPacket>());
+        senf::Packet spayload (sudp.next());
+        unsigned extra (i < 2 ? 0u : i == 2 ? 5u : 10u);
+        BOOST_CHECK_EQUAL( packets[i].size(), tmpl.size() + extra );
+        BOOST_CHECK_EQUAL( sip->identifier(), (0xfffeu + i) & 0xffffu );
+        BOOST_CHECK_EQUAL( sip->length(), 20u + 8u + 13u + extra );
+        BOOST_CHECK_EQUAL( sudp->length(), 8u + 13u + extra );
+        BOOST_CHECK( sip->validateChecksum() );
+        BOOST_CHECK( sudp->validateChecksum() );
+        BOOST_CHECK_EQUAL( spayload.data()[0], 0xa5u );
+        BOOST_CHECK_EQUAL( spayload.data()[4], 3u * i );
+        BOOST_CHECK_EQUAL( spayload.data()[12], i < 3 ? 0x40u : 0x06u );
+    }
+
+    tmpl.reset();
+    std::vector<unsigned char> buffer (tmpl.size());
+    tmpl.stamp(&buffer[0], buffer.size());
+    senf::EthernetPacket raw (senf::EthernetPacket::create(buffer));
+    BOOST_CHECK_EQUAL( raw.find<senf::IPv4Packet>()->identifier(), 0xfffeu );
+    BOOST_CHECK( raw.find<senf::UDPPacket>()->validateChecksum() );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
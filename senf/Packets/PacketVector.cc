@@ -25,11 +25,100 @@
 
 #ifndef SENF_PACKET_STD_CONTAINER
 
+// Copy-on-write: The first vector sharing its data moves ownership of the buffer into a reference
+// counted SharedBuffer. Each vector using the buffer then references it as external memory with the
+// SharedBuffer as the ExternalMemoryOwner, so the existing external memory release path
+// (grow()/destructor) drops the reference. The last user frees the buffer.
+
+prefix_ senf::PacketVector::PacketVector(PacketVector & other, size_type b, size_type e)
+    : owner_ (false),
+      shared_ (true)
+{
+    SENF_ASSERT( b <= e && e <= other.size(), "invalid range passed to sharing PacketVector" );
+    if (other.external())
+        other.releaseExternal();
+    if (! other.shared_) {
+        other.externalOwner_ = new SharedBuffer(other.data_, other.size_);
+        other.owner_ = false;
+        other.shared_ = true;
+    }
+    SharedBuffer * buffer (static_cast<SharedBuffer *>(other.externalOwner_));
+    ++ buffer->refcount;
+    externalOwner_ = buffer;
+    size_ = e - b;
+    data_ = other.b_ + b;
+    b_ = data_;
+    e_ = data_ + size_;
+}
+
+prefix_ senf::PacketVector::value_type * senf::PacketVector::allocateMultiChunk(size_type chunks)
+{
+    // The buffer is served from the smallest pool with at least 'chunks' chunks. deallocate() is
+    // called with the same number of chunks and thus selects the same pool.
+    if (chunks <= 2)
+        return static_cast<value_type *>(MultiChunkPool<2>::malloc());
+    if (chunks <= 4)
+        return static_cast<value_type *>(MultiChunkPool<4>::malloc());
+    if (chunks <= 8)
+        return static_cast<value_type *>(MultiChunkPool<8>::malloc());
+    if (chunks <= 16)
+        return static_cast<value_type *>(MultiChunkPool<16>::malloc());
+    if (chunks <= MaxPooledChunks)
+        return static_cast<value_type *>(MultiChunkPool<MaxPooledChunks>::malloc());
+    return static_cast<value_type *>(::operator new(chunks << ChunkSizeIndex));
+}
+
+prefix_ void senf::PacketVector::deallocateMultiChunk(value_type * data, size_type chunks)
+{
+    if (chunks <= 2)
+        MultiChunkPool<2>::free(data);
+    else if (chunks <= 4)
+        MultiChunkPool<4>::free(data);
+    else if (chunks <= 8)
+        MultiChunkPool<8>::free(data);
+    else if (chunks <= 16)
+        MultiChunkPool<16>::free(data);
+    else if (chunks <= MaxPooledChunks)
+        MultiChunkPool<MaxPooledChunks>::free(data);
+    else
+        ::operator delete(data);
+}
+
+prefix_ senf::PacketVector::SharedBuffer::SharedBuffer(value_type * data_, size_type size_)
+    : refcount (1u), data (data_), size (size_)
+{}
+
+prefix_ void senf::PacketVector::SharedBuffer::externalMemoryReleased(value_type *)
+{
+    if (-- refcount == 0) {
+        deallocate(data, size >> ChunkSizeIndex);
+        delete this;
+    }
+}
+
+prefix_ senf::PacketVector::iterator senf::PacketVector::unshare(iterator pos)
+{
+    SharedBuffer * buffer (static_cast<SharedBuffer *>(externalOwner_));
+    if (buffer->refcount == 1) {
+        // we are the last user: take over the buffer
+        data_ = buffer->data;
+        size_ = buffer->size;
+        owner_ = true;
+        shared_ = false;
+        externalOwner_ = nullptr;
+        delete buffer;
+        return pos;
+    }
+    return grow(pos, 0);
+}
+
 prefix_ senf::PacketVector::iterator senf::PacketVector::moveGrow(iterator pos, size_type n)
 {
-    // This is called in two cases:
+    // This is called in three cases:
     // a) best insertion side is back but there is not enough tailroom
-    // b) a reallocation is needed (neither headroom nor tailroom are sufficient)
+    // b) insertion at the front of non-empty data (e.g. createBefore()) but there is not enough
+    //    headroom
+    // c) a reallocation is needed (neither headroom nor tailroom are sufficient)
     if (b_ >= data_ + n) {
         // there is enough headroom. This can only be true if the best insertion side really is
         // the end but there is not enough tailroom (otherwise moveGrow would not have been called)
@@ -37,6 +126,16 @@ prefix_ senf::PacketVector::iterator senf::PacketVector::moveGrow(iterator pos,
         b_ -= n;
         return pos - n;
     }
+    else if (pos == b_ && size_type(e_ - b_) + n + HeadRoom <= size_) {
+        // Prepending headers: Moving the data just by n bytes would need to move the complete
+        // packet again on the next prepend. Instead restore the full headroom, so further headers
+        // may be prepended without moving the data
+        size_type dataSize (e_ - b_);
+        ::memmove(data_ + HeadRoom + n, b_, dataSize);
+        b_ = data_ + HeadRoom;
+        e_ = b_ + n + dataSize;
+        return b_;
+    }
     else
         // otherwise we need a reallocation
         return grow(pos, n);
@@ -47,16 +146,22 @@ prefix_ senf::PacketVector::iterator senf::PacketVector::grow(iterator pos, size
     size_type posIndex (pos - b_);
     size_type dataSize (e_ - b_);
     size_type requestSize (allocationSize(dataSize + n));
-    value_type * newData (static_cast<value_type *>(Pool::ordered_malloc(requestSize >> ChunkSizeIndex)));
+    value_type * newData (allocate(requestSize >> ChunkSizeIndex));
     ::memcpy(newData + HeadRoom, b_, posIndex);
     ::memcpy(newData + HeadRoom + posIndex + n, b_ + posIndex, dataSize - posIndex);
     if (owner_)
-        Pool::ordered_free(data_, size_ >> ChunkSizeIndex);
+        deallocate(data_, size_ >> ChunkSizeIndex);
+    else if (externalOwner_) {
+        ExternalMemoryOwner * externalOwner (externalOwner_);
+        externalOwner_ = nullptr;
+        externalOwner->externalMemoryReleased(data_);
+    }
     b_ = newData + HeadRoom;
     e_ = b_ + dataSize + n;
     size_ = requestSize;
     data_ = newData;
     owner_ = true;
+    shared_ = false;
     return b_ + posIndex;
 }
 
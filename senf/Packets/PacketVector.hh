@@ -18,10 +18,11 @@
 #define HH_SENF_Packets_PacketVector_ 1
 
 // Custom includes
+#include <atomic>
 #include <boost/noncopyable.hpp>
 #include <boost/cstdint.hpp>
-#include <boost/pool/singleton_pool.hpp>
 #include <senf/config.hh>
+#include <senf/Utils/ThreadLocalPool.hh>
 #include <cstddef>
 
 //#include "PacketVector.mpp"
@@ -37,8 +38,6 @@ namespace senf {
         : boost::noncopyable
     {
         struct PacketVectorPoolTag {};
-        typedef boost::singleton_pool<
-            PacketVectorPoolTag, 1u << SENF_PACKET_VECTOR_SIZE_INDEX> Pool;
 
     public:
         ///////////////////////////////////////////////////////////////////////////
@@ -55,6 +54,29 @@ namespace senf {
         static size_type const HeadRoom = SENF_PACKET_VECTOR_HEADROOM;
         static size_type const TailRoom = SENF_PACKET_VECTOR_TAILROOM;
 
+        typedef ThreadLocalPool<PacketVectorPoolTag, ChunkSize> ChunkPool;
+                                        ///< Thread local pool serving single chunk buffers
+        static size_type const MaxPooledChunks = 32u;
+                                        ///< Largest buffer (in chunks) served from a pool
+                                        /**< Multi chunk buffers are served from thread local
+                                             pools with power of two chunk counts up to
+                                             MaxPooledChunks. Even larger buffers are
+                                             allocated from the heap. */
+
+        /** \brief Owner of external packet memory
+
+            An ExternalMemoryOwner may be registered with a PacketVector using external memory. It
+            is notified as soon as the PacketVector stops using the external memory, either
+            because the vector is destroyed or because the data has been moved into internally
+            managed memory (releaseExternal() or an insert() exceeding the external buffer).
+         */
+        struct ExternalMemoryOwner
+        {
+            virtual ~ExternalMemoryOwner();
+            virtual void externalMemoryReleased(value_type * data) = 0;
+                                        ///< Called when the external memory \a data is released
+        };
+
         ///////////////////////////////////////////////////////////////////////////
         ///\name Structors and default members
         ///@{
@@ -70,6 +92,14 @@ namespace senf {
         PacketVector(ForwardIterator f, ForwardIterator l);
         PacketVector(value_type * data, size_type size,
                      size_type chunkSize = 0u, size_type offset = 0u);
+        PacketVector(PacketVector & other, size_type b, size_type e);
+                                        ///< Share data with \a other
+                                        /**< The new vector references the bytes [\a b, \a e)
+                                             (relative to other.begin()) of \a other. Both
+                                             vectors use the same reference counted buffer until
+                                             either is modified (copy-on-write, see shared()). If
+                                             \a other uses external memory, its data is first
+                                             moved into an internal buffer. */
 
         ~PacketVector();
 
@@ -88,6 +118,22 @@ namespace senf {
 
         bool external() const;
         void releaseExternal();
+        void externalOwner(ExternalMemoryOwner * owner);
+                                        ///< Register owner of external memory
+                                        /**< \a owner will be notified as soon as this vector does
+                                             not use the external memory any more. Only valid, if
+                                             external() is \c true. */
+
+        bool shared() const;            ///< \c true, if the data buffer is shared
+                                        /**< A shared buffer is used by several vectors. Any
+                                             modification through the vector interface (insert(),
+                                             erase()) first creates a private copy. Writing to a
+                                             shared buffer via iterators is not allowed, call
+                                             releaseShared() before. */
+        void releaseShared();           ///< Create private copy of shared data
+                                        /**< If this vector is the last user of the shared buffer,
+                                             it takes over the buffer without copying. Invalidates
+                                             all iterators. No-op, if shared() is \c false. */
 
         void erase(iterator pos);
         void erase(iterator first, iterator last);
@@ -99,19 +145,47 @@ namespace senf {
         template <class ForwardIterator>
         void insert(iterator pos, ForwardIterator f, ForwardIterator l);
 
+        static void preallocate(unsigned n); ///< Pre-warm the calling threads chunk cache
+                                        /**< Single chunk buffers are allocated from a per-thread
+                                             cache (see ThreadLocalPool). This call ensures, that
+                                             at least \a n chunks are available in the cache of
+                                             the calling thread. */
+
     protected:
 
     private:
+        struct SharedBuffer : public ExternalMemoryOwner
+        {
+            SharedBuffer(value_type * data_, size_type size_);
+            virtual void externalMemoryReleased(value_type *);
+
+            std::atomic<unsigned> refcount;
+            value_type * data;
+            size_type size;
+        };
+
         static size_type allocationSize(size_type sz);
+        template <unsigned Chunks>
+        struct MultiChunkPool
+            : public ThreadLocalPool<PacketVectorPoolTag, Chunks * ChunkSize, 8u>
+        {};
+
+        static value_type * allocate(size_type chunks);
+        static void deallocate(value_type * data, size_type chunks);
+        static value_type * allocateMultiChunk(size_type chunks);
+        static void deallocateMultiChunk(value_type * data, size_type chunks);
         iterator move(iterator pos, size_type n);
         iterator moveGrow(iterator pos, size_type n);
         iterator grow(iterator pos, size_type n);
+        iterator unshare(iterator pos);
 
         size_type size_;
         value_type * data_;
         iterator b_;
         iterator e_;
         bool owner_;
+        bool shared_;
+        ExternalMemoryOwner * externalOwner_;
     };
 
 }
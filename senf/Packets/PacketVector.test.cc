@@ -17,7 +17,11 @@
 #include "PacketVector.hh"
 
 // Custom includes
+#include <string.h>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 // Unit test includes
 #include <senf/Utils/auto_unit_test.hh>
@@ -135,6 +139,179 @@ SENF_AUTO_TEST_CASE(packetVector)
     }
 }
 
+SENF_AUTO_TEST_CASE(packetVector_preallocate)
+{
+    typedef senf::PacketVector::ChunkPool ChunkPool;
+
+    senf::PacketVector::preallocate(100);
+    BOOST_CHECK( ChunkPool::cached() >= 100u );
+    unsigned long allocated (ChunkPool::allocated());
+
+    {
+        std::vector< std::unique_ptr<senf::PacketVector> > vecs;
+        for (unsigned i (0); i < 100; ++i)
+            vecs.emplace_back(new senf::PacketVector(64u, senf::PacketVector::value_type(0)));
+        // multi chunk buffers are not served from the single chunk pool
+        senf::PacketVector big (3 * senf::PacketVector::ChunkSize, senf::PacketVector::value_type(0));
+        BOOST_CHECK_EQUAL( ChunkPool::allocated(), allocated );
+    }
+    BOOST_CHECK( ChunkPool::cached() > 0u );
+}
+
+SENF_AUTO_TEST_CASE(packetVector_crossThread)
+{
+    // Buffers of any size may be freed by another thread
+    typedef senf::PacketVector::size_type size_type;
+    size_type const sizes[] = { 64u, 3 * senf::PacketVector::ChunkSize,
+                                20 * senf::PacketVector::ChunkSize,
+                                2 * senf::PacketVector::MaxPooledChunks
+                                    * senf::PacketVector::ChunkSize };
+    for (unsigned round (0); round < 2; ++round) {
+        std::vector< std::unique_ptr<senf::PacketVector> > vecs;
+        for (unsigned i (0); i < 50; ++i)
+            for (size_type size : sizes)
+                vecs.emplace_back(new senf::PacketVector(size, senf::PacketVector::value_type(i)));
+        std::thread t ([&vecs]() { vecs.clear(); });
+        t.join();
+        BOOST_CHECK( vecs.empty() );
+    }
+}
+
+namespace {
+
+    struct TestOwner : public senf::PacketVector::ExternalMemoryOwner
+    {
+        TestOwner() : released (nullptr), count (0) {}
+        virtual void externalMemoryReleased(senf::PacketVector::value_type * data)
+            { released = data; ++ count; }
+        senf::PacketVector::value_type * released;
+        unsigned count;
+    };
+
+}
+
+SENF_AUTO_TEST_CASE(packetVector_externalOwner)
+{
+    senf::PacketVector::value_type storage[] = "\0\0\0TEST\0\0";
+    TestOwner owner;
+
+    {
+        senf::PacketVector vec (storage, 4u, 10u, 3u);
+        vec.externalOwner(&owner);
+        * vec.begin() = 'F';
+        vec.insert(vec.end(), 2, '!');
+        BOOST_CHECK_EQUAL( owner.count, 0u );
+        BOOST_CHECK( vec.external() );
+    }
+    BOOST_CHECK_EQUAL( owner.count, 1u );
+    BOOST_CHECK( owner.released == storage );
+
+    {
+        senf::PacketVector vec (storage, 4u, 10u, 3u);
+        vec.externalOwner(&owner);
+        vec.insert(vec.end(), 10, '!');
+        BOOST_CHECK( ! vec.external() );
+        BOOST_CHECK_EQUAL( owner.count, 2u );
+        BOOST_CHECK_EQUAL( str(vec), strc("FEST!!!!!!!!!!") );
+    }
+    BOOST_CHECK_EQUAL( owner.count, 2u );
+
+    {
+        senf::PacketVector vec (storage, 4u, 10u, 3u);
+        vec.externalOwner(&owner);
+        vec.releaseExternal();
+        BOOST_CHECK_EQUAL( owner.count, 3u );
+    }
+    BOOST_CHECK_EQUAL( owner.count, 3u );
+}
+
+SENF_AUTO_TEST_CASE(packetVector_prepend)
+{
+    senf::PacketVector::value_type storage[1024];
+    ::memset(storage, 'x', sizeof(storage));
+
+    // no headroom at all
+    senf::PacketVector vec (storage, 64u, sizeof(storage), 0u);
+    vec.insert(vec.begin(), 4u, 'a');
+    BOOST_CHECK( vec.external() );
+    BOOST_CHECK_EQUAL( vec.size(), 68u );
+    senf::PacketVector::value_type * payload (&(*vec.begin()) + 4);
+    BOOST_CHECK_EQUAL( *payload, 'x' );
+
+    // the first prepend has restored the headroom: further headers do not move the payload
+    vec.insert(vec.begin(), 8u, 'b');
+    vec.insert(vec.begin(), 16u, 'c');
+    BOOST_CHECK( payload == &(*vec.begin()) + 28 );
+    BOOST_CHECK_EQUAL( vec.size(), 92u );
+    BOOST_CHECK_EQUAL( *vec.begin(), 'c' );
+    BOOST_CHECK_EQUAL( *(vec.begin() + 16), 'b' );
+    BOOST_CHECK_EQUAL( *(vec.begin() + 24), 'a' );
+    BOOST_CHECK_EQUAL( *(vec.begin() + 28), 'x' );
+}
+
+SENF_AUTO_TEST_CASE(packetVector_shared)
+{
+    std::string data ("TEST");
+
+    {
+        senf::PacketVector vec (data.begin(), data.end());
+        senf::PacketVector shared (vec, 1u, 3u);
+        BOOST_CHECK( vec.shared() );
+        BOOST_CHECK( shared.shared() );
+        BOOST_CHECK( ! vec.external() );
+        BOOST_CHECK( ! shared.external() );
+        BOOST_CHECK( shared.begin() == vec.begin() + 1 );
+        BOOST_CHECK_EQUAL( str(shared), strc("ES") );
+
+        shared.insert(shared.end(), '!');
+        BOOST_CHECK( ! shared.shared() );
+        BOOST_CHECK_EQUAL( str(shared), strc("ES!") );
+        BOOST_CHECK_EQUAL( str(vec), strc("TEST") );
+
+        // The last user takes over the buffer without copying
+        senf::PacketVector::iterator b (vec.begin());
+        BOOST_CHECK( vec.shared() );
+        vec.releaseShared();
+        BOOST_CHECK( ! vec.shared() );
+        BOOST_CHECK( vec.begin() == b );
+    }
+
+    {
+        senf::PacketVector vec (data.begin(), data.end());
+        std::unique_ptr<senf::PacketVector> shared1 (new senf::PacketVector(vec, 0u, 4u));
+        senf::PacketVector shared2 (*shared1, 2u, 4u);
+        vec.erase(vec.begin());
+        vec.truncateBack(vec.begin() + 2);
+        BOOST_CHECK( ! vec.shared() );
+        BOOST_CHECK_EQUAL( str(vec), strc("ES") );
+        BOOST_CHECK_EQUAL( str(*shared1), strc("TEST") );
+        shared1.reset();
+        BOOST_CHECK( shared2.shared() );
+        BOOST_CHECK_EQUAL( str(shared2), strc("ST") );
+    }
+
+    {
+        senf::PacketVector::value_type storage[] = "\0\0\0TEST\0\0";
+        TestOwner owner;
+        senf::PacketVector vec (storage, 4u, 10u, 3u);
+        vec.externalOwner(&owner);
+        {
+            // external memory is moved into an internal buffer before sharing
+            senf::PacketVector shared (vec, 0u, 4u);
+            BOOST_CHECK_EQUAL( owner.count, 1u );
+            BOOST_CHECK( ! vec.external() );
+            BOOST_CHECK( vec.shared() );
+            * shared.begin() = 'B';
+            BOOST_CHECK_EQUAL( storage[3], 'T' );
+        }
+        BOOST_CHECK_EQUAL( owner.count, 1u );
+        BOOST_CHECK_EQUAL( str(vec), strc("BEST") );
+        vec.insert(vec.begin(), 'A');
+        BOOST_CHECK( ! vec.shared() );
+        BOOST_CHECK_EQUAL( str(vec), strc("ABEST") );
+    }
+}
+
 #endif
 
 ///////////////////////////////cc.e////////////////////////////////////////
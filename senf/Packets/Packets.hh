@@ -72,6 +72,7 @@
 #endif
 
 #include "PacketInfo.hh"
+#include "PacketTemplate.hh"
 
 
 // Local Variables:
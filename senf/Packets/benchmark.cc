@@ -12,16 +12,32 @@
 
 
 /** \file
-    \brief benchmark non-inline non-template implementation */
+    \brief benchmark non-inline non-template implementation
+
+    Packet library and PPI microbenchmarks. Run \c benchmark \c --help for usage. */
 
 #include "Packets.hh"
 //#include "benchmark.ih"
 
 // Custom includes
+#include <stdlib.h>
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
 #include <senf/PPI.hh>
 #include <senf/Packets/DefaultBundle/EthernetPacket.hh>
-#include <senf/Utils/Console.hh>
+#include <senf/Packets/DefaultBundle/IPv4Packet.hh>
+#include <senf/Packets/DefaultBundle/LlcSnapPacket.hh>
+#include <senf/Packets/DefaultBundle/RTPPacket.hh>
+#include <senf/Packets/DefaultBundle/UDPPacket.hh>
+#include <senf/Packets/80211Bundle/RadiotapPacket.hh>
+#include <senf/Packets/80211Bundle/WLANPacket.hh>
 
 //#include "benchmark.mpp"
 #define prefix_
@@ -29,6 +45,181 @@
 
 namespace {
 
+    //-/////////////////////////////////////////////////////////////////////////////////////////
+    // Allocation accounting
+
+    // Every heap allocation of the process is counted. Results are reported per operation, so a
+    // regression which adds a malloc() to the fast path shows up immediately.
+    unsigned long heapAllocations (0);
+
+    // kept out of line, otherwise the compiler warns about the malloc()/free() calls being
+    // inlined into regular new/delete expressions
+    __attribute__((noinline)) void release(void * p)
+    {
+        std::free(p);
+    }
+
+}
+
+void * operator new(std::size_t size)
+{
+    ++ heapAllocations;
+    void * p (std::malloc(size ? size : 1));
+    if (! p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * p) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+    release(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void * p, std::size_t) noexcept
+{
+    release(p);
+}
+
+namespace {
+
+    //-/////////////////////////////////////////////////////////////////////////////////////////
+    // Benchmark runner
+
+    struct Options
+    {
+        Options() : batch (1000u), samples (100u), warmup (10u), format ("text") {}
+
+        unsigned batch;                 // operations per sample
+        unsigned samples;               // number of timed samples
+        unsigned warmup;                // number of untimed samples run first
+        std::string format;             // text, csv or json
+        std::vector<std::string> filters;
+    };
+
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void ()> op;
+    };
+
+    struct Result
+    {
+        std::string name;
+        unsigned long operations;
+        double min, p50, p90, p99, max; // nanoseconds per operation
+        double mean;
+        double allocations;             // heap allocations per operation
+        double chunks;                  // PacketVector chunks taken from the heap per operation
+    };
+
+    double percentile(std::vector<double> const & sorted, double p)
+    {
+        std::size_t i (static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5));
+        return sorted[std::min(i, sorted.size() - 1)];
+    }
+
+    Result run(Benchmark const & benchmark, Options const & options)
+    {
+        for (unsigned s (0); s < options.warmup; ++s)
+            for (unsigned i (0); i < options.batch; ++i)
+                benchmark.op();
+
+        std::vector<double> samples;
+        samples.reserve(options.samples);
+        unsigned long allocations (heapAllocations);
+        unsigned long chunks (senf::PacketVector::ChunkPool::allocated());
+        for (unsigned s (0); s < options.samples; ++s) {
+            senf::ClockService::clock_type start (senf::ClockService::now());
+            for (unsigned i (0); i < options.batch; ++i)
+                benchmark.op();
+            samples.push_back(
+                double(senf::ClockService::in_nanoseconds(senf::ClockService::now() - start))
+                / options.batch);
+        }
+        // the sample vector has been reserved up front, so the runner itself does not allocate
+        allocations = heapAllocations - allocations;
+        chunks = senf::PacketVector::ChunkPool::allocated() - chunks;
+
+        Result result;
+        result.name = benchmark.name;
+        result.operations = (unsigned long)(options.batch) * options.samples;
+        result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        std::sort(samples.begin(), samples.end());
+        result.min = samples.front();
+        result.p50 = percentile(samples, 0.50);
+        result.p90 = percentile(samples, 0.90);
+        result.p99 = percentile(samples, 0.99);
+        result.max = samples.back();
+        result.allocations = double(allocations) / result.operations;
+        result.chunks = double(chunks) / result.operations;
+        return result;
+    }
+
+    void report(std::vector<Result> const & results, std::string const & format)
+    {
+        if (format == "json") {
+            std::cout << "[\n";
+            for (std::size_t i (0); i < results.size(); ++i) {
+                Result const & r (results[i]);
+                std::cout << boost::format(
+                    "  { \"name\": \"%s\", \"operations\": %d, \"mean_ns\": %.1f, "
+                    "\"min_ns\": %.1f, \"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, "
+                    "\"max_ns\": %.1f, \"allocations\": %.3f, \"chunks\": %.3f }%s\n")
+                    % r.name % r.operations % r.mean % r.min % r.p50 % r.p90 % r.p99 % r.max
+                    % r.allocations % r.chunks % (i+1 < results.size() ? "," : "");
+            }
+            std::cout << "]" << std::endl;
+        }
+        else if (format == "csv") {
+            std::cout << "name,operations,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,max_ns,"
+                      << "allocations,chunks\n";
+            for (Result const & r : results)
+                std::cout << boost::format("%s,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f\n")
+                    % r.name % r.operations % r.mean % r.min % r.p50 % r.p90 % r.p99 % r.max
+                    % r.allocations % r.chunks;
+        }
+        else {
+            std::cout << boost::format("%-32s %9s %9s %9s %9s %9s %7s %7s\n")
+                % "benchmark" % "mean ns" % "min" % "p50" % "p90" % "p99" % "allocs" % "chunks";
+            for (Result const & r : results)
+                std::cout << boost::format("%-32s %9.1f %9.1f %9.1f %9.1f %9.1f %7.2f %7.2f\n")
+                    % r.name % r.mean % r.min % r.p50 % r.p90 % r.p99 % r.allocations % r.chunks;
+        }
+    }
+
+    //-/////////////////////////////////////////////////////////////////////////////////////////
+    // Benchmarks
+
+    struct IntAnnotation {
+        boost::uint32_t value;
+    };
+
+    std::ostream & operator<<(std::ostream & os, IntAnnotation const & v)
+    { os << v.value; return os; }
+
+    struct StringAnnotation : senf::ComplexAnnotation
+    {
+        std::string value;
+    };
+
+    std::ostream & operator<<(std::ostream & os, StringAnnotation const & v)
+    { os << v.value; return os; }
+
     class BenchmarkModule
         : public senf::ppi::module::Module
     {
@@ -46,54 +237,247 @@ namespace {
     private:
         void onRequest()
             {
-                output(senf::EthernetPacket::createBefore(input.read()));
+                output(input());
             }
     };
 
-    void displayRate(float rate)
+    class BurstBenchmarkModule
+        : public senf::ppi::module::Module
     {
-        std::cerr << rate << std::endl;
+        SENF_PPI_MODULE(BurstBenchmarkModule);
+    public:
+        senf::ppi::connector::PassiveInput<senf::EthernetPacket> input;
+        senf::ppi::connector::ActiveOutput<senf::EthernetPacket> output;
+
+        BurstBenchmarkModule()
+            {
+                route(input, output);
+                input.onRequestBurst(& BurstBenchmarkModule::onRequest);
+            }
+
+    private:
+        void onRequest(senf::ppi::PacketBurst & burst)
+            {
+                output(burst);
+            }
+    };
+
+    // A chain of n forwarding modules between an ActiveSource and a DiscardSink
+    template <class Module>
+    class PPIChain
+    {
+    public:
+        explicit PPIChain(unsigned n)
+            : modules_ (n)
+            {
+                if (n == 0)
+                    senf::ppi::connect(source_, sink_);
+                else {
+                    senf::ppi::connect(source_, modules_[0]);
+                    for (unsigned i (1); i < n; ++i)
+                        senf::ppi::connect(modules_[i-1], modules_[i]);
+                    senf::ppi::connect(modules_[n-1], sink_);
+                }
+            }
+
+        senf::ppi::module::debug::ActiveSource source_;
+        std::vector<Module> modules_;
+        senf::ppi::module::DiscardSink sink_;
+    };
+
+    typedef std::vector<senf::PacketData::byte> Bytes;
+
+    Bytes packetData(senf::Packet packet)
+    {
+        packet.finalizeAll();
+        return Bytes(packet.data().begin(), packet.data().end());
     }
 
-}
+    senf::EthernetPacket ethIPv4UDP(bool vlan)
+    {
+        senf::EthernetPacket eth (senf::EthernetPacket::create());
+        senf::Packet p (eth);
+        if (vlan)
+            p = senf::EthVLanCPacket::createAfter(eth);
+        senf::IPv4Packet ip (senf::IPv4Packet::createAfter(p));
+        senf::UDPPacket udp (senf::UDPPacket::createAfter(ip));
+        senf::RTPPacket rtp (senf::RTPPacket::createAfter(udp));
+        rtp->version() << 2;
+        senf::DataPacket::createAfter(rtp, 160u);
+        eth.finalizeAll();
+        return eth;
+    }
 
-int main(int argc, char const * argv[])
-{
-    unsigned n (atoi(argv[1]));
-    senf::EthernetPacket packet (senf::EthernetPacket::create());
-    senf::ppi::module::debug::ActiveSource source;
-    //senf::ppi::module::CloneSource source (packet);
-    //senf::ppi::module::ActiveFeeder feeder;
-    BenchmarkModule first;
-    //senf::ppi::module::RateAnalyzer analyzer;
-    senf::ppi::module::DiscardSink sink;
-
-    senf::ppi::connect(source, first);
-
-    BenchmarkModule * previous (&first);
-    for (unsigned i (0); i < 4; ++i) {
-        BenchmarkModule * next (new BenchmarkModule);
-        senf::ppi::connect(*previous, *next);
-        previous = next;
+    Bytes radiotapWLAN()
+    {
+        senf::RadiotapPacket rt (senf::RadiotapPacket::create());
+        rt->init_tsft() = 81059833346uLL;
+        rt->init_rate() = 12u;
+        rt->init_dbmAntennaSignal() = -61;
+        senf::WLANPacket_DataFrame wlan (senf::WLANPacket_DataFrame::createAfter(rt));
+        senf::LlcSnapPacket llc (senf::LlcSnapPacket::createAfter(wlan));
+        senf::IPv4Packet ip (senf::IPv4Packet::createAfter(llc));
+        senf::UDPPacket udp (senf::UDPPacket::createAfter(ip));
+        senf::DataPacket::createAfter(udp, 64u);
+        return packetData(rt);
+    }
+
+    std::vector<Benchmark> benchmarks()
+    {
+        std::vector<Benchmark> res;
+
+        // parse chain depth. Every step resolves the next header via the packet registries. Build
+        // the library with SENF_PACKET_REGISTRY_NO_FLAT_LOOKUP defined to compare against the
+        // ordered index lookup.
+        Bytes eth (packetData(senf::EthernetPacket::create()));
+        Bytes ethIP (packetData(ethIPv4UDP(false)));
+        Bytes ethVLanIP (packetData(ethIPv4UDP(true)));
+        Bytes wlan (radiotapWLAN());
+
+        res.push_back({ "parse.eth", [eth]() {
+                    senf::EthernetPacket::create(eth).last(); } });
+        res.push_back({ "parse.eth_ipv4_udp", [ethIP]() {
+                    senf::EthernetPacket::create(ethIP).last(); } });
+        res.push_back({ "parse.eth_vlan_ipv4_udp", [ethVLanIP]() {
+                    senf::EthernetPacket::create(ethVLanIP).last(); } });
+        // RTP is not registered with the UDP port registry, it is parsed explicitly
+        res.push_back({ "parse.eth_vlan_ipv4_udp_rtp", [ethVLanIP]() {
+                    senf::EthernetPacket::create(ethVLanIP).find<senf::UDPPacket>()
+                        .parseNextAs<senf::RTPPacket>().last(); } });
+        res.push_back({ "parse.radiotap_wlan_llc_ipv4_udp", [wlan]() {
+                    senf::RadiotapPacket::create(wlan).last(); } });
+        res.push_back({ "registry.lookup", []() {
+                    senf::PacketRegistry<senf::EtherTypes>::lookup(0x0800, senf::nothrow);
+                    senf::PacketRegistry<senf::IPTypes>::lookup(17, senf::nothrow); } });
+
+        // packet creation
+        senf::EthernetPacket packet (ethIPv4UDP(false));
+        senf::DataPacket payload (senf::DataPacket::create(64u));
+        res.push_back({ "packet.create", []() {
+                    senf::EthernetPacket::create(); } });
+        res.push_back({ "packet.clone", [packet]() {
+                    packet.clone(); } });
+        res.push_back({ "packet.clone_createBefore", [payload]() {
+                    senf::EthernetPacket::createBefore(payload.clone()); } });
+        res.push_back({ "packet.createInsertBefore", [packet]() {
+                    senf::Packet p (packet.clone());
+                    senf::EthVLanCPacket::createInsertBefore(p.next()); } });
+
+        // annotations. Use a separate packet, complex annotations would otherwise be copied by
+        // every clone in the remaining benchmarks
+        senf::EthernetPacket annotated (packet.clone());
+        res.push_back({ "annotation.int", [annotated]() mutable {
+                    ++ annotated.annotation<IntAnnotation>().value; } });
+        res.push_back({ "annotation.complex", [annotated]() mutable {
+                    annotated.annotation<StringAnnotation>().value.size(); } });
+        res.push_back({ "annotation.clone_clear", [annotated]() mutable {
+                    annotated.annotation<IntAnnotation>().value = 1;
+                    annotated.clone().clearAnnotations(); } });
+
+        // raw data container. Inserting and erasing the same range keeps the container size
+        // constant over the benchmark
+        std::shared_ptr<senf::PacketVector> vec (
+            std::make_shared<senf::PacketVector>(1000u, senf::PacketVector::value_type(0)));
+        res.push_back({ "vector.insert_erase_head", [vec]() {
+                    vec->insert(vec->begin(), 14u, senf::PacketVector::value_type(0));
+                    vec->erase(vec->begin(), vec->begin() + 14); } });
+        res.push_back({ "vector.insert_erase_tail", [vec]() {
+                    vec->insert(vec->end(), 14u, senf::PacketVector::value_type(0));
+                    vec->erase(vec->end() - 14, vec->end()); } });
+        res.push_back({ "vector.insert_erase_middle", [vec]() {
+                    vec->insert(vec->begin() + 500, 14u, senf::PacketVector::value_type(0));
+                    vec->erase(vec->begin() + 500, vec->begin() + 514); } });
+
+        // PPI connector hops. The difference between the chains is the per hop cost. The burst
+        // chains pass 32 packets per operation
+        static unsigned const hops[] = { 0u, 1u, 5u };
+        for (unsigned n : hops) {
+            std::shared_ptr<PPIChain<BenchmarkModule> > chain (
+                std::make_shared<PPIChain<BenchmarkModule> >(n));
+            res.push_back({ (boost::format("ppi.hops_%d") % n).str(), [chain, packet]() {
+                        chain->source_.submit(packet.clone()); } });
+        }
+        for (unsigned n : hops) {
+            std::shared_ptr<PPIChain<BurstBenchmarkModule> > chain (
+                std::make_shared<PPIChain<BurstBenchmarkModule> >(n));
+            std::shared_ptr<senf::ppi::PacketBurst> burst (
+                std::make_shared<senf::ppi::PacketBurst>());
+            res.push_back({ (boost::format("ppi.burst32_hops_%d") % n).str(), [chain, burst, packet]() {
+                        for (unsigned i (0); i < 32u; ++i)
+                            burst->push_back(packet.clone());
+                        chain->source_.submit(*burst);
+                        burst->clear(); } });
+        }
+        senf::ppi::init();
+
+        return res;
     }
 
-    senf::ppi::connect(*previous, sink);
+    bool selected(std::string const & name, Options const & options)
+    {
+        if (options.filters.empty())
+            return true;
+        for (std::string const & filter : options.filters)
+            if (name.find(filter) != std::string::npos)
+                return true;
+        return false;
+    }
 
-    //analyzer.signals.packetsPerSecond.connect(displayRate);
-    //analyzer.startStatistics(senf::ClockService::seconds(1));
+    int usage(char const * name)
+    {
+        std::cerr << "usage: " << name << " [--list] [--batch=<n>] [--samples=<n>] [--warmup=<n>]\n"
+                  << "       [--format=text|csv|json] [<filter>...]\n\n"
+                  << "Runs all benchmarks whose name contains one of the <filter> strings.\n"
+                  << "Each benchmark is run for <warmup> untimed and <samples> timed samples of\n"
+                  << "<batch> operations. Times are reported in ns per operation, allocs is\n"
+                  << "the number of heap allocations and chunks the number of packet data\n"
+                  << "chunks allocated from the heap per operation." << std::endl;
+        return 1;
+    }
+
+}
 
-    //senf::console::Server::start(senf::INet4SocketAddress(23232u));
+int main(int argc, char const * argv[])
+{
+    Options options;
+    bool list (false);
+    for (int i (1); i < argc; ++i) {
+        std::string arg (argv[i]);
+        std::string::size_type eq (arg.find('='));
+        std::string key (arg.substr(0, eq));
+        std::string value (eq == std::string::npos ? "" : arg.substr(eq+1));
+        if (key == "--list")
+            list = true;
+        else if (key == "--batch")
+            options.batch = std::max(atoi(value.c_str()), 1);
+        else if (key == "--samples")
+            options.samples = std::max(atoi(value.c_str()), 1);
+        else if (key == "--warmup")
+            options.warmup = std::max(atoi(value.c_str()), 0);
+        else if (key == "--format" && (value == "text" || value == "csv" || value == "json"))
+            options.format = value;
+        else if (arg.compare(0, 1, "-") == 0)
+            return usage(argv[0]);
+        else
+            options.filters.push_back(arg);
+    }
 
-    //senf::ppi::run();
+    // serve packet data from the thread local pool right from the start
+    senf::PacketVector::preallocate(1024);
 
-    while (true) {
-        senf::ClockService::clock_type start (senf::ClockService::now());
-        for (unsigned i (0); i < n; ++i)
-            source.submit(packet.clone());
-        senf::ClockService::int64_type msecs (
-            senf::ClockService::in_milliseconds(senf::ClockService::now() - start));
-        std::cout << (1000 * n) / msecs << std::endl;
+    std::vector<Benchmark> all (benchmarks());
+    std::vector<Result> results;
+    for (Benchmark const & benchmark : all) {
+        if (! selected(benchmark.name, options))
+            continue;
+        if (list)
+            std::cout << benchmark.name << "\n";
+        else
+            results.push_back(run(benchmark, options));
     }
+    if (! list)
+        report(results, options.format);
+    return 0;
 }
 
 ///////////////////////////////cc.e////////////////////////////////////////
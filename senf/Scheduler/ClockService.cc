@@ -18,7 +18,11 @@
 //#include "ClockService.ih"
 
 // Custom includes
+#include <fstream>
 #include <boost/regex.hpp>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
 #include <senf/Utils/Console/Traits.hh>
 
 // this include needed to add dependency on Scheduler. This should really be in 
@@ -35,6 +39,13 @@
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+    // The console parser and formatter exported by ClockService.hh forward to these
+    SENF_CONSOLE_REGISTER_ENUM_MEMBER( senf::ClockService, ClockSource, (MONOTONIC)(TSC) );
+
+}
+
 template <class T> static senf::ClockService::clock_type
 parseClockServiceInterval__(std::string const & value)
 {
@@ -99,7 +110,8 @@ senf::parseClockServiceInterval(console::ParseCommandInfo::TokensRange const & t
 
 prefix_ senf::ClockService::clock_type senf::ClockService::clock_m(abstime_type const & time)
 {
-    if (scheduler::now() - baseClock_ > clock_type(1000000000ll))
+    // Keep the base fixed in virtual time: Re-sampling would tie virtual time to the wall clock
+    if (! virtualTime() && scheduler::now() - baseClock_ > clock_type(1000000000ll))
         restart_m();
     boost::posix_time::time_duration delta (time - baseAbstime_);
     return baseClock_ + clock_type( delta.ticks() )
@@ -110,7 +122,7 @@ prefix_ senf::ClockService::abstime_type senf::ClockService::abstime_m(clock_typ
 {
     if (clock == clock_type(0))
         return abstime_type();
-    if (scheduler::now() - baseClock_ > clock_type(1000000000ll))
+    if (! virtualTime() && scheduler::now() - baseClock_ > clock_type(1000000000ll))
         restart_m();
 #ifdef BOOST_DATE_TIME_POSIX_TIME_STD_CONFIG
     return baseAbstime_ + boost::posix_time::nanoseconds(
@@ -128,6 +140,270 @@ prefix_ void senf::formatClockServiceInterval(ClockService::clock_type interval,
     os << interval << "ns";
 }
 
+prefix_ void
+senf::senf_console_parse_argument(console::ParseCommandInfo::TokensRange const & tokens,
+                                  ClockService::ClockSource & out)
+{
+    ::senf_console_parse_argument(tokens, out);
+}
+
+prefix_ void senf::senf_console_format_value(ClockService::ClockSource value, std::ostream & os)
+{
+    ::senf_console_format_value(value, os);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// Clock sources
+
+// The TSC clock state is kept per thread: Each thread extrapolates the clock from its last
+// synchronization point using the TSC and re-synchronizes against CLOCK_MONOTONIC once per
+// second. On every synchronization, the TSC frequency estimate is refined using the TSC /
+// CLOCK_MONOTONIC delta since the thread started using the TSC. Whenever the settings change,
+// the generation in mode_ changes which makes every thread re-initialize its state.
+
+namespace {
+
+    struct ClockThreadState
+    {
+        unsigned generation;
+        std::uint64_t tscStart;         // TSC value at first synchronization
+        std::uint64_t clockStart;       // CLOCK_MONOTONIC value at first synchronization
+        std::uint64_t tscBase;          // TSC value at last synchronization
+        std::uint64_t clockBase;        // CLOCK_MONOTONIC value at last synchronization
+        std::uint64_t mult;             // nanoseconds per TSC tick as 32.32 fixed point, 0 if none
+        std::uint64_t syncTicks;        // TSC ticks between synchronizations
+        std::uint64_t last;             // last TSC clock value returned
+        std::uint64_t cached;           // cached clock value
+        std::uint64_t cacheStamp;       // TSC / coarse clock value at last cache refresh
+        std::uint64_t cacheLimit;       // cacheStamp delta after which the cache is stale
+    };
+
+    thread_local ClockThreadState clockState_ = {};
+
+    std::atomic<std::uint64_t> tscMult_ (0u);
+    std::atomic<std::uint64_t> maxStaleness_ (0u);
+    std::atomic<std::uint64_t> virtualClock_ (0u);
+
+    std::uint64_t const SyncInterval (1000000000ull);
+    std::uint64_t const CalibrationInterval (10000000ull);
+
+    std::uint64_t readTSC()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0u;
+#endif
+    }
+
+    std::uint64_t readMonotonic()
+    {
+        return SENF_CLOCKTYPEVAL(senf::ClockService::monotonic());
+    }
+
+    std::uint64_t readCoarse()
+    {
+        struct timespec spec;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &spec);
+        return spec.tv_sec * 1000000000ull + spec.tv_nsec;
+    }
+
+    // Sample TSC and CLOCK_MONOTONIC as close together as possible
+    void sample(std::uint64_t & tsc, std::uint64_t & clock)
+    {
+        std::uint64_t t (readTSC());
+        clock = readMonotonic();
+        tsc = t + (readTSC() - t) / 2;
+    }
+
+    std::uint64_t ticksToNs(std::uint64_t ticks, std::uint64_t mult)
+    {
+        return (static_cast<unsigned __int128>(ticks) * mult) >> 32;
+    }
+
+    std::uint64_t nsToTicks(std::uint64_t ns, std::uint64_t mult)
+    {
+        return (static_cast<unsigned __int128>(ns) << 32) / mult;
+    }
+
+    bool checkTSC()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        std::ifstream cpuinfo ("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 5, "flags") != 0)
+                continue;
+            line += ' ';
+            return line.find(" constant_tsc ") != std::string::npos
+                && line.find(" nonstop_tsc ") != std::string::npos;
+        }
+#endif
+        return false;
+    }
+
+    void calibrateTSC()
+    {
+        if (tscMult_.load() != 0)
+            return;
+        std::uint64_t tsc0, clock0, tsc1, clock1;
+        sample(tsc0, clock0);
+        do
+            sample(tsc1, clock1);
+        while (clock1 - clock0 < CalibrationInterval);
+        tscMult_.store(((clock1 - clock0) << 32) / (tsc1 - tsc0));
+    }
+
+    void initState(ClockThreadState & state, unsigned generation)
+    {
+        state.generation = generation;
+        state.mult = tscMult_.load();
+        sample(state.tscStart, state.clockStart);
+        state.tscBase = state.tscStart;
+        state.clockBase = state.clockStart;
+        state.syncTicks = state.mult ? nsToTicks(SyncInterval, state.mult) : 0u;
+        state.cacheLimit = state.mult
+            ? nsToTicks(maxStaleness_.load(), state.mult) : maxStaleness_.load();
+    }
+
+    std::uint64_t tscNow(ClockThreadState & state)
+    {
+        std::uint64_t tsc (readTSC());
+        // This check also catches the TSC going backwards (e.g. after migrating to another CPU
+        // with unsynchronized TSC)
+        if (SENF_UNLIKELY(tsc - state.tscBase >= state.syncTicks)) {
+            std::uint64_t clock;
+            sample(tsc, clock);
+            if (tsc > state.tscStart && clock > state.clockStart)
+                state.mult = (static_cast<unsigned __int128>(clock - state.clockStart) << 32)
+                    / (tsc - state.tscStart);
+            state.tscBase = tsc;
+            state.clockBase = clock;
+            state.syncTicks = nsToTicks(SyncInterval, state.mult);
+        }
+        std::uint64_t now (state.clockBase + ticksToNs(tsc - state.tscBase, state.mult));
+        if (now > state.last)
+            state.last = now;
+        return state.last;
+    }
+
+    std::uint64_t refreshCache(ClockThreadState & state, bool tsc)
+    {
+        state.cacheStamp = state.mult ? readTSC() : readCoarse();
+        state.cached = tsc ? tscNow(state) : readMonotonic();
+        return state.cached;
+    }
+
+}
+
+std::atomic<unsigned> senf::ClockService::mode_ (0u);
+
+prefix_ senf::ClockService::clock_type senf::ClockService::now_m()
+{
+    ClockThreadState & state (clockState_);
+    unsigned mode (mode_.load(std::memory_order_acquire));
+    if (mode & VirtualMode)
+        return clock_type(virtualClock_.load(std::memory_order_relaxed));
+    if (SENF_UNLIKELY(state.generation != (mode & ~ModeMask))) {
+        initState(state, mode & ~ModeMask);
+        if (mode & CachedMode)
+            return clock_type(refreshCache(state, mode & TSCMode));
+    }
+    if (mode & CachedMode) {
+        std::uint64_t stamp (state.mult ? readTSC() : readCoarse());
+        if (SENF_LIKELY(stamp - state.cacheStamp <= state.cacheLimit))
+            return clock_type(state.cached);
+        return clock_type(refreshCache(state, mode & TSCMode));
+    }
+    return clock_type(tscNow(state));
+}
+
+prefix_ senf::ClockService::clock_type senf::ClockService::refresh()
+{
+    unsigned mode (mode_.load(std::memory_order_acquire));
+    if ((mode & VirtualMode) || ! (mode & CachedMode))
+        return now();
+    ClockThreadState & state (clockState_);
+    if (state.generation != (mode & ~ModeMask))
+        initState(state, mode & ~ModeMask);
+    return clock_type(refreshCache(state, mode & TSCMode));
+}
+
+prefix_ void senf::ClockService::updateMode(unsigned flag, bool on)
+{
+    unsigned mode (mode_.load());
+    mode = ((mode & ~ModeMask) + GenerationStep)
+        | ((on ? (mode | flag) : (mode & ~flag)) & ModeMask);
+    mode_.store(mode, std::memory_order_release);
+}
+
+prefix_ void senf::ClockService::source(ClockSource src)
+{
+    if (src == TSC) {
+        if (! tscAvailable())
+            throw UnsupportedClockSourceException();
+        calibrateTSC();
+    }
+    updateMode(TSCMode, src == TSC);
+}
+
+prefix_ senf::ClockService::ClockSource senf::ClockService::source()
+{
+    return mode_.load() & TSCMode ? TSC : MONOTONIC;
+}
+
+prefix_ void senf::ClockService::cached(clock_type maxStaleness)
+{
+    if (tscAvailable())
+        calibrateTSC();
+    maxStaleness_.store(SENF_CLOCKTYPEVAL(maxStaleness));
+    updateMode(CachedMode, maxStaleness != clock_type(0));
+}
+
+prefix_ senf::ClockService::clock_type senf::ClockService::cached()
+{
+    return mode_.load() & CachedMode ? clock_type(maxStaleness_.load()) : clock_type(0);
+}
+
+prefix_ void senf::ClockService::virtualTime(bool flag)
+{
+    if (flag == virtualTime())
+        return;
+    if (flag) {
+        virtualClock_.store(SENF_CLOCKTYPEVAL(now()));
+        instance().restart_m();
+    }
+    updateMode(VirtualMode, flag);
+    if (! flag)
+        instance().restart_m();
+}
+
+prefix_ bool senf::ClockService::virtualTime()
+{
+    return mode_.load() & VirtualMode;
+}
+
+prefix_ void senf::ClockService::advance(clock_type const & time)
+{
+    if (! virtualTime())
+        return;
+    std::uint64_t t (SENF_CLOCKTYPEVAL(time));
+    std::uint64_t current (virtualClock_.load());
+    while (t > current && ! virtualClock_.compare_exchange_weak(current, t)) ;
+}
+
+prefix_ bool senf::ClockService::tscAvailable()
+{
+    static bool const available (checkTSC());
+    return available;
+}
+
+prefix_ double senf::ClockService::tscFrequency()
+{
+    std::uint64_t mult (tscMult_.load());
+    return mult ? 1e9 * 4294967296.0 / mult : 0.0;
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 //#include "ClockService.mpp"
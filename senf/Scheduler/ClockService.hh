@@ -18,9 +18,11 @@
 #define HH_SENF_Scheduler_ClockService_ 1
 
 // Custom includes
+#include <atomic>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <senf/config.hh>
 #include <senf/Utils/singleton.hh>
+#include <senf/Utils/Exception.hh>
 #include <senf/Utils/Console/Parse.hh>
 
 #ifdef SENF_DEBUG
@@ -53,6 +55,35 @@ namespace senf {
         The ClockService provides a highly accurate monotonous clock source based on
         gettimeofday(). However, it takes additional precautions to detect clock skew.
 
+        \section clockservice_sources Clock sources
+
+        By default, now() calls \c clock_gettime(CLOCK_MONOTONIC) which is served by the vDSO
+        without a system call. Code calling now() per packet may still spend a noticeable share of
+        its time there. Two alternatives may be selected at runtime:
+
+        \li source(\ref TSC) reads the CPU time stamp counter instead. The counter frequency is
+            calibrated against \c CLOCK_MONOTONIC and the TSC clock is re-synchronized to \c
+            CLOCK_MONOTONIC once per second, so it never drifts away from the system clock. This
+            source needs an invariant TSC (\c constant_tsc and \c nonstop_tsc CPU flags).
+        \li cached(\a maxStaleness) makes now() return a cached clock value which is refreshed
+            by the scheduler on every event loop iteration. The cached value is never older than
+            \a maxStaleness: Once that has passed, the next now() call reads the clock source
+            again. Staleness is measured using the TSC if available and \c
+            CLOCK_MONOTONIC_COARSE otherwise (whose resolution, typically some milliseconds, then
+            limits the bound).
+
+        The clock is always monotonous per thread, independent of the source. Both settings are
+        also available via the \c clockSource and \c clockCache commands in the scheduler
+        console directory.
+
+        \section clockservice_virtual Virtual time
+
+        For simulations, the clock may be replaced by a virtual clock (see virtualTime()). The
+        virtual clock starts at the current time and only changes when advance() is called. It is
+        shared by all threads and overrides both the clock source and cached mode. Virtual time is
+        normally not used directly but via senf::scheduler::virtualTime(), which makes the
+        scheduler advance the clock from timer deadline to timer deadline.
+
         \implementation The funny mixture of static and non-static members stems from the old
             implementation based on interval timers and gettimeofday(). The current implementation
             uses POSIX clocks and is much simpler and more precise.
@@ -160,9 +191,83 @@ namespace senf {
                                              abstime() / clock() automatically call restart() if
                                              needed */
 
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Clock source
+        //\{
+
+        /** \brief Clock sources
+            \see \ref clockservice_sources */
+        enum ClockSource {
+            MONOTONIC,                  ///< \c clock_gettime(CLOCK_MONOTONIC) (the default)
+            TSC                         ///< Calibrated CPU time stamp counter
+        };
+
+        /** \brief The requested clock source is not available on this system */
+        struct UnsupportedClockSourceException : public senf::Exception
+        { UnsupportedClockSourceException() : senf::Exception("clock source not supported") {} };
+
+        static clock_type monotonic();  ///< Read \c CLOCK_MONOTONIC ignoring clock source settings
+
+        static void source(ClockSource src); ///< Select clock source used by now()
+                                        /**< Selecting \ref TSC will calibrate the TSC frequency
+                                             on first use which takes about 10ms.
+                                             \throws UnsupportedClockSourceException if \ref TSC
+                                                 is selected without an invariant TSC */
+        static ClockSource source();    ///< Current clock source
+
+        static void cached(clock_type maxStaleness);
+                                        ///< Enable/disable cached clock mode
+                                        /**< If \a maxStaleness is non-zero, now() returns a
+                                             cached clock value which is at most \a maxStaleness
+                                             old. A \a maxStaleness of 0 disables caching (the
+                                             default). */
+        static clock_type cached();     ///< Current cached mode staleness bound, 0 if disabled
+
+        static clock_type refresh();    ///< Update cached clock value
+                                        /**< Reads the clock source, updates the current threads
+                                             cached clock value and returns the new value. This
+                                             is called by the scheduler once per event loop
+                                             iteration. Without cached mode, this is the same as
+                                             now(). */
+
+        static bool tscAvailable();     ///< \c true, if an invariant TSC is available
+        static double tscFrequency();   ///< Calibrated TSC frequency in Hz, 0 if not calibrated
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Virtual time
+        //\{
+
+        static void virtualTime(bool flag); ///< Enable/disable virtual time
+                                        /**< When enabled, now() returns the virtual clock which
+                                             starts at the current clock value. When disabled
+                                             again, the clock continues from the real clock
+                                             source, which may be earlier than the last virtual
+                                             time.
+                                             \see \ref clockservice_virtual */
+        static bool virtualTime();      ///< \c true, if virtual time is enabled
+
+        static void advance(clock_type const & time);
+                                        ///< Advance virtual clock to \a time
+                                        /**< The virtual clock is never set back: If \a time is
+                                             not later than the current virtual time, the call
+                                             has no effect. Without virtual time, the call is
+                                             ignored. */
+
+        //\}
+
     private:
         ClockService();
 
+        // mode_ holds the clock source flags in the lower bits and a generation counter, which
+        // is incremented on every change, in the remaining bits
+        enum { TSCMode = 1, CachedMode = 2, VirtualMode = 4, ModeMask = 7, GenerationStep = 8 };
+
+        static clock_type now_m();
+        static void updateMode(unsigned flag, bool on);
+
+        static std::atomic<unsigned> mode_;
+
         abstime_type abstime_m(clock_type const & clock);
         clock_type clock_m(abstime_type const & time);
         void restart_m();
@@ -210,6 +315,10 @@ namespace senf {
                                    ClockService::clock_type & out);
 
     void formatClockServiceInterval(ClockService::clock_type interval, std::ostream & os);
+
+    void senf_console_parse_argument(console::ParseCommandInfo::TokensRange const & tokens,
+                                     ClockService::ClockSource & out);
+    void senf_console_format_value(ClockService::ClockSource value, std::ostream & os);
     
     class CyclicTimestamp final
     {
@@ -18,6 +18,8 @@
 
 // Custom includes
 #include <errno.h>
+#include <sstream>
+#include <senf/Utils/Console/Traits.hh>
 
 // Unit test includes
 #include <senf/Utils/auto_unit_test.hh>
@@ -95,6 +97,82 @@ SENF_AUTO_TEST_CASE(clockService)
     BOOST_CHECK_EQUAL( senf::ClockService::seconds(1),  senf::ClockService::milliseconds(1000) );
 }
 
+SENF_AUTO_TEST_CASE(clockSources)
+{
+    typedef senf::ClockService CS;
+
+    BOOST_CHECK_EQUAL( CS::source(), CS::MONOTONIC );
+    BOOST_CHECK_EQUAL( CS::cached(), CS::clock_type(0) );
+
+    std::stringstream ss;
+    senf::console::format(CS::TSC, ss);
+    BOOST_CHECK_EQUAL( ss.str(), "TSC" );
+
+    if (CS::tscAvailable()) {
+        CS::source(CS::TSC);
+        BOOST_CHECK_EQUAL( CS::source(), CS::TSC );
+        BOOST_CHECK( CS::tscFrequency() > 0.0 );
+        CS::clock_type last (CS::now());
+        bool monotonous (true);
+        for (unsigned i (0); i < 100000u; ++i) {
+            CS::clock_type t (CS::now());
+            if (t < last)
+                monotonous = false;
+            last = t;
+        }
+        BOOST_CHECK( monotonous );
+        BOOST_CHECK_PREDICATE( is_close_clock,
+                               (CS::now())(CS::monotonic())(CS::milliseconds(1)) );
+        CS::source(CS::MONOTONIC);
+    }
+    else
+        BOOST_CHECK_THROW( CS::source(CS::TSC), CS::UnsupportedClockSourceException );
+    BOOST_CHECK_EQUAL( CS::source(), CS::MONOTONIC );
+
+    CS::cached(CS::milliseconds(100));
+    BOOST_CHECK_EQUAL( CS::cached(), CS::milliseconds(100) );
+    CS::clock_type t1 (CS::now());
+    BOOST_CHECK_EQUAL( CS::now(), t1 );
+    CS::clock_type t2 (CS::refresh());
+    BOOST_CHECK( t2 > t1 );
+    BOOST_CHECK_EQUAL( CS::now(), t2 );
+    delay(150);
+    BOOST_CHECK( CS::now() - t2 >= CS::milliseconds(150) );
+    CS::cached(CS::clock_type(0));
+    BOOST_CHECK_EQUAL( CS::cached(), CS::clock_type(0) );
+}
+
+SENF_AUTO_TEST_CASE(clockService_virtualTime)
+{
+    typedef senf::ClockService CS;
+
+    BOOST_CHECK( ! CS::virtualTime() );
+    CS::clock_type t0 (CS::now());
+    CS::advance(t0 + CS::hours(1));
+    BOOST_CHECK( CS::now() < t0 + CS::hours(1) );
+
+    CS::virtualTime(true);
+    BOOST_CHECK( CS::virtualTime() );
+    CS::clock_type t1 (CS::now());
+    BOOST_CHECK( t1 >= t0 );
+    delay(10);
+    BOOST_CHECK_EQUAL( CS::now(), t1 );
+    BOOST_CHECK_EQUAL( CS::refresh(), t1 );
+
+    CS::advance(t1 + CS::hours(1));
+    BOOST_CHECK_EQUAL( CS::now(), t1 + CS::hours(1) );
+    CS::advance(t1);
+    BOOST_CHECK_EQUAL( CS::now(), t1 + CS::hours(1) );
+    BOOST_CHECK_PREDICATE( is_close_clock,
+                           (CS::clock(CS::abstime(t1 + CS::minutes(30))))
+                           (t1 + CS::minutes(30))
+                           (CS::microseconds(1)) );
+
+    CS::virtualTime(false);
+    BOOST_CHECK( ! CS::virtualTime() );
+    BOOST_CHECK_PREDICATE( is_close_clock, (CS::now())(CS::monotonic())(CS::milliseconds(1)) );
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
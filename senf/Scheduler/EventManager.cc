@@ -32,6 +32,9 @@
 prefix_ senf::scheduler::detail::EventManager::EventManager()
 {
 #ifndef SENF_DISABLE_CONSOLE
+    // The console is not thread safe: only the main threads scheduler is accessible
+    if (! mainThread())
+        return;
     consoleDir().add("events", console::factory::Command(
             membind(&EventManager::listEvents, this))
         .doc("List all scheduler events sorted by priority\n"
@@ -22,7 +22,7 @@
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/list_hook.hpp>
-#include <senf/Utils/singleton.hh>
+#include <senf/Utils/thread_singleton.hh>
 
 //#include "EventManager.mpp"
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -79,11 +79,11 @@ namespace detail {
     /** \brief
       */
     class EventManager
-        : public singleton<EventManager>
+        : public thread_singleton<EventManager>
     {
     public:
-        using singleton<EventManager>::instance;
-        using singleton<EventManager>::alive;
+        using thread_singleton<EventManager>::instance;
+        using thread_singleton<EventManager>::alive;
 
         struct IteratorFilter {
             bool operator()(Event const & e);
@@ -107,7 +107,7 @@ namespace detail {
 
         EventList events_;
 
-        friend class singleton<EventManager>;
+        friend class thread_singleton<EventManager>;
     };
 
 }}}
@@ -100,6 +100,9 @@ prefix_ senf::scheduler::detail::FIFORunner::FIFORunner()
     tasks_.push_back(normalPriorityEnd_);
 
 #ifndef SENF_DISABLE_CONSOLE
+    // The console is not thread safe: only the main threads scheduler is accessible
+    if (! mainThread())
+        return;
     namespace fty = console::factory;
     consoleDir().add("abortOnWatchdocTimeout", fty::Command(
             SENF_MEMBINDFNP( bool, FIFORunner, abortOnTimeout, () const ))
@@ -123,6 +126,9 @@ prefix_ senf::scheduler::detail::FIFORunner::FIFORunner()
 prefix_ senf::scheduler::detail::FIFORunner::~FIFORunner()
 {
     timer_delete(watchdogId_);
+    // the watchdog signal handler is shared by the schedulers of all threads
+    if (! mainThread())
+        return;
     signal(SIGURG, SIG_DFL);
 
 #ifndef SENF_DISABLE_CONSOLE
@@ -22,7 +22,7 @@
 #include <boost/function.hpp>
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/list_hook.hpp>
-#include <senf/Utils/singleton.hh>
+#include <senf/Utils/thread_singleton.hh>
 #include "EventManager.hh"
 
 //#include "FIFORunner.mpp"
@@ -36,7 +36,7 @@ namespace scheduler {
 namespace detail {
 
     class FIFORunner
-        : public singleton<FIFORunner>
+        : public thread_singleton<FIFORunner>
     {
     public:
         class TaskInfo;
@@ -82,8 +82,8 @@ namespace detail {
         typedef boost::filter_iterator<
             EventManager::IteratorFilter, TaskList::const_iterator> iterator;
 
-        using singleton<FIFORunner>::instance;
-        using singleton<FIFORunner>::alive;
+        using thread_singleton<FIFORunner>::instance;
+        using thread_singleton<FIFORunner>::alive;
 
         void enqueue(TaskInfo * task);
         void dequeue(TaskInfo * task);
@@ -152,7 +152,7 @@ namespace detail {
         bool yield_;
 
         friend void senf::scheduler::restart();
-        friend class singleton<FIFORunner>;
+        friend class thread_singleton<FIFORunner>;
     };
 
 }}}
@@ -18,20 +18,169 @@
 //#include "FdManager.ih"
 
 // Custom includes
+#include <algorithm>
+#include <boost/format.hpp>
+#include <senf/Utils/membind.hh>
+#include <senf/Utils/Console/ScopedDirectory.hh>
+#include <senf/Utils/Console/ParsedCommand.hh>
+#include "ConsoleDir.hh"
 
 //#include "FdManager.mpp"
 #define prefix_
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 
+prefix_ senf::scheduler::detail::FdManager::FdManager()
+    : eventTime_ (senf::ClockService::now()), spinBudget_ (0), virtualTimeoutEnabled_ (false),
+      virtualTimeout_ (0)
+{
+    eventTimestamp_.update(eventTime_);
+
+#ifndef SENF_DISABLE_CONSOLE
+    // The console is not thread safe: only the main threads scheduler is accessible
+    if (! mainThread())
+        return;
+    namespace fty = console::factory;
+    consoleDir().add("pollStatistics", fty::Command(
+            membind(&FdManager::dumpStatistics, this))
+        .doc("Show event loop statistics\n"
+             "\n"
+             "    wakeups          number of event loop iterations\n"
+             "    events           number of file descriptor events delivered\n"
+             "    events/wakeup    average number of events per wakeup\n"
+             "    max events       maximum number of events in a single wakeup\n"
+             "    empty wakeups    wakeups without any event (timeout or signal)\n"
+             "    spin polls       non-blocking polls issued while busy polling\n"
+             "    batch size       current (adaptive) epoll event batch size") );
+    consoleDir().add("resetPollStatistics", fty::Command(
+            membind(&FdManager::resetStatistics, this))
+        .doc("Reset event loop statistics") );
+    consoleDir().add("busyPoll", fty::Command(
+            SENF_MEMBINDFNP( unsigned, FdManager, consoleBusyPoll, () const ))
+        .doc("Get busy poll budget in microseconds") );
+    consoleDir().add("busyPoll", fty::Command(
+            SENF_MEMBINDFNP( void, FdManager, consoleBusyPoll, (unsigned) ))
+        .arg("us", "busy poll budget in microseconds, 0 disables busy polling")
+        .doc("Set busy poll budget in microseconds\n"
+             "While busy polling, the scheduler polls for events without blocking until either\n"
+             "an event arrives or the budget is exhausted.") );
+    consoleDir().add("eventBatchSize", fty::Command(
+            SENF_MEMBINDFNP( unsigned, FdManager, eventBatchSize, () const ))
+        .doc("Get current epoll event batch size") );
+    consoleDir().add("eventBatchSize", fty::Command(
+            SENF_MEMBINDFNP( void, FdManager, eventBatchSize, (unsigned, unsigned) ))
+        .arg("min", "minimum event batch size")
+        .arg("max", "maximum event batch size")
+        .doc("Set epoll event batch size limits\n"
+             "The batch size adapts to the load within [min, max].") );
+    consoleDir().add("clockSource", fty::Command(
+            SENF_FNP( ClockService::ClockSource, ClockService::source, () ))
+        .doc("Get clock source") );
+    consoleDir().add("clockSource", fty::Command(
+            SENF_FNP( void, ClockService::source, (ClockService::ClockSource) ))
+        .arg("source", "clock source, one of 'monotonic' or 'tsc'")
+        .doc("Set clock source\n"
+             "'tsc' reads the calibrated CPU time stamp counter instead of CLOCK_MONOTONIC and\n"
+             "needs an invariant TSC.") );
+    consoleDir().add("clockCache", fty::Command(
+            SENF_FNP( ClockService::clock_type, ClockService::cached, () ))
+        .formatter(senf::formatClockServiceInterval)
+        .doc("Get maximum staleness of the cached clock, 0 if clock caching is disabled") );
+    consoleDir().add("clockCache", fty::Command(
+            SENF_FNP( void, ClockService::cached, (ClockService::clock_type) ))
+        .arg("staleness", "maximum staleness of the cached clock, 0 disables caching",
+             console::kw::parser = senf::parseClockServiceInterval)
+        .doc("Enable/disable clock caching\n"
+             "When enabled, the clock is read once per event loop iteration and whenever the\n"
+             "cached value has become older than the given staleness bound.") );
+#endif
+}
+
+prefix_ senf::scheduler::detail::FdManager::~FdManager()
+{
+#ifndef SENF_DISABLE_CONSOLE
+    if (! mainThread())
+        return;
+    consoleDir().remove("pollStatistics");
+    consoleDir().remove("resetPollStatistics");
+    consoleDir().remove("busyPoll");
+    consoleDir().remove("eventBatchSize");
+    consoleDir().remove("clockSource");
+    consoleDir().remove("clockCache");
+#endif
+}
+
 prefix_ void senf::scheduler::detail::FdManager::processOnce()
 {
-    Poller<Event>::range events (poller_.wait());
-    eventTime_ = ClockService::now();
+    Poller<Event>::range events;
+    int t (poller_.timeout());
+    if (SENF_UNLIKELY(virtualTimeoutEnabled_) && t != 0) {
+        // Nothing else is pending: Jump to the next deadline unless a file descriptor is ready
+        events = poller_.wait(0);
+        if (events.empty())
+            ClockService::advance(virtualTimeout_);
+    }
+    else if (spinBudget_ > 0 && t != 0) {
+        // Never spin past the poll timeout: A timer due before the spin budget is used up must
+        // not wait for the budget to expire
+        ClockService::clock_type budget (spinBudget_);
+        if (t > 0)
+            budget = std::min(budget, ClockService::milliseconds(t));
+        ClockService::clock_type start (ClockService::now());
+        ClockService::clock_type n (start);
+        do {
+            events = poller_.wait(0);
+            ++ statistics_.spinPolls;
+        } while (events.empty() && (n = ClockService::now()) - start < budget);
+        if (events.empty()) {
+            // Don't let busy polling delay the next timeout
+            if (t > 0)
+                t = std::max(0, t - int(ClockService::in_milliseconds(n - start)));
+            events = poller_.wait(t);
+        }
+    }
+    else
+        events = poller_.wait(t);
+    eventTime_ = ClockService::refresh();
     eventTimestamp_.update(eventTime_);
+
+    unsigned count (events.size());
+    ++ statistics_.wakeups;
+    statistics_.events += count;
+    if (count == 0)
+        ++ statistics_.emptyWakeups;
+    if (count > statistics_.maxEvents)
+        statistics_.maxEvents = count;
+
     for (Poller<Event>::iterator i (events.begin()); i != events.end(); ++i)
         i->second->signal(i->first);
 }
 
+prefix_ void senf::scheduler::detail::FdManager::dumpStatistics(std::ostream & os)
+    const
+{
+    boost::format fmt ("%-16s %12s\n");
+    os << fmt % "wakeups" % statistics_.wakeups
+       << fmt % "events" % statistics_.events
+       << fmt % "events/wakeup" % (boost::format("%.3f") % statistics_.eventsPerWakeup())
+       << fmt % "max events" % statistics_.maxEvents
+       << fmt % "empty wakeups" % statistics_.emptyWakeups
+       << fmt % "spin polls" % statistics_.spinPolls
+       << fmt % "batch size" % (boost::format("%d [%d..%d]")
+                                % poller_.batchSize() % poller_.minBatchSize()
+                                % poller_.maxBatchSize());
+}
+
+prefix_ unsigned senf::scheduler::detail::FdManager::consoleBusyPoll()
+    const
+{
+    return ClockService::in_microseconds(spinBudget_);
+}
+
+prefix_ void senf::scheduler::detail::FdManager::consoleBusyPoll(unsigned us)
+{
+    busyPoll(ClockService::microseconds(us));
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 //#include "FdManager.mpp"
@@ -20,7 +20,7 @@
 // Custom includes
 #include "Poller.hh"
 #include "ClockService.hh"
-#include <senf/Utils/singleton.hh>
+#include <senf/Utils/thread_singleton.hh>
 #include <senf/Utils/FlowStatistics.hh>
 
 //#include "FdManager.mpp"
@@ -34,7 +34,7 @@ namespace scheduler {
 namespace detail {
 
     class FdManager
-        : public singleton<FdManager>
+        : public thread_singleton<FdManager>
     {
     public:
         ///< Event baseclass
@@ -48,8 +48,21 @@ namespace detail {
             EV_HUP = Poller<Event>::EV_HUP, EV_ERR = Poller<Event>::EV_ERR
         };
 
-        using singleton<FdManager>::instance;
-        using singleton<FdManager>::alive;
+        ///< Event loop statistics
+        struct Statistics {
+            Statistics();
+
+            unsigned long wakeups;      ///< Number of processOnce() calls
+            unsigned long events;       ///< Total number of events delivered
+            unsigned long emptyWakeups; ///< Number of wakeups without any event (timeout, signal)
+            unsigned long spinPolls;    ///< Number of non-blocking polls while busy polling
+            unsigned maxEvents;         ///< Maximum number of events delivered in one wakeup
+
+            double eventsPerWakeup() const; ///< Average number of events per wakeup
+        };
+
+        using thread_singleton<FdManager>::instance;
+        using thread_singleton<FdManager>::alive;
 
         bool set(int fd, int events, Event * entry);
         void remove(int fd);
@@ -60,7 +73,30 @@ namespace detail {
 
         void processOnce();             ///< Wait for events
                                         /**< This call waits until at least one event is posted but
-                                             no longer than the current timeout(). */
+                                             no longer than the current timeout(). If a busy poll
+                                             budget is set, the call will first poll without
+                                             blocking until either an event is posted or the budget
+                                             is exhausted.
+
+                                             If a virtual timeout is set and no other event is
+                                             pending, the call does not block at all. If no file
+                                             descriptor is ready, the virtual clock is advanced
+                                             to the virtual timeout instead. */
+
+        void eventBatchSize(unsigned min, unsigned max); ///< Set event batch size limits
+        unsigned eventBatchSize() const; ///< Current (adaptive) event batch size
+
+        void busyPoll(ClockService::clock_type spinBudget);
+                                        ///< Set busy poll budget (0 disables busy polling)
+        ClockService::clock_type busyPoll() const; ///< Current busy poll budget
+
+        // Called by VirtualTimerSource
+        void virtualTimeout(ClockService::clock_type const & t);
+        void noVirtualTimeout();
+        void updateEventTime();
+
+        Statistics const & statistics() const; ///< Event loop statistics
+        void resetStatistics();         ///< Reset event loop statistics
         ClockService::clock_type const & eventTime() const; ///< Time of last event
         CyclicTimestamp const & eventTimestamp() const; ///< Cyclic Timestamp of last event (1ms precision)
         
@@ -68,13 +104,22 @@ namespace detail {
 
     private:
         FdManager();
+        ~FdManager();
+
+        void dumpStatistics(std::ostream & os) const;
+        unsigned consoleBusyPoll() const;
+        void consoleBusyPoll(unsigned us);
 
         Poller<Event> poller_;
         ClockService::clock_type eventTime_;
         CyclicTimestamp eventTimestamp_;
+        ClockService::clock_type spinBudget_;
+        bool virtualTimeoutEnabled_;
+        ClockService::clock_type virtualTimeout_;
+        Statistics statistics_;
 
         friend void senf::scheduler::restart();
-        friend class singleton<FdManager>;
+        friend class thread_singleton<FdManager>;
     };
 
 }}}
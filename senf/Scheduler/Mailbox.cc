@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Mailbox non-inline non-template implementation */
+
+#include "Mailbox.hh"
+//#include "Mailbox.ih"
+
+// Custom includes
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <senf/Utils/Exception.hh>
+#include <senf/Utils/membind.hh>
+
+//#include "Mailbox.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    int createEventFd()
+    {
+        int fd (::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+        if (fd < 0)
+            SENF_THROW_SYSTEM_EXCEPTION("eventfd()");
+        return fd;
+    }
+
+}
+
+prefix_ senf::scheduler::Mailbox::Mailbox(std::string const & name)
+    : fd_ (createEventFd()),
+      event_ (name, membind(&Mailbox::signal, this), fd_, FdEvent::EV_READ)
+{}
+
+prefix_ senf::scheduler::Mailbox::~Mailbox()
+{
+    event_.disable();
+    ::close(fd_);
+}
+
+prefix_ void senf::scheduler::Mailbox::post(Callback const & cb)
+{
+    bool wakeup;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        wakeup = queue_.empty();
+        queue_.push_back(cb);
+    }
+    // The receiver drains the complete queue after reading the eventfd, so only the first
+    // callback posted to an empty queue needs to wake it up
+    if (wakeup) {
+        uint64_t one (1);
+        while (::write(fd_, &one, sizeof(one)) < 0)
+            if (errno != EINTR && errno != EAGAIN)
+                SENF_THROW_SYSTEM_EXCEPTION("write(eventfd)");
+    }
+}
+
+prefix_ unsigned senf::scheduler::Mailbox::pending()
+    const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return queue_.size();
+}
+
+prefix_ void senf::scheduler::Mailbox::signal(int events)
+{
+    uint64_t count;
+    if (::read(fd_, &count, sizeof(count)) < 0 && errno != EAGAIN && errno != EINTR)
+        SENF_THROW_SYSTEM_EXCEPTION("read(eventfd)");
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        running_.swap(queue_);
+    }
+    // running_ keeps its capacity, so processing a batch does not allocate
+    std::vector<Callback>::size_type i (0);
+    try {
+        for (; i < running_.size(); ++i)
+            running_[i]();
+    }
+    catch (...) {
+        requeue(i + 1);
+        throw;
+    }
+    running_.clear();
+}
+
+prefix_ void senf::scheduler::Mailbox::requeue(std::vector<Callback>::size_type n)
+{
+    // A callback has thrown: Put the not yet executed rest of the batch back in front of the
+    // callbacks posted meanwhile and make sure, the mailbox is signaled again
+    bool wakeup;
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        queue_.insert(queue_.begin(), running_.begin() + n, running_.end());
+        wakeup = ! queue_.empty();
+    }
+    running_.clear();
+    if (wakeup) {
+        uint64_t one (1);
+        while (::write(fd_, &one, sizeof(one)) < 0)
+            if (errno != EINTR && errno != EAGAIN)
+                SENF_THROW_SYSTEM_EXCEPTION("write(eventfd)");
+    }
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "Mailbox.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Mailbox public header */
+
+#ifndef HH_SENF_Scheduler_Mailbox_
+#define HH_SENF_Scheduler_Mailbox_ 1
+
+// Custom includes
+#include <vector>
+#include <mutex>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include "FdEvent.hh"
+
+//#include "Mailbox.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace scheduler {
+
+    /** \brief Cross thread callback mailbox
+
+        Every thread runs its own %scheduler instance. A Mailbox is the only way to hand work to
+        the %scheduler of another thread: post() may be called from any thread, the posted
+        callbacks are executed by the %scheduler of the thread which created the Mailbox, in the
+        order they have been posted.
+
+        \code
+        // worker thread
+        senf::scheduler::Mailbox mailbox ("worker");
+        // ... hand &mailbox to other threads
+        senf::scheduler::process();
+
+        // any other thread
+        mailbox.post(boost::bind(&Forwarder::handle, &forwarder, packet));
+        mailbox.post(&senf::scheduler::terminate);
+        \endcode
+
+        The mailbox is backed by an \c eventfd: The receiving %scheduler is only woken up when a
+        callback is posted to an empty mailbox, all callbacks posted until the %scheduler gets to
+        run are processed in a single batch. If a callback throws, the exception is propagated and
+        the remaining callbacks of the batch stay queued for the next round.
+
+        Packets may be posted by binding them to the callback, however packet handles are not
+        thread safe: The posting thread must not keep any reference to the packet (or any packet
+        of the same packet chain).
+
+        A Mailbox keeps the receiving %scheduler running (process() does not return due to lack
+        of events while the mailbox exists). The Mailbox must outlive all post() calls and must not
+        be destroyed by one of its callbacks.
+      */
+    class Mailbox
+        : boost::noncopyable
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // Types
+
+        typedef boost::function<void ()> Callback;
+
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        explicit Mailbox(std::string const & name);
+                                        ///< Create mailbox of the calling threads %scheduler
+                                        /**< \param[in] name Descriptive event name (purely
+                                                 informational) */
+        ~Mailbox();
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+
+        void post(Callback const & cb); ///< Post \a cb to the receiving %scheduler
+                                        /**< May be called from any thread */
+        unsigned pending() const;       ///< Number of posted callbacks not yet dispatched
+                                        /**< May be called from any thread */
+
+    private:
+        void signal(int events);
+        void requeue(std::vector<Callback>::size_type n);
+
+        int fd_;
+        mutable std::mutex mutex_;
+        std::vector<Callback> queue_;
+        std::vector<Callback> running_;
+        FdEvent event_;
+    };
+
+}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+//#include "Mailbox.cci"
+//#include "Mailbox.ct"
+//#include "Mailbox.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
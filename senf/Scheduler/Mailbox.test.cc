@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Mailbox unit tests */
+
+#include "Mailbox.hh"
+
+// Custom includes
+#include <stdexcept>
+#include <thread>
+#include <boost/bind.hpp>
+#include "Scheduler.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    bool timeoutFlag (false);
+
+    void timeout()
+    {
+        timeoutFlag = true;
+        senf::scheduler::terminate();
+    }
+
+    // counter only accessed by the worker thread
+    unsigned workerCalls (0u);
+    bool workerSchedulerRunning (false);
+
+    void workerCall()
+    {
+        ++ workerCalls;
+        workerSchedulerRunning = senf::scheduler::running();
+    }
+
+    void done(senf::scheduler::Mailbox * mainBox, unsigned * calls)
+    {
+        // executed in the worker thread
+        mainBox->post(&senf::scheduler::terminate);
+        *calls = workerCalls;
+        senf::scheduler::terminate();
+    }
+
+    void workerReady(senf::scheduler::Mailbox * mainBox, senf::scheduler::Mailbox * workerBox,
+                     unsigned * calls)
+    {
+        // executed in the main thread
+        for (unsigned i (0); i < 100; ++i)
+            workerBox->post(&workerCall);
+        workerBox->post(boost::bind(&done, mainBox, calls));
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(mailbox)
+{
+    senf::scheduler::Mailbox mainBox ("main mailbox");
+    BOOST_CHECK_EQUAL( mainBox.pending(), 0u );
+
+    unsigned calls (0u);
+    std::thread worker ([&mainBox, &calls]() {
+            senf::scheduler::Mailbox workerBox ("worker mailbox");
+            mainBox.post(boost::bind(&workerReady, &mainBox, &workerBox, &calls));
+            // runs the worker threads scheduler
+            senf::scheduler::process();
+        });
+
+    senf::scheduler::TimerEvent watchdog (
+        "Mailbox unit test watchdog", &timeout,
+        senf::ClockService::now() + senf::ClockService::seconds(5));
+    senf::scheduler::process();
+    worker.join();
+
+    BOOST_CHECK( ! timeoutFlag );
+    BOOST_CHECK_EQUAL( calls, 100u );
+    BOOST_CHECK( workerSchedulerRunning );
+    BOOST_CHECK_EQUAL( mainBox.pending(), 0u );
+
+    mainBox.post(&senf::scheduler::terminate);
+    BOOST_CHECK_EQUAL( mainBox.pending(), 1u );
+    senf::scheduler::process();
+    BOOST_CHECK_EQUAL( mainBox.pending(), 0u );
+}
+
+namespace {
+
+    void throwing()
+    {
+        throw std::runtime_error("mailbox callback failed");
+    }
+
+    void count(unsigned * calls)
+    {
+        ++ *calls;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(mailboxThrowingCallback)
+{
+    senf::scheduler::Mailbox box ("mailbox");
+    unsigned calls (0u);
+    box.post(boost::bind(&count, &calls));
+    box.post(&throwing);
+    box.post(boost::bind(&count, &calls));
+    box.post(&senf::scheduler::terminate);
+
+    senf::scheduler::TimerEvent watchdog (
+        "Mailbox unit test watchdog", &timeout,
+        senf::ClockService::now() + senf::ClockService::seconds(5));
+    BOOST_CHECK_THROW( senf::scheduler::process(), std::runtime_error );
+    BOOST_CHECK_EQUAL( calls, 1u );
+    BOOST_CHECK_EQUAL( box.pending(), 2u );
+
+    senf::scheduler::process();
+    BOOST_CHECK( ! timeoutFlag );
+    BOOST_CHECK_EQUAL( calls, 2u );
+    BOOST_CHECK_EQUAL( box.pending(), 0u );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
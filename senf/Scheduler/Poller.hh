@@ -19,6 +19,7 @@
 
 // Custom includes
 #include <sys/epoll.h>
+#include <vector>
 #include <boost/noncopyable.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/range/iterator_range.hpp>
@@ -36,6 +37,12 @@ namespace detail {
         registered with pointers to a parameterized event type. After waiting for an event, the
         Poller allows to iterate over the event instances for all posted events.
 
+        The number of events fetched by a single epoll_wait() call (the event batch) adapts to the
+        load: Whenever a call fills the complete batch, the batch size is doubled (up to the
+        configured maximum). If the batch stays mostly empty for a while, it is halved again (down
+        to the configured minimum). Setting minimum and maximum to the same value disables
+        adaptation.
+
         \tparam Value Event type
       */
     template <class Value>
@@ -48,8 +55,6 @@ namespace detail {
             result_type operator()(epoll_event const &) const;
         };
 
-        static int const NumEvents = 8;
-
     public:
         //-////////////////////////////////////////////////////////////////////////
         // Types
@@ -63,6 +68,10 @@ namespace detail {
             EV_HUP = EPOLLHUP, EV_ERR = EPOLLERR
         };
 
+        static unsigned const DefaultMinEvents = 8u;
+        static unsigned const DefaultMaxEvents = 256u;
+        static unsigned const ShrinkThreshold = 64u; ///< Mostly empty waits before shrinking
+
         //-////////////////////////////////////////////////////////////////////////
         ///\name Structors and default members
         //\{
@@ -82,13 +91,32 @@ namespace detail {
         range wait();                   ///< Wait for one event
                                         /**< \returns a range of iterators which iterate over the
                                              data values registered with the event */
+        range wait(int t);              ///< Wait for one event but at most \a t milliseconds
+                                        /**< Same as wait() but overrides the current timeout() for
+                                             this call only. */
 
         void timeout(int t);            ///< Set event timeout to \a t milliseconds
         int timeout() const;            ///< Current event timeout
 
+        void batchSize(unsigned min, unsigned max);
+                                        ///< Set event batch size limits
+                                        /**< The event batch size will adapt within [\a min, \a
+                                             max]. If \a min == \a max, the batch size is
+                                             fixed. */
+        unsigned batchSize() const;     ///< Current event batch size
+        unsigned minBatchSize() const;  ///< Minimum event batch size
+        unsigned maxBatchSize() const;  ///< Maximum event batch size
+
     private:
+        void adapt(unsigned n);
+
         int epollFd_;
         int timeout_;
+        std::vector<epoll_event> events_;
+        unsigned batch_;
+        unsigned minBatch_;
+        unsigned maxBatch_;
+        unsigned idleCount_;
     };
 
 
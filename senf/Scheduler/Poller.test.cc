@@ -17,6 +17,9 @@
 #include "Poller.hh"
 
 // Custom includes
+#include <unistd.h>
+#include <boost/range/size.hpp>
+#include <boost/range/empty.hpp>
 
 // Unit test includes
 #include <senf/Utils/auto_unit_test.hh>
@@ -26,7 +29,58 @@
 
 SENF_AUTO_TEST_CASE(poller)
 {
-    BOOST_CHECK( true );
+    typedef senf::scheduler::detail::Poller<int> Poller;
+    Poller poller;
+    int fds[32][2];
+    int values[32];
+    for (unsigned i (0); i < 32; ++i) {
+        BOOST_REQUIRE( pipe(fds[i]) == 0 );
+        values[i] = i;
+        BOOST_CHECK( poller.set(fds[i][1], Poller::EV_WRITE, &values[i]) );
+    }
+
+    BOOST_CHECK_EQUAL( poller.batchSize(), 8u );
+    poller.batchSize(4u, 16u);
+    BOOST_CHECK_EQUAL( poller.minBatchSize(), 4u );
+    BOOST_CHECK_EQUAL( poller.maxBatchSize(), 16u );
+    BOOST_CHECK_EQUAL( poller.batchSize(), 8u );
+
+    // All 32 pipes are writable: Every wait returns a full batch and the batch grows up to max
+    poller.timeout(0);
+    BOOST_CHECK_EQUAL( boost::size(poller.wait()), 8 );
+    BOOST_CHECK_EQUAL( poller.batchSize(), 16u );
+    BOOST_CHECK_EQUAL( boost::size(poller.wait()), 16 );
+    BOOST_CHECK_EQUAL( poller.batchSize(), 16u );
+
+    // A single ready fd lets the batch shrink again, but only slowly and not below min
+    for (unsigned i (1); i < 32; ++i)
+        poller.remove(fds[i][1]);
+    for (unsigned i (0); i < Poller::ShrinkThreshold - 1; ++i) {
+        Poller::range r (poller.wait());
+        BOOST_REQUIRE_EQUAL( boost::size(r), 1 );
+        BOOST_CHECK_EQUAL( *r.begin()->second, 0 );
+    }
+    BOOST_CHECK_EQUAL( poller.batchSize(), 16u );
+    poller.wait();
+    BOOST_CHECK_EQUAL( poller.batchSize(), 8u );
+    for (unsigned i (0); i < 2*Poller::ShrinkThreshold; ++i)
+        poller.wait();
+    BOOST_CHECK_EQUAL( poller.batchSize(), 4u );
+
+    // Empty waits don't change the batch size
+    poller.remove(fds[0][1]);
+    for (unsigned i (0); i < 2*Poller::ShrinkThreshold; ++i)
+        BOOST_CHECK( boost::empty(poller.wait(0)) );
+    BOOST_CHECK_EQUAL( poller.batchSize(), 4u );
+
+    // Fixed batch size
+    poller.batchSize(2u, 2u);
+    BOOST_CHECK_EQUAL( poller.batchSize(), 2u );
+
+    for (unsigned i (0); i < 32; ++i) {
+        close(fds[i][0]);
+        close(fds[i][1]);
+    }
 }
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -14,12 +14,8 @@
 /** \file
     \brief Scheduler non-inline non-template implementation
 
-    \idea Multithreading support: To support multithreading, the
-    static member Scheduler::instance() must return a thread-local
-    value (that is Scheduler::instance() must allocate one Scheduler
-    instance per thread). Another possibility would be to distribute
-    the async load unto several threads (one scheduler for multiple
-    threads)
+    Every thread has its own scheduler instance: All scheduler singletons except the
+    SignalDispatcher are thread_singleton's. UNIX signals are only handled by the main thread.
  */
 
 #include "Scheduler.hh"
@@ -31,8 +27,14 @@
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 
 namespace {
-    bool terminate_ (false);
-    bool running_ (false);
+    thread_local bool terminate_ (false);
+    thread_local bool running_ (false);
+    thread_local bool hiresBeforeVirtualTime_ (false);
+
+    bool mainThread()
+    {
+        return senf::detail::mainThread();
+    }
 }
 
 prefix_ void senf::scheduler::terminate()
@@ -59,7 +61,8 @@ namespace {
         SchedulerScopedInit()
             {
                 senf::scheduler::detail::FIFORunner::instance().startWatchdog();
-                senf::scheduler::detail::SignalDispatcher::instance().unblockSignals();
+                if (mainThread())
+                    senf::scheduler::detail::SignalDispatcher::instance().unblockSignals();
                 senf::scheduler::detail::TimerDispatcher::instance().enable();
                 running_ = true;
             }
@@ -67,7 +70,8 @@ namespace {
         ~SchedulerScopedInit()
             {
                 senf::scheduler::detail::TimerDispatcher::instance().disable();
-                senf::scheduler::detail::SignalDispatcher::instance().blockSignals();
+                if (mainThread())
+                    senf::scheduler::detail::SignalDispatcher::instance().blockSignals();
                 senf::scheduler::detail::FIFORunner::instance().stopWatchdog();
                 running_ = false;
             }
@@ -99,7 +103,7 @@ prefix_ void senf::scheduler::restart()
     detail::FIFORunner*           ffr (&detail::FIFORunner::instance());
     detail::FdDispatcher*         fdd (&detail::FdDispatcher::instance());
     detail::TimerDispatcher*      tdd (&detail::TimerDispatcher::instance());
-    detail::SignalDispatcher*     sdd (&detail::SignalDispatcher::instance());
+    detail::SignalDispatcher*     sdd (mainThread() ? &detail::SignalDispatcher::instance() : 0);
     detail::FileDispatcher*       fld (&detail::FileDispatcher::instance());
     detail::IdleEventDispatcher*  ied (&detail::IdleEventDispatcher::instance());
     detail::EventHookDispatcher*  eed (&detail::EventHookDispatcher::instance());
@@ -107,7 +111,8 @@ prefix_ void senf::scheduler::restart()
     eed->~EventHookDispatcher();
     ied->~IdleEventDispatcher();
     fld->~FileDispatcher();
-    sdd->~SignalDispatcher();
+    if (sdd)
+        sdd->~SignalDispatcher();
     tdd->~TimerDispatcher();
     fdd->~FdDispatcher();
     ffr->~FIFORunner();
@@ -117,7 +122,8 @@ prefix_ void senf::scheduler::restart()
     new (ffr) detail::FIFORunner();
     new (fdd) detail::FdDispatcher();
     new (tdd) detail::TimerDispatcher();
-    new (sdd) detail::SignalDispatcher();
+    if (sdd)
+        new (sdd) detail::SignalDispatcher();
     new (fld) detail::FileDispatcher();
     new (ied) detail::IdleEventDispatcher();
     new (eed) detail::EventHookDispatcher();
@@ -128,7 +134,7 @@ prefix_ bool senf::scheduler::empty()
     return detail::FdDispatcher::instance().empty()
         && detail::TimerDispatcher::instance().empty()
         && detail::FileDispatcher::instance().empty()
-        && detail::SignalDispatcher::instance().empty()
+        && (! mainThread() || detail::SignalDispatcher::instance().empty())
         && detail::IdleEventDispatcher::instance().empty()
         && detail::EventHookDispatcher::instance().empty();
 }
@@ -145,6 +151,21 @@ prefix_ void senf::scheduler::hiresTimers()
                 std::unique_ptr<detail::TimerSource>(new detail::POSIXTimerSource()));
 }
 
+prefix_ void senf::scheduler::virtualTime(bool flag)
+{
+    if (flag == virtualTime())
+        return;
+    if (flag) {
+        hiresBeforeVirtualTime_ = usingHiresTimers();
+        detail::TimerDispatcher::instance().timerSource(
+                std::unique_ptr<detail::TimerSource>(new detail::VirtualTimerSource()));
+    }
+    else if (hiresBeforeVirtualTime_)
+        hiresTimers();
+    else
+        loresTimers();
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 // senf::schedulerLogTimeSource
 
@@ -26,6 +26,7 @@
 #include "SignalEvent.hh"
 #include "IdleEvent.hh"
 #include "EventHook.hh"
+#include "Mailbox.hh"
 
 //#include "scheduler.mpp"
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -189,6 +190,25 @@ namespace senf {
     for the pointer container library reference.
 
 
+    \section sched_threads Schedulers and threads
+
+    Every thread has its own, independent %scheduler instance: Events are always registered with
+    the %scheduler of the thread creating (enabling) them and process() runs the calling threads
+    %scheduler. Event objects must therefore only be used from the thread they have been created
+    in. To run e.g. one forwarding pipeline per core, start a thread per core, create the events
+    (or PPI modules) of the pipeline within that thread and call process() (or senf::ppi::run()).
+
+    The only way to hand work to another threads %scheduler is a senf::scheduler::Mailbox created
+    by that thread: Callbacks (and packets bound to them) posted to the mailbox are executed by the
+    receiving %scheduler. This includes terminating another threads %scheduler:
+
+    \code
+    workerMailbox.post(&senf::scheduler::terminate);
+    \endcode
+
+    Some parts are shared by all threads: UNIX signals (SignalEvent) are only handled by the main
+    thread and only the main threads %scheduler is accessible via the console.
+
     \section sched_signals Signals and the Watchdog
 
     To secure against blocking callbacks, the %scheduler implementation includes a watchdog
@@ -255,6 +275,9 @@ namespace scheduler {
 
         This call will return the current time as far as it is already known to the scheduler.
         Note: The scheduler must be running() for this time to be accurate.
+
+        In contrast to ClockService::now() in cached mode (see ClockService::cached()), this value
+        is only updated once per event loop iteration and thus has no staleness bound.
      */
     ClockService::clock_type const & now();
 
@@ -332,6 +355,100 @@ namespace scheduler {
         \see hiresTimers() */
     bool usingHiresTimers();
 
+    /** \brief Enable/disable virtual time
+
+        In virtual time, the scheduler does not wait for timers to expire. Whenever there is no
+        other work (no file descriptor ready, no idle event enabled), the clock jumps directly to
+        the next timer deadline. Timers thus fire in order at exactly their deadline, and a
+        scenario with long delays runs as fast as the CPU allows and independent of the system
+        load. ClockService::now() and now() both return the virtual time (see \ref
+        clockservice_virtual).
+
+        File descriptor events are still delivered, but the scheduler never blocks waiting for
+        them while a timer is armed: Virtual time is meant for simulations where file descriptor
+        events come from in-memory sources (pipes, socket pairs, PPI debug modules) which are
+        ready immediately. Events from the network will arrive at arbitrary virtual times.
+
+        Likewise, an idle event which is permanently enabled stops the virtual clock.
+
+        Calling virtualTime(\c false), hiresTimers() or loresTimers() returns to the real
+        clock. The clock may then jump back to the real time. virtualTime(\c false) restores the
+        kind of timer source (hiresTimers() or loresTimers()) used before virtual time was
+        enabled.
+
+        \warning Virtual time must not be switched from a scheduler callback. The virtual clock
+            is shared by all threads, so virtual time should only be used with a single
+            scheduler thread.
+     */
+    void virtualTime(bool flag);
+
+    /** \brief \c true, if virtual time is enabled
+        \see virtualTime(bool) */
+    bool virtualTime();
+
+    /** \brief Select timer storage
+
+        By default, armed TimerEvent's are kept in an ordered set. Arming and canceling a timer
+        thus is logarithmic in the number of armed timers. Calling timerWheel(\c true) switches
+        to a hierarchical timing wheel, where arming and canceling are constant time
+        operations. This pays off with many (thousands and more) concurrently armed timers, e.g.
+        per flow timers.
+
+        The timer storage is independent of the timer source (see hiresTimers()). Timers are never
+        signaled early, independent of the storage used. Already armed timers are moved over when
+        switching.
+
+        \warning The timer storage must not be switched from a scheduler callback
+     */
+    void timerWheel(bool flag);
+
+    /** \brief \c true, if the timing wheel is used for timers
+        \see timerWheel(bool) */
+    bool timerWheel();
+
+    /** \brief Set epoll event batch size limits
+
+        The scheduler fetches up to eventBatchSize() file descriptor events with a single \c
+        epoll_wait() call. The batch size adapts to the load: It is doubled whenever a call returns
+        a full batch and halved again after the batch has stayed mostly empty for a while. The
+        batch size will always stay within [\a min, \a max]. Setting \a min == \a max disables
+        adaptation.
+     */
+    void eventBatchSize(unsigned min, unsigned max);
+
+    /** \brief Current epoll event batch size
+        \see eventBatchSize(unsigned, unsigned) */
+    unsigned eventBatchSize();
+
+    /** \brief Enable/disable busy polling
+
+        If \a spinBudget is non-zero, the scheduler will not block immediately when no event is
+        pending. Instead it polls for new events without blocking until either an event is posted
+        or \a spinBudget has elapsed and only then blocks in \c epoll_wait(). This trades CPU time
+        for lower wakeup latency. A \a spinBudget of 0 disables busy polling (the default).
+
+        Busy polling never delays timers: Spinning stops as soon as the next timer is due and the
+        blocking wait is shortened by the time spent spinning.
+     */
+    void busyPoll(ClockService::clock_type spinBudget);
+
+    /** \brief Current busy poll budget
+        \see busyPoll(ClockService::clock_type) */
+    ClockService::clock_type busyPoll();
+
+    /** \brief Event loop statistics
+
+        Number of wakeups, events, events per wakeup etc. The statistics are also available via
+        the \c pollStatistics command in the scheduler console directory.
+     */
+    typedef detail::FdManager::Statistics PollStatistics;
+
+    /** \brief Get current event loop statistics */
+    PollStatistics const & pollStatistics();
+
+    /** \brief Reset event loop statistics */
+    void resetPollStatistics();
+
     /** \brief Restart scheduler
 
         This call will restart all scheduler dispatchers (timers, signals, file descriptors). This
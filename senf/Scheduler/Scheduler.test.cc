@@ -354,6 +354,31 @@ SENF_AUTO_TEST_CASE(testSchedulerPOSIXTimers)
     }
 }
 
+SENF_AUTO_TEST_CASE(testSchedulerTimerWheel)
+{
+    BOOST_CHECK( ! senf::scheduler::timerWheel() );
+    senf::scheduler::TimerEvent timer (
+        "testMigrate", &timeout, senf::ClockService::now()+senf::ClockService::milliseconds(100));
+    SENF_CHECK_NO_THROW( senf::scheduler::timerWheel(true) );
+    BOOST_CHECK( senf::scheduler::timerWheel() );
+    BOOST_CHECK( timer.enabled() );
+    timeoutCalled = false;
+    SENF_CHECK_NO_THROW( senf::scheduler::process() );
+    BOOST_CHECK( timeoutCalled );
+    BOOST_CHECK( ! timer.enabled() );
+    timeoutCalled = false;
+
+    schedulerTest();
+
+    timer.timeout(senf::ClockService::now()+senf::ClockService::milliseconds(100));
+    SENF_CHECK_NO_THROW( senf::scheduler::timerWheel(false) );
+    BOOST_CHECK( ! senf::scheduler::timerWheel() );
+    BOOST_CHECK( timer.enabled() );
+    SENF_CHECK_NO_THROW( senf::scheduler::process() );
+    BOOST_CHECK( timeoutCalled );
+    timeoutCalled = false;
+}
+
 namespace {
 
     void sigme()
@@ -394,6 +419,74 @@ SENF_AUTO_TEST_CASE(blockSignals)
     SENF_CHECK_NO_THROW( senf::scheduler::process() );
 }
 
+namespace {
+
+    unsigned busyPollCount (0);
+
+    void busyPollCallback(int fd, int)
+    {
+        char buf[16];
+        BOOST_CHECK( read(fd, buf, sizeof(buf)) > 0 );
+        if (++busyPollCount >= 3)
+            senf::scheduler::terminate();
+    }
+
+    void busyPollWriter(int fd)
+    {
+        BOOST_CHECK_EQUAL( write(fd, "x", 1), 1 );
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(busyPoll)
+{
+    int fds[2];
+    BOOST_REQUIRE( pipe(fds) == 0 );
+
+    BOOST_CHECK_EQUAL( senf::scheduler::busyPoll(), senf::ClockService::clock_type(0) );
+    senf::scheduler::busyPoll(senf::ClockService::milliseconds(5));
+    BOOST_CHECK_EQUAL( senf::scheduler::busyPoll(), senf::ClockService::milliseconds(5) );
+    senf::scheduler::eventBatchSize(2u, 64u);
+    senf::scheduler::resetPollStatistics();
+
+    senf::scheduler::FdEvent reader (
+        "busyPollReader", boost::bind(&busyPollCallback, fds[0], _1), fds[0],
+        senf::scheduler::FdEvent::EV_READ);
+    // The first timer fires within the spin budget, the others only after it is exhausted
+    senf::scheduler::TimerEvent w1 (
+        "busyPollWriter1", boost::bind(&busyPollWriter, fds[1]),
+        senf::ClockService::now() + senf::ClockService::milliseconds(1));
+    senf::scheduler::TimerEvent w2 (
+        "busyPollWriter2", boost::bind(&busyPollWriter, fds[1]),
+        senf::ClockService::now() + senf::ClockService::milliseconds(20));
+    senf::scheduler::TimerEvent w3 (
+        "busyPollWriter3", boost::bind(&busyPollWriter, fds[1]),
+        senf::ClockService::now() + senf::ClockService::milliseconds(40));
+
+    senf::ClockService::clock_type t (senf::ClockService::now());
+    SENF_CHECK_NO_THROW( senf::scheduler::process() );
+    BOOST_CHECK_EQUAL( busyPollCount, 3u );
+    // Busy polling must not delay timers beyond the normal timer granularity
+    BOOST_CHECK( senf::ClockService::now() - t < senf::ClockService::milliseconds(200) );
+
+    senf::scheduler::PollStatistics const & stats (senf::scheduler::pollStatistics());
+    BOOST_CHECK( stats.wakeups > 0u );
+    BOOST_CHECK( stats.events >= 3u );
+    BOOST_CHECK( stats.spinPolls > 0u );
+    BOOST_CHECK( stats.maxEvents >= 1u );
+    BOOST_CHECK( stats.eventsPerWakeup() > 0.0 );
+    BOOST_CHECK( senf::scheduler::eventBatchSize() >= 2u );
+
+    senf::scheduler::resetPollStatistics();
+    BOOST_CHECK_EQUAL( senf::scheduler::pollStatistics().wakeups, 0u );
+    senf::scheduler::busyPoll(0);
+    senf::scheduler::eventBatchSize(8u, 256u);
+
+    reader.disable();
+    close(fds[0]);
+    close(fds[1]);
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
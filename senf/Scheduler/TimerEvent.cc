@@ -19,6 +19,7 @@
 
 // Custom includes
 #include <sstream>
+#include "TimerWheel.hh"
 
 //#include "TimerEvent.mpp"
 #define prefix_
@@ -30,6 +31,12 @@ prefix_ senf::scheduler::detail::TimerDispatcher::TimerDispatcher()
 
 prefix_ senf::scheduler::detail::TimerDispatcher::~TimerDispatcher()
 {
+    if (wheel_) {
+        TimerWheel::TimerList timers;
+        wheel_->clear(timers);
+        for (TimerWheel::TimerList::iterator i (timers.begin()); i != timers.end(); ++i)
+            FIFORunner::instance().dequeue(&(*i));
+    }
     TimerSet::iterator i (timers_.begin());
     TimerSet::iterator const i_end (timers_.end());
     for (; i != i_end; ++i)
@@ -38,12 +45,20 @@ prefix_ senf::scheduler::detail::TimerDispatcher::~TimerDispatcher()
 
 void senf::scheduler::detail::TimerDispatcher::add(TimerEvent & event)
 {
-    TimerSet::iterator i (timers_.insert(event));
-    FIFORunner::instance().enqueue(&(*i));
+    if (wheel_)
+        wheel_->insert(event);
+    else
+        timers_.insert(event);
+    FIFORunner::instance().enqueue(&event);
 }
 
 prefix_ void senf::scheduler::detail::TimerDispatcher::remove(TimerEvent & event)
 {
+    if (event.TimerWheelBase::is_linked()) {
+        FIFORunner::instance().dequeue(&event);
+        wheel_->remove(event);
+        return;
+    }
     TimerSet::iterator i (TimerSet::s_iterator_to(event));
     if (i == timers_.end())
         return;
@@ -53,6 +68,13 @@ prefix_ void senf::scheduler::detail::TimerDispatcher::remove(TimerEvent & event
 
 prefix_ void senf::scheduler::detail::TimerDispatcher::prepareRun()
 {
+    if (wheel_) {
+        TimerWheel::TimerList & expired (
+            wheel_->expire(FdManager::instance().eventTime()));
+        for (TimerWheel::TimerList::iterator i (expired.begin()); i != expired.end(); ++i)
+            i->setRunnable();
+        return;
+    }
     TimerSet::iterator i (timers_.begin());
     TimerSet::iterator const i_end (timers_.end());
     ClockService::clock_type const & now (FdManager::instance().eventTime());
@@ -62,12 +84,52 @@ prefix_ void senf::scheduler::detail::TimerDispatcher::prepareRun()
 
 prefix_ void senf::scheduler::detail::TimerDispatcher::reschedule()
 {
+    if (wheel_) {
+        if (wheel_->empty())
+            source_->notimeout();
+        else
+            source_->timeout(wheel_->nextTimeout());
+        return;
+    }
     if (timers_.empty())
         source_->notimeout();
     else
         source_->timeout(timers_.begin()->timeout_);
 }
 
+prefix_ bool senf::scheduler::detail::TimerDispatcher::empty()
+    const
+{
+    return wheel_ ? wheel_->empty() : timers_.empty();
+}
+
+prefix_ void senf::scheduler::detail::TimerDispatcher::timerWheel(bool flag)
+{
+    // Armed timers are moved over, they stay registered with the FIFORunner
+    if (flag) {
+        if (wheel_)
+            return;
+        wheel_.reset(new TimerWheel(FdManager::instance().eventTime()));
+        while (! timers_.empty()) {
+            TimerEvent & event (*timers_.begin());
+            timers_.erase(timers_.begin());
+            wheel_->insert(event);
+        }
+    }
+    else {
+        if (! wheel_)
+            return;
+        TimerWheel::TimerList timers;
+        wheel_->clear(timers);
+        wheel_.reset();
+        while (! timers.empty()) {
+            TimerEvent & event (timers.front());
+            timers.pop_front();
+            timers_.insert(event);
+        }
+    }
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 // senf::scheduler::detail::TimerDispatcher::TimerEvent
 
@@ -20,6 +20,7 @@
 // Custom includes
 #include <signal.h>
 #include <boost/intrusive/set_hook.hpp>
+#include <boost/intrusive/list_hook.hpp>
 #include "ClockService.hh"
 #include "FIFORunner.hh"
 #include <senf/Utils/Logger/SenfLog.hh>
@@ -34,8 +35,13 @@ namespace scheduler {
     namespace detail {
         struct TimerSetTag;
         typedef boost::intrusive::set_base_hook< boost::intrusive::tag<TimerSetTag> > TimerSetBase;
+        struct TimerWheelTag;
+        typedef boost::intrusive::list_base_hook<
+            boost::intrusive::tag<TimerWheelTag>,
+            boost::intrusive::link_mode<boost::intrusive::auto_unlink> > TimerWheelBase;
         struct TimerSetCompare;
         class TimerDispatcher;
+        class TimerWheel;
     }
 
     /** \brief Deadline timer event
@@ -47,6 +53,9 @@ namespace scheduler {
         resolution will be far more precise than the linux clock tick resolution. The nominal timer
         resolution is 1 nanosecond.
 
+        Armed timers are kept either in an ordered set (the default) or in a hierarchical timing
+        wheel, see senf::scheduler::timerWheel().
+
         The timeout time is set as \e absolute time as returned by the senf::ClockService. After
         expiration, the timer will be disabled. It may be re-enabled by setting a new timeout time.
         It is also possible to change a running timer resetting the timeout time.
@@ -58,7 +67,8 @@ namespace scheduler {
      */
     class TimerEvent
         : public detail::FIFORunner::TaskInfo,
-          public detail::TimerSetBase
+          public detail::TimerSetBase,
+          public detail::TimerWheelBase
     {
     public:
         //-////////////////////////////////////////////////////////////////////////
@@ -110,15 +120,19 @@ namespace scheduler {
                                         ///< Get current/last timeout value
 
     private:
+        bool armed() const;
+
         virtual void v_run();
         virtual char const * v_type() const;
         virtual std::string v_info() const;
 
         Callback cb_;
         ClockService::clock_type timeout_;
+        unsigned wheelSlot_;            // TimerWheel slot, only valid while linked into the wheel
 
         friend class detail::TimerDispatcher;
         friend struct detail::TimerSetCompare;
+        friend class detail::TimerWheel;
     };
 
 }}
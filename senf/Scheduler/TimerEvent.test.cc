@@ -18,6 +18,8 @@
 
 // Custom includes
 #include <boost/bind.hpp>
+#include <unistd.h>
+#include <vector>
 #include <boost/random.hpp>
 #include "Scheduler.hh"
 
@@ -161,6 +163,99 @@ SENF_AUTO_TEST_CASE(timerJitter)
     BOOST_CHECK( true );
 }
 
+namespace {
+
+    std::vector< std::pair<char, senf::ClockService::clock_type> > virtualEvents;
+
+    void virtualCb(char id)
+    {
+        virtualEvents.push_back(std::make_pair(id, senf::scheduler::now()));
+    }
+
+    void virtualRearmCb(senf::scheduler::TimerEvent & tm)
+    {
+        virtualCb('b');
+        if (virtualEvents.size() < 4)
+            tm.timeout(tm.timeout() + senf::ClockService::minutes(10));
+    }
+
+    void virtualFdCb(senf::scheduler::FdEvent & ev, int fd)
+    {
+        char data;
+        BOOST_CHECK_EQUAL( ::read(fd, &data, 1), 1 );
+        virtualCb(data);
+        ev.disable();
+    }
+
+    void virtualTimeTest()
+    {
+        typedef senf::ClockService CS;
+
+        int fds[2];
+        BOOST_REQUIRE( ::pipe(fds) == 0 );
+        BOOST_CHECK_EQUAL( ::write(fds[1], "f", 1), 1 );
+
+        virtualEvents.clear();
+        CS::clock_type real (CS::monotonic());
+        CS::clock_type t0 (CS::now());
+        {
+            senf::scheduler::TimerEvent a ("virtualTime::a", boost::bind(&virtualCb, 'a'),
+                                           t0 + CS::hours(1));
+            senf::scheduler::TimerEvent b ("virtualTime::b", boost::bind(&virtualRearmCb,
+                                                                          boost::ref(b)),
+                                           t0 + CS::minutes(30));
+            senf::scheduler::FdEvent f ("virtualTime::f", boost::bind(&virtualFdCb, boost::ref(f),
+                                                                      fds[0]),
+                                        fds[0], senf::scheduler::FdEvent::EV_READ);
+            senf::scheduler::process();
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+
+        BOOST_CHECK( CS::monotonic() - real < CS::seconds(1) );
+        BOOST_REQUIRE_EQUAL( virtualEvents.size(), 5u );
+        BOOST_CHECK_EQUAL( virtualEvents[0].first, 'f' );
+        BOOST_CHECK_EQUAL( virtualEvents[0].second, t0 );
+        BOOST_CHECK_EQUAL( virtualEvents[1].first, 'b' );
+        BOOST_CHECK_EQUAL( virtualEvents[1].second, t0 + CS::minutes(30) );
+        BOOST_CHECK_EQUAL( virtualEvents[2].first, 'b' );
+        BOOST_CHECK_EQUAL( virtualEvents[2].second, t0 + CS::minutes(40) );
+        BOOST_CHECK_EQUAL( virtualEvents[3].first, 'b' );
+        BOOST_CHECK_EQUAL( virtualEvents[3].second, t0 + CS::minutes(50) );
+        BOOST_CHECK_EQUAL( virtualEvents[4].first, 'a' );
+        BOOST_CHECK_EQUAL( virtualEvents[4].second, t0 + CS::hours(1) );
+        BOOST_CHECK_EQUAL( CS::now(), t0 + CS::hours(1) );
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(timerDispatcher_virtualTime)
+{
+    senf::scheduler::virtualTime(true);
+    BOOST_CHECK( senf::scheduler::virtualTime() );
+    BOOST_CHECK( ! senf::scheduler::usingHiresTimers() );
+    BOOST_CHECK( senf::ClockService::virtualTime() );
+
+    virtualTimeTest();
+    senf::scheduler::timerWheel(true);
+    virtualTimeTest();
+    senf::scheduler::timerWheel(false);
+
+    senf::scheduler::virtualTime(false);
+    BOOST_CHECK( ! senf::scheduler::virtualTime() );
+    BOOST_CHECK( ! senf::ClockService::virtualTime() );
+    BOOST_CHECK( ! senf::scheduler::usingHiresTimers() );
+
+    // leaving virtual time returns to the timer source used before
+    senf::scheduler::hiresTimers();
+    senf::scheduler::virtualTime(true);
+    BOOST_CHECK( ! senf::scheduler::usingHiresTimers() );
+    senf::scheduler::virtualTime(false);
+    BOOST_CHECK( ! senf::scheduler::virtualTime() );
+    BOOST_CHECK( senf::scheduler::usingHiresTimers() );
+    senf::scheduler::loresTimers();
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
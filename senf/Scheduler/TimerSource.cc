@@ -164,6 +164,44 @@ prefix_ void senf::scheduler::detail::PollTimerSource::enable()
 prefix_ void senf::scheduler::detail::PollTimerSource::disable()
 {}
 
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::scheduler::detail::VirtualTimerSource
+
+// The virtual timer source owns virtual time: It is enabled while the source is installed
+
+prefix_ senf::scheduler::detail::VirtualTimerSource::VirtualTimerSource()
+{
+    // Drop a poll timeout left over by the PollTimerSource
+    IdleEventDispatcher::instance().timeout(-1);
+    ClockService::virtualTime(true);
+    FdManager::instance().updateEventTime();
+}
+
+prefix_ senf::scheduler::detail::VirtualTimerSource::~VirtualTimerSource()
+{
+    FdManager::instance().noVirtualTimeout();
+    ClockService::virtualTime(false);
+    // The event time is ahead of the real clock
+    FdManager::instance().updateEventTime();
+}
+
+prefix_ void
+senf::scheduler::detail::VirtualTimerSource::timeout(ClockService::clock_type const & timeout)
+{
+    FdManager::instance().virtualTimeout(timeout);
+}
+
+prefix_ void senf::scheduler::detail::VirtualTimerSource::notimeout()
+{
+    FdManager::instance().noVirtualTimeout();
+}
+
+prefix_ void senf::scheduler::detail::VirtualTimerSource::enable()
+{}
+
+prefix_ void senf::scheduler::detail::VirtualTimerSource::disable()
+{}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 // senf::scheduler::detail::TimerFDTimerSource
 
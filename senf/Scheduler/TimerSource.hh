@@ -83,6 +83,20 @@ namespace detail {
         virtual void disable();
     };
 
+    class VirtualTimerSource
+        : public TimerSource
+    {
+    public:
+        VirtualTimerSource();
+        ~VirtualTimerSource();
+
+        virtual void timeout(ClockService::clock_type const & timeout);
+        virtual void notimeout();
+
+        virtual void enable();
+        virtual void disable();
+    };
+
 #ifdef HAVE_TIMERFD_CREATE
     class TimerFDTimerSource
         : public detail::FdManager::Event, public TimerSource
@@ -0,0 +1,293 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief TimerWheel non-inline non-template implementation */
+
+#include "TimerWheel.hh"
+//#include "TimerWheel.ih"
+
+// Custom includes
+#include <limits>
+
+//#include "TimerWheel.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    boost::uint64_t rotateRight(boost::uint64_t v, unsigned n)
+    {
+        return n ? (v >> n) | (v << (64 - n)) : v;
+    }
+
+}
+
+prefix_ senf::scheduler::detail::TimerWheel::TimerWheel(ClockService::clock_type now)
+    : overflowTimeout_ (0), overflowTimeoutValid_ (false), current_ (tick(now)),
+      overflowMin_ (std::numeric_limits<tick_type>::max()), size_ (0)
+{
+    for (unsigned l (0); l < Levels; ++l) {
+        occupied_[l] = 0;
+        slotMinValid_[l] = 0;
+    }
+}
+
+prefix_ void senf::scheduler::detail::TimerWheel::place(TimerEvent & event)
+{
+    tick_type t (tick(event.timeout()));
+    if (t < current_) {
+        event.wheelSlot_ = NoSlot;
+        expired_.push_back(event);
+        return;
+    }
+    // A timer is placed on the lowest level on which its slot lies within the next Slots slots
+    // of the current position. Thus the slot of the current position is always empty on
+    // levels > 0. This does NOT imply, that all timers on level l expire after all timers on the
+    // levels below (see nextTimeout()).
+    for (unsigned l (0); l < Levels; ++l) {
+        tick_type slot (t >> (SlotBits*l));
+        if (slot - (current_ >> (SlotBits*l)) < tick_type(Slots)) {
+            link(l, slot & (Slots-1), event);
+            return;
+        }
+    }
+    event.wheelSlot_ = OverflowSlot;
+    if (overflow_.empty()) {
+        overflowTimeout_ = event.timeout();
+        overflowTimeoutValid_ = true;
+    }
+    else if (overflowTimeoutValid_ && event.timeout() < overflowTimeout_)
+        overflowTimeout_ = event.timeout();
+    overflow_.push_back(event);
+    if (t < overflowMin_)
+        overflowMin_ = t;
+}
+
+prefix_ void senf::scheduler::detail::TimerWheel::link(unsigned level, unsigned i,
+                                                       TimerEvent & event)
+{
+    boost::uint64_t bit (boost::uint64_t(1u) << i);
+    if (slots_[level][i].empty()) {
+        slotMin_[level][i] = event.timeout();
+        slotMinValid_[level] |= bit;
+    }
+    else if ((slotMinValid_[level] & bit) && event.timeout() < slotMin_[level][i])
+        slotMin_[level][i] = event.timeout();
+    slots_[level][i].push_back(event);
+    occupied_[level] |= bit;
+    event.wheelSlot_ = level * Slots + i;
+}
+
+prefix_ senf::ClockService::clock_type
+senf::scheduler::detail::TimerWheel::slotTimeout(unsigned level, unsigned i)
+    const
+{
+    // Earliest timeout of a non-empty slot. The slot is only walked, if the cached minimum has
+    // been invalidated
+    boost::uint64_t bit (boost::uint64_t(1u) << i);
+    if (! (slotMinValid_[level] & bit)) {
+        TimerList const & slot (slots_[level][i]);
+        TimerList::const_iterator j (slot.begin());
+        ClockService::clock_type timeout (j->timeout());
+        for (++j; j != slot.end(); ++j)
+            if (j->timeout() < timeout)
+                timeout = j->timeout();
+        slotMin_[level][i] = timeout;
+        slotMinValid_[level] |= bit;
+    }
+    return slotMin_[level][i];
+}
+
+prefix_ senf::ClockService::clock_type senf::scheduler::detail::TimerWheel::overflowTimeout()
+    const
+{
+    if (! overflowTimeoutValid_) {
+        TimerList::const_iterator i (overflow_.begin());
+        overflowTimeout_ = i->timeout();
+        for (++i; i != overflow_.end(); ++i)
+            if (i->timeout() < overflowTimeout_)
+                overflowTimeout_ = i->timeout();
+        overflowTimeoutValid_ = true;
+    }
+    return overflowTimeout_;
+}
+
+prefix_ int senf::scheduler::detail::TimerWheel::firstSlot(unsigned level, unsigned start)
+    const
+{
+    // Returns the offset of the first non-empty slot on 'level' in circular order beginning at
+    // slot 'start' or -1, if all slots are empty. Slots which became empty by remove() are
+    // cleared from the bitmap on the fly.
+    boost::uint64_t m (rotateRight(occupied_[level], start));
+    while (m) {
+        unsigned offset (__builtin_ctzll(m));
+        unsigned i ((start + offset) & (Slots-1));
+        if (! slots_[level][i].empty())
+            return offset;
+        occupied_[level] &= ~(boost::uint64_t(1u) << i);
+        m &= ~(boost::uint64_t(1u) << offset);
+    }
+    return -1;
+}
+
+prefix_ senf::scheduler::detail::TimerWheel::tick_type
+senf::scheduler::detail::TimerWheel::nextTick()
+    const
+{
+    // Earliest tick at which a level 0 slot expires or a higher level slot must be cascaded
+    tick_type next (std::numeric_limits<tick_type>::max());
+    int offset (firstSlot(0, current_ & (Slots-1)));
+    if (offset >= 0)
+        next = current_ + offset;
+    for (unsigned l (1); l < Levels; ++l) {
+        tick_type pos ((current_ >> (SlotBits*l)) + 1);
+        offset = firstSlot(l, pos & (Slots-1));
+        if (offset >= 0)
+            next = std::min(next, (pos + offset) << (SlotBits*l));
+    }
+    if (! overflow_.empty()) {
+        unsigned shift (SlotBits*(Levels-1));
+        next = std::min(next, std::max(current_,
+                                       ((overflowMin_ >> shift) - tick_type(Slots-1)) << shift));
+    }
+    return next;
+}
+
+prefix_ void senf::scheduler::detail::TimerWheel::advance(tick_type t)
+{
+    current_ = t;
+    if (! overflow_.empty()) {
+        unsigned shift (SlotBits*(Levels-1));
+        if (current_ >= ((overflowMin_ >> shift) - tick_type(Slots-1)) << shift) {
+            TimerList timers;
+            timers.splice(timers.end(), overflow_);
+            overflowMin_ = std::numeric_limits<tick_type>::max();
+            while (! timers.empty()) {
+                TimerEvent & event (timers.front());
+                timers.pop_front();
+                place(event);
+            }
+        }
+    }
+    // Cascade from the top down: timers cascaded from level l may land in the level l-1 slot
+    // which is due at the same tick.
+    for (unsigned l (Levels-1); l > 0; --l) {
+        if (current_ & ((tick_type(1) << (SlotBits*l)) - 1))
+            continue;
+        unsigned i ((current_ >> (SlotBits*l)) & (Slots-1));
+        if (slots_[l][i].empty())
+            continue;
+        TimerList timers;
+        timers.splice(timers.end(), slots_[l][i]);
+        occupied_[l] &= ~(boost::uint64_t(1u) << i);
+        while (! timers.empty()) {
+            TimerEvent & event (timers.front());
+            timers.pop_front();
+            place(event);
+        }
+    }
+}
+
+prefix_ senf::scheduler::detail::TimerWheel::TimerList &
+senf::scheduler::detail::TimerWheel::expire(ClockService::clock_type now)
+{
+    tick_type nowTick (tick(now));
+    while (current_ < nowTick) {
+        tick_type t (nextTick());
+        if (t >= nowTick) {
+            advance(nowTick);
+            break;
+        }
+        if (t > current_)
+            advance(t);
+        // All timers in the slot of a tick before nowTick have expired
+        expired_.splice(expired_.end(), slots_[0][current_ & (Slots-1)]);
+        advance(current_ + 1);
+    }
+    // Timers in the slot of the current tick only expire if their exact timeout has been reached
+    unsigned i (current_ & (Slots-1));
+    TimerList & slot (slots_[0][i]);
+    if (! slot.empty() && slotTimeout(0, i) <= now) {
+        for (TimerList::iterator j (slot.begin()); j != slot.end();) {
+            if (j->timeout() <= now) {
+                TimerEvent & event (*j);
+                j = slot.erase(j);
+                expired_.push_back(event);
+            }
+            else
+                ++j;
+        }
+        slotMinValid_[0] &= ~(boost::uint64_t(1u) << i);
+    }
+    return expired_;
+}
+
+prefix_ senf::ClockService::clock_type senf::scheduler::detail::TimerWheel::nextTimeout()
+    const
+{
+    if (! expired_.empty())
+        return expired_.front().timeout();
+    // Within a level the slots are ordered by time starting at the current position, but a timer
+    // on some level may well expire later than a timer on a higher level (a level 0 timer may
+    // extend up to Slots ticks beyond the next level 1 boundary). Thus the earliest timer is the
+    // earliest timer in the first non-empty slot of any level. Overflow timers expire after all
+    // timers in the wheel.
+    ClockService::clock_type timeout (0);
+    bool found (false);
+    for (unsigned l (0); l < Levels; ++l) {
+        tick_type pos ((current_ >> (SlotBits*l)) + (l ? 1 : 0));
+        int offset (firstSlot(l, pos & (Slots-1)));
+        if (offset < 0)
+            continue;
+        ClockService::clock_type t (slotTimeout(l, (pos + offset) & (Slots-1)));
+        if (! found || t < timeout) {
+            timeout = t;
+            found = true;
+        }
+    }
+    if (! found)
+        timeout = overflowTimeout();
+    return timeout;
+}
+
+prefix_ void senf::scheduler::detail::TimerWheel::clear(TimerList & timers)
+{
+    timers.splice(timers.end(), expired_);
+    for (unsigned l (0); l < Levels; ++l) {
+        for (unsigned i (0); i < Slots; ++i)
+            timers.splice(timers.end(), slots_[l][i]);
+        occupied_[l] = 0;
+        slotMinValid_[l] = 0;
+    }
+    timers.splice(timers.end(), overflow_);
+    overflowTimeoutValid_ = false;
+    overflowMin_ = std::numeric_limits<tick_type>::max();
+    size_ = 0;
+}
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "TimerWheel.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
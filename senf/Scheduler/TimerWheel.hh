@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief TimerWheel public header */
+
+#ifndef HH_SENF_Scheduler_TimerWheel_
+#define HH_SENF_Scheduler_TimerWheel_ 1
+
+// Custom includes
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/intrusive/list.hpp>
+#include "TimerEvent.hh"
+
+//#include "TimerWheel.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace scheduler {
+namespace detail {
+
+    /** \brief Hierarchical timing wheel
+
+        The TimerWheel stores armed TimerEvent instances in a hierarchy of Levels wheels with
+        Slots slots each. A slot on level 0 covers a single tick of 2^TickShift
+        nanoseconds, a slot on level \e l covers Slots ^ \e l ticks. Timers too far in the
+        future for the topmost level are kept on an overflow list.
+
+        Arming and canceling a timer are constant time operations: A timer is appended to or
+        unlinked from its slot list. While time advances, the slots of the higher levels are
+        cascaded down to the lower levels. Empty slots are skipped using a per-level occupancy
+        bitmap, so the cost of advancing the wheel does not depend on the time passed.
+
+        Timers are never signaled early: A timer in the slot of the current tick is only moved to
+        the expired list when its exact timeout has been reached. nextTimeout() likewise returns the
+        exact timeout of the earliest timer. To find it without walking the timers, the earliest
+        timeout of every slot (and of the overflow list) is cached. The cache is updated when a
+        timer is armed and invalidated when the earliest timer of a slot is canceled, only then
+        nextTimeout() has to walk that slot again.
+
+        \see senf::scheduler::timerWheel()
+     */
+    class TimerWheel
+        : boost::noncopyable
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // Types
+
+        typedef boost::intrusive::list< TimerEvent,
+                                        boost::intrusive::constant_time_size<false>,
+                                        boost::intrusive::base_hook<TimerWheelBase> > TimerList;
+        typedef boost::int64_t tick_type;
+
+        static unsigned const TickShift = 20u; ///< Tick length is 2^TickShift ns (~1.05 ms)
+        static unsigned const SlotBits = 6u;
+        static unsigned const Slots = 1u << SlotBits; ///< Number of slots per level
+        static unsigned const Levels = 6u; ///< Number of levels (range ~2.3 years)
+
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        explicit TimerWheel(ClockService::clock_type now);
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+
+        void insert(TimerEvent & event); ///< Arm \a event
+        void remove(TimerEvent & event); ///< Cancel \a event
+
+        TimerList & expire(ClockService::clock_type now);
+                                        ///< Advance wheel to \a now
+                                        /**< All timers with a timeout <= \a now are moved to the
+                                             expired list which is returned. Timers stay on the
+                                             expired list until they are removed. */
+
+        bool empty() const;             ///< \c true, if no timer is armed
+        unsigned size() const;          ///< Number of armed timers
+        ClockService::clock_type nextTimeout() const;
+                                        ///< Timeout of earliest armed timer
+                                        /**< \pre ! empty() */
+
+        void clear(TimerList & timers); ///< Move all armed timers to \a timers
+
+    private:
+        static unsigned const OverflowSlot = Levels * Slots;
+        static unsigned const NoSlot = OverflowSlot + 1;
+
+        static tick_type tick(ClockService::clock_type t);
+
+        void place(TimerEvent & event);
+        void link(unsigned level, unsigned i, TimerEvent & event);
+        ClockService::clock_type slotTimeout(unsigned level, unsigned i) const;
+        ClockService::clock_type overflowTimeout() const;
+        int firstSlot(unsigned level, unsigned start) const;
+        tick_type nextTick() const;
+        void advance(tick_type t);
+
+        TimerList slots_[Levels][Slots];
+        mutable boost::uint64_t occupied_[Levels];
+        mutable ClockService::clock_type slotMin_[Levels][Slots];
+        mutable boost::uint64_t slotMinValid_[Levels];
+        TimerList overflow_;
+        mutable ClockService::clock_type overflowTimeout_;
+        mutable bool overflowTimeoutValid_;
+        TimerList expired_;
+        tick_type current_;
+        tick_type overflowMin_;
+        unsigned size_;
+    };
+
+}}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "TimerWheel.cci"
+//#include "TimerWheel.ct"
+//#include "TimerWheel.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
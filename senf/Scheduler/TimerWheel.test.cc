@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief TimerWheel unit tests */
+
+#include "TimerWheel.hh"
+
+// Custom includes
+#include <random>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    void noop() {}
+
+    typedef senf::scheduler::detail::TimerWheel TimerWheel;
+
+    bool isArmed(senf::scheduler::TimerEvent & timer)
+    {
+        return timer.senf::scheduler::detail::TimerWheelBase::is_linked();
+    }
+
+    senf::ClockService::clock_type minTimeout(
+        boost::ptr_vector<senf::scheduler::TimerEvent> & timers)
+    {
+        senf::ClockService::clock_type t (senf::ClockService::days(365*100));
+        for (unsigned i (0); i < timers.size(); ++i)
+            if (isArmed(timers[i]) && timers[i].timeout() < t)
+                t = timers[i].timeout();
+        return t;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(timerWheel)
+{
+    senf::ClockService::clock_type const base (senf::ClockService::seconds(1000));
+    boost::ptr_vector<senf::scheduler::TimerEvent> timers;
+    for (unsigned i (0); i < 4; ++i)
+        timers.push_back(new senf::scheduler::TimerEvent("timerWheel", &noop));
+    TimerWheel wheel (base);
+
+    BOOST_CHECK( wheel.empty() );
+    timers[0].timeout(base + senf::ClockService::microseconds(100), false);
+    timers[1].timeout(base + senf::ClockService::milliseconds(100), false);
+    timers[2].timeout(base + senf::ClockService::hours(24*365*10), false); // overflow
+    timers[3].timeout(base - senf::ClockService::seconds(1), false); // already expired
+    for (unsigned i (0); i < 4; ++i)
+        wheel.insert(timers[i]);
+    BOOST_CHECK_EQUAL( wheel.size(), 4u );
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[3].timeout() );
+
+    TimerWheel::TimerList & expired (wheel.expire(base));
+    BOOST_REQUIRE_EQUAL( expired.size(), 1u );
+    BOOST_CHECK( &expired.front() == &timers[3] );
+    wheel.remove(timers[3]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[0].timeout() );
+
+    // Same tick, but not yet expired
+    BOOST_CHECK( wheel.expire(base + senf::ClockService::microseconds(99)).empty() );
+    BOOST_CHECK_EQUAL( wheel.expire(base + senf::ClockService::microseconds(100)).size(), 1u );
+    wheel.remove(timers[0]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[1].timeout() );
+
+    wheel.remove(timers[1]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[2].timeout() );
+    BOOST_CHECK( wheel.expire(base + senf::ClockService::hours(24*365*10) - 1).empty() );
+    BOOST_CHECK_EQUAL( wheel.expire(base + senf::ClockService::hours(24*365*10)).size(), 1u );
+
+    TimerWheel::TimerList all;
+    wheel.clear(all);
+    BOOST_CHECK( wheel.empty() );
+    BOOST_CHECK_EQUAL( all.size(), 1u );
+    all.clear();
+}
+
+SENF_AUTO_TEST_CASE(timerWheel_levelBoundary)
+{
+    // A timer placed on a lower level may expire later than a timer on a higher level: With the
+    // wheel positioned just before a boundary of level l, a timer beyond the boundary is placed
+    // on level l-1 while an earlier timer armed before is still on level l
+    for (unsigned l (1); l < 4; ++l) {
+        TimerWheel::tick_type const boundary (TimerWheel::tick_type(1) << (TimerWheel::SlotBits*l));
+        senf::ClockService::clock_type const base (
+            senf::ClockService::nanoseconds(
+                boundary << (TimerWheel::TickShift + TimerWheel::SlotBits)));
+        senf::ClockService::clock_type const tick (
+            senf::ClockService::nanoseconds(1ll << TimerWheel::TickShift));
+        senf::scheduler::TimerEvent early ("timerWheel", &noop);
+        senf::scheduler::TimerEvent late ("timerWheel", &noop);
+        TimerWheel wheel (base);
+
+        early.timeout(base + boundary * tick, false);
+        wheel.insert(early);
+        BOOST_CHECK( wheel.expire(base + (boundary - 1) * tick).empty() );
+        TimerWheel::tick_type const lateTick (
+            boundary - 1 + (TimerWheel::Slots - 2) * (boundary >> TimerWheel::SlotBits));
+        late.timeout(base + lateTick * tick, false);
+        wheel.insert(late);
+        BOOST_CHECK_EQUAL( wheel.nextTimeout(), early.timeout() );
+
+        TimerWheel::TimerList & expired (wheel.expire(early.timeout()));
+        BOOST_REQUIRE_EQUAL( expired.size(), 1u );
+        BOOST_CHECK( &expired.front() == &early );
+        wheel.remove(early);
+        BOOST_CHECK_EQUAL( wheel.nextTimeout(), late.timeout() );
+        BOOST_CHECK_EQUAL( wheel.expire(late.timeout()).size(), 1u );
+        wheel.remove(late);
+        BOOST_CHECK( wheel.empty() );
+    }
+}
+
+SENF_AUTO_TEST_CASE(timerWheel_slotMinimum)
+{
+    // Timers within the same higher level slot: The cached slot minimum must follow arming and
+    // canceling the earliest timer
+    senf::ClockService::clock_type const base (senf::ClockService::seconds(1000));
+    boost::ptr_vector<senf::scheduler::TimerEvent> timers;
+    for (unsigned i (0); i < 4; ++i)
+        timers.push_back(new senf::scheduler::TimerEvent("timerWheel", &noop));
+    TimerWheel wheel (base);
+
+    timers[0].timeout(base + senf::ClockService::seconds(100) + 3, false);
+    timers[1].timeout(base + senf::ClockService::seconds(100) + 1, false);
+    timers[2].timeout(base + senf::ClockService::seconds(100) + 2, false);
+    for (unsigned i (0); i < 3; ++i)
+        wheel.insert(timers[i]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[1].timeout() );
+    wheel.remove(timers[1]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[2].timeout() );
+    wheel.remove(timers[0]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[2].timeout() );
+    timers[3].timeout(base + senf::ClockService::seconds(100), false);
+    wheel.insert(timers[3]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[3].timeout() );
+    wheel.insert(timers[1]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[3].timeout() );
+    wheel.remove(timers[3]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[1].timeout() );
+
+    BOOST_CHECK( wheel.expire(timers[1].timeout() - 1).empty() );
+    BOOST_CHECK_EQUAL( wheel.expire(timers[1].timeout()).size(), 1u );
+    wheel.remove(timers[1]);
+    BOOST_CHECK_EQUAL( wheel.nextTimeout(), timers[2].timeout() );
+    BOOST_CHECK_EQUAL( wheel.expire(timers[2].timeout()).size(), 1u );
+    wheel.remove(timers[2]);
+    BOOST_CHECK( wheel.empty() );
+}
+
+SENF_AUTO_TEST_CASE(timerWheel_random)
+{
+    // Compare the wheel against a brute force search over random timeouts, removals and
+    // time steps covering all levels of the wheel
+    senf::ClockService::clock_type const base (senf::ClockService::seconds(1000));
+    std::mt19937_64 rng (4711u);
+    boost::ptr_vector<senf::scheduler::TimerEvent> timers;
+    for (unsigned i (0); i < 2000; ++i)
+        timers.push_back(new senf::scheduler::TimerEvent("timerWheel", &noop));
+    TimerWheel wheel (base);
+    senf::ClockService::clock_type now (base);
+
+    unsigned armed (0);
+    for (unsigned round (0); round < 400; ++round) {
+        for (unsigned n (0); n < 50; ++n) {
+            senf::scheduler::TimerEvent & timer (timers[rng() % timers.size()]);
+            if (isArmed(timer)) {
+                wheel.remove(timer);
+                -- armed;
+            }
+            else {
+                // Delays from 0 up to ~2^40 ns (~18 minutes) spanning levels 0 to 3
+                unsigned bits (rng() % 41);
+                timer.timeout(now + senf::ClockService::nanoseconds(rng() % (1ull << bits)), false);
+                wheel.insert(timer);
+                ++ armed;
+            }
+        }
+        BOOST_REQUIRE_EQUAL( wheel.size(), armed );
+        if (armed)
+            BOOST_REQUIRE_EQUAL( wheel.nextTimeout(), minTimeout(timers) );
+
+        now += senf::ClockService::nanoseconds(rng() % (1ull << (rng() % 36)));
+        TimerWheel::TimerList & expired (wheel.expire(now));
+        unsigned due (0);
+        for (unsigned i (0); i < timers.size(); ++i)
+            if (isArmed(timers[i]) && timers[i].timeout() <= now)
+                ++ due;
+        BOOST_REQUIRE_EQUAL( expired.size(), due );
+        while (! expired.empty()) {
+            BOOST_REQUIRE( expired.front().timeout() <= now );
+            wheel.remove(expired.front());
+            -- armed;
+        }
+    }
+
+    TimerWheel::TimerList all;
+    wheel.clear(all);
+    BOOST_CHECK_EQUAL( all.size(), armed );
+    all.clear();
+}
+
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
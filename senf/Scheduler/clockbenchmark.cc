@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief clockbenchmark non-inline non-template implementation */
+
+#include "ClockService.hh"
+//#include "clockbenchmark.ih"
+
+// Custom includes
+#include <time.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <iostream>
+#include <boost/format.hpp>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+//#include "clockbenchmark.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    typedef senf::ClockService CS;
+
+    void delay(CS::clock_type t)
+    {
+        struct timespec ts;
+        ts.tv_sec = CS::in_seconds(t);
+        ts.tv_nsec = CS::in_nanoseconds(t) % 1000000000LL;
+        while (nanosleep(&ts, &ts) < 0 && errno == EINTR) ;
+    }
+
+    // Measure the cost of a single ClockService::now() call with the current settings
+    void callBenchmark(char const * name, unsigned n)
+    {
+        CS::clock_type sum (CS::clock_type(0));
+        CS::clock_type start (CS::monotonic());
+        for (unsigned i (0); i < n; ++i)
+            sum += CS::now();
+        double perCall (double(CS::in_nanoseconds(CS::monotonic() - start)) / n);
+        std::cout << boost::format("%-24s %7.1f ns/call\n") % name % perCall;
+        if (sum == CS::clock_type(0))
+            std::cout << "\n";
+    }
+
+    // Compare the TSC clock and an uncorrected TSC extrapolation against CLOCK_MONOTONIC once
+    // per second
+    void driftBenchmark(unsigned seconds)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        CS::source(CS::TSC);
+        double nsPerTick (1e9 / CS::tscFrequency());
+        std::uint64_t tsc0 (__rdtsc());
+        CS::int64_type clock0 (CS::in_nanoseconds(CS::monotonic()));
+        std::cout << "\n  elapsed     tsc clock   uncorrected tsc\n";
+        for (unsigned i (1); i <= seconds; ++i) {
+            delay(CS::seconds(1));
+            CS::int64_type tscClock (CS::in_nanoseconds(CS::now()));
+            std::uint64_t tsc (__rdtsc());
+            CS::int64_type clock (CS::in_nanoseconds(CS::monotonic()));
+            CS::int64_type raw (clock0 + CS::int64_type((tsc - tsc0) * nsPerTick));
+            if (i < 10 || i % 60 == 0 || i == seconds)
+                std::cout << boost::format("%8ds %10d ns %14d ns\n")
+                    % i % (tscClock - clock) % (raw - clock);
+        }
+        CS::source(CS::MONOTONIC);
+#endif
+    }
+
+}
+
+int main(int argc, char const * argv[])
+{
+    unsigned n (argc > 1 ? atoi(argv[1]) : 10000000u);
+    unsigned seconds (argc > 2 ? atoi(argv[2]) : 10u);
+
+    callBenchmark("monotonic (vDSO)", n);
+    CS::cached(CS::microseconds(100));
+    callBenchmark("cached monotonic", n);
+    CS::cached(CS::clock_type(0));
+
+    if (! CS::tscAvailable()) {
+        std::cout << "no invariant TSC available\n";
+        return 0;
+    }
+
+    CS::source(CS::TSC);
+    std::cout << boost::format("TSC frequency %.6f MHz\n") % (CS::tscFrequency() / 1e6);
+    callBenchmark("tsc", n);
+    CS::cached(CS::microseconds(100));
+    callBenchmark("cached tsc", n);
+    CS::cached(CS::clock_type(0));
+    CS::source(CS::MONOTONIC);
+
+    driftBenchmark(seconds);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "clockbenchmark.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u clockbenchmark"
+// End:
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u clockbenchmark"
+// End:
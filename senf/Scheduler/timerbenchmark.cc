@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief timerbenchmark non-inline non-template implementation */
+
+#include "Scheduler.hh"
+//#include "timerbenchmark.ih"
+
+// Custom includes
+#include <time.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <iostream>
+#include <random>
+#include <boost/format.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+//#include "timerbenchmark.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    void noop() {}
+
+    void delay(senf::ClockService::clock_type t)
+    {
+        struct timespec ts;
+        ts.tv_sec = senf::ClockService::in_seconds(t);
+        ts.tv_nsec = senf::ClockService::in_nanoseconds(t) % 1000000000LL;
+        while (nanosleep(&ts, &ts) < 0 && errno == EINTR) ;
+    }
+
+    double perTimer(senf::ClockService::clock_type start, unsigned n)
+    {
+        return double(senf::ClockService::in_nanoseconds(senf::ClockService::now() - start)) / n;
+    }
+
+    // Measure the cost of arming, canceling and expiring n timers per timer. Arming and
+    // canceling uses random timeouts within the next minute, expiring runs the scheduler over
+    // timers which are all due already, so no time is spent waiting.
+    void timerBenchmark(unsigned n, bool wheel)
+    {
+        senf::scheduler::timerWheel(wheel);
+        std::mt19937 rng (4711u);
+        boost::ptr_vector<senf::scheduler::TimerEvent> timers;
+        timers.reserve(n);
+        std::vector<senf::ClockService::clock_type> timeouts (n);
+        for (unsigned i (0); i < n; ++i) {
+            timers.push_back(new senf::scheduler::TimerEvent("benchmark", &noop));
+            timeouts[i] = senf::ClockService::milliseconds(1 + rng() % 60000);
+        }
+
+        senf::ClockService::clock_type now (senf::ClockService::now());
+        senf::ClockService::clock_type start (senf::ClockService::now());
+        for (unsigned i (0); i < n; ++i)
+            timers[i].timeout(now + timeouts[i]);
+        double arm (perTimer(start, n));
+
+        start = senf::ClockService::now();
+        for (unsigned i (0); i < n; ++i)
+            timers[i].disable();
+        double cancel (perTimer(start, n));
+
+        now = senf::ClockService::now();
+        for (unsigned i (0); i < n; ++i)
+            timers[i].timeout(now + timeouts[i] / 1000);
+        delay(senf::ClockService::milliseconds(61));
+        start = senf::ClockService::now();
+        senf::scheduler::process();
+        double expire (perTimer(start, n));
+
+        std::cout << boost::format("%-5s %8d timers: arm %7.1f ns  cancel %7.1f ns  "
+                                   "expire %7.1f ns\n")
+            % (wheel ? "wheel" : "set") % n % arm % cancel % expire;
+        senf::scheduler::timerWheel(false);
+    }
+
+}
+
+int main(int argc, char const * argv[])
+{
+    std::vector<unsigned> counts;
+    for (int i (1); i < argc; ++i)
+        counts.push_back(atoi(argv[i]));
+    if (counts.empty()) {
+        counts.push_back(1000u);
+        counts.push_back(100000u);
+        counts.push_back(1000000u);
+    }
+    for (unsigned i (0); i < counts.size(); ++i) {
+        timerBenchmark(counts[i], false);
+        timerBenchmark(counts[i], true);
+    }
+}
+
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "timerbenchmark.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u timerbenchmark"
+// End:
@@ -19,6 +19,7 @@
 #define HH_SENF_Socket_ClientSocketHandle_ 1
 
 // Custom includes
+#include <sys/socket.h>
 #include <boost/call_traits.hpp>
 #include <boost/range/iterator.hpp>
 #include <boost/type_traits/is_convertible.hpp>
@@ -50,6 +51,11 @@ namespace senf {
         <tr><td>readfrom()</td>   <td>ReadPolicy::readfrom (\ref senf::ReadPolicyBase)</td>              <td>UnconnectedCommunicationPolicy</td></tr>
         <tr><td>write()</td>      <td>WritePolicy::write (\ref senf::WritePolicyBase)</td>               <td>ConnectedCommunicationPolicy</td></tr>
         <tr><td>writeto()</td>    <td>WritePolicy::writeto (\ref senf::WritePolicyBase)</td>             <td>UnconnectedCommunicationPolicy</td></tr>
+        <tr><td>readBatch()</td>  <td>ReadPolicy::readBatch (\ref senf::BatchReadPolicy)</td>            <td></td></tr>
+        <tr><td>writeBatch()</td> <td>WritePolicy::writeBatch (\ref senf::BatchWritePolicy)</td>         <td></td></tr>
+        <tr><td>writeBatchTo()</td> <td>WritePolicy::writeBatch (\ref senf::BatchWritePolicy)</td>       <td></td></tr>
+        <tr><td>writeGather()</td> <td>WritePolicy::writev (\ref senf::WriteablePolicy)</td>             <td></td></tr>
+        <tr><td>writeGatherTo()</td> <td>WritePolicy::writev (\ref senf::WriteablePolicy)</td>           <td>UnconnectedCommunicationPolicy</td></tr>
         <tr><td>connect()</td>    <td>AddressingPolicy::connect (\ref senf::AddressingPolicyBase)</td>   <td></td></tr>
         <tr><td>bind()</td>       <td>AddressingPolicy::bind (\ref senf::AddressingPolicyBase)</td>      <td></td></tr>
         <tr><td>peer()</td>       <td>AddressingPolicy::peer (\ref senf::AddressingPolicyBase)</td>      <td></td></tr>
@@ -361,6 +367,99 @@ namespace senf {
                                              \see \ref writeto() \n
                                                   <a href="http://www.boost.org/doc/libs/release/libs/range/index.html">Boost.Range</a>  */
 
+        /** \brief Read several datagrams from socket
+
+            The batch members are only available, if the sockets \c ReadPolicy / \c WritePolicy is
+            BatchReadPolicy / BatchWritePolicy. They transfer a whole range of packets with a single
+            system call.
+
+            \a packets is a range of packet objects (e.g. a <tt>std::vector<senf::DataPacket></tt>).
+            Every element \c p must provide a \c p.data() member returning a resizable container
+            with contiguous storage (like senf::PacketData).
+
+            readBatch() will resize every element to \a limit bytes and then read up to
+            <tt>boost::size(packets)</tt> datagrams. The first \e n elements are then resized to
+            the size of the datagram received, the remaining elements are left unspecified.
+
+            On a blocking socket, readBatch() will block until at least one datagram is available.
+
+            \param[in,out] packets range of packets to read data into
+            \param[in] limit maximum datagram size. Longer datagrams are truncated.
+            \returns number of datagrams read (\e n)
+
+            \throws senf::SystemException
+         */
+        template <class PacketRange>
+        unsigned     readBatch    (PacketRange & packets, unsigned limit);
+
+        template <class PacketRange>
+        unsigned     writeBatch   (PacketRange const & packets);
+                                        ///< Write several datagrams to socket
+                                        /**< Send all packets in \a packets as separate datagrams
+                                             with a single system call. The socket must be
+                                             connected.
+                                             \param[in] packets range of packets to send. See
+                                                 readBatch() for the requirements.
+                                             \returns number of datagrams written
+                                             \see \ref readBatch() */
+        template <class PacketRange>
+        unsigned     writeBatchTo (AddressParam addr, PacketRange const & packets);
+                                        ///< Write several datagrams to unconnected socket
+                                        /**< Send all packets in \a packets as separate datagrams
+                                             to \a addr with a single system call.
+                                             \param[in] addr Address of peer to send data to
+                                             \param[in] packets range of packets to send. See
+                                                 readBatch() for the requirements.
+                                             \returns number of datagrams written
+                                             \see \ref readBatch() */
+
+        /** \brief Write data gathered from several packets to socket
+
+            writeGather() sends the concatenation of the data of all packets in \a segments with a
+            single \c writev() system call. On a datagram socket this sends a single datagram. This
+            allows to send encapsulated data without copying: Instead of prepending the headers to
+            the payload packet (which will move the payload, if the packet does not provide enough
+            headroom), the headers are built in a packet of their own and sent together with the
+            payload packet:
+
+            \code
+            senf::EthernetPacket eth (senf::EthernetPacket::create());
+            eth->destination() = ...;
+            eth->type_length() = 0x0800u;
+            std::vector<senf::Packet> segments;
+            segments.push_back(eth);
+            segments.push_back(payload);
+            handle.writeGather(segments);
+            \endcode
+
+            Since the header packet has no next packet, finalize() cannot compute any field
+            depending on the payload. Those fields have to be set explicitly.
+
+            writeGather() is available on all writeable sockets (\c WritePolicy is
+            WriteablePolicy), writeGatherTo() additionally requires an unconnected socket.
+
+            \param[in] segments range of packets to send. Every element \c p must provide a \c
+                p.data() member returning a container with contiguous storage (like
+                senf::PacketData). Empty elements are skipped.
+            \returns number of bytes written
+
+            \throws senf::SystemException
+         */
+        template <class PacketRange>
+        unsigned     writeGather  (PacketRange const & segments);
+
+        template <class PacketRange>
+        unsigned     writeGatherTo(AddressParam addr, PacketRange const & segments);
+                                        ///< Write data gathered from several packets to socket
+                                        /**< Send the concatenation of the data of all packets in
+                                             \a segments to \a addr using a single \c sendmsg()
+                                             system call.
+                                             \param[in] addr Address of peer to send data to
+                                             \param[in] segments range of packets to send. See
+                                                 writeGather() for the requirements.
+                                             \returns number of bytes written
+                                             \see \ref writeGather() */
+
         //\}
 
         //-////////////////////////////////////////////////////////////////////////
@@ -510,6 +609,13 @@ namespace senf {
         explicit ClientSocketHandle(std::unique_ptr<SocketBody> body);
 
     private:
+        template <class PacketRange>
+        unsigned do_writeBatch(PacketRange const & packets, struct ::sockaddr const * addr,
+                               socklen_t len);
+        template <class PacketRange>
+        unsigned do_writeGather(PacketRange const & segments, struct ::sockaddr const * addr,
+                                socklen_t len);
+
         friend class senf::ServerSocketHandle<SPolicy>;
     };
 
@@ -43,8 +43,8 @@ namespace senf {
         INet4AddressingPolicy,
         DatagramFramingPolicy,
         ConnectedCommunicationPolicy,
-        ReadablePolicy,
-        WriteablePolicy
+        BatchReadPolicy,
+        BatchWritePolicy
         >::policy ConnectedUDPv4Socket_Policy;   ///< Socket Policy of the UDPv4 Protocol
 
     /** \brief IPv4 UDP Socket Protocol, connected
@@ -54,7 +54,8 @@ namespace senf {
 
         \par Policy Interface:
             ClientSocketHandle::read(), ClientSocketHandle::write(), ClientSocketHandle::bind(),
-            ClientSocketHandle::local(), ClientSocketHandle::connect(), ClientSocketHandle::peer()
+            ClientSocketHandle::local(), ClientSocketHandle::connect(), ClientSocketHandle::peer(),
+            ClientSocketHandle::readBatch(), ClientSocketHandle::writeBatch()
 
         \par Address Type:
             INet4SocketAddress
@@ -113,7 +114,8 @@ namespace senf {
 
         \par Policy Interface:
             ClientSocketHandle::read(), ClientSocketHandle::write(), ClientSocketHandle::bind(),
-            ClientSocketHandle::local(), ClientSocketHandle::connect(), ClientSocketHandle::peer()
+            ClientSocketHandle::local(), ClientSocketHandle::connect(), ClientSocketHandle::peer(),
+            ClientSocketHandle::readBatch(), ClientSocketHandle::writeBatch()
 
         \par Address Type:
             INet6Address
@@ -44,8 +44,8 @@ namespace senf {
         INet4AddressingPolicy,
         DatagramFramingPolicy,
         UnconnectedCommunicationPolicy,
-        ReadablePolicy,
-        WriteablePolicy
+        BatchReadPolicy,
+        BatchWritePolicy
         >::policy UDPv4Socket_Policy;   ///< Socket Policy of the UDPv4 Protocol
 
     /** \brief IPv4 UDP Socket Protocol
@@ -55,7 +55,8 @@ namespace senf {
 
         \par Policy Interface:
             ClientSocketHandle::read(), ClientSocketHandle::readfrom(),
-            ClientSocketHandle::writeto(), ClientSocketHandle::bind(), ClientSocketHandle::local()
+            ClientSocketHandle::writeto(), ClientSocketHandle::bind(), ClientSocketHandle::local(),
+            ClientSocketHandle::readBatch(), ClientSocketHandle::writeBatchTo()
 
         \par Address Type:
             INet4SocketAddress
@@ -114,7 +115,8 @@ namespace senf {
 
         \par Policy Interface:
             ClientSocketHandle::read(), ClientSocketHandle::readfrom(),
-            ClientSocketHandle::writeto(), ClientSocketHandle::bind(), ClientSocketHandle::local()
+            ClientSocketHandle::writeto(), ClientSocketHandle::bind(), ClientSocketHandle::local(),
+            ClientSocketHandle::readBatch(), ClientSocketHandle::writeBatchTo()
 
         \par Address Type:
             INet6Address
@@ -15,6 +15,7 @@
     \brief UDPSocketHandle unit tests */
 
 #include "UDPSocketHandle.hh"
+#include "ConnectedUDPSocketHandle.hh"
 
 // Custom includes
 #include <sys/types.h>
@@ -24,6 +25,8 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 
+#include <senf/Packets/Packets.hh>
+
 // Unit test includes
 #include <senf/Utils/auto_unit_test.hh>
 #include "net.test.hh"
@@ -113,6 +116,53 @@ SENF_AUTO_TEST_CASE(udpv4ClientSocketHandle)
     }
 }
 
+SENF_AUTO_TEST_CASE(udpv4ClientSocketHandle_batch)
+{
+    senf::UDPv4ClientSocketHandle rx;
+    rx.bind(senf::INet4SocketAddress(localhost4str(2)));
+    senf::UDPv4ClientSocketHandle tx;
+    rx.blocking(false);
+
+    std::vector<senf::DataPacket> packets;
+    packets.push_back(senf::DataPacket::create(std::string("FIRST")));
+    packets.push_back(senf::DataPacket::create(std::string("2ND")));
+    packets.push_back(senf::DataPacket::create(std::string("THIRD-DATAGRAM")));
+    BOOST_CHECK_EQUAL( tx.writeBatchTo(senf::INet4SocketAddress(localhost4str(2)), packets), 3u );
+
+    std::vector<senf::DataPacket> received;
+    for (unsigned i (0); i < 4; ++i)
+        received.push_back(senf::DataPacket::create(senf::noinit));
+    BOOST_REQUIRE_EQUAL( rx.readBatch(received, 10u), 3u );
+    BOOST_CHECK_EQUAL( std::string(received[0].data().begin(), received[0].data().end()), "FIRST" );
+    BOOST_CHECK_EQUAL( std::string(received[1].data().begin(), received[1].data().end()), "2ND" );
+    // truncated to limit
+    BOOST_CHECK_EQUAL( std::string(received[2].data().begin(), received[2].data().end()), "THIRD-DATA" );
+
+    BOOST_CHECK_EQUAL( rx.readBatch(received, 10u), 0u );
+}
+
+SENF_AUTO_TEST_CASE(udpv4ClientSocketHandle_gather)
+{
+    senf::UDPv4ClientSocketHandle rx;
+    rx.bind(senf::INet4SocketAddress(localhost4str(3)));
+    senf::UDPv4ClientSocketHandle tx;
+    rx.blocking(false);
+
+    std::vector<senf::DataPacket> segments;
+    segments.push_back(senf::DataPacket::create(std::string("HEADER:")));
+    segments.push_back(senf::DataPacket::create());
+    segments.push_back(senf::DataPacket::create(std::string("PAYLOAD")));
+    BOOST_CHECK_EQUAL( tx.writeGatherTo(senf::INet4SocketAddress(localhost4str(3)), segments), 14u );
+
+    // a single datagram
+    BOOST_CHECK_EQUAL( rx.read(), "HEADER:PAYLOAD" );
+    BOOST_CHECK_EQUAL( rx.read(), "" );
+
+    senf::ConnectedUDPv4ClientSocketHandle ctx (senf::INet4SocketAddress(localhost4str(3)));
+    BOOST_CHECK_EQUAL( ctx.writeGather(segments), 14u );
+    BOOST_CHECK_EQUAL( rx.read(), "HEADER:PAYLOAD" );
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 
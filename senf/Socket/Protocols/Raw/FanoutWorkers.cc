@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief FanoutWorkers non-inline non-template implementation */
+
+#include "FanoutWorkers.hh"
+//#include "FanoutWorkers.ih"
+
+// Custom includes
+#include <sched.h>
+#include <boost/lexical_cast.hpp>
+#include <senf/Scheduler/Mailbox.hh>
+#include <senf/Scheduler/Scheduler.hh>
+#include <senf/Utils/Exception.hh>
+
+//#include "FanoutWorkers.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    std::vector<int> allowedCpus()
+    {
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        if (::sched_getaffinity(0, sizeof(set), &set) < 0)
+            SENF_THROW_SYSTEM_EXCEPTION("::sched_getaffinity()");
+        std::vector<int> cpus;
+        for (int cpu (0); cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+        return cpus;
+    }
+
+    void pinToCpu(int cpu)
+    {
+        // On linux, pid 0 refers to the calling thread and not to the whole process
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (::sched_setaffinity(0, sizeof(set), &set) < 0)
+            SENF_THROW_SYSTEM_EXCEPTION("::sched_setaffinity()");
+    }
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::FanoutWorkers
+
+prefix_ senf::FanoutWorkers::FanoutWorkers(std::string const & iface, unsigned n,
+                                           std::uint16_t group,
+                                           LinuxPacketSocketProtocol::FanoutMode mode,
+                                           Worker const & worker, unsigned qlen, unsigned flags,
+                                           bool pinCpu)
+    : iface_ (iface), group_ (group), mode_ (mode), flags_ (flags), qlen_ (qlen),
+      worker_ (worker), started_ (0u), failed_ (false), slots_ (n)
+{
+    if (n == 0)
+        throw InvalidArgumentException("number of fanout workers must not be 0");
+    if (pinCpu) {
+        std::vector<int> cpus (allowedCpus());
+        for (unsigned i (0); i < n && ! cpus.empty(); ++i)
+            slots_[i].cpu = cpus[i % cpus.size()];
+    }
+
+    std::exception_ptr error;
+    unsigned i (0);
+    try {
+        for (; i < n; ++i)
+            slots_[i].thread = std::thread(&FanoutWorkers::run, this, i);
+    }
+    catch (...) {
+        error = std::current_exception();
+        // Threads which have not been started will never report back
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            started_ += n - i;
+            failed_ = true;
+        }
+        startedCond_.notify_all();
+    }
+    {
+        std::unique_lock<std::mutex> lock (mutex_);
+        while (started_ < n)
+            startedCond_.wait(lock);
+        for (i = 0; i < n && ! error; ++i)
+            error = slots_[i].error;
+    }
+    if (error) {
+        terminate();
+        joinThreads();
+        std::rethrow_exception(error);
+    }
+}
+
+prefix_ senf::FanoutWorkers::~FanoutWorkers()
+{
+    terminate();
+    joinThreads();
+}
+
+prefix_ unsigned senf::FanoutWorkers::size()
+    const
+{
+    return slots_.size();
+}
+
+prefix_ int senf::FanoutWorkers::cpu(unsigned worker)
+    const
+{
+    return slots_[worker].cpu;
+}
+
+prefix_ void senf::FanoutWorkers::terminate()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (Slot & slot : slots_)
+        if (slot.mailbox)
+            slot.mailbox->post(&scheduler::terminate);
+}
+
+prefix_ void senf::FanoutWorkers::join()
+{
+    joinThreads();
+    for (Slot & slot : slots_)
+        if (slot.error) {
+            std::exception_ptr error (slot.error);
+            slot.error = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+}
+
+prefix_ void senf::FanoutWorkers::joinThreads()
+{
+    for (Slot & slot : slots_)
+        if (slot.thread.joinable())
+            slot.thread.join();
+}
+
+prefix_ void senf::FanoutWorkers::run(unsigned worker)
+{
+    try {
+        if (slots_[worker].cpu >= 0)
+            pinToCpu(slots_[worker].cpu);
+        // The mailbox, the socket and everything set up by the worker function belong to the
+        // scheduler of this thread
+        scheduler::Mailbox mailbox (
+            "FanoutWorkers worker " + boost::lexical_cast<std::string>(worker));
+        Handle handle (iface_, qlen_);
+        handle.protocol().fanout(group_, mode_, flags_);
+        if (! started(worker, &mailbox, std::exception_ptr())) {
+            // Another worker failed to start, the constructor terminates all workers
+            stopped(worker, std::exception_ptr());
+            return;
+        }
+
+        std::exception_ptr error;
+        try {
+            worker_(worker, handle);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        // The mailbox must not be posted to any more, once it goes out of scope
+        stopped(worker, error);
+    }
+    catch (...) {
+        started(worker, 0, std::current_exception());
+    }
+}
+
+prefix_ bool senf::FanoutWorkers::started(unsigned worker, scheduler::Mailbox * mailbox,
+                                          std::exception_ptr error)
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+    slots_[worker].mailbox = mailbox;
+    slots_[worker].error = error;
+    if (error)
+        failed_ = true;
+    ++ started_;
+    startedCond_.notify_all();
+    // Wait for all other workers, the worker function must not run if any of them failed
+    while (started_ < slots_.size())
+        startedCond_.wait(lock);
+    return ! failed_;
+}
+
+prefix_ void senf::FanoutWorkers::stopped(unsigned worker, std::exception_ptr error)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    slots_[worker].mailbox = 0;
+    slots_[worker].error = error;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::FanoutWorkers::Slot
+
+prefix_ senf::FanoutWorkers::Slot::Slot()
+    : cpu (-1), mailbox (0)
+{}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "FanoutWorkers.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
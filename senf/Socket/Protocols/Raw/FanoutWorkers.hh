@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief FanoutWorkers public header */
+
+#ifndef HH_SENF_Socket_Protocols_Raw_FanoutWorkers_
+#define HH_SENF_Socket_Protocols_Raw_FanoutWorkers_ 1
+
+// Custom includes
+#include <cstdint>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include "LinuxPacketSocketProtocol.hh"
+#include "MMapPacketSocketHandle.hh"
+
+//#include "FanoutWorkers.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    namespace scheduler { class Mailbox; }
+
+    /** \brief Packet fanout worker threads
+
+        FanoutWorkers starts \a n worker threads sharing the rx load of a single interface. Each
+        worker thread runs its own %scheduler instance and opens its own packet socket (and thus
+        its own mmap rx ring) on the interface, which joins a common packet fanout group. The
+        kernel then distributes the received packets over all workers.
+
+        The worker function is called within each worker thread with the worker index and the
+        workers socket handle. It sets up the workers pipeline and runs it:
+
+        \code
+        void worker(unsigned n, senf::ConnectedMMapReadPacketSocketHandle handle)
+        {
+            senf::ppi::module::ActiveQueueSocketSource<> source (handle);
+            Forwarder forwarder;
+            senf::ppi::connect(source, forwarder);
+            senf::ppi::run();
+        }
+
+        senf::FanoutWorkers workers (
+            "eth0", 4, 42, senf::LinuxPacketSocketProtocol::FanoutCPU, &worker);
+        // console, signals etc. are handled by the main thread
+        senf::scheduler::process();
+        \endcode
+
+        Every worker owns a scheduler::Mailbox, thus its %scheduler keeps running until
+        terminate() is called. The constructor returns as soon as all workers have joined the
+        fanout group. If a worker cannot open its socket or join the group, all workers are
+        terminated and the error is rethrown by the constructor. The worker function is only
+        called, after all workers have started successfully. An exception thrown by a worker
+        function is rethrown by join().
+
+        \see LinuxPacketSocketProtocol::fanout()
+     */
+    class FanoutWorkers
+        : boost::noncopyable
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // Types
+
+        typedef ConnectedMMapReadPacketSocketHandle Handle;
+        typedef boost::function<void (unsigned, Handle)> Worker;
+
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        FanoutWorkers(std::string const & iface, unsigned n, std::uint16_t group,
+                      LinuxPacketSocketProtocol::FanoutMode mode, Worker const & worker,
+                      unsigned qlen = 2048, unsigned flags = 0, bool pinCpu = true);
+                                        ///< Start \a n fanout workers
+                                        /**< \param[in] iface interface to receive from
+                                             \param[in] n number of worker threads
+                                             \param[in] group fanout group id
+                                             \param[in] mode fanout mode
+                                             \param[in] worker worker function
+                                             \param[in] qlen rx ring size (frames) of each worker
+                                             \param[in] flags bit-or of
+                                                 LinuxPacketSocketProtocol::FanoutFlags
+                                             \param[in] pinCpu if \c true, worker \e i is bound
+                                                 to the \e i th CPU the calling thread may run
+                                                 on (as returned by \c sched_getaffinity()),
+                                                 wrapping around if there are more workers than
+                                                 CPUs */
+        ~FanoutWorkers();               ///< Terminate and join all workers
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+
+        unsigned size() const;          ///< Number of workers
+        int cpu(unsigned worker) const; ///< CPU \a worker is bound to, -1 if not bound
+
+        void terminate();               ///< Terminate the %scheduler of all workers
+                                        /**< May be called from any thread. */
+        void join();                    ///< Wait for all workers to terminate
+                                        /**< \throws the first exception thrown by a worker
+                                                 function */
+
+    private:
+        struct Slot
+        {
+            Slot();
+
+            std::thread thread;
+            int cpu;
+            scheduler::Mailbox * mailbox;
+            std::exception_ptr error;
+        };
+
+        void run(unsigned worker);
+        bool started(unsigned worker, scheduler::Mailbox * mailbox, std::exception_ptr error);
+        void stopped(unsigned worker, std::exception_ptr error);
+        void joinThreads();
+
+        std::string iface_;
+        std::uint16_t group_;
+        LinuxPacketSocketProtocol::FanoutMode mode_;
+        unsigned flags_;
+        unsigned qlen_;
+        Worker worker_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable startedCond_;
+        unsigned started_;
+        bool failed_;
+        std::vector<Slot> slots_;
+    };
+
+}
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+//#include "FanoutWorkers.cci"
+//#include "FanoutWorkers.ct"
+//#include "FanoutWorkers.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
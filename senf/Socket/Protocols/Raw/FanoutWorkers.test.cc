@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief FanoutWorkers unit tests */
+
+#include "FanoutWorkers.hh"
+
+// Custom includes
+#include <atomic>
+#include <stdexcept>
+#include <sched.h>
+#include <senf/Scheduler/Scheduler.hh>
+#include <senf/Socket/NetdeviceController.hh>
+#include "MMapPacketSocketHandle.hh"
+#include "PacketSocketHandle.hh"
+#include "TunTapSocketHandle.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+SENF_AUTO_TEST_CASE(packetFanout)
+{
+    SENF_RETURN_NO_ROOT_PRIVILEGES("Cannot test packet fanout as non-root user");
+
+    senf::TapSocketHandle tap;
+    senf::NetdeviceController tapCtl (tap.protocol().ifaceName());
+    tapCtl.up();
+
+    senf::ConnectedMMapReadPacketSocketHandle mmap (tap.protocol().ifaceName(), 128);
+    senf::PacketSocketHandle pk;
+    pk.bind(senf::LLSocketAddress(tap.protocol().ifaceName()));
+
+    SENF_CHECK_NO_THROW( mmap.protocol().fanout(
+                             4711, senf::LinuxPacketSocketProtocol::FanoutHash,
+                             senf::LinuxPacketSocketProtocol::FanoutFlagDefrag) );
+    SENF_CHECK_NO_THROW( pk.protocol().fanout(
+                             4711, senf::LinuxPacketSocketProtocol::FanoutHash,
+                             senf::LinuxPacketSocketProtocol::FanoutFlagDefrag) );
+
+    // all members of a group must use the same mode
+    senf::PacketSocketHandle other;
+    other.bind(senf::LLSocketAddress(tap.protocol().ifaceName()));
+    BOOST_CHECK_THROW( other.protocol().fanout(4711, senf::LinuxPacketSocketProtocol::FanoutCPU),
+                       senf::SystemException );
+}
+
+namespace {
+
+    std::atomic<unsigned> workersRun (0u);
+    std::atomic<unsigned> workersPinned (0u);
+
+    void fanoutWorker(unsigned n, senf::ConnectedMMapReadPacketSocketHandle)
+    {
+        ++ workersRun;
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        if (::sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) == 1)
+            ++ workersPinned;
+        senf::scheduler::process();
+        if (n == 1)
+            throw std::runtime_error("fanout worker failed");
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(fanoutWorkers)
+{
+    SENF_RETURN_NO_ROOT_PRIVILEGES("Cannot test fanout workers as non-root user");
+
+    senf::TapSocketHandle tap;
+    senf::NetdeviceController tapCtl (tap.protocol().ifaceName());
+    tapCtl.up();
+
+    ::cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    BOOST_REQUIRE( ::sched_getaffinity(0, sizeof(allowed), &allowed) == 0 );
+
+    {
+        senf::FanoutWorkers workers (
+            tap.protocol().ifaceName(), 3, 4712, senf::LinuxPacketSocketProtocol::FanoutHash,
+            &fanoutWorker, 128);
+        BOOST_CHECK_EQUAL( workers.size(), 3u );
+        for (unsigned i (0); i < workers.size(); ++i) {
+            BOOST_CHECK( workers.cpu(i) >= 0 );
+            BOOST_CHECK( CPU_ISSET(workers.cpu(i), &allowed) );
+        }
+        workers.terminate();
+        BOOST_CHECK_THROW( workers.join(), std::runtime_error );
+        BOOST_CHECK_EQUAL( workersRun, 3u );
+        BOOST_CHECK_EQUAL( workersPinned, 3u );
+    }
+
+    {
+        // the destructor terminates all workers
+        senf::FanoutWorkers workers (
+            tap.protocol().ifaceName(), 2, 4713, senf::LinuxPacketSocketProtocol::FanoutCPU,
+            &fanoutWorker, 128, 0, false);
+        BOOST_CHECK_EQUAL( workers.cpu(0), -1 );
+    }
+    BOOST_CHECK_EQUAL( workersRun, 5u );
+
+    // all members of a group must use the same mode
+    senf::PacketSocketHandle pk;
+    pk.bind(senf::LLSocketAddress(tap.protocol().ifaceName()));
+    pk.protocol().fanout(4714, senf::LinuxPacketSocketProtocol::FanoutHash);
+    BOOST_CHECK_THROW( senf::FanoutWorkers(
+                           tap.protocol().ifaceName(), 2, 4714,
+                           senf::LinuxPacketSocketProtocol::FanoutCPU, &fanoutWorker, 128),
+                       senf::SystemException );
+    BOOST_CHECK_EQUAL( workersRun, 5u );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -103,6 +103,15 @@ prefix_ unsigned senf::LinuxPacketSocketProtocol::txWrongFormat()
     return wrongFormat;
 }
 
+prefix_ void senf::LinuxPacketSocketProtocol::fanout(std::uint16_t group, FanoutMode mode,
+                                                    unsigned flags)
+    const
+{
+    int v (group | ((mode | flags) << 16));
+    if (::setsockopt(fd(), SOL_PACKET, PACKET_FANOUT, &v, sizeof(v)) < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("::setsockopt(SOL_PACKET, PACKET_FANOUT) failed");
+}
+
 prefix_ bool senf::LinuxPacketSocketProtocol::eof()
     const
 {
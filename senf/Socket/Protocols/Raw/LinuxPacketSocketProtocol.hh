@@ -18,6 +18,7 @@
 #define HH_SENF_Socket_Protocols_Raw_LinuxPacketSocketProtocol_ 1
 
 // Custom includes
+#include <linux/if_packet.h>
 #include <senf/Socket/SocketProtocol.hh>
 #include "MACAddress.hh"
 
@@ -33,6 +34,20 @@ namespace senf {
         enum SocketType { RawSocket, DatagramSocket };
                                         ///< Socket types
 
+        enum FanoutMode {
+            FanoutHash = PACKET_FANOUT_HASH,         ///< distribute by flow hash
+            FanoutCPU = PACKET_FANOUT_CPU,           ///< distribute by receiving CPU
+            FanoutRollover = PACKET_FANOUT_ROLLOVER, ///< fill one socket, then move to the next
+            FanoutQueueMapping = PACKET_FANOUT_QM    ///< distribute by recorded NIC rx queue
+        };                              ///< Packet fanout group modes
+
+        enum FanoutFlags {
+            FanoutFlagRollover = PACKET_FANOUT_FLAG_ROLLOVER,
+                                        ///< roll over to another socket, if the selected is full
+            FanoutFlagDefrag = PACKET_FANOUT_FLAG_DEFRAG
+                                        ///< defragment IP packets before selecting the socket
+        };                              ///< Packet fanout group flags
+
         void mcAdd(std::string const & interface, MACAddress const & address) const;
                                         ///< Enable reception of a multicast group
                                         /**< mcAdd will join a new multicast group.
@@ -58,6 +73,26 @@ namespace senf {
                                         /**< query the number of packets dropped by the kernel since
                                              the last call to this method. */
 
+        void fanout(std::uint16_t group, FanoutMode mode, unsigned flags = 0) const;
+                                        ///< Join a packet fanout group
+                                        /**< All packet sockets in the same fanout \a group share
+                                             the received packets. Each packet is delivered to
+                                             exactly one socket of the group, which is selected as
+                                             defined by \a mode. Thus several threads, each
+                                             with its own socket (and mmap ring) may share the rx
+                                             load of a single interface. All sockets of a group
+                                             must be bound to the same interface and protocol and
+                                             must use the same \a mode and \a flags.
+
+                                             The socket must be bound before it can join a group.
+                                             A socket cannot leave a group, close the socket
+                                             instead.
+                                             \param[in] group fanout group id
+                                             \param[in] mode fanout mode
+                                             \param[in] flags bit-or of FanoutFlags
+
+                                             \see FanoutWorkers */
+
         bool eof() const;
 
     protected:
@@ -71,6 +71,11 @@ namespace senf {
         This protocol uses the linux mmap packet socket access API. This API replaces the ordinary
         read/write calls with a linux specific api.
 
+        A read-only handle (\ref ConnectedMMapReadPacketSocketHandle) may alternatively be created
+        with a TPACKET_V3 block based rx ring by passing a senf::MMapBlockRing instead of the queue
+        length. The kernel then signals readability once per block of frames instead of once per
+        frame.
+
         \warning The socket handle is neither readable nor writable in the ordinary sense. It
             utilises the special QueueReadPolicy and QueueWritePolicy socket policies.
      */
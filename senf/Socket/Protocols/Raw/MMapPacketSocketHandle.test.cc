@@ -223,6 +223,21 @@ SENF_AUTO_TEST_CASE(connectedMMapReadPacketSocketHandle)
     runTest(tap, pk);
 }
 
+SENF_AUTO_TEST_CASE(connectedMMapBlockReadPacketSocketHandle)
+{
+    SENF_RETURN_NO_ROOT_PRIVILEGES("Cannot test senf::MMapPacketSocketHandle as non-root user");
+
+    senf::TapSocketHandle tap;
+    senf::NetdeviceController tapCtl (tap.protocol().ifaceName());
+    tapCtl.up();
+    senf::ConnectedMMapReadPacketSocketHandle pk (
+        tap.protocol().ifaceName(), senf::MMapBlockRing(4, 16384, 1));
+    // blocks are only handed over after the retire timeout, so wait for them
+    pk.blocking(true);
+
+    runTest(tap, pk);
+}
+
 SENF_AUTO_TEST_CASE(connectedMMapWritePacketSocketHandle)
 {
     SENF_RETURN_NO_ROOT_PRIVILEGES("Cannot test senf::MMapPacketSocketHandle as non-root user");
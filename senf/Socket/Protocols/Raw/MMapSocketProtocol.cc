@@ -35,6 +35,11 @@
 #define PACKET_QDISC_BYPASS	20
 #endif
 
+prefix_ senf::MMapBlockRing::MMapBlockRing(unsigned blockNr_, unsigned blockSize_,
+                                          unsigned retireTimeout_)
+    : blockNr (blockNr_), blockSize (blockSize_), retireTimeout (retireTimeout_)
+{}
+
 prefix_ void senf::MMapSocketProtocol::close()
 {
     close_mmap();
@@ -54,6 +59,7 @@ prefix_ void senf::MMapSocketProtocol::init_mmap(unsigned frameSize, unsigned rx
 {
     ::memset(&qi_, 0, sizeof(qi_));
     qi_.frameSize = frameSize;
+    qi_.version = TPACKET_V2;
 
     int v = TPACKET_V2;
     ::socklen_t l = sizeof(int);
@@ -125,11 +131,58 @@ prefix_ void senf::MMapSocketProtocol::init_mmap(unsigned frameSize, unsigned rx
     senf::FileHandleAccess::extraPtr(fh(), &qi_);
 }
 
+prefix_ void senf::MMapSocketProtocol::init_mmap(MMapBlockRing const & ring, unsigned frameSize,
+                                                 unsigned reserve)
+    const
+{
+    ::memset(&qi_, 0, sizeof(qi_));
+    qi_.frameSize = frameSize;
+    qi_.version = TPACKET_V3;
+
+    int v = TPACKET_V3;
+    ::socklen_t l = sizeof(int);
+    if (getsockopt(fd(), SOL_PACKET, PACKET_HDRLEN, (char *)&v, &l) != 0)
+        SENF_THROW_SYSTEM_EXCEPTION("::getsockopt(SOL_PACKET, PACKET_HDRLEN)");
+    qi_.hdrlen = TPACKET_ALIGN(v);
+
+    v = TPACKET_V3;
+    if (setsockopt(fd(), SOL_PACKET, PACKET_VERSION, (char *)&v, sizeof(v)) != 0 )
+        SENF_THROW_SYSTEM_EXCEPTION("::setsockopt(SOL_PACKET, PACKET_VERSION)");
+
+    qi_.reserveSize = 0;
+    if (reserve > 0
+        && setsockopt(fd(), SOL_PACKET, PACKET_RESERVE, (char *)&reserve, sizeof(reserve)) == 0)
+        qi_.reserveSize = reserve;
+
+    struct ::tpacket_req3 req;
+    ::memset(&req, 0, sizeof(req));
+    req.tp_block_size = ring.blockSize;
+    req.tp_block_nr = ring.blockNr;
+    req.tp_frame_size = frameSize;
+    req.tp_frame_nr = (ring.blockSize / frameSize) * ring.blockNr;
+    req.tp_retire_blk_tov = ring.retireTimeout;
+    if (setsockopt(fd(), SOL_PACKET, PACKET_RX_RING,
+                   reinterpret_cast<char *>(&req), sizeof(req)) != 0 )
+        SENF_THROW_SYSTEM_EXCEPTION("::setsockopt(SOL_PACKET, PACKET_RX_RING");
+
+    unsigned char * map (static_cast<unsigned char *>(
+                             ::mmap(NULL, req.tp_block_size * req.tp_block_nr,
+                                    PROT_READ|PROT_WRITE, MAP_SHARED, fd(), 0)));
+    if (map == MAP_FAILED)
+        SENF_THROW_SYSTEM_EXCEPTION("::mmap()");
+
+    qi_.map = map;
+    qi_.initBlocks(ring.blockSize, ring.blockNr);
+
+    senf::FileHandleAccess::extraPtr(fh(), &qi_);
+}
+
 prefix_ void senf::MMapSocketProtocol::close_mmap()
     const
 {
     if (! qi_.map)
         return;
+    qi_.detachHolder();
     if (::munmap(qi_.map, (qi_.rx.end - qi_.rx.begin) + (qi_.tx.end - qi_.tx.begin)) < 0)
         SENF_THROW_SYSTEM_EXCEPTION("::munmap");
     ::memset(&qi_, 0, sizeof(qi_));
@@ -140,6 +193,7 @@ prefix_ void senf::MMapSocketProtocol::terminate_mmap()
 {
     if (! qi_.map)
         return;
+    qi_.detachHolder();
     ::munmap(qi_.map, (qi_.rx.end - qi_.rx.begin) + (qi_.tx.end - qi_.tx.begin));
     ::memset(&qi_, 0, sizeof(qi_));
 }
@@ -26,6 +26,22 @@
 
 namespace senf {
 
+    /** \brief TPACKET_V3 (block based) rx ring parameters
+
+        With a TPACKET_V3 rx ring, the kernel fills blocks of variable sized frames and hands a
+        block to user-space once it is full or once the retire timeout has expired. Thus the socket
+        becomes readable once per block and not once per frame.
+     */
+    struct MMapBlockRing
+    {
+        unsigned blockNr;               ///< number of blocks in the rx ring
+        unsigned blockSize;             ///< size of a single block (multiple of the page size)
+        unsigned retireTimeout;         ///< block retire timeout in ms (0: let the kernel decide)
+
+        explicit MMapBlockRing(unsigned blockNr, unsigned blockSize = 1u << 20,
+                               unsigned retireTimeout = 1);
+    };
+
     class MMapSocketProtocol
         : public virtual SocketProtocol,
           private FileHandleAccess
@@ -41,6 +57,10 @@ namespace senf {
 
     protected:
         void init_mmap(unsigned frameSize, unsigned rxqlen, unsigned txqlen, unsigned reserve = 0, bool qDiscBypass = false) const;
+        void init_mmap(MMapBlockRing const & ring, unsigned frameSize, unsigned reserve = 0) const;
+                                        ///< Initialize a TPACKET_V3 rx only ring
+                                        /**< \a frameSize is the maximum size of a single frame
+                                             within a block. */
         void close_mmap() const;
         void terminate_mmap() const;
 
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief UNStreamSocketHandle non-inline non-template implementation */
+
+#include "UNStreamSocketHandle.hh"
+//#include "UNStreamSocketHandle.ih"
+
+// Custom includes
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/un.h>
+#include <linux/sockios.h> // for SIOCINQ
+#include <senf/Utils/Exception.hh>
+
+//#include "UNStreamSocketHandle.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+prefix_ void senf::UNStreamSocketProtocol::init_client()
+    const
+{
+    int sock = ::socket(PF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("Could not create socket(PF_UNIX,SOCK_STREAM,0).");
+    fd(sock);
+}
+
+prefix_ void senf::UNStreamSocketProtocol::init_client(UNSocketAddress const & address)
+    const
+{
+    init_client();
+    clientHandle().connect(address);
+}
+
+prefix_ void senf::UNStreamSocketProtocol::init_server()
+    const
+{
+    int sock = ::socket(PF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("Could not create socket(PF_UNIX,SOCK_STREAM,0).");
+    fd(sock);
+}
+
+prefix_ void senf::UNStreamSocketProtocol::init_server(UNSocketAddress const & address,
+                                                       unsigned backlog)
+    const
+{
+    init_server();
+    ::unlink(address.path().c_str());
+    serverHandle().bind(address);
+    if (::listen(fd(), backlog) < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("could not listen on UNStreamSocket");
+}
+
+prefix_ void senf::UNStreamSocketProtocol::close()
+{
+    unlinkListening();
+    SocketProtocol::close();
+}
+
+prefix_ void senf::UNStreamSocketProtocol::terminate()
+    const
+{
+    unlinkListening();
+    SocketProtocol::terminate();
+}
+
+prefix_ unsigned senf::UNStreamSocketProtocol::available()
+    const
+{
+    int n;
+    if (::ioctl(fd(), SIOCINQ, &n) < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("::ioctl(SIOCINQ)");
+    return n;
+}
+
+prefix_ bool senf::UNStreamSocketProtocol::eof()
+    const
+{
+    return fh().readable() && available() == 0;
+}
+
+prefix_ void senf::UNStreamSocketProtocol::unlinkListening()
+    const
+{
+    // Accepted sockets report the address of the listening socket as local address, so only
+    // remove the socket file when closing the listening socket itself. Never throws.
+    int listening (0);
+    socklen_t len (sizeof(listening));
+    if (::getsockopt(fd(), SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) < 0 || ! listening)
+        return;
+    struct sockaddr_un addr;
+    len = sizeof(addr);
+    if (::getsockname(fd(), reinterpret_cast<struct sockaddr *>(&addr), &len) == 0
+        && len > sizeof(sa_family_t) && addr.sun_path[0] != '\0')
+        ::unlink(addr.sun_path);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "UNStreamSocketHandle.mpp"
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief UNStreamSocketHandle public header */
+
+#ifndef HH_SENF_Socket_Protocols_UN_UNStreamSocketHandle_
+#define HH_SENF_Socket_Protocols_UN_UNStreamSocketHandle_ 1
+
+// Custom includes
+#include "UNAddressing.hh"
+#include <senf/Socket/Protocols/BSDSocketProtocol.hh>
+#include <senf/Socket/FramingPolicy.hh>
+#include <senf/Socket/CommunicationPolicy.hh>
+#include <senf/Socket/ReadWritePolicy.hh>
+#include <senf/Socket/ProtocolClientSocketHandle.hh>
+#include <senf/Socket/ProtocolServerSocketHandle.hh>
+
+//#include "UNStreamSocketHandle.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    /// \addtogroup concrete_protocol_group
+    //\{
+
+    typedef MakeSocketPolicy<
+        UNAddressingPolicy,
+        StreamFramingPolicy,
+        ConnectedCommunicationPolicy,
+        ReadablePolicy,
+        WriteablePolicy
+        >::policy UNStreamSocket_Policy;   ///< Socket Policy of the Unix Domain Stream Protocol
+
+    /** \brief Unix Domain Stream Socket Protocol
+
+        \par Socket Handle typedefs:
+            \ref UNStreamClientSocketHandle (ProtocolClientSocketHandle), \ref
+            UNStreamServerSocketHandle (ProtocolServerSocketHandle)
+
+        \par Policy Interface:
+            ClientSocketHandle::read(), ClientSocketHandle::write(), ClientSocketHandle::bind(),
+            ClientSocketHandle::local(), ClientSocketHandle::connect(), ClientSocketHandle::peer()
+
+        \par Address Type:
+            UNSocketAddress
+
+        UNStreamSocketProtocol provides a connection oriented stream socket based on the unix
+        domain addressing.
+
+        The socket file of a listening socket is removed when the server socket is closed. Sockets
+        returned by accept() share the address of the listening socket but never remove the
+        socket file.
+
+        This class is utilized as the protocol class of the ProtocolClientSocketHandle and
+        ProtocolServerSocketHandle via the Socket Handle typedefs above.
+     */
+    class UNStreamSocketProtocol
+        : public ConcreteSocketProtocol<UNStreamSocket_Policy, UNStreamSocketProtocol>,
+          public BSDSocketProtocol,
+          public AddressableBSDSocketProtocol
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // internal interface
+
+        ///\name Constructors
+        //\{
+
+        void init_client() const;       ///< Create unconnected client socket
+                                        /**< \note This member is implicitly called from the
+                                             ProtocolClientSocketHandle::ProtocolClientSocketHandle()
+                                             constructor */
+        void init_client(UNSocketAddress const & address) const;
+                                        ///< Create client socket and connect
+                                        /**< Creates a new client socket and connects to the given
+                                             address.
+                                             \param[in] address remote address to connect to */
+                                        /**< \note This member is implicitly called from the
+                                             ProtocolClientSocketHandle::ProtocolClientSocketHandle()
+                                             constructor */
+        void init_server() const;       ///< Create server socket
+                                        /**< \note This member is implicitly called from the
+                                             ProtocolServerSocketHandle::ProtocolServerSocketHandle()
+                                             constructor */
+        void init_server(UNSocketAddress const & address, unsigned backlog=1) const;
+                                        ///< Create server socket and listen
+                                        /**< Creates a new server socket, binds to \a address end
+                                             starts listening for new connections with a backlog of
+                                             \a backlog connections. A stale socket file at \a
+                                             address is removed before binding.
+                                             \param[in] address address to listen on
+                                             \param[in] backlog size of the listen backlog */
+                                        /**< \note This member is implicitly called from the
+                                             ProtocolServerSocketHandle::ProtocolServerSocketHandle()
+                                             constructor */
+
+        //\}
+
+        ///\name Abstract Interface Implementation
+        //\{
+
+        void close();
+        void terminate() const;
+        unsigned available() const;
+        bool eof() const;
+
+        //\}
+
+    private:
+        void unlinkListening() const;
+    };
+
+    typedef ProtocolClientSocketHandle<UNStreamSocketProtocol> UNStreamClientSocketHandle;
+    typedef ProtocolServerSocketHandle<UNStreamSocketProtocol> UNStreamServerSocketHandle;
+
+    //\}
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+//#include "UNStreamSocketHandle.cci"
+//#include "UNStreamSocketHandle.ct"
+//#include "UNStreamSocketHandle.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief UNStreamSocketHandle unit tests */
+
+#include "UNStreamSocketHandle.hh"
+
+// Custom includes
+#include <sys/stat.h>
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    bool exists(std::string const & path)
+    {
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(unStreamSocketHandle)
+{
+    std::string socketPath (".socket-UNStreamSocketHandle.test");
+    senf::UNSocketAddress addr (socketPath);
+
+    senf::UNStreamServerSocketHandle server (addr);
+    BOOST_CHECK( exists(socketPath) );
+
+    senf::UNStreamClientSocketHandle client (addr);
+    senf::UNStreamServerSocketHandle::ClientHandle peer (server.accept());
+
+    client.write(std::string("Hallo Welt."));
+    BOOST_CHECK_EQUAL( peer.read(), "Hallo Welt." );
+    peer.write(std::string("Bye."));
+    BOOST_CHECK_EQUAL( client.read(), "Bye." );
+
+    // Closing the accepted socket must not remove the servers socket file
+    peer.close();
+    BOOST_CHECK( exists(socketPath) );
+    BOOST_CHECK( client.eof() );
+    client.close();
+
+    server.close();
+    BOOST_CHECK( ! exists(socketPath) );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
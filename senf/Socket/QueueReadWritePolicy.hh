@@ -45,6 +45,10 @@ namespace senf {
         \li \c begin(), \c end(), \c size() and \c empty() provide access to the active frame data
         \li \c frameBegin(), \c frameEnd() and \c frameSize() provide access to the maximum space
             usable for packet data
+
+        On a TPACKET_V3 (block based) rx ring, the buffer references a single frame within a
+        retired block. Since frames are packed back to back in the block, the frame space ends with
+        the captured data and such a buffer cannot be resized.
      */
     class SocketQueueBuffer
     {
@@ -88,14 +92,20 @@ namespace senf {
             );      ///< resize active packet data to given size
 
     private:
-        SocketQueueBuffer(unsigned char * b, unsigned char * e, unsigned hdrlen);
+        SocketQueueBuffer(unsigned char * b, unsigned char * e, unsigned hdrlen, bool v3 = false);
 
         struct ::tpacket2_hdr & hdr();
         struct ::tpacket2_hdr const & hdr() const;
+        struct ::tpacket3_hdr const & hdr3() const;
+
+        unsigned mac() const;
+        unsigned len() const;
+        unsigned status() const;
 
         unsigned char * b_;
         unsigned char * e_;
         unsigned hdrlen_;
+        bool v3_;
 
         friend struct QueueReadPolicy;
         friend struct QueueWritePolicy;
@@ -106,7 +116,11 @@ namespace senf {
 
     /** \brief ReadPolicy for sockets readable via packet queue API
 
-        This policy provides support for reading via the linux specific packet queue API
+        This policy provides support for reading via the linux specific packet queue API. Both,
+        the frame based TPACKET_V2 and the block based TPACKET_V3 rx ring are supported. On a
+        TPACKET_V3 ring, dequeue() iterates over all frames of a retired block before moving on to
+        the next block. release() returns all completely dequeued blocks to the kernel, a partially
+        dequeued block is kept until all its frames have been dequeued.
      */
     struct QueueReadPolicy
         : public ReadPolicyBase,
@@ -120,6 +134,9 @@ namespace senf {
 
         // classic read API
         static unsigned read(FileHandle & handle, char * buffer, unsigned size);
+
+    private:
+        static boost::optional<Buffer> dequeueBlockFrame(detail::QueueInfo & qi);
     };
 
     /** \brief WritePolicy for sockets writeable via packet queue API
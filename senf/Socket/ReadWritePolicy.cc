@@ -23,7 +23,9 @@
 // Custom includes
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#include <string.h>
 #include <errno.h>
 
 //#include "ReadWritePolicy.mpp"
@@ -72,6 +74,26 @@ prefix_ unsigned senf::ReadablePolicy::do_readfrom(FileHandle & handle, char * b
     return rv;
 }
 
+prefix_ unsigned senf::BatchReadPolicy::readBatch(FileHandle & handle, struct ::mmsghdr * msgs,
+                                                  unsigned n)
+{
+    int rv = -1;
+    do {
+        rv = ::recvmmsg(handle.fd(), msgs, n, MSG_WAITFORONE, 0);
+        if (rv < 0)
+            switch (errno) {
+            case EINTR:
+                break;
+            case EAGAIN:
+                rv = 0;
+                break;
+            default:
+                SENF_THROW_SYSTEM_EXCEPTION("::recvmmsg");
+            }
+    } while (rv<0);
+    return rv;
+}
+
 prefix_ unsigned senf::WriteablePolicy::do_write(FileHandle & handle, char const * buffer,
                                                         unsigned size)
 {
@@ -135,6 +157,78 @@ prefix_ unsigned senf::WriteablePolicy::do_writeto(FileHandle & handle,
     return rv;
 }
 
+prefix_ unsigned senf::WriteablePolicy::writev(FileHandle & handle, struct ::iovec const * iov,
+                                               unsigned n, struct ::sockaddr const * addr,
+                                               socklen_t len)
+{
+    struct ::msghdr msg;
+    ::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = const_cast<struct ::sockaddr *>(addr);
+    msg.msg_namelen = len;
+    msg.msg_iov = const_cast<struct ::iovec *>(iov);
+    msg.msg_iovlen = n;
+    int rv = -1;
+    do {
+        // ::writev() also works on non-socket handles (e.g. tap devices)
+        rv = addr ? ::sendmsg(handle.fd(), &msg, 0) : ::writev(handle.fd(), iov, n);
+        if (rv < 0)
+            switch (errno) {
+            case EINTR:
+                continue;
+            case ENOTCONN:
+            case ENETDOWN:
+            case ENXIO:
+                if (! addr)
+                    SENF_THROW_SYSTEM_EXCEPTION("::writev");
+                // see do_writeto(): pretend that we have written out such frames
+                rv = 0;
+                for (unsigned i (0); i < n; ++i)
+                    rv += iov[i].iov_len;
+                break;
+            case EAGAIN:
+            case ENOBUFS:
+            case ECONNREFUSED:
+                // see do_write()
+                rv = 0;
+                break;
+            default:
+                SENF_THROW_SYSTEM_EXCEPTION(addr ? "::sendmsg" : "::writev");
+            }
+    } while (rv<0);
+    return rv;
+}
+
+prefix_ unsigned senf::BatchWritePolicy::writeBatch(FileHandle & handle, struct ::mmsghdr * msgs,
+                                                    unsigned n)
+{
+    int rv = -1;
+    do {
+        // sendmmsg() only fails if the first datagram could not be sent. Errors on any later
+        // datagram will just stop the batch early
+        rv = ::sendmmsg(handle.fd(), msgs, n, 0);
+        if (rv < 0)
+            switch (errno) {
+            case EINTR:
+                continue;
+            case ENOTCONN:
+            case ENETDOWN:
+            case ENXIO:
+                // see WriteablePolicy::do_writeto(): pretend that we have written out such frames
+                rv = n;
+                break;
+            case EAGAIN:
+            case ENOBUFS:
+            case ECONNREFUSED:
+                // see WriteablePolicy::do_write()
+                rv = 0;
+                break;
+            default:
+                SENF_THROW_SYSTEM_EXCEPTION("::sendmmsg");
+            }
+    } while (rv<0);
+    return rv;
+}
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
 //#include "ReadWritePolicy.mpp"
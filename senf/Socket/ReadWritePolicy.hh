@@ -22,6 +22,7 @@
 
 // Custom includes
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include "SocketPolicy.hh"
 #include "ClientSocketHandle.hh"
 #include "CommunicationPolicy.hh"
@@ -82,6 +83,28 @@ namespace senf {
     struct NotReadablePolicy : public ReadPolicyBase
     {};
 
+    /** \brief ReadPolicy for readable sockets supporting batched reads
+
+        This policy extends ReadablePolicy by support for reading several datagrams with a single
+        \c recvmmsg() system call (see ClientSocketHandle::readBatch()). All members of
+        ReadablePolicy are available unchanged.
+     */
+    struct BatchReadPolicy : public ReadablePolicy
+    {
+        static unsigned readBatch(FileHandle & handle, struct ::mmsghdr * msgs, unsigned n);
+                                        ///< read several datagrams from socket
+                                        /**< On a blocking socket, this call will block until at
+                                             least one datagram is available. It will then return
+                                             all datagrams available up to \a n without blocking
+                                             again.
+                                             \param[in] handle socket handle to read from
+                                             \param[in,out] msgs array of \a n message headers
+                                                 describing the receive buffers. On return, \c
+                                                 msg_len is set for all datagrams read.
+                                             \param[in] n number of message headers
+                                             \returns number of datagrams read */
+    };
+
     /** \brief WritePolicy for writeable sockets
 
         This policy provides support for writable sockets via the standard UNIX write/sendto system
@@ -135,6 +158,22 @@ namespace senf {
                                           */
 #       endif
 
+        static unsigned writev(FileHandle & handle, struct ::iovec const * iov, unsigned n,
+                               struct ::sockaddr const * addr = 0, socklen_t len = 0);
+                                        ///< write gathered data to socket
+                                        /**< Send the concatenation of the \a n buffers described
+                                             by \a iov with a single system call (\c writev() or,
+                                             if \a addr is given, \c sendmsg()). On a datagram
+                                             socket this sends a single datagram.
+                                             \param[in] handle socket handle to write data to
+                                             \param[in] iov array of \a n buffer descriptors
+                                             \param[in] n number of buffers
+                                             \param[in] addr peer to send data to or 0, if the
+                                                 socket is connected
+                                             \param[in] len size of \a addr
+                                             \returns number of bytes written
+                                             \see ClientSocketHandle::writeGather() */
+
     private:
         static unsigned do_write(FileHandle & handle, char const * buffer, unsigned size);
         static unsigned do_writeto(FileHandle & handle, char const * buffer, unsigned size,
@@ -150,6 +189,25 @@ namespace senf {
     struct NotWriteablePolicy : public WritePolicyBase
     {};
 
+    /** \brief WritePolicy for writeable sockets supporting batched writes
+
+        This policy extends WriteablePolicy by support for sending several datagrams with a single
+        \c sendmmsg() system call (see ClientSocketHandle::writeBatch() and
+        ClientSocketHandle::writeBatchTo()). All members of WriteablePolicy are available unchanged.
+     */
+    struct BatchWritePolicy : public WriteablePolicy
+    {
+        static unsigned writeBatch(FileHandle & handle, struct ::mmsghdr * msgs, unsigned n);
+                                        ///< write several datagrams to socket
+                                        /**< \param[in] handle socket handle to write data to
+                                             \param[in] msgs array of \a n message headers
+                                                 describing the datagrams to send
+                                             \param[in] n number of message headers
+                                             \returns number of datagrams written. Transient
+                                                 errors (e.g. a full send buffer) will stop the
+                                                 batch early. */
+    };
+
     //\}
 
 }
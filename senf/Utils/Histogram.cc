@@ -0,0 +1,290 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Histogram non-inline non-template implementation */
+
+#include "Histogram.hh"
+//#include "Histogram.ih"
+
+// Custom includes
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <boost/format.hpp>
+#include <senf/Utils/Console/ParsedCommand.hh>
+#include <senf/Utils/Console/STLSupport.hh>
+#include "senfassert.hh"
+
+//#include "Histogram.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::detail
+
+thread_local unsigned senf::detail::histogramThread (0u);
+
+prefix_ unsigned senf::detail::assignHistogramThread()
+{
+    static std::atomic<unsigned> threads (0u);
+    histogramThread = threads.fetch_add(1u, std::memory_order_relaxed) + 1u;
+    return histogramThread;
+}
+
+prefix_ senf::detail::HistogramShard::HistogramShard(unsigned buckets)
+    : counts (new std::atomic<boost::uint64_t>[buckets]),
+      min (std::numeric_limits<boost::uint64_t>::max()), max (0u)
+{
+    for (unsigned i (0); i < buckets; ++i)
+        counts[i].store(0u, std::memory_order_relaxed);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::Histogram
+
+unsigned const senf::Histogram::DefaultPrecision;
+unsigned const senf::Histogram::MaxPrecision;
+
+prefix_ senf::Histogram::Histogram(unsigned precision)
+    : precision_ (precision), counts_ ((65u - precision) << precision, 0u), count_ (0u),
+      min_ (std::numeric_limits<value_type>::max()), max_ (0u)
+{
+    SENF_ASSERT( precision >= 1u && precision <= MaxPrecision, "Invalid histogram precision" );
+}
+
+prefix_ void senf::Histogram::merge(Histogram const & other)
+{
+    if (other.precision_ != precision_)
+        throw IncompatibleException();
+    if (other.count_ == 0u)
+        return;
+    for (unsigned i (0); i < counts_.size(); ++i)
+        counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    if (other.min_ < min_) min_ = other.min_;
+    if (other.max_ > max_) max_ = other.max_;
+}
+
+prefix_ void senf::Histogram::clear()
+{
+    std::fill(counts_.begin(), counts_.end(), 0u);
+    count_ = 0u;
+    min_ = std::numeric_limits<value_type>::max();
+    max_ = 0u;
+}
+
+prefix_ double senf::Histogram::mean()
+    const
+{
+    if (count_ == 0u)
+        return 0.0;
+    double sum (0.0);
+    for (unsigned i (0); i < counts_.size(); ++i)
+        if (counts_[i])
+            sum += double(counts_[i]) * double(medianEquivalent(i));
+    return sum / double(count_);
+}
+
+prefix_ double senf::Histogram::stddev()
+    const
+{
+    if (count_ == 0u)
+        return 0.0;
+    double m (mean());
+    double sum (0.0);
+    for (unsigned i (0); i < counts_.size(); ++i)
+        if (counts_[i]) {
+            double d (double(medianEquivalent(i)) - m);
+            sum += double(counts_[i]) * d * d;
+        }
+    return std::sqrt(sum / double(count_));
+}
+
+prefix_ senf::Histogram::value_type senf::Histogram::percentile(double p)
+    const
+{
+    if (count_ == 0u)
+        return 0u;
+    if (p <= 0.0)
+        return min_;
+    if (p >= 100.0)
+        return max_;
+    // Round to the nearest count so floating point noise does not skip a bucket
+    count_type target (count_type(p / 100.0 * double(count_) + 0.5));
+    if (target == 0u)
+        target = 1u;
+    count_type n (0u);
+    for (unsigned i (0); i < counts_.size(); ++i) {
+        n += counts_[i];
+        if (n >= target)
+            return std::min(std::max(highestEquivalent(i, precision_), min_), max_);
+    }
+    return max_;
+}
+
+prefix_ senf::StatisticsData senf::Histogram::data()
+    const
+{
+    return StatisticsData(float(min()), float(mean()), float(max()), float(stddev()),
+                          unsigned(count_));
+}
+
+prefix_ std::ostream & senf::operator<<(std::ostream & os, Histogram const & histogram)
+{
+    os << "count=" << histogram.count()
+       << " min=" << histogram.min()
+       << " p50=" << histogram.percentile(50.0)
+       << " p90=" << histogram.percentile(90.0)
+       << " p99=" << histogram.percentile(99.0)
+       << " p99.9=" << histogram.percentile(99.9)
+       << " max=" << histogram.max();
+    return os;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::HistogramRecorder
+
+unsigned const senf::HistogramRecorder::MaxShards;
+
+prefix_ senf::HistogramRecorder::HistogramRecorder(unsigned precision)
+    : precision_ (precision)
+{
+    SENF_ASSERT( precision >= 1u && precision <= Histogram::MaxPrecision,
+                 "Invalid histogram precision" );
+    for (unsigned i (0); i < MaxShards; ++i)
+        shards_[i].store(0, std::memory_order_relaxed);
+}
+
+prefix_ senf::HistogramRecorder::~HistogramRecorder()
+{
+    for (unsigned i (0); i < MaxShards; ++i)
+        delete shards_[i].load(std::memory_order_acquire);
+}
+
+prefix_ senf::detail::HistogramShard * senf::HistogramRecorder::allocShard(unsigned index)
+{
+    detail::HistogramShard * s (new detail::HistogramShard((65u - precision_) << precision_));
+    detail::HistogramShard * expected (0);
+    if (! shards_[index].compare_exchange_strong(expected, s, std::memory_order_acq_rel)) {
+        // Another thread sharing the same slot was faster
+        delete s;
+        return expected;
+    }
+    return s;
+}
+
+prefix_ void senf::HistogramRecorder::snapshot(Histogram & target)
+{
+    if (target.precision_ != precision_)
+        throw Histogram::IncompatibleException();
+    unsigned const buckets (target.buckets());
+    for (unsigned i (0); i < MaxShards; ++i) {
+        detail::HistogramShard * s (shards_[i].load(std::memory_order_acquire));
+        if (! s)
+            continue;
+        value_type min (s->min.exchange(std::numeric_limits<value_type>::max(),
+                                        std::memory_order_relaxed));
+        value_type max (s->max.exchange(0u, std::memory_order_relaxed));
+        unsigned first (buckets);
+        unsigned last (0u);
+        for (unsigned b (0); b < buckets; ++b) {
+            // Only write to the cache line if there is something to collect
+            if (s->counts[b].load(std::memory_order_relaxed) == 0u)
+                continue;
+            count_type n (s->counts[b].exchange(0u, std::memory_order_relaxed));
+            target.counts_[b] += n;
+            target.count_ += n;
+            if (first == buckets)
+                first = b;
+            last = b;
+        }
+        if (first == buckets)
+            continue;
+        // A value recorded concurrently may have updated min/max but not yet the counters or
+        // vice versa. Keep min/max consistent with the buckets actually collected.
+        min = std::min(std::max(min, Histogram::lowestEquivalent(first, precision_)),
+                       Histogram::highestEquivalent(first, precision_));
+        max = std::max(std::min(max, Histogram::highestEquivalent(last, precision_)),
+                       Histogram::lowestEquivalent(last, precision_));
+        if (min < target.min_) target.min_ = min;
+        if (max > target.max_) target.max_ = max;
+    }
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::HistogramStatistics
+
+prefix_ senf::HistogramStatistics::HistogramStatistics(unsigned precision)
+    : recorder_ (precision), interval_ (precision), total_ (precision)
+{
+#ifndef SENF_DISABLE_CONSOLE
+    namespace fty = console::factory;
+
+    dir.add("percentiles", fty::Command(&HistogramStatistics::consolePercentiles, this)
+            .doc("Show value percentiles of the last collection interval and of all values\n"
+                 "collected since the last 'clear-histogram'. Without argument, a default set\n"
+                 "of percentiles is shown:\n"
+                 "\n"
+                 "    $ percentiles (50 99 99.99)\n"
+                 "\n"
+                 "Columns:\n"
+                 "    PERCENTILE  Requested percentile\n"
+                 "    INTERVAL    Value of the percentile over the last collection interval\n"
+                 "    TOTAL       Value of the percentile over all values since last clear")
+            .arg("percentiles", "list of percentiles to show (0 .. 100)",
+                 console::kw::default_value = std::vector<double>()) );
+    dir.add("clear-histogram", fty::Command(&HistogramStatistics::clear, this)
+            .doc("Clear the accumulated total histogram.") );
+#endif
+}
+
+prefix_ void senf::HistogramStatistics::update(unsigned n)
+{
+    interval_.clear();
+    recorder_.snapshot(interval_);
+    total_ += interval_;
+    Statistics::operator()(n, interval_.count(), float(interval_.min()), float(interval_.mean()),
+                           float(interval_.max()), float(interval_.stddev()));
+}
+
+prefix_ void senf::HistogramStatistics::consolePercentiles(std::ostream & os,
+                                                           std::vector<double> const & percentiles)
+    const
+{
+    static double const defaults[] = { 0.0, 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 };
+    std::vector<double> ps (percentiles);
+    if (ps.empty())
+        ps.assign(defaults, defaults + sizeof(defaults)/sizeof(defaults[0]));
+    boost::format fmt ("%10.3f  %16d  %16d\n");
+    os << "PERCENTILE          INTERVAL             TOTAL\n";
+    for (std::vector<double>::const_iterator i (ps.begin()); i != ps.end(); ++i)
+        os << fmt % *i % interval_.percentile(*i) % total_.percentile(*i);
+    os << boost::format("%-10s  %16d  %16d\n") % "COUNT" % interval_.count() % total_.count();
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "Histogram.mpp"
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Histogram public header */
+
+#ifndef HH_SENF_Utils_Histogram_
+#define HH_SENF_Utils_Histogram_ 1
+
+// Custom includes
+#include <atomic>
+#include <vector>
+#include <iosfwd>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include "Exception.hh"
+#include "Statistics.hh"
+
+//#include "Histogram.mpp"
+#include "Histogram.ih"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    /** \brief Log-linear (HDR) histogram
+
+        Histogram records integral values (e.g. latencies in nanoseconds) into log-linear buckets:
+        Values below <tt>2<sup>precision+1</sup></tt> are counted exactly, larger values are
+        counted with a relative resolution of <tt>2<sup>-precision</sup></tt>. The default
+        precision of 7 bits gives a relative error below 1% over the complete \c uint64 range
+        using 7424 buckets.
+
+        Recording a value is a constant time operation (a single count leading zeros instruction
+        computes the bucket). Histograms with the same precision may be merged, percentile
+        queries walk the bucket array. \c mean() and \c stddev() are computed from the bucket
+        midpoints and are thus subject to the same relative error.
+
+        Histogram is not thread safe. To record from several threads concurrently, use
+        senf::HistogramRecorder.
+
+        \ingroup senf_statistics
+     */
+    class Histogram
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // Types
+
+        typedef boost::uint64_t value_type;
+        typedef boost::uint64_t count_type;
+
+        static unsigned const DefaultPrecision = 7u;
+        static unsigned const MaxPrecision = 12u;
+
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        explicit Histogram(unsigned precision = DefaultPrecision);
+                                        ///< Create empty histogram
+                                        /**< \param[in] precision number of significant bits
+                                                 (1 .. MaxPrecision) */
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+
+        void record(value_type value, count_type n = 1u);
+                                        ///< Record \a value \a n times
+        void merge(Histogram const & other);
+                                        ///< Add all values of \a other to this histogram
+                                        /**< \throws IncompatibleException if the precision of
+                                                 the histograms differs */
+        Histogram & operator+=(Histogram const & other);
+                                        ///< Same as merge()
+        void clear();                   ///< Remove all values
+
+        count_type count() const;       ///< Number of values recorded
+        bool empty() const;             ///< \c true, if no value has been recorded
+        value_type min() const;         ///< Smallest value recorded (0 if empty)
+        value_type max() const;         ///< Largest value recorded (0 if empty)
+        double mean() const;            ///< Mean of all values
+        double stddev() const;          ///< Standard deviation of all values
+        value_type percentile(double p) const;
+                                        ///< Get percentile
+                                        /**< Returns the value, below or at which \a p percent
+                                             of all recorded values lie. The returned value is
+                                             the highest value equivalent to the bucket the
+                                             percentile falls into, clamped to max().
+                                             \param[in] p percentile in the range 0 .. 100 */
+        StatisticsData data() const;    ///< Get count, min, mean, max and stddev as a tuple
+
+        unsigned precision() const;     ///< Number of significant bits
+        unsigned buckets() const;       ///< Number of buckets
+
+        static unsigned bucketIndex(value_type value, unsigned precision);
+                                        ///< Bucket index of \a value
+        static value_type lowestEquivalent(unsigned bucket, unsigned precision);
+                                        ///< Smallest value counted in \a bucket
+        static value_type highestEquivalent(unsigned bucket, unsigned precision);
+                                        ///< Largest value counted in \a bucket
+
+        struct IncompatibleException : public senf::Exception
+        { IncompatibleException() : senf::Exception("Incompatible histogram precision") {} };
+
+    private:
+        value_type medianEquivalent(unsigned bucket) const;
+
+        unsigned precision_;
+        std::vector<count_type> counts_;
+        count_type count_;
+        value_type min_;
+        value_type max_;
+
+        friend class HistogramRecorder;
+    };
+
+    /** \brief Write percentile summary of \a histogram to \a os */
+    std::ostream & operator<<(std::ostream & os, Histogram const & histogram);
+
+    /** \brief Lock-free concurrent Histogram recorder
+
+        HistogramRecorder allows any number of threads to record values concurrently without
+        locking: Every recording thread gets it's own set of bucket counters (a shard) which is
+        allocated on the first record() call from that thread. Recording is a relaxed atomic
+        increment on a cache line only touched by the recording thread.
+
+        snapshot() moves all values recorded since the last snapshot from all shards into a
+        Histogram. It may be called from any thread concurrently with record(); values recorded
+        while the snapshot is taken end up either in this or in the next snapshot.
+
+        There are at most \c MaxShards shards. If more threads record values, threads will share
+        shards. This is still correct but the threads will then contend on the counters.
+
+        \code
+          senf::HistogramRecorder latency;
+
+          // any thread
+          latency.record(senf::ClockService::in_nanoseconds(rxTime - txTime));
+
+          // statistics thread, periodically
+          senf::Histogram h;
+          latency.snapshot(h);
+          std::cout << h.percentile(99.9) << "\n";
+        \endcode
+
+        \warning The recorder must outlive all threads recording into it.
+
+        \ingroup senf_statistics
+     */
+    class HistogramRecorder
+        : boost::noncopyable
+    {
+    public:
+        typedef Histogram::value_type value_type;
+        typedef Histogram::count_type count_type;
+
+        static unsigned const MaxShards = 64u;
+
+        explicit HistogramRecorder(unsigned precision = Histogram::DefaultPrecision);
+        ~HistogramRecorder();
+
+        void record(value_type value, count_type n = 1u);
+                                        ///< Record \a value \a n times (thread-safe, lock-free)
+        void snapshot(Histogram & target);
+                                        ///< Move values recorded since the last snapshot
+                                        /**< All values are added to \a target and removed from
+                                             the recorder.
+                                             \throws Histogram::IncompatibleException if the
+                                                 precision of \a target differs */
+
+        unsigned precision() const;     ///< Number of significant bits
+
+    private:
+        detail::HistogramShard & shard();
+        detail::HistogramShard * allocShard(unsigned index);
+
+        unsigned precision_;
+        std::atomic<detail::HistogramShard *> shards_[MaxShards];
+    };
+
+    /** \brief Statistics fed by a concurrent Histogram
+
+        HistogramStatistics is a senf::Statistics instance collecting the complete value
+        distribution in addition to the min/avg/max/dev values. record() may be called from any
+        thread (see senf::HistogramRecorder). update() must be called periodically from the
+        thread owning the statistics: It takes a snapshot of the values recorded since the last
+        update() and enters it into the Statistics collector hierarchy as a single time-slice.
+
+        The histogram of the last interval and the histogram accumulated over all intervals since
+        the last clear() are available for percentile queries from C++ and the console.
+
+        \ingroup senf_statistics
+     */
+    class HistogramStatistics
+        : public Statistics
+    {
+    public:
+        explicit HistogramStatistics(unsigned precision = Histogram::DefaultPrecision);
+
+        void record(Histogram::value_type value, Histogram::count_type n = 1u);
+                                        ///< Record value (thread-safe, lock-free)
+        void update(unsigned n = 1u);   ///< Take snapshot and enter it into the Statistics
+                                        /**< \param[in] n number of time-slices */
+
+        Histogram const & interval() const; ///< Histogram of the last update() interval
+        Histogram const & total() const; ///< Histogram accumulated since last clear()
+        void clear();                   ///< Clear total() histogram
+
+        HistogramRecorder & recorder(); ///< Access underlying recorder
+
+    private:
+        void consolePercentiles(std::ostream & os, std::vector<double> const & percentiles) const;
+
+        HistogramRecorder recorder_;
+        Histogram interval_;
+        Histogram total_;
+    };
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "Histogram.cci"
+//#include "Histogram.ct"
+//#include "Histogram.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
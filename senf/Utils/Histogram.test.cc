@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Histogram unit tests */
+
+#include "Histogram.hh"
+
+// Custom includes
+#include <thread>
+#include <sstream>
+#include <senf/Utils/Console/Executor.hh>
+#include <senf/Utils/Console/Parse.hh>
+#include <senf/Utils/Console/Node.hh>
+
+// Unit test includes
+#include <boost/test/floating_point_comparison.hpp>
+#include "auto_unit_test.hh"
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+SENF_AUTO_TEST_CASE(histogram)
+{
+    // Bucket layout: exact below 2^(precision+1), then relative resolution 2^-precision
+    for (senf::Histogram::value_type v (0u); v < 256u; ++v)
+        BOOST_CHECK_EQUAL( senf::Histogram::bucketIndex(v, 7u), unsigned(v) );
+    BOOST_CHECK_EQUAL( senf::Histogram::bucketIndex(256u, 7u), 256u );
+    BOOST_CHECK_EQUAL( senf::Histogram::bucketIndex(257u, 7u), 256u );
+    BOOST_CHECK_EQUAL( senf::Histogram::bucketIndex(258u, 7u), 257u );
+    BOOST_CHECK_EQUAL( senf::Histogram::bucketIndex(~senf::Histogram::value_type(0u), 7u),
+                       senf::Histogram().buckets() - 1u );
+    for (unsigned b (0u); b < senf::Histogram().buckets(); ++b) {
+        senf::Histogram::value_type low (senf::Histogram::lowestEquivalent(b, 7u));
+        senf::Histogram::value_type high (senf::Histogram::highestEquivalent(b, 7u));
+        BOOST_CHECK_EQUAL( senf::Histogram::bucketIndex(low, 7u), b );
+        BOOST_CHECK_EQUAL( senf::Histogram::bucketIndex(high, 7u), b );
+        if (b + 1u < senf::Histogram().buckets())
+            BOOST_CHECK_EQUAL( senf::Histogram::lowestEquivalent(b + 1u, 7u), high + 1u );
+    }
+
+    senf::Histogram h;
+    BOOST_CHECK( h.empty() );
+    BOOST_CHECK_EQUAL( h.percentile(50.0), 0u );
+    BOOST_CHECK_EQUAL( h.min(), 0u );
+
+    for (unsigned i (1u); i <= 100u; ++i)
+        h.record(i);
+    BOOST_CHECK_EQUAL( h.count(), 100u );
+    BOOST_CHECK_EQUAL( h.min(), 1u );
+    BOOST_CHECK_EQUAL( h.max(), 100u );
+    BOOST_CHECK_EQUAL( h.percentile(0.0), 1u );
+    BOOST_CHECK_EQUAL( h.percentile(50.0), 50u );
+    BOOST_CHECK_EQUAL( h.percentile(99.0), 99u );
+    BOOST_CHECK_EQUAL( h.percentile(100.0), 100u );
+    BOOST_CHECK_CLOSE( h.mean(), 50.5, 0.001 );
+    BOOST_CHECK_CLOSE( h.stddev(), 28.866, 0.01 );
+
+    // Large values keep their relative precision
+    senf::Histogram l;
+    l.record(1000000u, 999u);
+    l.record(5000000000ull);
+    BOOST_CHECK_EQUAL( l.count(), 1000u );
+    BOOST_CHECK_CLOSE( double(l.percentile(50.0)), 1000000.0, 100.0 / 128.0 );
+    BOOST_CHECK_CLOSE( double(l.percentile(99.9)), 1000000.0, 100.0 / 128.0 );
+    BOOST_CHECK_EQUAL( l.percentile(99.95), 5000000000ull );
+    BOOST_CHECK_EQUAL( l.max(), 5000000000ull );
+
+    h.merge(l);
+    BOOST_CHECK_EQUAL( h.count(), 1100u );
+    BOOST_CHECK_EQUAL( h.min(), 1u );
+    BOOST_CHECK_EQUAL( h.max(), 5000000000ull );
+    BOOST_CHECK_EQUAL( h.percentile(5.0), 55u );
+
+    senf::Histogram p (3u);
+    BOOST_CHECK_THROW( h.merge(p), senf::Histogram::IncompatibleException );
+
+    std::stringstream ss;
+    ss << l;
+    BOOST_CHECK_EQUAL( ss.str().substr(0, 19), "count=1000 min=1000" );
+
+    h.clear();
+    BOOST_CHECK( h.empty() );
+    BOOST_CHECK_EQUAL( h.max(), 0u );
+}
+
+SENF_AUTO_TEST_CASE(histogramRecorder)
+{
+    senf::HistogramRecorder recorder;
+    unsigned const threads (4u);
+    unsigned const values (100000u);
+
+    std::vector<std::thread> workers;
+    for (unsigned t (0u); t < threads; ++t)
+        workers.push_back(std::thread([&recorder, t]() {
+                    for (unsigned i (0u); i < values; ++i)
+                        recorder.record(1000u * (t + 1u) + i % 100u);
+                }));
+
+    // Snapshots may be taken concurrently to recording
+    senf::Histogram h;
+    recorder.snapshot(h);
+    for (std::vector<std::thread>::iterator i (workers.begin()); i != workers.end(); ++i)
+        i->join();
+    recorder.snapshot(h);
+
+    BOOST_CHECK_EQUAL( h.count(), threads * values );
+    BOOST_CHECK_EQUAL( h.min(), 1000u );
+    BOOST_CHECK_EQUAL( h.max(), 4099u );
+    BOOST_CHECK_CLOSE( double(h.percentile(50.0)), 2099.0, 1.0 );
+
+    senf::Histogram h2;
+    recorder.snapshot(h2);
+    BOOST_CHECK( h2.empty() );
+
+    senf::Histogram p (3u);
+    BOOST_CHECK_THROW( recorder.snapshot(p), senf::Histogram::IncompatibleException );
+}
+
+SENF_AUTO_TEST_CASE(histogramStatistics)
+{
+    senf::HistogramStatistics stats;
+    for (unsigned i (1u); i <= 100u; ++i)
+        stats.record(i);
+    stats.update();
+
+    BOOST_CHECK_EQUAL( stats.cnt(), 100u );
+    BOOST_CHECK_CLOSE( stats.min(), 1.0f, 0.001f );
+    BOOST_CHECK_CLOSE( stats.avg(), 50.5f, 0.001f );
+    BOOST_CHECK_CLOSE( stats.max(), 100.0f, 0.001f );
+    BOOST_CHECK_EQUAL( stats.interval().percentile(90.0), 90u );
+
+    stats.record(200u);
+    stats.update();
+    BOOST_CHECK_EQUAL( stats.cnt(), 1u );
+    BOOST_CHECK_EQUAL( stats.interval().count(), 1u );
+    BOOST_CHECK_EQUAL( stats.total().count(), 101u );
+    BOOST_CHECK_EQUAL( stats.total().max(), 200u );
+
+    senf::console::Executor executor;
+    senf::console::CommandParser parser;
+    senf::console::root().add("histogram", stats.dir);
+    std::stringstream ss;
+    parser.parse("histogram/percentiles (50 100)",
+                 boost::bind<void>( boost::ref(executor), boost::ref(ss), _1 ));
+    BOOST_CHECK_EQUAL( ss.str(),
+                       "PERCENTILE          INTERVAL             TOTAL\n"
+                       "    50.000               200                51\n"
+                       "   100.000               200               200\n"
+                       "COUNT                      1               101\n" );
+
+    ss.str("");
+    parser.parse("histogram/clear-histogram",
+                 boost::bind<void>( boost::ref(executor), boost::ref(ss), _1 ));
+    BOOST_CHECK( stats.total().empty() );
+
+    senf::Histogram h;
+    h.record(10u, 3u);
+    stats(1u, h);
+    BOOST_CHECK_EQUAL( stats.cnt(), 3u );
+    BOOST_CHECK_CLOSE( stats.avg(), 10.0f, 0.001f );
+    BOOST_CHECK( h.empty() );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief IpChecksum non-inline non-template implementation */
+
+#include "IpChecksum.hh"
+//#include "IpChecksum.ih"
+
+// Custom includes
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SENF_IPCHECKSUM_X86 1
+#endif
+
+//#include "IpChecksum.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+// All the sum functions below add up the data as 16bit words in host byte order. The result is a
+// 64bit one's complement sum which must be folded. Since the one's complement sum is byte order
+// independent (RFC 1071), the folded sum only needs to be byte swapped on little endian hosts.
+
+namespace {
+
+    typedef boost::uint64_t (*SumFunction)(boost::uint8_t const *, std::size_t);
+
+    inline boost::uint64_t add(boost::uint64_t a, boost::uint64_t b)
+    {
+        a += b;
+        return a + (a < b);
+    }
+
+    // n must be even
+    boost::uint64_t sumScalar(boost::uint8_t const * p, std::size_t n)
+    {
+        boost::uint64_t sum (0);
+        for (; n >= 8; p += 8, n -= 8) {
+            boost::uint64_t w;
+            ::memcpy(&w, p, 8);
+            sum = add(sum, w);
+        }
+        for (; n >= 2; p += 2, n -= 2) {
+            boost::uint16_t w;
+            ::memcpy(&w, p, 2);
+            sum = add(sum, w);
+        }
+        return sum;
+    }
+
+#ifdef SENF_IPCHECKSUM_X86
+
+    // Every iteration adds at most 2 * 0xffff to each 32bit lane
+    std::size_t const MaxBlockIterations (16384u);
+
+    __attribute__((target("sse2")))
+    boost::uint64_t sumSSE2(boost::uint8_t const * p, std::size_t n)
+    {
+        boost::uint64_t sum (0);
+        __m128i const zero (_mm_setzero_si128());
+        while (n >= 16) {
+            std::size_t iterations (std::min(n / 16, MaxBlockIterations));
+            n -= iterations * 16;
+            __m128i acc (zero);
+            for (; iterations > 0; --iterations, p += 16) {
+                __m128i v (_mm_loadu_si128(reinterpret_cast<__m128i const *>(p)));
+                acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+                acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+            }
+            boost::uint32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+            sum += boost::uint64_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        }
+        return add(sum, sumScalar(p, n));
+    }
+
+    __attribute__((target("avx2")))
+    boost::uint64_t sumAVX2(boost::uint8_t const * p, std::size_t n)
+    {
+        boost::uint64_t sum (0);
+        __m256i const zero (_mm256_setzero_si256());
+        while (n >= 32) {
+            std::size_t iterations (std::min(n / 32, MaxBlockIterations));
+            n -= iterations * 32;
+            __m256i acc (zero);
+            for (; iterations > 0; --iterations, p += 32) {
+                __m256i v (_mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)));
+                acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(v, zero));
+                acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(v, zero));
+            }
+            boost::uint32_t lanes[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc);
+            for (unsigned i (0); i < 8; ++i)
+                sum += lanes[i];
+        }
+        return add(sum, sumScalar(p, n));
+    }
+
+#endif
+
+    boost::uint64_t sumSelect(boost::uint8_t const * p, std::size_t n);
+
+    // Initially points to sumSelect() which replaces the pointer on first use. This is constant
+    // initialized and therefore safe to use during static initialization. Concurrent first uses
+    // all store the same value, so relaxed ordering suffices.
+    std::atomic<SumFunction> sumFunction (&sumSelect);
+
+    boost::uint64_t sumSelect(boost::uint8_t const * p, std::size_t n)
+    {
+        SumFunction f (&sumScalar);
+#ifdef SENF_IPCHECKSUM_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            f = &sumAVX2;
+        else if (__builtin_cpu_supports("sse2"))
+            f = &sumSSE2;
+#endif
+        sumFunction.store(f, std::memory_order_relaxed);
+        return f(p, n);
+    }
+
+    // Below this size, the scalar implementation is faster
+    std::size_t const MinVectorSize (32u);
+
+}
+
+prefix_ void senf::IpChecksum::feed(void const * data, std::size_t size)
+{
+    boost::uint8_t const * p (static_cast<boost::uint8_t const *>(data));
+    if (size == 0)
+        return;
+    if (odd_) {
+        feed(*p);
+        ++ p;
+        -- size;
+    }
+    std::size_t n (size & ~std::size_t(1));
+    if (n > 0) {
+        boost::uint64_t s (n < MinVectorSize ? sumScalar(p, n)
+                           : sumFunction.load(std::memory_order_relaxed)(p, n));
+        while (s >> 16)
+            s = (s & 0xffff) + (s >> 16);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        s = ((s & 0xff) << 8) | (s >> 8);
+#endif
+        s += sum_;
+        sum_ = (s & 0xffff) + (s >> 16);
+    }
+    if (size & 1)
+        feed(p[n]);
+}
+
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "IpChecksum.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -18,7 +18,9 @@
 #define HH_SENF_Utils_IpChecksum_ 1
 
 // Custom includes
+#include <cstddef>
 #include <boost/cstdint.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 
 //#include "IpChecksum.mpp"
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -36,6 +38,17 @@ namespace senf {
 
         The mathematical properties of the checksum allow to skip any \e even number of zero bytes
         without changing the checksum value.
+
+        Contiguous ranges of bytes (e.g. packet data) are summed by a vectorized implementation
+        (AVX2 or SSE2 depending on the CPU, scalar on other architectures), which is selected at
+        runtime.
+
+        When rewriting single header fields (e.g. decrementing the IPv4 TTL or NAT address
+        rewrites), the checksum need not be recalculated. update() and update32() will instead
+        adjust the checksum incrementally as defined in RFC 1624:
+        \code
+        ip->checksum() << senf::IpChecksum::update(ip->checksum(), oldWord, newWord);
+        \endcode
       */
     class IpChecksum
     {
@@ -57,12 +70,34 @@ namespace senf {
         template <class InputIterator>
         void feed(InputIterator b, InputIterator e);
                                         ///< Feed range of bytes
+                                        /**< If \a InputIterator is a pointer to bytes, the range is
+                                             summed by the vectorized implementation. */
+        void feed(void const * data, std::size_t size);
+                                        ///< Feed contiguous block of memory
 
         boost::uint16_t sum() const;    ///< Calculate checksum
 
+        static boost::uint16_t update(boost::uint16_t checksum,
+                                      boost::uint16_t oldValue, boost::uint16_t newValue);
+                                        ///< Incrementally update checksum
+                                        /**< Returns the new value of \a checksum after changing a
+                                             16bit word (aligned at an even offset) of the
+                                             checksummed data from \a oldValue to \a newValue
+                                             (RFC 1624). */
+        static boost::uint16_t update32(boost::uint16_t checksum,
+                                        boost::uint32_t oldValue, boost::uint32_t newValue);
+                                        ///< Incrementally update checksum for 32bit value
+                                        /**< Same as update() for a 32bit value like an IPv4
+                                             address. */
+
     protected:
 
     private:
+        template <class InputIterator>
+        void feed(InputIterator b, InputIterator e, boost::true_type);
+        template <class InputIterator>
+        void feed(InputIterator b, InputIterator e, boost::false_type);
+
         boost::uint32_t sum_;
         bool odd_;
     };
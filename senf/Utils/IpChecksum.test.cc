@@ -17,6 +17,9 @@
 #include "IpChecksum.hh"
 
 // Custom includes
+#include <cstdlib>
+#include <vector>
+#include <boost/cstdint.hpp>
 
 // Unit test includes
 #include <senf/Utils/auto_unit_test.hh>
@@ -35,6 +38,81 @@ SENF_AUTO_TEST_CASE(ipChecksum)
     BOOST_CHECK_EQUAL( summer.sum(), 0x7e62u );
 }
 
+namespace {
+
+    boost::uint16_t referenceSum(std::vector<boost::uint8_t> const & data,
+                                 std::size_t b, std::size_t e)
+    {
+        boost::uint32_t sum (0);
+        for (std::size_t i (b); i < e; ++i)
+            sum += (i - b) % 2 ? data[i] : data[i] << 8;
+        while (sum >> 16)
+            sum = (sum & 0xffff) + (sum >> 16);
+        return ~ sum;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(ipChecksum_bulk)
+{
+    std::vector<boost::uint8_t> data (70000);
+    ::srand(17);
+    for (std::size_t i (0); i < data.size(); ++i)
+        data[i] = ::rand();
+
+    // different lengths and (mis-)alignments hitting the scalar and vectorized code paths
+    std::size_t const offsets[] = { 0, 1, 2, 3, 7 };
+    std::size_t const sizes[] = { 0, 1, 2, 19, 31, 32, 33, 64, 1500, 1501, 65537, 69990 };
+    for (std::size_t const * o (offsets); o != offsets + sizeof(offsets)/sizeof(offsets[0]); ++o)
+        for (std::size_t const * s (sizes); s != sizes + sizeof(sizes)/sizeof(sizes[0]); ++s) {
+            senf::IpChecksum summer;
+            summer.feed(&data[*o], &data[*o] + *s);
+            BOOST_CHECK_EQUAL( summer.sum(), referenceSum(data, *o, *o + *s) );
+        }
+
+    // mixing byte wise and bulk feeding with odd offsets
+    {
+        senf::IpChecksum summer;
+        summer.feed(data[0]);
+        summer.feed(&data[1], 100u);
+        summer.feed(data.begin() + 101, data.begin() + 104);
+        summer.feed(&data[104], 1397u);
+        BOOST_CHECK_EQUAL( summer.sum(), referenceSum(data, 0, 1501) );
+    }
+}
+
+SENF_AUTO_TEST_CASE(ipChecksum_update)
+{
+    unsigned char data[] = { 0x45, 0x00, 0x00, 0x28, 0x49, 0x44, 0x40, 0x00,
+                             0x40, 0x06, 0x00, 0x00, 0x0a, 0xc1, 0x01, 0x06,
+                             0xc2, 0x9f, 0xa4, 0xc3 };
+    boost::uint16_t checksum (0x7e62u);
+
+    // decrement TTL
+    boost::uint16_t oldWord ((data[8] << 8) | data[9]);
+    -- data[8];
+    boost::uint16_t newWord ((data[8] << 8) | data[9]);
+    checksum = senf::IpChecksum::update(checksum, oldWord, newWord);
+    {
+        senf::IpChecksum summer;
+        summer.feed(data, data+sizeof(data));
+        BOOST_CHECK_EQUAL( checksum, summer.sum() );
+    }
+
+    // rewrite source address
+    boost::uint32_t oldAddr ((data[12] << 24) | (data[13] << 16) | (data[14] << 8) | data[15]);
+    boost::uint32_t newAddr (0xc0a80001u);
+    data[12] = 0xc0; data[13] = 0xa8; data[14] = 0x00; data[15] = 0x01;
+    checksum = senf::IpChecksum::update32(checksum, oldAddr, newAddr);
+    {
+        senf::IpChecksum summer;
+        summer.feed(data, data+sizeof(data));
+        BOOST_CHECK_EQUAL( checksum, summer.sum() );
+    }
+
+    BOOST_CHECK_EQUAL( senf::IpChecksum::update(checksum, 0x1234u, 0x1234u), checksum );
+}
+
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
@@ -24,11 +24,13 @@
 #define prefix_
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 
+unsigned senf::log::detail::AreaBase::nAreas = 0;
+
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 // senf::log::detail::AreaBase
 
 prefix_ senf::log::detail::AreaBase::AreaBase()
-    : alive_ (true)
+    : index (nAreas++), alive_ (true)
 {}
 
 prefix_ senf::log::detail::AreaBase::~AreaBase()
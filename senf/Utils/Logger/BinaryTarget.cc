@@ -0,0 +1,566 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief BinaryTarget non-inline non-template implementation */
+
+#include "BinaryTarget.hh"
+//#include "BinaryTarget.ih"
+
+// Custom includes
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <boost/filesystem/path.hpp>
+#include <boost/version.hpp>
+#include <senf/Scheduler/ClockService.hh>
+#include <senf/Utils/String.hh>
+#include <senf/Utils/Console/ParsedCommand.hh>
+#include <senf/Utils/Console/Variables.hh>
+#include <senf/Utils/Console/ScopedDirectory.hh>
+
+//#include "BinaryTarget.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    typedef senf::log::detail::BinaryLogRecord Record;
+    typedef senf::log::detail::BinaryLogHeader Header;
+
+    std::string getNodename(std::string const & filename, std::string const & nodename)
+    {
+        if (! nodename.empty())
+            return nodename;
+#if BOOST_VERSION >= 104600
+        return boost::filesystem::path(filename).leaf().string();
+#else
+        return boost::filesystem::path(filename).leaf();
+#endif
+    }
+
+    std::size_t roundSize(unsigned size)
+    {
+        std::size_t n (4096u);
+        while (n < size)
+            n <<= 1;
+        return n;
+    }
+
+    std::size_t align(std::size_t size)
+    {
+        return (size + senf::log::detail::BinaryLogAlign - 1) & ~ std::size_t(senf::log::detail::BinaryLogAlign - 1);
+    }
+
+    boost::posix_time::ptime const epoch (boost::gregorian::date(1970,1,1));
+
+    // Names are usually identified by the stream / area index. Names passed as strings are
+    // assigned ids from a separate range
+    unsigned const InternedId = 0x80000000u;
+
+    // Padding records at the end of the buffer may be shorter than a complete Record
+    std::size_t const MinRecordSize = 2 * sizeof(std::uint32_t);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::log::BinaryTarget
+
+prefix_ senf::log::BinaryTarget::BinaryTarget(std::string const & filename,
+                                              std::string const & nodename, unsigned bufferSize)
+    : Target (getNodename(filename, nodename)),
+      file_ (filename), mask_ (roundSize(bufferSize) - 1), buffer_ (new char[mask_ + 1]),
+      head_ (0u), tailCache_ (0u), dropped_ (0u), pendingDrops_ (0u), tail_ (0u), fd_ (-1),
+      flushInterval_ (100u), flushRequested_ (false), stop_ (false)
+{
+    namespace fty = console::factory;
+
+    openFile(file_);
+    if (fd_ < 0)
+        SENF_THROW_SYSTEM_EXCEPTION("logfile open") << ": " << filename;
+    writeHeader();
+    thread_ = std::thread(&BinaryTarget::run, this);
+
+    consoleDir()
+        .add( "reopen",
+              fty::Command(SENF_MEMBINDFNP(void, BinaryTarget, reopen, ()))
+              .doc("Reopen logfile") );
+    consoleDir()
+        .add("reopen",
+             fty::Command(SENF_MEMBINDFNP(void, BinaryTarget, reopen, (std::string const &)))
+             .arg("filename","new filename")
+             .overloadDoc("Reopen logfile under new name") );
+    consoleDir()
+        .add("file", fty::Variable(boost::cref(file_))
+             .doc("Show filename log messages are sent to") );
+    consoleDir()
+        .add("flush", fty::Command(&BinaryTarget::flush, this)
+             .doc("Write out all buffered log messages") );
+    consoleDir()
+        .add("dropped", fty::Command(&BinaryTarget::dropped, this)
+             .doc("Number of log messages dropped due to a full buffer") );
+}
+
+prefix_ senf::log::BinaryTarget::~BinaryTarget()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+prefix_ void senf::log::BinaryTarget::reopen()
+{
+    reopen(file_);
+}
+
+prefix_ void senf::log::BinaryTarget::reopen(std::string const & file)
+{
+    bool rename (file != file_);
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        reopenFile_ = file;
+    }
+    file_ = file;
+    Record record = {};
+    record.type = Record::Reopen;
+    writeControl(record, 0);
+    // The new file needs the names again
+    knownStreams_.clear();
+    knownAreas_.clear();
+    streamIds_.clear();
+    areaIds_.clear();
+    writeHeader();
+    if (rename) {
+        console::DirectoryNode::ptr parent (consoleDir().node().parent());
+        if (parent)
+            parent->add(file, consoleDir().node().unlink());
+    }
+}
+
+prefix_ void senf::log::BinaryTarget::flush()
+{
+    std::uint64_t head (head_.load(std::memory_order_relaxed));
+    std::unique_lock<std::mutex> lock (mutex_);
+    flushRequested_ = true;
+    wakeup_.notify_one();
+    drained_.wait(lock, [this, head] () { return tail_.load(std::memory_order_acquire) >= head; });
+}
+
+prefix_ void senf::log::BinaryTarget::flushInterval(unsigned ms)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    flushInterval_ = ms;
+}
+
+prefix_ unsigned senf::log::BinaryTarget::flushInterval()
+    const
+{
+    std::lock_guard<std::mutex> lock (const_cast<std::mutex &>(mutex_));
+    return flushInterval_;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// private members
+
+prefix_ void senf::log::BinaryTarget::v_writeRaw(time_type timestamp,
+                                                 detail::StreamBase const & stream,
+                                                 detail::AreaBase const & area, unsigned level,
+                                                 std::string const & message)
+{
+    // Only the first message of every stream and area needs the (expensive) name
+    if (SENF_UNLIKELY(! known(knownStreams_, stream.index))) {
+        if (! writeName(Record::StreamName, stream.index, stream.v_name())) {
+            ++ dropped_;
+            ++ pendingDrops_;
+            return;
+        }
+        knownStreams_[stream.index] = true;
+    }
+    if (SENF_UNLIKELY(! known(knownAreas_, area.index))) {
+        if (! writeName(Record::AreaName, area.index, area.v_name())) {
+            ++ dropped_;
+            ++ pendingDrops_;
+            return;
+        }
+        knownAreas_[area.index] = true;
+    }
+    write(timestamp, stream.index, area.index, level, message);
+}
+
+prefix_ void senf::log::BinaryTarget::v_write(time_type timestamp, std::string const & stream,
+                                              std::string const & area, unsigned level,
+                                              std::string const & message)
+{
+    unsigned streamId (intern(streamIds_, Record::StreamName, stream));
+    unsigned areaId (intern(areaIds_, Record::AreaName, area));
+    if (streamId == 0 || areaId == 0) {
+        ++ dropped_;
+        ++ pendingDrops_;
+        return;
+    }
+    write(timestamp, streamId, areaId, level, message);
+}
+
+prefix_ void senf::log::BinaryTarget::write(time_type timestamp, unsigned stream, unsigned area,
+                                            unsigned level, std::string const & message)
+{
+    if (SENF_UNLIKELY(pendingDrops_)) {
+        Record record = {};
+        record.type = Record::Dropped;
+        record.length = pendingDrops_;
+        record.timestamp = timestamp;
+        if (! writeRecord(record, 0)) {
+            ++ dropped_;
+            ++ pendingDrops_;
+            return;
+        }
+        pendingDrops_ = 0;
+    }
+    Record record = {};
+    record.type = Record::Message;
+    record.level = level;
+    record.id = stream;
+    record.area = area;
+    // Overly long messages are truncated, so they are not dropped in any case
+    record.length = std::min(message.size(), (mask_ + 1) / 4 - sizeof(Record));
+    record.timestamp = timestamp;
+    if (! writeRecord(record, message.data())) {
+        ++ dropped_;
+        ++ pendingDrops_;
+    }
+}
+
+prefix_ bool senf::log::BinaryTarget::writeName(Record::Type type, unsigned index,
+                                                std::string const & name)
+{
+    Record record = {};
+    record.type = type;
+    if (type == Record::StreamName)
+        record.id = index;
+    else
+        record.area = index;
+    record.length = std::min(name.size(), (mask_ + 1) / 4 - sizeof(Record));
+    return writeRecord(record, name.data());
+}
+
+prefix_ bool senf::log::BinaryTarget::writeRecord(Record & record, void const * data)
+{
+    record.size = align(sizeof(Record) + (data ? record.length : 0));
+    char * p (reserve(record.size));
+    if (! p)
+        return false;
+    ::memcpy(p, &record, sizeof(Record));
+    if (data)
+        ::memcpy(p + sizeof(Record), data, record.length);
+    head_.store(head_.load(std::memory_order_relaxed) + record.size, std::memory_order_release);
+    if (SENF_UNLIKELY(used() > (mask_ + 1) / 2))
+        wakeup_.notify_one();
+    return true;
+}
+
+prefix_ void senf::log::BinaryTarget::writeControl(Record & record, void const * data)
+{
+    // Control records must not be lost: make room if necessary
+    if (! writeRecord(record, data)) {
+        flush();
+        writeRecord(record, data);
+    }
+}
+
+prefix_ void senf::log::BinaryTarget::writeHeader()
+{
+    time_type now (TimeSource::now());
+    Header header = { { 'S', 'E', 'N', 'F', 'B', 'L', 'O', 'G' }, Header::Version,
+                      Header::ByteOrder,
+                      (ClockService::abstime(ClockService::nanoseconds(now)) - epoch)
+                      .total_microseconds() * 1000 };
+    Record record = {};
+    record.type = Record::Header;
+    record.length = sizeof(header);
+    record.timestamp = now;
+    writeControl(record, &header);
+}
+
+prefix_ char * senf::log::BinaryTarget::reserve(std::size_t size)
+{
+    std::uint64_t head (head_.load(std::memory_order_relaxed));
+    std::size_t offset (head & mask_);
+    std::size_t contiguous (mask_ + 1 - offset);
+    // Records never wrap: the rest of the buffer is skipped with a padding record
+    std::size_t need (size > contiguous ? size + contiguous : size);
+    if (head + need - tailCache_ > mask_ + 1) {
+        tailCache_ = tail_.load(std::memory_order_acquire);
+        if (head + need - tailCache_ > mask_ + 1)
+            return 0;
+    }
+    if (size > contiguous) {
+        std::uint32_t padding[2] = { std::uint32_t(contiguous), Record::Padding };
+        ::memcpy(buffer_.get() + offset, padding, sizeof(padding));
+        head_.store(head + contiguous, std::memory_order_release);
+        offset = 0;
+    }
+    return buffer_.get() + offset;
+}
+
+prefix_ std::size_t senf::log::BinaryTarget::used()
+    const
+{
+    return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+}
+
+prefix_ bool senf::log::BinaryTarget::known(std::vector<bool> & flags, unsigned index)
+{
+    if (index >= flags.size())
+        flags.resize(index + 1, false);
+    return flags[index];
+}
+
+prefix_ unsigned senf::log::BinaryTarget::intern(std::map<std::string,unsigned> & ids,
+                                                 Record::Type type, std::string const & name)
+{
+    std::map<std::string,unsigned>::iterator i (ids.find(name));
+    if (i != ids.end())
+        return i->second;
+    unsigned id (InternedId + ids.size());
+    if (! writeName(type, id, name))
+        return 0;
+    ids.insert(std::make_pair(name, id));
+    return id;
+}
+
+prefix_ void senf::log::BinaryTarget::run()
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+    for (;;) {
+        bool stop (stop_);
+        wakeup_.wait_for(lock, std::chrono::milliseconds(flushInterval_), [this] () {
+                return stop_ || flushRequested_ || used() > (mask_ + 1) / 2; });
+        stop = stop_;
+        flushRequested_ = false;
+        lock.unlock();
+        drain();
+        lock.lock();
+        drained_.notify_all();
+        if (stop)
+            break;
+    }
+}
+
+prefix_ void senf::log::BinaryTarget::drain()
+{
+    std::uint64_t tail (tail_.load(std::memory_order_relaxed));
+    std::uint64_t const head (head_.load(std::memory_order_acquire));
+    while (tail != head) {
+        // Collect a contiguous run of records up to the end of the buffer or a reopen request
+        std::size_t const offset (tail & mask_);
+        std::size_t run (0u);
+        Record const * reopen (0);
+        while (tail + run != head && (run == 0 || ((tail + run) & mask_) != 0)) {
+            Record const * record (
+                reinterpret_cast<Record const *>(buffer_.get() + ((tail + run) & mask_)));
+            if (record->size >= sizeof(Record) && record->type == Record::Reopen) {
+                reopen = record;
+                break;
+            }
+            run += record->size;
+        }
+        writeFile(buffer_.get() + offset, run);
+        tail += run;
+        if (reopen) {
+            std::string file;
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                file = reopenFile_;
+            }
+            openFile(file);
+            tail += reopen->size;
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+}
+
+prefix_ void senf::log::BinaryTarget::openFile(std::string const & file)
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = ::open(file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+}
+
+prefix_ void senf::log::BinaryTarget::writeFile(char const * data, std::size_t size)
+{
+    // There is no way to report errors: if the file cannot be written, messages are lost
+    while (size > 0 && fd_ >= 0) {
+        ssize_t n (::write(fd_, data, size));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        data += n;
+        size -= n;
+    }
+}
+
+prefix_ senf::log::BinaryTarget::RegisterConsole::RegisterConsole()
+{
+    namespace kw = console::kw;
+    namespace fty = console::factory;
+
+    detail::TargetRegistry::instance().consoleDir()
+        .add("binary-target", fty::Command(&RegisterConsole::create)
+             .arg("filename", "name of logfile")
+             .arg("nodename", "name of node in console. Defaults to the files basename",
+                  kw::default_value = "")
+             .doc("Create new binary file target. The file is converted to text with the\n"
+                  "'logdecode' utility. Example:\n"
+                  "\n"
+                  "Create new binary target '/var/log/example.blog\n"
+                  "    $ binary-target \"/var/log/example.blog\"\n"
+                  "    <Directory '/sys/log/example.blog'>\n") );
+}
+
+prefix_ boost::shared_ptr<senf::console::DirectoryNode>
+senf::log::BinaryTarget::RegisterConsole::create(std::string const & filename,
+                                                 std::string const & nodename)
+{
+    std::unique_ptr<Target> tp (new BinaryTarget(filename, nodename));
+    Target & target (*tp.get());
+    detail::TargetRegistry::instance().dynamicTarget(std::move(tp));
+    return target.consoleDir().node().thisptr();
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::log::BinaryLogReader
+
+prefix_ senf::log::BinaryLogReader::BinaryLogReader(std::istream & is)
+    : is_ (is), offset_ (0), session_ (false)
+{}
+
+prefix_ bool senf::log::BinaryLogReader::next(Entry & entry)
+{
+    while (readRecord()) {
+        switch (record_.type) {
+        case Record::Header: {
+            Header header;
+            if (payload_.size() < sizeof(header))
+                throw FormatException("truncated header");
+            ::memcpy(&header, payload_.data(), sizeof(header));
+            if (::memcmp(header.magic, "SENFBLOG", sizeof(header.magic)) != 0)
+                throw FormatException("bad magic");
+            if (header.byteOrder != Header::ByteOrder)
+                throw FormatException("unsupported byte order");
+            if (header.version != Header::Version)
+                throw FormatException("unsupported version");
+            // Translate into the local clock so ClockService::abstime() returns the original time
+            offset_ = ClockService::in_nanoseconds(
+                ClockService::clock(epoch + boost::posix_time::microseconds(header.wallclock / 1000)))
+                - record_.timestamp;
+            streams_.clear();
+            areas_.clear();
+            session_ = true;
+            break;
+        }
+        case Record::StreamName:
+            streams_[record_.id] = payload_;
+            break;
+        case Record::AreaName:
+            areas_[record_.area] = payload_;
+            break;
+        case Record::Message:
+            entry.timestamp = record_.timestamp + offset_;
+            entry.stream = name(streams_, record_.id);
+            entry.area = name(areas_, record_.area);
+            entry.level = record_.level;
+            entry.message = payload_;
+            entry.dropped = 0;
+            return true;
+        case Record::Dropped:
+            entry.timestamp = record_.timestamp + offset_;
+            entry.stream.clear();
+            entry.area.clear();
+            entry.level = 0;
+            entry.message.clear();
+            entry.dropped = record_.length;
+            return true;
+        default:
+            throw FormatException("unknown record type " + senf::str(record_.type));
+        }
+    }
+    return false;
+}
+
+prefix_ bool senf::log::BinaryLogReader::readRecord()
+{
+    for (;;) {
+        std::uint32_t start[2];
+        if (! is_.read(reinterpret_cast<char *>(start), sizeof(start))) {
+            if (is_.gcount() == 0)
+                return false;
+            throw FormatException("truncated record");
+        }
+        std::uint32_t size (start[0]);
+        if (size < MinRecordSize || size % detail::BinaryLogAlign != 0)
+            throw FormatException("bad record size");
+        if ((start[1] & 0xffffu) == Record::Padding) {
+            is_.ignore(size - sizeof(start));
+            continue;
+        }
+        if (size < sizeof(Record))
+            throw FormatException("bad record size");
+        ::memcpy(&record_, start, sizeof(start));
+        if (! is_.read(reinterpret_cast<char *>(&record_) + sizeof(start),
+                       sizeof(Record) - sizeof(start)))
+            throw FormatException("truncated record");
+        if (record_.type != Record::Header && ! session_)
+            throw FormatException("missing header");
+        payload_.resize(size - sizeof(Record));
+        if (! payload_.empty() && ! is_.read(&payload_[0], payload_.size()))
+            throw FormatException("truncated record");
+        if (record_.type != Record::Dropped) {
+            if (record_.length > payload_.size())
+                throw FormatException("bad record length");
+            payload_.resize(record_.length);
+        }
+        return true;
+    }
+}
+
+prefix_ std::string const & senf::log::BinaryLogReader::name(Names const & names,
+                                                             unsigned index)
+    const
+{
+    Names::const_iterator i (names.find(index));
+    if (i == names.end())
+        throw FormatException("undefined stream or area " + senf::str(index));
+    return i->second;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "BinaryTarget.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief BinaryTarget public header */
+
+#ifndef HH_SENF_Utils_Logger_BinaryTarget_
+#define HH_SENF_Utils_Logger_BinaryTarget_ 1
+
+// Custom includes
+#include <atomic>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <istream>
+#include <boost/scoped_array.hpp>
+#include <boost/shared_ptr.hpp>
+#include <senf/Utils/Exception.hh>
+#include "Target.hh"
+
+#include "BinaryTarget.ih"
+//#include "BinaryTarget.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    namespace console { class DirectoryNode; }
+
+namespace log {
+
+    /** \brief Asynchronous binary %log file target
+
+        The BinaryTarget writes %log messages into a compact binary %log file. Messages are
+        neither formatted nor written by the thread emitting them: The message text together
+        with the timestamp, the level and the stream and area \e index is copied into a
+        preallocated lock-free ring buffer. A background thread drains the buffer and writes the
+        file. Stream and area names are only recorded once per file.
+
+        \code
+        senf::log::BinaryTarget target ("app.blog");
+
+        // Route all messages to this file.
+        target.route();
+        \endcode
+
+        The \c logdecode utility converts the file into the text format of the FileTarget, a
+        program may read it using BinaryLogReader.
+
+        Writing a message never blocks: If the buffer is full, the message is dropped. The number
+        of dropped messages is recorded in the %log file and available via dropped().
+
+        The buffer is drained whenever it is half full but at least every flushInterval()
+        milliseconds. All messages are written on destruction of the target or by an explicit
+        flush().
+
+        After %log files have been rotated, the reopen() member should be called to create a new
+        %log file.
+
+        \note The ring buffer has a single producer: As any other %log target, the BinaryTarget
+            must only be written to from a single thread.
+
+        \ingroup targets
+      */
+    class BinaryTarget
+        : public Target
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        explicit BinaryTarget(std::string const & filename, std::string const & nodename = "",
+                              unsigned bufferSize = 1024u*1024u);
+                                        ///< Construct BinaryTarget writing to \a filename
+                                        /**< \param[in] filename %log file name
+                                             \param[in] nodename console directory name,
+                                                 defaults to the files basename
+                                             \param[in] bufferSize ring buffer size in bytes,
+                                                 rounded up to the next power of 2 */
+        ~BinaryTarget();
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+
+        void reopen();                  ///< Reopen %log after log-file rotation
+        void reopen(std::string const & file);  ///< Reopen %log under a new name
+        void flush();                   ///< Wait until all buffered messages are written
+
+        std::string const & filename() const; ///< Return current log file name
+        unsigned bufferSize() const;    ///< Ring buffer size in bytes
+        unsigned dropped() const;       ///< Number of messages dropped since construction
+
+        unsigned flushInterval() const; ///< Maximum buffering delay in milliseconds
+        void flushInterval(unsigned ms); ///< Set maximum buffering delay in milliseconds
+
+    private:
+        void v_writeRaw(time_type timestamp, detail::StreamBase const & stream,
+                        detail::AreaBase const & area, unsigned level,
+                        std::string const & message) override;
+        void v_write(time_type timestamp, std::string const & stream,
+                     std::string const & area, unsigned level,
+                     std::string const & message) override;
+
+        void write(time_type timestamp, unsigned stream, unsigned area, unsigned level,
+                   std::string const & message);
+        bool writeName(detail::BinaryLogRecord::Type type, unsigned index,
+                       std::string const & name);
+        bool writeRecord(detail::BinaryLogRecord & record, void const * data);
+        void writeControl(detail::BinaryLogRecord & record, void const * data);
+        void writeHeader();
+        char * reserve(std::size_t size);
+        std::size_t used() const;
+        bool known(std::vector<bool> & flags, unsigned index);
+        unsigned intern(std::map<std::string,unsigned> & ids, detail::BinaryLogRecord::Type type,
+                        std::string const & name);
+
+        void run();
+        void drain();
+        void openFile(std::string const & file);
+        void writeFile(char const * data, std::size_t size);
+
+        std::string file_;
+        std::size_t mask_;
+        boost::scoped_array<char> buffer_;
+
+        // producer (logging thread) state
+        std::atomic<std::uint64_t> head_;
+        std::uint64_t tailCache_;
+        std::vector<bool> knownStreams_;
+        std::vector<bool> knownAreas_;
+        std::map<std::string,unsigned> streamIds_;
+        std::map<std::string,unsigned> areaIds_;
+        std::atomic<unsigned> dropped_;
+        unsigned pendingDrops_;
+
+        // consumer (writer thread) state
+        std::atomic<std::uint64_t> tail_;
+        int fd_;
+
+        std::mutex mutex_;
+        std::condition_variable wakeup_;
+        std::condition_variable drained_;
+        std::string reopenFile_;
+        unsigned flushInterval_;
+        bool flushRequested_;
+        bool stop_;
+        std::thread thread_;
+
+        struct RegisterConsole {
+            RegisterConsole();
+            static boost::shared_ptr<senf::console::DirectoryNode> create(
+                std::string const & filename, std::string const & nodename);
+            static RegisterConsole instance;
+        };
+    };
+
+    /** \brief Read binary %log files
+
+        The BinaryLogReader reads %log files written by BinaryTarget:
+
+        \code
+        std::ifstream is ("app.blog");
+        senf::log::BinaryLogReader reader (is);
+        senf::log::BinaryLogReader::Entry entry;
+        while (reader.next(entry))
+            std::cout << entry.area << ": " << entry.message << std::endl;
+        \endcode
+
+        Timestamps are translated into the ClockService time of the reading process:
+        senf::ClockService::abstime() returns the absolute time the message was written at.
+
+        \see BinaryTarget
+     */
+    class BinaryLogReader
+    {
+    public:
+        struct Entry
+        {
+            time_type timestamp;        ///< Message time
+            std::string stream;         ///< Stream name
+            std::string area;           ///< Area name
+            unsigned level;             ///< Message level
+            std::string message;        ///< Message text
+            unsigned dropped;           ///< Number of messages lost at this point
+                                        /**< If not 0, this entry does not contain a message
+                                             but records the loss of messages */
+        };
+
+        /** \brief Invalid binary %log file */
+        struct FormatException : public senf::Exception
+        { explicit FormatException(std::string const & msg)
+              : senf::Exception("invalid binary log file: " + msg) {} };
+
+        explicit BinaryLogReader(std::istream & is);
+
+        bool next(Entry & entry);       ///< Read next entry
+                                        /**< \returns \c false at end of file
+                                             \throws FormatException */
+
+    private:
+        typedef std::map<unsigned, std::string> Names;
+
+        bool readRecord();
+        std::string const & name(Names const & names, unsigned index) const;
+
+        std::istream & is_;
+        detail::BinaryLogRecord record_;
+        std::string payload_;
+        Names streams_;
+        Names areas_;
+        time_type offset_;
+        bool session_;
+    };
+
+}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "BinaryTarget.cci"
+//#include "BinaryTarget.ct"
+//#include "BinaryTarget.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
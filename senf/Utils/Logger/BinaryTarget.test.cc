@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief BinaryTarget unit tests */
+
+#include "BinaryTarget.hh"
+
+// Custom includes
+#include <fstream>
+#include <boost/filesystem/operations.hpp>
+#include <senf/Scheduler/ClockService.hh>
+#include "main.test.hh"
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    std::vector<senf::log::BinaryLogReader::Entry> readLog(std::string const & filename)
+    {
+        std::vector<senf::log::BinaryLogReader::Entry> entries;
+        std::ifstream is (filename.c_str());
+        senf::log::BinaryLogReader reader (is);
+        senf::log::BinaryLogReader::Entry entry;
+        while (reader.next(entry))
+            entries.push_back(entry);
+        return entries;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(binaryTarget)
+{
+    std::string filename ("/tmp/senf_binaryTarget_test.blog");
+    boost::filesystem::remove(filename);
+    senf::ClockService::clock_type start (senf::ClockService::now());
+
+    {
+        senf::log::BinaryTarget target (filename);
+        target.route();
+
+        SENF_LOG(("Test message"));
+        SENF_LOG((senf::log::test::myStream)(senf::log::test::myArea)(senf::log::IMPORTANT)
+                 ("Another message"));
+        SENF_LOG((senf::log::test::myStream)(senf::log::test::myArea)(senf::log::CRITICAL)
+                 ("Third message"));
+        target.flush();
+
+        std::vector<senf::log::BinaryLogReader::Entry> entries (readLog(filename));
+        BOOST_REQUIRE_EQUAL( entries.size(), 3u );
+        BOOST_CHECK_EQUAL( entries[0].stream, "senf::log::Debug" );
+        BOOST_CHECK_EQUAL( entries[0].area, "senf::log::DefaultArea" );
+        BOOST_CHECK_EQUAL( entries[0].level, unsigned(senf::log::MESSAGE::value) );
+        BOOST_CHECK_EQUAL( entries[0].message, "Test message" );
+        BOOST_CHECK_EQUAL( entries[1].stream, "senf::log::test::myStream" );
+        BOOST_CHECK_EQUAL( entries[1].area, "senf::log::test::myArea" );
+        BOOST_CHECK_EQUAL( entries[1].level, unsigned(senf::log::IMPORTANT::value) );
+        BOOST_CHECK_EQUAL( entries[1].message, "Another message" );
+        BOOST_CHECK_EQUAL( entries[2].level, unsigned(senf::log::CRITICAL::value) );
+        BOOST_CHECK_EQUAL( entries[2].message, "Third message" );
+        BOOST_CHECK( entries[0].timestamp <= entries[1].timestamp );
+        BOOST_CHECK( entries[1].timestamp <= entries[2].timestamp );
+        // The reader translates timestamps into the local clock
+        BOOST_CHECK_PREDICATE( std::less_equal<senf::ClockService::int64_type>(),
+                               (senf::ClockService::in_milliseconds(start) - 1)
+                               (senf::ClockService::in_milliseconds(entries[0].timestamp)) );
+        BOOST_CHECK_PREDICATE( std::less_equal<senf::ClockService::int64_type>(),
+                               (senf::ClockService::in_milliseconds(entries[2].timestamp))
+                               (senf::ClockService::in_milliseconds(senf::ClockService::now()) + 1) );
+
+        // After rotation, names are written again to the new file
+        std::string rotated (filename + ".1");
+        boost::filesystem::rename(filename, rotated);
+        target.reopen();
+        SENF_LOG((senf::log::test::myStream)(senf::log::test::myArea)(senf::log::IMPORTANT)
+                 ("After reopen"));
+        target.flush();
+
+        BOOST_CHECK_EQUAL( readLog(rotated).size(), 3u );
+        entries = readLog(filename);
+        BOOST_REQUIRE_EQUAL( entries.size(), 1u );
+        BOOST_CHECK_EQUAL( entries[0].stream, "senf::log::test::myStream" );
+        BOOST_CHECK_EQUAL( entries[0].area, "senf::log::test::myArea" );
+        BOOST_CHECK_EQUAL( entries[0].message, "After reopen" );
+        BOOST_CHECK_EQUAL( target.dropped(), 0u );
+
+        SENF_CHECK_NO_THROW( boost::filesystem::remove(rotated) );
+    }
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+}
+
+SENF_AUTO_TEST_CASE(binaryTarget_dropped)
+{
+    std::string filename ("/tmp/senf_binaryTarget_test2.blog");
+    boost::filesystem::remove(filename);
+    unsigned const count (200);
+    unsigned dropped;
+
+    {
+        senf::log::BinaryTarget target (filename, "", 4096u);
+        BOOST_CHECK_EQUAL( target.bufferSize(), 4096u );
+        target.route();
+
+        std::string message (400, 'x');
+        for (unsigned i (0); i < count; ++i)
+            SENF_LOG((message));
+        // Overly long messages are truncated
+        SENF_LOG((std::string(8192, 'y')));
+        dropped = target.dropped();
+    }
+
+    std::vector<senf::log::BinaryLogReader::Entry> entries (readLog(filename));
+    unsigned messages (0), lost (0);
+    for (unsigned i (0); i < entries.size(); ++i) {
+        if (entries[i].dropped)
+            lost += entries[i].dropped;
+        else if (entries[i].message[0] == 'x') {
+            BOOST_CHECK_EQUAL( entries[i].message.size(), 400u );
+            ++ messages;
+        }
+        else
+            BOOST_CHECK_EQUAL( entries[i].message.size(), 1024u - 32u );
+    }
+    // The last drop count may not have been recorded if no message followed
+    BOOST_CHECK( lost <= dropped );
+    BOOST_CHECK( messages + dropped >= count );
+    BOOST_CHECK( messages + lost <= count );
+
+    SENF_CHECK_NO_THROW( boost::filesystem::remove(filename) );
+}
+
+SENF_AUTO_TEST_CASE(binaryLogReader)
+{
+    std::stringstream ss ("garbage, not a binary log file .......");
+    senf::log::BinaryLogReader reader (ss);
+    senf::log::BinaryLogReader::Entry entry;
+    BOOST_CHECK_THROW( reader.next(entry), senf::log::BinaryLogReader::FormatException );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -303,11 +303,19 @@ prefix_ void senf::log::Target::write(time_type timestamp,
              (! i->area_ || i->area_ == &area) &&
              (i->level_ == NONE::value ? stream.defaultRuntimeLimit() : i->level_) <= level ) {
             if (i->action_ == ACCEPT)
-                v_write(timestamp, stream.v_name(), area.v_name(), level, message);
+                v_writeRaw(timestamp, stream, area, level, message);
             return;
         }
 }
 
+prefix_ void senf::log::Target::v_writeRaw(time_type timestamp,
+                                           detail::StreamBase const & stream,
+                                           detail::AreaBase const & area, unsigned level,
+                                           std::string const & message)
+{
+    v_write(timestamp, stream.v_name(), area.v_name(), level, message);
+}
+
 namespace {
     std::string formatLabel(std::string const & l)
     {
@@ -578,6 +586,7 @@ senf_console_parse_argument(console::ParseCommandInfo::TokensRange const & token
 senf::log::FileTarget::RegisterConsole senf::log::FileTarget::RegisterConsole::instance;
 senf::log::SyslogTarget::RegisterConsole senf::log::SyslogTarget::RegisterConsole::instance;
 senf::log::SyslogUDPTarget::RegisterConsole senf::log::SyslogUDPTarget::RegisterConsole::instance;
+senf::log::BinaryTarget::RegisterConsole senf::log::BinaryTarget::RegisterConsole::instance;
 
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
 #undef prefix_
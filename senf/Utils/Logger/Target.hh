@@ -366,6 +366,16 @@ namespace log {
     protected:
 #   endif
 
+        virtual void v_writeRaw(time_type timestamp, detail::StreamBase const & stream,
+                                detail::AreaBase const & area, unsigned level,
+                                std::string const & message);
+                                        ///< Called to write out the routing message
+                                        /**< This member is called with the stream and area
+                                             objects instead of their names. The default
+                                             implementation calls v_write(). Targets which
+                                             identify streams and areas by their \c index need
+                                             not format the names for every message. */
+
         virtual void v_write(time_type timestamp, std::string const & stream,
                              std::string const & area, unsigned level,
                              std::string const & message) = 0;
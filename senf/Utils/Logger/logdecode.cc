@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+
+/** \file
+    \brief logdecode non-inline non-template implementation */
+
+// Custom includes
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <senf/Utils/String.hh>
+#include "BinaryTarget.hh"
+#include "IOStreamTarget.hh"
+
+//#include "logdecode.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    struct Output
+        : public senf::log::IOStreamTarget
+    {
+        Output() : senf::log::IOStreamTarget("logdecode", std::cout) {}
+        using senf::log::IOStreamTarget::v_write;
+    };
+
+    int usage(char const * name)
+    {
+        std::cerr << "usage: " << name << " [options] [file...]\n"
+                  << "\n"
+                  << "Convert binary log files written by senf::log::BinaryTarget to text.\n"
+                  << "Reads standard input if no file is given.\n"
+                  << "\n"
+                  << "    --no-time            don't show the timestamp\n"
+                  << "    --no-stream          don't show the stream name\n"
+                  << "    --no-level           don't show the log level\n"
+                  << "    --no-area            don't show the area name\n"
+                  << "    --time-format=FMT    strftime style time format (empty: relative time)\n"
+                  << "    --tag=TAG            prefix every line with TAG\n";
+        return 1;
+    }
+
+    bool decode(std::istream & is, std::string const & name, Output & out)
+    {
+        senf::log::BinaryLogReader reader (is);
+        senf::log::BinaryLogReader::Entry entry;
+        try {
+            while (reader.next(entry)) {
+                if (entry.dropped)
+                    out.v_write(entry.timestamp, "", "", senf::log::IMPORTANT::value,
+                                senf::str(entry.dropped) + " messages dropped");
+                else
+                    out.v_write(entry.timestamp, entry.stream, entry.area, entry.level,
+                                entry.message);
+            }
+        }
+        catch (senf::log::BinaryLogReader::FormatException & ex) {
+            std::cout << std::flush;
+            std::cerr << name << ": " << ex.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char const ** argv)
+{
+    Output out;
+    out.tag("");
+    std::vector<std::string> files;
+
+    for (int i (1); i < argc; ++i) {
+        std::string arg (argv[i]);
+        if (arg == "--no-time")
+            out.showTime(false);
+        else if (arg == "--no-stream")
+            out.showStream(false);
+        else if (arg == "--no-level")
+            out.showLevel(false);
+        else if (arg == "--no-area")
+            out.showArea(false);
+        else if (arg.compare(0, 14, "--time-format=") == 0)
+            out.timeFormat(arg.substr(14));
+        else if (arg.compare(0, 6, "--tag=") == 0)
+            out.tag(arg.substr(6));
+        else if (arg == "--help" || (arg.size() > 1 && arg[0] == '-'))
+            return usage(argv[0]);
+        else
+            files.push_back(arg);
+    }
+
+    if (files.empty())
+        files.push_back("-");
+
+    bool ok (true);
+    for (std::vector<std::string>::const_iterator i (files.begin()); i != files.end(); ++i) {
+        if (*i == "-") {
+            ok = decode(std::cin, "<stdin>", out) && ok;
+            continue;
+        }
+        std::ifstream is (i->c_str(), std::ios::binary);
+        if (! is) {
+            std::cerr << *i << ": " << std::strerror(errno) << std::endl;
+            ok = false;
+            continue;
+        }
+        ok = decode(is, *i, out) && ok;
+    }
+    return ok ? 0 : 1;
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "logdecode.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,284 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Metrics non-inline non-template implementation */
+
+#include "Metrics.hh"
+//#include "Metrics.ih"
+
+// Custom includes
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include <boost/bind.hpp>
+#include "Console/ScopedDirectory.hh"
+#include "Console/Sysdir.hh"
+#include "Console/ParsedCommand.hh"
+#include "Histogram.hh"
+#include "Statistics.hh"
+
+//#include "Metrics.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    char const * typeNames[] = { "counter", "gauge", "summary" };
+
+    bool validName(std::string const & name, bool allowColon)
+    {
+        if (name.empty())
+            return false;
+        for (std::string::const_iterator i (name.begin()); i != name.end(); ++i)
+            if (! ((*i >= 'a' && *i <= 'z') || (*i >= 'A' && *i <= 'Z') || *i == '_'
+                   || (allowColon && *i == ':')
+                   || (*i >= '0' && *i <= '9' && i != name.begin())))
+                return false;
+        return true;
+    }
+
+    void writeCounter(senf::metrics::Registry::ValueFn const & value, senf::metrics::Writer & w,
+                      std::string const & name, senf::metrics::Labels const & labels)
+    {
+        w.sample(name + "_total", labels, value());
+    }
+
+    void writeGauge(senf::metrics::Registry::ValueFn const & value, senf::metrics::Writer & w,
+                    std::string const & name, senf::metrics::Labels const & labels)
+    {
+        w.sample(name, labels, value());
+    }
+
+    void writeSummary(senf::Histogram const & h, double scale, senf::metrics::Writer & w,
+                      std::string const & name, senf::metrics::Labels const & labels)
+    {
+        static char const * quantiles[] = { "0.5", "0.9", "0.99", "0.999" };
+        static double const percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+        for (unsigned i (0); i < sizeof(quantiles)/sizeof(quantiles[0]); ++i)
+            w.sample(name, labels, "quantile", quantiles[i],
+                     double(h.percentile(percentiles[i])) * scale);
+        w.sample(name + "_count", labels, double(h.count()));
+        w.sample(name + "_sum", labels, h.mean() * double(h.count()) * scale);
+    }
+
+    void writeStatistics(senf::StatisticsBase const & stats, senf::metrics::Writer & w,
+                         std::string const & name, senf::metrics::Labels const & labels)
+    {
+        w.sample(name, labels, "stat", "cnt", stats.cnt());
+        w.sample(name, labels, "stat", "min", stats.min());
+        w.sample(name, labels, "stat", "avg", stats.avg());
+        w.sample(name, labels, "stat", "max", stats.max());
+        w.sample(name, labels, "stat", "dev", stats.dev());
+    }
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::metrics::Writer
+
+prefix_ void senf::metrics::Writer::family(std::string const & name, Type type,
+                                           std::string const & help)
+{
+    os_ << "# TYPE " << name << ' ' << typeNames[type] << '\n';
+    if (help.empty())
+        return;
+    os_ << "# HELP " << name << ' ';
+    for (std::string::const_iterator i (help.begin()); i != help.end(); ++i)
+        switch (*i) {
+        case '\\': os_ << "\\\\"; break;
+        case '\n': os_ << "\\n"; break;
+        default:   os_ << *i;
+        }
+    os_ << '\n';
+}
+
+prefix_ void senf::metrics::Writer::sample(std::string const & name, Labels const & labels,
+                                           double v)
+{
+    os_ << name;
+    writeLabels(labels, std::string(), std::string());
+    os_ << ' ';
+    value(os_, v);
+    os_ << '\n';
+}
+
+prefix_ void senf::metrics::Writer::sample(std::string const & name, Labels const & labels,
+                                           std::string const & label,
+                                           std::string const & labelValue, double v)
+{
+    os_ << name;
+    writeLabels(labels, label, labelValue);
+    os_ << ' ';
+    value(os_, v);
+    os_ << '\n';
+}
+
+prefix_ void senf::metrics::Writer::eof()
+{
+    os_ << "# EOF\n";
+}
+
+prefix_ void senf::metrics::Writer::value(std::ostream & os, double value)
+{
+    if (std::isnan(value))
+        os << "NaN";
+    else if (std::isinf(value))
+        os << (value > 0 ? "+Inf" : "-Inf");
+    else if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0)
+        // Exactly representable integer: avoid exponent notation for counters
+        os << static_cast<long long>(value);
+    else {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        os << buffer;
+    }
+}
+
+prefix_ void senf::metrics::Writer::writeLabels(Labels const & labels, std::string const & label,
+                                                std::string const & labelValue)
+{
+    if (labels.empty() && label.empty())
+        return;
+    os_ << '{';
+    bool first (true);
+    for (Labels::const_iterator i (labels.begin()); i != labels.end(); ++i) {
+        if (! first) os_ << ',';
+        first = false;
+        os_ << i->first << "=\"";
+        for (std::string::const_iterator j (i->second.begin()); j != i->second.end(); ++j)
+            switch (*j) {
+            case '\\': os_ << "\\\\"; break;
+            case '"':  os_ << "\\\""; break;
+            case '\n': os_ << "\\n"; break;
+            default:   os_ << *j;
+            }
+        os_ << '"';
+    }
+    if (! label.empty()) {
+        if (! first) os_ << ',';
+        // additional labels are generated internally and never need escaping
+        os_ << label << "=\"" << labelValue << '"';
+    }
+    os_ << '}';
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::metrics::Registry
+
+prefix_ senf::metrics::Registry::Registry()
+{
+    namespace fty = console::factory;
+
+    console::sysdir().add("metrics", fty::Command(&Registry::write, this)
+        .doc("Write all registered metrics in OpenMetrics text format.") );
+}
+
+prefix_ senf::metrics::Registration
+senf::metrics::Registry::add(std::string const & name, Type type, std::string const & help,
+                             Collector const & collector, Labels const & labels)
+{
+    if (! validName(name, true))
+        throw InvalidMetricException() << ": invalid name '" << name << "'";
+    for (Labels::const_iterator i (labels.begin()); i != labels.end(); ++i)
+        if (! validName(i->first, false))
+            throw InvalidMetricException() << ": invalid label name '" << i->first << "'";
+
+    detail::MetricFamilies::iterator f (families_.find(name));
+    if (f == families_.end()) {
+        f = families_.insert(std::make_pair(name, detail::MetricFamily())).first;
+        f->second.type = type;
+        f->second.help = help;
+    }
+    else {
+        if (f->second.type != type)
+            throw InvalidMetricException() << ": '" << name << "' registered with different type";
+        for (detail::MetricEntries::const_iterator i (f->second.entries.begin());
+             i != f->second.entries.end(); ++i)
+            if (i->labels == labels)
+                throw DuplicateMetricException() << ": " << name;
+    }
+
+    detail::MetricEntry entry;
+    entry.labels = labels;
+    entry.collector = collector;
+    f->second.entries.push_back(entry);
+    return Registration(f, --f->second.entries.end());
+}
+
+prefix_ senf::metrics::Registration
+senf::metrics::Registry::counter(std::string const & name, std::string const & help,
+                                 ValueFn const & value, Labels const & labels)
+{
+    return add(name, Counter, help, boost::bind(&writeCounter, value, _1, _2, _3), labels);
+}
+
+prefix_ senf::metrics::Registration
+senf::metrics::Registry::gauge(std::string const & name, std::string const & help,
+                               ValueFn const & value, Labels const & labels)
+{
+    return add(name, Gauge, help, boost::bind(&writeGauge, value, _1, _2, _3), labels);
+}
+
+prefix_ senf::metrics::Registration
+senf::metrics::Registry::summary(std::string const & name, std::string const & help,
+                                 Histogram const & histogram, double scale, Labels const & labels)
+{
+    return add(name, Summary, help,
+               boost::bind(&writeSummary, boost::cref(histogram), scale, _1, _2, _3), labels);
+}
+
+prefix_ senf::metrics::Registration
+senf::metrics::Registry::statistics(std::string const & name, std::string const & help,
+                                    StatisticsBase const & stats, Labels const & labels)
+{
+    return add(name, Gauge, help,
+               boost::bind(&writeStatistics, boost::cref(stats), _1, _2, _3), labels);
+}
+
+prefix_ void senf::metrics::Registry::write(std::ostream & os)
+    const
+{
+    Writer w (os);
+    for (detail::MetricFamilies::const_iterator f (families_.begin()); f != families_.end(); ++f) {
+        w.family(f->first, Type(f->second.type), f->second.help);
+        for (detail::MetricEntries::const_iterator i (f->second.entries.begin());
+             i != f->second.entries.end(); ++i)
+            i->collector(w, f->first, i->labels);
+    }
+    w.eof();
+}
+
+prefix_ void senf::metrics::Registry::remove(detail::MetricFamilies::iterator family,
+                                             detail::MetricEntries::iterator entry)
+{
+    family->second.entries.erase(entry);
+    if (family->second.entries.empty())
+        families_.erase(family);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "Metrics.mpp"
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
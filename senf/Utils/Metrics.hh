@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Metrics public header */
+
+#ifndef HH_SENF_Utils_Metrics_
+#define HH_SENF_Utils_Metrics_ 1
+
+// Custom includes
+#include <map>
+#include <list>
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <boost/function.hpp>
+#include "Exception.hh"
+#include "singleton.hh"
+
+//#include "Metrics.mpp"
+#include "Metrics.ih"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    class Histogram;
+    class StatisticsBase;
+
+/** \brief Metrics registry and OpenMetrics export
+
+    The metrics registry collects named counters, gauges and summaries from all over the
+    application and writes them in the <a href="https://openmetrics.io">OpenMetrics</a> text
+    format. The output is available on the console as <tt>/sys/metrics</tt> and may be served to
+    a monitoring system (e.g. Prometheus) using senf::metrics::Server.
+
+    Metrics are not copied into the registry. A registered metric is a callback which reads the
+    current value directly from it's source whenever the metrics are written. Thus recording a
+    value is just the update of the plain counter the code already keeps, the packet path never
+    touches the registry and is never blocked by a scrape.
+
+    \code
+      senf::metrics::Registration reg (
+          senf::metrics::Registry::instance().counter(
+              "myapp_packets", "Number of packets received",
+              [this]() { return double(packets_); }));
+    \endcode
+
+    Every registration is represented by a senf::metrics::Registration instance. The metric is
+    removed from the registry when the Registration is destroyed. Several metrics with the same
+    name but different labels form a metric family.
+
+    \warning The registry is not thread safe. All registrations and all output must happen from
+        the same thread (normally the main scheduler thread). Callbacks reading values updated by
+        other threads must use atomic values or a senf::HistogramRecorder.
+ */
+namespace metrics {
+
+    /** \brief OpenMetrics metric type */
+    enum Type { Counter, Gauge, Summary };
+
+    /** \brief Metric labels
+
+        Sequence of (name, value) pairs.
+     */
+    typedef detail::MetricLabels Labels;
+
+    /** \brief OpenMetrics text format writer
+
+        Writer formats metric families and samples in the OpenMetrics text exposition format
+        including name and label escaping. It is passed to the metric callbacks.
+     */
+    class Writer
+    {
+    public:
+        explicit Writer(std::ostream & os);
+
+        void family(std::string const & name, Type type, std::string const & help);
+                                        ///< Start new metric family
+        void sample(std::string const & name, Labels const & labels, double value);
+                                        ///< Write sample
+        void sample(std::string const & name, Labels const & labels, std::string const & label,
+                    std::string const & labelValue, double value);
+                                        ///< Write sample with additional label
+        void eof();                     ///< Terminate exposition
+
+        static void value(std::ostream & os, double value);
+                                        ///< Write value in OpenMetrics number format
+
+    private:
+        void writeLabels(Labels const & labels, std::string const & label,
+                         std::string const & labelValue);
+
+        std::ostream & os_;
+    };
+
+    /** \brief Registration handle
+
+        A Registration keeps a metric registered. The metric is removed from the registry when the
+        Registration is destroyed or reset. Registrations may be moved but not copied.
+     */
+    class Registration
+    {
+    public:
+        Registration();
+        Registration(Registration && other);
+        ~Registration();
+        Registration & operator=(Registration && other);
+
+        void reset();                   ///< Remove metric from registry
+        explicit operator bool() const; ///< \c true, if a metric is registered
+
+    private:
+        Registration(detail::MetricFamilies::iterator family,
+                     detail::MetricEntries::iterator entry);
+
+        Registration(Registration const &);
+        Registration & operator=(Registration const &);
+
+        detail::MetricFamilies::iterator family_;
+        detail::MetricEntries::iterator entry_;
+        bool valid_;
+
+        friend class Registry;
+    };
+
+    /** \brief Registry of all metrics
+
+        \see \ref senf::metrics
+     */
+    class Registry
+        : public senf::singleton<Registry>
+    {
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // Types
+
+        typedef detail::MetricEntry::Collector Collector;
+        typedef boost::function<double ()> ValueFn;
+
+        using senf::singleton<Registry>::instance;
+
+        //-////////////////////////////////////////////////////////////////////////
+
+        Registration add(std::string const & name, Type type, std::string const & help,
+                         Collector const & collector, Labels const & labels = Labels());
+                                        ///< Register arbitrary metric
+                                        /**< The \a collector is called with a Writer, the metric
+                                             name and the labels and must write all samples of the
+                                             metric.
+                                             \throws InvalidMetricException if \a name or a label
+                                                 name is invalid or the family is already
+                                                 registered with a different type
+                                             \throws DuplicateMetricException if a metric with the
+                                                 same name and labels is registered */
+        Registration counter(std::string const & name, std::string const & help,
+                             ValueFn const & value, Labels const & labels = Labels());
+                                        ///< Register counter
+                                        /**< The value returned by \a value must never decrease.
+                                             The sample name is \a name with a \c _total suffix. */
+        Registration gauge(std::string const & name, std::string const & help,
+                           ValueFn const & value, Labels const & labels = Labels());
+                                        ///< Register gauge
+        Registration summary(std::string const & name, std::string const & help,
+                             Histogram const & histogram, double scale = 1.0,
+                             Labels const & labels = Labels());
+                                        ///< Register histogram as summary
+                                        /**< Writes the 0.5, 0.9, 0.99 and 0.999 quantiles and the
+                                             count and sum of \a histogram. All values are
+                                             multiplied by \a scale (e.g. 1e-9 to export
+                                             nanoseconds in the OpenMetrics base unit seconds). */
+        Registration statistics(std::string const & name, std::string const & help,
+                                StatisticsBase const & stats, Labels const & labels = Labels());
+                                        ///< Register Statistics collector
+                                        /**< Writes the last entered cnt, min, avg, max and dev
+                                             values of \a stats as gauge with an additional \c stat
+                                             label. */
+
+        void write(std::ostream & os) const; ///< Write all metrics in OpenMetrics text format
+        unsigned size() const;          ///< Number of registered metric families
+
+        struct InvalidMetricException : public senf::Exception
+        { InvalidMetricException() : senf::Exception("Invalid metric") {} };
+
+        struct DuplicateMetricException : public senf::Exception
+        { DuplicateMetricException() : senf::Exception("Duplicate metric") {} };
+
+    private:
+        Registry();
+
+        void remove(detail::MetricFamilies::iterator family, detail::MetricEntries::iterator entry);
+
+        detail::MetricFamilies families_;
+
+        friend class senf::singleton<Registry>;
+        friend class Registration;
+    };
+
+}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "Metrics.cci"
+//#include "Metrics.ct"
+//#include "Metrics.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief Metrics unit tests */
+
+#include "Metrics.hh"
+
+// Custom includes
+#include <sstream>
+#include <limits>
+#include "Histogram.hh"
+#include "Statistics.hh"
+
+// Unit test includes
+#include "auto_unit_test.hh"
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    std::string metricsOutput()
+    {
+        std::stringstream ss;
+        senf::metrics::Registry::instance().write(ss);
+        return ss.str();
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(metricsWriter)
+{
+    std::stringstream ss;
+    senf::metrics::Writer w (ss);
+    senf::metrics::Labels labels;
+    labels.push_back(std::make_pair("if", "eth\"0\"\n"));
+
+    w.family("test", senf::metrics::Gauge, "Help with \\ and\nnewline");
+    w.sample("test", labels, 1.5);
+    w.sample("test", labels, "stat", "min", -3.0);
+    w.sample("test", senf::metrics::Labels(), std::numeric_limits<double>::infinity());
+    w.sample("test", senf::metrics::Labels(), "q", "x", std::numeric_limits<double>::quiet_NaN());
+    w.sample("test", senf::metrics::Labels(), 18446744073709551616.0);
+    w.eof();
+
+    BOOST_CHECK_EQUAL( ss.str(),
+                       "# TYPE test gauge\n"
+                       "# HELP test Help with \\\\ and\\nnewline\n"
+                       "test{if=\"eth\\\"0\\\"\\n\"} 1.5\n"
+                       "test{if=\"eth\\\"0\\\"\\n\",stat=\"min\"} -3\n"
+                       "test +Inf\n"
+                       "test{q=\"x\"} NaN\n"
+                       "test 1.8446744073709552e+19\n"
+                       "# EOF\n" );
+}
+
+SENF_AUTO_TEST_CASE(metricsRegistry)
+{
+    senf::metrics::Registry & registry (senf::metrics::Registry::instance());
+    unsigned families (registry.size());
+
+    unsigned packets (10u);
+    double level (0.25);
+    senf::metrics::Labels eth0;
+    eth0.push_back(std::make_pair("if", "eth0"));
+    senf::metrics::Labels eth1;
+    eth1.push_back(std::make_pair("if", "eth1"));
+
+    {
+        senf::metrics::Registration c0 (registry.counter(
+            "test_packets", "Packets", [&packets]() { return double(packets); }, eth0));
+        senf::metrics::Registration c1 (registry.counter(
+            "test_packets", "Packets", []() { return 3.0; }, eth1));
+        senf::metrics::Registration g (registry.gauge(
+            "test_level", "", [&level]() { return level; }));
+        BOOST_CHECK_EQUAL( registry.size(), families + 2u );
+
+        BOOST_CHECK_THROW( registry.counter("test_packets", "", []() { return 0.0; }, eth0),
+                           senf::metrics::Registry::DuplicateMetricException );
+        BOOST_CHECK_THROW( registry.gauge("test_packets", "", []() { return 0.0; }),
+                           senf::metrics::Registry::InvalidMetricException );
+        BOOST_CHECK_THROW( registry.gauge("0test", "", []() { return 0.0; }),
+                           senf::metrics::Registry::InvalidMetricException );
+        senf::metrics::Labels bad;
+        bad.push_back(std::make_pair("a:b", "x"));
+        BOOST_CHECK_THROW( registry.gauge("test_bad", "", []() { return 0.0; }, bad),
+                           senf::metrics::Registry::InvalidMetricException );
+        BOOST_CHECK_EQUAL( registry.size(), families + 2u );
+
+        packets = 42u;
+        std::string out (metricsOutput());
+        BOOST_CHECK( out.find("# TYPE test_level gauge\n"
+                              "test_level 0.25\n") != std::string::npos );
+        BOOST_CHECK( out.find("# TYPE test_packets counter\n"
+                              "# HELP test_packets Packets\n"
+                              "test_packets_total{if=\"eth0\"} 42\n"
+                              "test_packets_total{if=\"eth1\"} 3\n") != std::string::npos );
+        BOOST_CHECK_EQUAL( out.substr(out.size() - 6), "# EOF\n" );
+
+        // Moving transfers the registration
+        senf::metrics::Registration moved (std::move(c1));
+        BOOST_CHECK( ! c1 );
+        BOOST_CHECK( moved );
+        moved.reset();
+        BOOST_CHECK( metricsOutput().find("eth1") == std::string::npos );
+        BOOST_CHECK( metricsOutput().find("eth0") != std::string::npos );
+    }
+
+    BOOST_CHECK_EQUAL( registry.size(), families );
+    BOOST_CHECK( metricsOutput().find("test_") == std::string::npos );
+}
+
+SENF_AUTO_TEST_CASE(metricsSummaryStatistics)
+{
+    senf::metrics::Registry & registry (senf::metrics::Registry::instance());
+
+    senf::Histogram h;
+    for (unsigned i (1u); i <= 1000u; ++i)
+        h.record(i * 1000u);
+    senf::metrics::Registration s (registry.summary("test_latency_seconds", "Latency", h, 1e-9));
+
+    senf::Statistics stats;
+    stats(1u, 2.0f, 3.0f, 4.0f, 0.5f);
+    senf::metrics::Registration st (registry.statistics("test_stats", "Stats", stats));
+
+    std::string out (metricsOutput());
+    BOOST_CHECK( out.find("# TYPE test_latency_seconds summary\n") != std::string::npos );
+    BOOST_CHECK( out.find("test_latency_seconds{quantile=\"0.5\"} 0.00050") != std::string::npos );
+    BOOST_CHECK( out.find("test_latency_seconds{quantile=\"0.999\"} 0.00099") != std::string::npos );
+    BOOST_CHECK( out.find("test_latency_seconds_count 1000\n") != std::string::npos );
+    BOOST_CHECK( out.find("test_latency_seconds_sum 0.50") != std::string::npos );
+    BOOST_CHECK( out.find("test_stats{stat=\"cnt\"} 1\n"
+                          "test_stats{stat=\"min\"} 2\n"
+                          "test_stats{stat=\"avg\"} 3\n"
+                          "test_stats{stat=\"max\"} 4\n"
+                          "test_stats{stat=\"dev\"} 0.5\n") != std::string::npos );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
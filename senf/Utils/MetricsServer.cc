@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief MetricsServer non-inline non-template implementation */
+
+#include "MetricsServer.hh"
+//#include "MetricsServer.ih"
+
+// Custom includes
+#include <sstream>
+#include <boost/range/iterator_range.hpp>
+#include <senf/Socket/Protocols/INet/TCPSocketHandle.hh>
+#include <senf/Socket/Protocols/UN/UNStreamSocketHandle.hh>
+#include <senf/Utils/membind.hh>
+
+//#include "MetricsServer.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    // Longest request accepted. Anything longer is certainly not a scrape request
+    std::string::size_type const MaxRequestSize (8192u);
+
+    unsigned const ListenBacklog (16u);
+
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::metrics::Server
+
+prefix_ senf::metrics::Server::Server(INet4SocketAddress const & address)
+    : Server (TCPv4ServerSocketHandle(address, ListenBacklog))
+{
+    SENF_LOG(( "Metrics server started at " << address ));
+}
+
+prefix_ senf::metrics::Server::Server(INet6SocketAddress const & address)
+    : Server (TCPv6ServerSocketHandle(address, ListenBacklog))
+{
+    SENF_LOG(( "Metrics server started at " << address ));
+}
+
+prefix_ senf::metrics::Server::Server(UNSocketAddress const & address)
+    : Server (UNStreamServerSocketHandle(address, ListenBacklog))
+{
+    SENF_LOG(( "Metrics server started at " << address ));
+}
+
+prefix_ senf::metrics::Server::Server(Handle handle)
+    : handle_ (handle),
+      event_ ("senf::metrics::Server", senf::membind(&Server::newClient, this),
+              handle_, scheduler::FdEvent::EV_READ),
+      maxClients_ (16u), timeout_ (ClockService::seconds(5))
+{}
+
+prefix_ void senf::metrics::Server::newClient(int event)
+{
+    Handle::ClientHandle client (handle_.accept());
+    if (clients_.size() >= maxClients_) {
+        SENF_LOG(( "Too many metrics clients, closing new connection" ));
+        return;
+    }
+    clients_.push_back(new detail::MetricsClient(*this, client));
+}
+
+prefix_ void senf::metrics::Server::removeClient(detail::MetricsClient & client)
+{
+    for (boost::ptr_list<detail::MetricsClient>::iterator i (clients_.begin());
+         i != clients_.end(); ++i)
+        if (&(*i) == &client) {
+            // THIS DELETES THE CLIENT INSTANCE !!
+            clients_.erase(i);
+            return;
+        }
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::metrics::detail::MetricsClient
+
+prefix_ senf::metrics::detail::MetricsClient::MetricsClient(Server & server, Handle handle)
+    : server_ (server), handle_ (handle),
+      readEvent_ ("senf::metrics::Client", senf::membind(&MetricsClient::readable, this),
+                  handle_, scheduler::FdEvent::EV_READ),
+      writeEvent_ ("senf::metrics::Client", senf::membind(&MetricsClient::writable, this),
+                   handle_, scheduler::FdEvent::EV_WRITE, false),
+      timer_ ("senf::metrics::Client", senf::membind(&MetricsClient::timeout, this),
+              ClockService::now() + server.timeout()),
+      sent_ (0u)
+{
+    handle_.blocking(false);
+}
+
+prefix_ void senf::metrics::detail::MetricsClient::readable(int event)
+{
+    try {
+        if (event != scheduler::FdEvent::EV_READ || handle_.eof()) {
+            if (request_.empty())
+                done();
+            else
+                respond(false);
+            return;
+        }
+        std::string::size_type n (request_.size());
+        request_.resize(n + handle_.available());
+        request_.erase(handle_.read(boost::make_iterator_range(request_.begin()+n, request_.end())),
+                       request_.end());
+    }
+    catch (ExceptionMixin &) {
+        done();
+        return;
+    }
+
+    if (request_.size() > MaxRequestSize) {
+        done();
+        return;
+    }
+    if (request_.find('\n') == std::string::npos)
+        return;
+    if (request_.compare(0, 4, "GET ") != 0)
+        respond(false);
+    else if (request_.find("\r\n\r\n") != std::string::npos
+             || request_.find("\n\n") != std::string::npos)
+        respond(true);
+}
+
+prefix_ void senf::metrics::detail::MetricsClient::respond(bool http)
+{
+    readEvent_.disable();
+    std::stringstream body;
+    Registry::instance().write(body);
+    if (http) {
+        std::stringstream ss;
+        ss << "HTTP/1.0 200 OK\r\n"
+           << "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+           << "Content-Length: " << body.str().size() << "\r\n"
+           << "Connection: close\r\n"
+           << "\r\n"
+           << body.str();
+        response_ = ss.str();
+    }
+    else
+        response_ = body.str();
+    sent_ = 0u;
+    writeEvent_.enable();
+}
+
+prefix_ void senf::metrics::detail::MetricsClient::writable(int event)
+{
+    if (event != scheduler::FdEvent::EV_WRITE) {
+        done();
+        return;
+    }
+    try {
+        char const * begin (response_.data());
+        sent_ = handle_.write(boost::make_iterator_range(begin + sent_, begin + response_.size()))
+            - begin;
+    }
+    catch (ExceptionMixin &) {
+        done();
+        return;
+    }
+    if (sent_ >= response_.size())
+        done();
+}
+
+prefix_ void senf::metrics::detail::MetricsClient::timeout()
+{
+    done();
+}
+
+prefix_ void senf::metrics::detail::MetricsClient::done()
+{
+    // THIS DELETES THE CLIENT INSTANCE !!
+    server_.removeClient(*this);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "MetricsServer.mpp"
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief MetricsServer public header */
+
+#ifndef HH_SENF_Utils_MetricsServer_
+#define HH_SENF_Utils_MetricsServer_ 1
+
+// Custom includes
+#include <boost/ptr_container/ptr_list.hpp>
+#include <senf/Scheduler/ClockService.hh>
+#include <senf/Scheduler/FdEvent.hh>
+#include <senf/Scheduler/TimerEvent.hh>
+#include <senf/Socket/Protocols/INet/INetAddressing.hh>
+#include <senf/Socket/Protocols/UN/UNAddressing.hh>
+#include <senf/Utils/Logger/SenfLog.hh>
+#include "Metrics.hh"
+
+//#include "MetricsServer.mpp"
+#include "MetricsServer.ih"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+namespace metrics {
+
+    /** \brief OpenMetrics endpoint
+
+        The Server serves the contents of the senf::metrics::Registry to monitoring systems. It is
+        completely driven by the scheduler of the thread it is created in: Every client connection
+        is handled by non-blocking reads and writes from scheduler callbacks, so a slow or stuck
+        client never blocks the scheduler.
+
+        Two kinds of requests are understood:
+
+        \li An HTTP request (\c GET on any path) is answered with a HTTP/1.0 response using the
+            OpenMetrics content type. This is what Prometheus and compatible scrapers send.
+        \li Any other line (e.g. a plain newline sent by <tt>nc -U</tt>) is answered with the bare
+            OpenMetrics text.
+
+        The connection is closed after the response has been sent.
+
+        \code
+          senf::metrics::Server tcp (senf::INet4SocketAddress("127.0.0.1:9100"));
+          senf::metrics::Server unix (senf::UNSocketAddress("/run/myapp/metrics"));
+        \endcode
+
+        \see senf::metrics
+     */
+    class Server
+        : boost::noncopyable
+    {
+        SENF_LOG_CLASS_AREA();
+        SENF_LOG_DEFAULT_LEVEL( senf::log::NOTICE );
+    public:
+        //-////////////////////////////////////////////////////////////////////////
+        // Types
+
+        typedef detail::MetricsServerHandle Handle;
+
+        //-////////////////////////////////////////////////////////////////////////
+        ///\name Structors and default members
+        //\{
+
+        explicit Server(INet4SocketAddress const & address);
+                                        ///< Serve metrics on TCP/IPv4 \a address
+        explicit Server(INet6SocketAddress const & address);
+                                        ///< Serve metrics on TCP/IPv6 \a address
+        explicit Server(UNSocketAddress const & address);
+                                        ///< Serve metrics on unix domain stream socket \a address
+        explicit Server(Handle handle); ///< Serve metrics on listening socket \a handle
+
+        //\}
+        //-////////////////////////////////////////////////////////////////////////
+
+        Handle handle() const;          ///< Listening socket
+
+        unsigned clients() const;       ///< Number of open client connections
+
+        unsigned maxClients() const;    ///< Maximum number of concurrent client connections
+        void maxClients(unsigned n);    ///< Set maximum number of concurrent client connections
+                                        /**< Further connections are closed immediately. */
+
+        ClockService::clock_type timeout() const; ///< Client timeout
+        void timeout(ClockService::clock_type t); ///< Set client timeout
+                                        /**< Clients not completing their request within \a t are
+                                             disconnected. */
+
+    private:
+        void newClient(int event);
+        void removeClient(detail::MetricsClient & client);
+
+        Handle handle_;
+        scheduler::FdEvent event_;
+        boost::ptr_list<detail::MetricsClient> clients_;
+        unsigned maxClients_;
+        ClockService::clock_type timeout_;
+
+        friend class detail::MetricsClient;
+    };
+
+}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "MetricsServer.cci"
+//#include "MetricsServer.ct"
+//#include "MetricsServer.cti"
+#endif
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
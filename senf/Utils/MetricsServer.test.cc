@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief MetricsServer unit tests */
+
+#include "MetricsServer.hh"
+
+// Custom includes
+#include <senf/Scheduler/Scheduler.hh>
+#include <senf/Socket/Protocols/UN/UNStreamSocketHandle.hh>
+
+// Unit test includes
+#include "auto_unit_test.hh"
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    void timeout()
+    {
+        senf::scheduler::terminate();
+    }
+
+    std::string scrape(senf::UNSocketAddress const & address, std::string const & request)
+    {
+        senf::UNStreamClientSocketHandle client (address);
+        client.write(request);
+        senf::scheduler::TimerEvent timer (
+            "metricsServer test timer", &timeout,
+            senf::ClockService::now() + senf::ClockService::milliseconds(200));
+        senf::scheduler::process();
+        std::string response;
+        while (client.readable() && ! client.eof())
+            response += client.read();
+        return response;
+    }
+
+}
+
+SENF_AUTO_TEST_CASE(metricsServer)
+{
+    senf::UNSocketAddress address (".socket-MetricsServer.test");
+    senf::metrics::Server server (address);
+    senf::metrics::Registration reg (senf::metrics::Registry::instance().gauge(
+        "test_server_value", "", []() { return 7.0; }));
+
+    std::string response (scrape(address, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+    BOOST_CHECK_EQUAL( response.substr(0, 17), "HTTP/1.0 200 OK\r\n" );
+    BOOST_CHECK( response.find("Content-Type: application/openmetrics-text") != std::string::npos );
+    BOOST_CHECK( response.find("\r\n\r\n# TYPE ") != std::string::npos );
+    BOOST_CHECK( response.find("\ntest_server_value 7\n") != std::string::npos );
+    BOOST_CHECK_EQUAL( response.substr(response.size() - 6), "# EOF\n" );
+
+    response = scrape(address, "\n");
+    BOOST_CHECK_EQUAL( response.substr(0, 7), "# TYPE " );
+    BOOST_CHECK( response.find("\ntest_server_value 7\n") != std::string::npos );
+    BOOST_CHECK_EQUAL( server.clients(), 0u );
+
+    // Incomplete requests time out
+    server.timeout(senf::ClockService::milliseconds(50));
+    response = scrape(address, "GET / HTTP/1.0\r\n");
+    BOOST_CHECK_EQUAL( response, "" );
+    BOOST_CHECK_EQUAL( server.clients(), 0u );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
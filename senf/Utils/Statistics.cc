@@ -24,6 +24,7 @@
 #include <senf/Utils/Format.hh>
 #include <senf/Utils/Console/STLSupport.hh>
 #include "StatisticsTargets.hh"
+#include "Histogram.hh"
 #include "String.hh"
 
 //#include "Statistics.mpp"
@@ -242,6 +243,13 @@ prefix_ senf::Statistics::Statistics()
 #endif
 }
 
+prefix_ void senf::Statistics::operator()(unsigned n, Histogram & histogram)
+{
+    enter(n, unsigned(histogram.count()), float(histogram.min()), float(histogram.mean()),
+          float(histogram.max()), float(histogram.stddev()));
+    histogram.clear();
+}
+
 prefix_ void senf::Statistics::consoleList(std::ostream & os)
     const
 {
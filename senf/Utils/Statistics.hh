@@ -42,6 +42,7 @@ namespace senf {
 
         \li the senf::Statistics class
         \li the senf::StatisticsAccumulator class
+        \li the senf::Histogram and senf::HistogramStatistics classes for value distributions
         \li statistics sources
 
         Each senf::Statistics instance collects information about a single parameter. Which
@@ -54,6 +55,7 @@ namespace senf {
 
     class Collector;
     class Statistics;
+    class Histogram;
 
     /** \brief Internal: Generic Statistics collection */
     class StatisticsBase
@@ -490,6 +492,12 @@ namespace senf {
                                              StatisticAccumulator afterwards
                                              \param[in] n number of time-slices
                                              \param[in] sa StatisticAccumulator*/
+        void operator()(unsigned n, Histogram & histogram);
+                                        ///< Same as operator() gathers values from Histogram
+                                        /**< Caution: Clears \a histogram afterwards.
+                                             \see senf::HistogramStatistics
+                                             \param[in] n number of time-slices
+                                             \param[in] histogram Histogram */
 
         StatisticsBase::OutputProxy<Statistics> output(unsigned n = 1u);
 
@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief ThreadLocalPool non-inline non-template implementation */
+
+#include "ThreadLocalPool.hh"
+//#include "ThreadLocalPool.ih"
+
+// Custom includes
+#include <algorithm>
+#include <new>
+
+//#include "ThreadLocalPool.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::detail::ThreadLocalPoolDepot
+
+prefix_ senf::detail::ThreadLocalPoolDepot::Block *
+senf::detail::ThreadLocalPoolDepot::get(unsigned & size)
+{
+    lock();
+    Block * magazine (magazines_);
+    if (magazine) {
+        magazines_ = magazine->nextMagazine;
+        count_.fetch_sub(1u, std::memory_order_relaxed);
+    }
+    unlock();
+    if (magazine) {
+        size = magazine->size;
+        return magazine;
+    }
+
+    // The depot is empty: carve a new magazine from the heap. This memory is never freed.
+    char * p (static_cast<char *>(::operator new(blockSize_ * magazineSize_)));
+    for (unsigned i (0); i < magazineSize_; ++i)
+        reinterpret_cast<Block *>(p + i * blockSize_)->next = i + 1 < magazineSize_
+            ? reinterpret_cast<Block *>(p + (i + 1) * blockSize_) : 0;
+    allocated_.fetch_add(magazineSize_, std::memory_order_relaxed);
+    size = magazineSize_;
+    return reinterpret_cast<Block *>(p);
+}
+
+prefix_ void senf::detail::ThreadLocalPoolDepot::put(Block * magazine, unsigned size)
+{
+    magazine->size = size;
+    lock();
+    magazine->nextMagazine = magazines_;
+    magazines_ = magazine;
+    count_.fetch_add(1u, std::memory_order_relaxed);
+    unlock();
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+// senf::detail::ThreadLocalPoolCache
+
+namespace senf {
+namespace detail {
+
+    // List of all caches used by a thread. This is a plain (non-template) thread_local, so
+    // it's destructor is run on thread exit.
+    class ThreadLocalPoolCacheList
+    {
+    public:
+        ThreadLocalPoolCacheList() : head_ (0) {}
+
+        ~ThreadLocalPoolCacheList()
+            {
+                while (head_) {
+                    ThreadLocalPoolCache * cache (head_);
+                    head_ = cache->nextCache_;
+                    cache->release();
+                }
+            }
+
+        void add(ThreadLocalPoolCache * cache)
+            {
+                cache->nextCache_ = head_;
+                head_ = cache;
+            }
+
+    private:
+        ThreadLocalPoolCache * head_;
+    };
+
+}}
+
+namespace {
+    thread_local senf::detail::ThreadLocalPoolCacheList cacheList;
+}
+
+prefix_ void senf::detail::ThreadLocalPoolCache::registerCache()
+{
+    // registered_ is never reset: A cache used during thread exit after the list has been
+    // destroyed must not be registered again
+    registered_ = true;
+    cacheList.add(this);
+}
+
+prefix_ void senf::detail::ThreadLocalPoolCache::release()
+{
+    // return everything to the depot so the blocks can be reused by other threads
+    while (size_ > 0) {
+        unsigned n (std::min(size_, depot_->magazineSize()));
+        depot_->put(detach(n), n);
+    }
+}
+
+prefix_ void senf::detail::ThreadLocalPoolCache::free(void * const * blocks, unsigned n)
+{
+    if (n == 0)
+        return;
+    if (SENF_UNLIKELY(! registered_))
+        registerCache();
+    for (unsigned i (0); i < n - 1; ++i)
+        static_cast<Block *>(blocks[i])->next = static_cast<Block *>(blocks[i + 1]);
+    static_cast<Block *>(blocks[n - 1])->next = head_;
+    head_ = static_cast<Block *>(blocks[0]);
+    size_ += n;
+    while (size_ >= 2 * depot_->magazineSize())
+        flush();
+}
+
+prefix_ void senf::detail::ThreadLocalPoolCache::reserve(unsigned n)
+{
+    if (! registered_)
+        registerCache();
+    while (size_ < n) {
+        unsigned k (0);
+        Block * magazine (depot_->get(k));
+        Block * tail (magazine);
+        while (tail->next)
+            tail = tail->next;
+        tail->next = head_;
+        head_ = magazine;
+        size_ += k;
+    }
+}
+
+prefix_ void senf::detail::ThreadLocalPoolCache::refill()
+{
+    if (! registered_)
+        registerCache();
+    unsigned n (0);
+    Block * magazine (depot_->get(n));
+    // the cache is empty, so the magazine is already correctly terminated
+    head_ = magazine;
+    size_ = n;
+}
+
+prefix_ void senf::detail::ThreadLocalPoolCache::flush()
+{
+    unsigned n (depot_->magazineSize());
+    depot_->put(detach(n), n);
+}
+
+prefix_ senf::detail::ThreadLocalPoolCache::Block *
+senf::detail::ThreadLocalPoolCache::detach(unsigned n)
+{
+    Block * magazine (head_);
+    Block * tail (head_);
+    for (unsigned i (1); i < n; ++i)
+        tail = tail->next;
+    head_ = tail->next;
+    tail->next = 0;
+    size_ -= n;
+    return magazine;
+}
+
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "ThreadLocalPool.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief ThreadLocalPool public header */
+
+#ifndef HH_SENF_Utils_ThreadLocalPool_
+#define HH_SENF_Utils_ThreadLocalPool_ 1
+
+// Custom includes
+#include <cstddef>
+#include <boost/noncopyable.hpp>
+
+#include "ThreadLocalPool.ih"
+//#include "ThreadLocalPool.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    /** \brief Thread local magazine pool allocator
+
+        ThreadLocalPool is a fixed size block allocator. Every thread has it's own private cache of
+        free blocks, so the fast path of malloc() and free() does neither lock nor use any atomic
+        operation. Blocks move between the threads' caches and a global depot in \e magazines of
+        \a MagazineSize blocks:
+
+        \li if the cache of a thread runs empty, a full magazine is fetched from the depot (or, if
+            the depot is empty, a new magazine is allocated from the heap)
+        \li if the cache of a thread grows beyond two magazines, one magazine is returned to the
+            depot
+        \li when a thread terminates, it's cache is returned to the depot
+
+        Within the scope of a ThreadLocalPool::BulkFree instance, free() just collects the blocks
+        which are then returned to the cache in bulk (e.g. while dropping a burst of packets).
+
+        Since all blocks of a pool are interchangeable, a block may be freed by any thread, not
+        only by the thread which allocated it. A pipeline where packets are allocated in one thread
+        and dropped in another will therefore just move full magazines through the depot.
+
+        Pools are identified by \a Tag and \a Size: all pools with the same tag and block size
+        share the same memory. Memory is never returned to the system.
+
+        \code
+        struct MyTag {};
+        typedef senf::ThreadLocalPool<MyTag, sizeof(SomeClass)> Pool;
+
+        Pool::reserve(1024);            // pre-warm this threads cache at startup
+        void * p (Pool::malloc());
+        Pool::free(p);
+        \endcode
+
+        \see pool_alloc_mixin
+     */
+    template <class Tag, std::size_t Size, unsigned MagazineSize=64u>
+    class ThreadLocalPool
+    {
+    public:
+        static std::size_t const BlockSize = detail::ThreadLocalPoolDepot::AlignedSize<Size>::value;
+                                        ///< Size of a single block
+
+        static void * malloc();         ///< Allocate a block
+        static void free(void * p);     ///< Free block
+        static void free(void * const * blocks, unsigned n);
+                                        ///< Free \a n blocks at once
+                                        /**< Bulk variant of free(), e.g. for a burst of dropped
+                                             packets. The blocks are moved to the calling threads
+                                             cache with a single overflow check. */
+
+        /** \brief Collect frees of the calling thread
+
+            While a BulkFree instance exists, free() does not touch the threads cache but collects
+            the blocks. They are returned to the cache with a single bulk free() when the
+            (outermost) BulkFree instance is destroyed or whenever the collection is full.
+         */
+        class BulkFree
+            : boost::noncopyable
+        {
+        public:
+            BulkFree();
+            ~BulkFree();
+        };
+
+        static void reserve(unsigned n); ///< Pre-warm the calling threads cache
+                                        /**< Ensures, that at least \a n blocks are available in
+                                             the calling threads cache. This avoids heap allocations
+                                             on the first packets. */
+
+        static unsigned cached();       ///< Number of free blocks cached by the calling thread
+        static unsigned long allocated(); ///< Number of blocks allocated from the heap
+        static unsigned depotMagazines(); ///< Number of free magazines in the global depot
+
+    private:
+        static void flushBulk();
+
+        static detail::ThreadLocalPoolDepot depot_;
+        static thread_local detail::ThreadLocalPoolCache cache_;
+        static thread_local detail::ThreadLocalPoolBulk bulk_;
+    };
+
+}
+
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "ThreadLocalPool.cci"
+//#include "ThreadLocalPool.ct"
+#include "ThreadLocalPool.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
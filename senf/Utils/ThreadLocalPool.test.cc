@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief ThreadLocalPool unit tests */
+
+#include "ThreadLocalPool.hh"
+
+// Custom includes
+#include <thread>
+#include <vector>
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    struct TestTag {};
+    typedef senf::ThreadLocalPool<TestTag, 40, 8> Pool;
+}
+
+SENF_AUTO_TEST_CASE(threadLocalPool)
+{
+    BOOST_CHECK_EQUAL( Pool::BlockSize % (2 * sizeof(void*)), 0u );
+    BOOST_CHECK( Pool::BlockSize >= 40u );
+    // pools of different block size are independent
+    BOOST_CHECK_EQUAL( (senf::ThreadLocalPool<TestTag, 1>::BlockSize) % (2 * sizeof(void*)), 0u );
+    BOOST_CHECK_EQUAL( (senf::ThreadLocalPool<TestTag, 1>::allocated()), 0u );
+
+    void * p (Pool::malloc());
+    BOOST_CHECK( p != 0 );
+    BOOST_CHECK_EQUAL( Pool::allocated(), 8u );
+    BOOST_CHECK_EQUAL( Pool::cached(), 7u );
+    Pool::free(p);
+    BOOST_CHECK_EQUAL( Pool::cached(), 8u );
+    BOOST_CHECK_EQUAL( Pool::malloc(), p );
+    Pool::free(p);
+
+    Pool::reserve(20);
+    BOOST_CHECK( Pool::cached() >= 20u );
+    BOOST_CHECK_EQUAL( Pool::allocated(), 24u );
+
+    std::vector<void *> blocks;
+    for (unsigned i (0); i < 24; ++i)
+        blocks.push_back(Pool::malloc());
+    BOOST_CHECK_EQUAL( Pool::cached(), 0u );
+    BOOST_CHECK_EQUAL( Pool::allocated(), 24u );
+    for (unsigned i (1); i < blocks.size(); ++i)
+        BOOST_CHECK( blocks[i] != blocks[i-1] );
+
+    // bulk free flushes surplus magazines to the depot
+    Pool::free(&blocks[0], blocks.size());
+    BOOST_CHECK( Pool::cached() < 16u );
+    BOOST_CHECK_EQUAL( Pool::cached() + 8 * Pool::depotMagazines(), 24u );
+}
+
+SENF_AUTO_TEST_CASE(threadLocalPool_bulkFree)
+{
+    typedef senf::ThreadLocalPool<TestTag, 200, 8> BulkPool;
+    std::vector<void *> blocks;
+    for (unsigned i (0); i < 5; ++i)
+        blocks.push_back(BulkPool::malloc());
+    BOOST_CHECK_EQUAL( BulkPool::cached(), 3u );
+    {
+        BulkPool::BulkFree bulk;
+        {
+            BulkPool::BulkFree nested;
+            for (void * p : blocks)
+                BulkPool::free(p);
+        }
+        // frees are collected until the outermost scope ends
+        BOOST_CHECK_EQUAL( BulkPool::cached(), 3u );
+    }
+    BOOST_CHECK_EQUAL( BulkPool::cached(), 8u );
+    BOOST_CHECK_EQUAL( BulkPool::allocated(), 8u );
+}
+
+SENF_AUTO_TEST_CASE(threadLocalPool_crossThread)
+{
+    std::vector<void *> blocks;
+    for (unsigned i (0); i < 100; ++i)
+        blocks.push_back(Pool::malloc());
+    unsigned long allocated (Pool::allocated());
+
+    // free the blocks in another thread. On thread exit, its cache is returned to the depot
+    std::thread t ([&blocks]() {
+            for (void * p : blocks)
+                Pool::free(p);
+        });
+    t.join();
+
+    unsigned magazines (Pool::depotMagazines());
+    BOOST_CHECK( magazines * 8 >= 100u );
+    for (unsigned i (0); i < 100; ++i)
+        Pool::malloc();
+    BOOST_CHECK_EQUAL( Pool::allocated(), allocated );
+}
+
+
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
@@ -18,7 +18,7 @@
 #define HH_SENF_Utils_pool_alloc_mixin_ 1
 
 // Custom includes
-#include <boost/pool/singleton_pool.hpp>
+#include <senf/Utils/ThreadLocalPool.hh>
 
 //#include "pool_alloc_mixin.mpp"
 //-/////////////////////////////////////////////////////////////////////////////////////////////////
@@ -30,9 +30,8 @@ namespace senf {
     /** \brief Mixin to assign pool allocator to a class
 
         This mixin will overload a classes <tt>operator new</tt> and <tt>operator delete</tt> so as
-        to make the class use the <a
-        href="http://www.boost.org/doc/libs/release/libs/pool/doc/index.html">Boost.Pool</a> memory allocator by
-        default. Using this allocator does however introduce a few restrictions:
+        to make the class use the senf::ThreadLocalPool memory allocator by default. Using this
+        allocator does however introduce a few restrictions:
 
         \li The operator is defined for a fixed size. Therefore if you derive from the class <b>you
             must not change it's size</b>.
@@ -48,11 +47,10 @@ namespace senf {
           };
         \endcode
 
-        \note pool_alloc_mixin uses the <a
-            href="http://www.boost.org/doc/libs/release/libs/pool/doc/index.html">Boost.Pool</a> <i>singleton
-            pool</i> interface with the tag <tt>pool_alloc_mixin_tag</tt>. This class is accessible
-            via the <tt>pool</tt> member. Using this member, it is simple to call relevant pool
-            functions, e.g. <tt>SomeClass::pool<>::release_memory()</tt>.
+        \note pool_alloc_mixin uses the senf::ThreadLocalPool with the tag
+            <tt>pool_alloc_mixin_tag</tt>. This class is accessible via the <tt>pool</tt> member.
+            Using this member, it is simple to call relevant pool functions, e.g.
+            <tt>SomeClass::pool<>::reserve(1024)</tt>.
      */
     template <class Self>
     class pool_alloc_mixin
@@ -65,9 +63,9 @@ namespace senf {
          */
         template <class T=void>
         struct pool
-            : public boost::singleton_pool< pool_alloc_mixin_tag, sizeof(Self) >
+            : public ThreadLocalPool< pool_alloc_mixin_tag, sizeof(Self) >
         {
-            typedef boost::singleton_pool< pool_alloc_mixin_tag, sizeof(Self) > type;
+            typedef ThreadLocalPool< pool_alloc_mixin_tag, sizeof(Self) > type;
         };
 
         static void * operator new (size_t size);
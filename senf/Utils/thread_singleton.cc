@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief thread_singleton non-inline non-template implementation */
+
+#include "thread_singleton.hh"
+//#include "thread_singleton.ih"
+
+// Custom includes
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <vector>
+
+//#include "thread_singleton.mpp"
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    // Callbacks to run on thread exit. This is a plain (non-template) thread_local, so it's
+    // destructor is run on thread exit.
+    class ThreadExitList
+    {
+    public:
+        ~ThreadExitList()
+            {
+                // destroying an instance may create (and register) further instances
+                while (! callbacks_.empty()) {
+                    Callback cb (callbacks_.back());
+                    callbacks_.pop_back();
+                    cb.first(cb.second);
+                }
+            }
+
+        void add(void (*fn)(void *), void * arg)
+            {
+                callbacks_.push_back(Callback(fn, arg));
+            }
+
+    private:
+        typedef std::pair<void (*)(void *), void *> Callback;
+        std::vector<Callback> callbacks_;
+    };
+
+    thread_local ThreadExitList exitList;
+    thread_local int isMainThread (-1);
+
+}
+
+prefix_ bool senf::detail::mainThread()
+{
+    if (isMainThread < 0)
+        // the thread id of the main thread is the process id
+        isMainThread = ::syscall(SYS_gettid) == ::getpid();
+    return isMainThread;
+}
+
+prefix_ void senf::detail::atThreadExit(void (*fn)(void *), void * arg)
+{
+    exitList.add(fn, arg);
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+//#include "thread_singleton.mpp"
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// comment-column: 40
+// End:
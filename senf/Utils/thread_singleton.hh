@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief thread_singleton public header */
+
+#ifndef HH_SENF_Utils_thread_singleton_
+#define HH_SENF_Utils_thread_singleton_ 1
+
+// Custom includes
+#include <boost/noncopyable.hpp>
+
+//#include "thread_singleton.mpp"
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace senf {
+
+    /** \brief Mark a class as per-thread singleton and provide singleton accessor
+
+        This mixin is the per-thread variant of \ref singleton: Every thread calling instance()
+        gets it's own instance of the class.
+
+        \li The instance of the main thread is a static object. As with \ref singleton, it is
+            constructed before main() starts executing and destroyed after main() ends.
+        \li Every other thread gets it's instance allocated on the first call to instance(). This
+            instance is destroyed when the thread terminates. Instances are destroyed in the
+            reverse order of their construction.
+
+        The singleton class must have a non throwing default constructor and destructor. The class
+        is used exactly like \ref singleton:
+
+        \code
+          class SomeClass
+              : public senf::thread_singleton<SomeClass>
+          {
+              SomeClass();
+              friend class senf::thread_singleton<SomeClass>;
+
+          public:
+              using senf::thread_singleton<SomeClass>::instance;
+          };
+        \endcode
+
+        \warning Instances are strictly thread private. Any object referencing an instance (like a
+            scheduler event referencing the scheduler instance of the thread it was registered
+            in) must only be used from that thread.
+     */
+    template <class Self>
+    class thread_singleton
+        : boost::noncopyable
+    {
+    protected:
+        thread_singleton();
+        ~thread_singleton();
+
+        static Self & instance();       ///< Return singleton instance of the calling thread
+        static bool alive();            ///< \c true, if the calling threads instance is ok
+        static bool mainThread();       ///< \c true, if called from the main thread
+
+    private:
+        static Self & create();
+        static void destroy(void * p);
+
+        /** \brief Internal
+            \internal
+         */
+        struct force_creation
+        {
+            force_creation();
+            void nop() const;
+        };
+
+        static force_creation creator_;
+        // both members are trivially destructible (see ThreadLocalPool)
+        static thread_local Self * instance_;
+        static thread_local bool alive_;
+    };
+
+namespace detail {
+
+    bool mainThread();
+    void atThreadExit(void (*fn)(void *), void * arg);
+
+}}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+//#include "thread_singleton.cci"
+//#include "thread_singleton.ct"
+#include "thread_singleton.cti"
+#endif
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// comment-column: 40
+// End:
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2020 Fraunhofer Institute for Applied Information Technology (FIT)
+//                    Network Research Group (NET)
+//                    Schloss Birlinghoven, 53754 Sankt Augustin, GERMANY
+//                    Contact: support@wiback.org
+//
+// This file is part of the SENF code tree.
+// It is licensed under the 3-clause BSD License (aka New BSD License).
+// See LICENSE.txt in the top level directory for details or visit
+// https://opensource.org/licenses/BSD-3-Clause
+//
+
+
+/** \file
+    \brief thread_singleton unit tests */
+
+#include "thread_singleton.hh"
+
+// Custom includes
+#include <thread>
+
+// Unit test includes
+#include <senf/Utils/auto_unit_test.hh>
+
+#define prefix_
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    unsigned constructed (0);
+    unsigned destructed (0);
+
+    class PerThread : public senf::thread_singleton<PerThread>
+    {
+        friend class senf::thread_singleton<PerThread>;
+
+        PerThread() : value (0) { ++ constructed; }
+        ~PerThread() { ++ destructed; }
+
+    public:
+        using senf::thread_singleton<PerThread>::instance;
+        using senf::thread_singleton<PerThread>::alive;
+        using senf::thread_singleton<PerThread>::mainThread;
+
+        unsigned value;
+    };
+
+}
+
+SENF_AUTO_TEST_CASE(threadSingleton)
+{
+    BOOST_CHECK( PerThread::mainThread() );
+    BOOST_CHECK( PerThread::alive() );
+    // the main threads instance is created before main()
+    BOOST_CHECK_EQUAL( constructed, 1u );
+
+    PerThread * mainInstance (&PerThread::instance());
+    mainInstance->value = 1;
+
+    PerThread * threadInstance (0);
+    bool threadMain (true);
+    bool threadAlive (false);
+    unsigned threadValue (1);
+    std::thread t ([&]() {
+            threadMain = PerThread::mainThread();
+            threadInstance = &PerThread::instance();
+            threadAlive = PerThread::alive();
+            threadValue = threadInstance->value;
+            BOOST_CHECK( threadInstance == &PerThread::instance() );
+        });
+    t.join();
+
+    BOOST_CHECK( ! threadMain );
+    BOOST_CHECK( threadAlive );
+    BOOST_CHECK( threadInstance != mainInstance );
+    BOOST_CHECK_EQUAL( threadValue, 0u );
+    BOOST_CHECK_EQUAL( constructed, 2u );
+    // the threads instance is destroyed on thread exit
+    BOOST_CHECK_EQUAL( destructed, 1u );
+    BOOST_CHECK_EQUAL( PerThread::instance().value, 1u );
+}
+
+//-/////////////////////////////////////////////////////////////////////////////////////////////////
+#undef prefix_
+
+
+// Local Variables:
+// mode: c++
+// fill-column: 100
+// comment-column: 40
+// c-file-style: "senf"
+// indent-tabs-mode: nil
+// ispell-local-dictionary: "american"
+// compile-command: "scons -u test"
+// End:
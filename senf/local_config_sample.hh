@@ -92,6 +92,11 @@
 // The initial tailroom of PacketVector
 // #define SENF_PACKET_VECTOR_TAILROOM 128
 
+///////////////////////////////////////////////////////////////////////////
+// If defined, packet registries with small integer keys do not use flat
+// lookup tables but always the ordered index
+// #define SENF_PACKET_REGISTRY_NO_FLAT_LOOKUP 1
+
 
 // Local Variables:
 // mode: c++
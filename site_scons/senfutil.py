@@ -216,7 +216,7 @@ def SetupForSENF(env, senf_path = [], flavor=None, exit_if_not_found=False, vars
         LINKFLAGS         = [ '-rdynamic' ],
         LIBS              = [ 'senf$LIBADDSUFFIX', 'rt', '$BOOSTREGEXLIB',
                               '$BOOSTSIGNALSLIB', '$BOOSTFSLIB', '$BOOSTSYSTEMLIB',
-                              '$BOOSTDATETIMELIB' ],
+                              '$BOOSTDATETIMELIB', 'pthread' ],
     )
 
     try: